@@ -89,38 +89,34 @@ void blake2s_compress(blake2s_state *state, const uint8_t block[BLAKE2S_BLOCKBYT
     }
 }
 
-// Initialize BLAKE2s state
-void blake2s_init(blake2s_state *state, uint8_t outlen, const uint8_t *key, uint8_t keylen) {
+// Fill a parameter block for sequential hashing (fanout 1, depth 1); tree
+// modes adjust the node fields afterwards
+void blake2s_param_init(blake2s_param *param, uint8_t outlen, uint8_t keylen) {
 #pragma HLS INLINE
-    
-    blake2s_param param;
-    
-    // Initialize parameter block
-    param.digest_length = outlen;
-    param.key_length = keylen;
-    param.fanout = 1;
-    param.depth = 1;
-    param.leaf_length = 0;
-    param.node_offset = 0;
-    param.xof_length = 0;
-    param.node_depth = 0;
-    param.inner_length = 0;
-    
-    // Clear reserved area
-    for (int i = 0; i < 14; i++) {
-#pragma HLS UNROLL
-        param.reserved[i] = 0;
-    }
+    param->digest_length = outlen;
+    param->key_length = keylen;
+    param->fanout = 1;
+    param->depth = 1;
+    param->leaf_length = 0;
+    param->node_offset = 0;
+    param->xof_length = 0;
+    param->node_depth = 0;
+    param->inner_length = 0;
     
     // Clear salt and personal
     for (int i = 0; i < BLAKE2S_SALTBYTES; i++) {
 #pragma HLS UNROLL
-        param.salt[i] = 0;
+        param->salt[i] = 0;
     }
     for (int i = 0; i < BLAKE2S_PERSONALBYTES; i++) {
 #pragma HLS UNROLL
-        param.personal[i] = 0;
+        param->personal[i] = 0;
     }
+}
+
+// Initialize BLAKE2s state from a parameter block
+void blake2s_init_param(blake2s_state *state, const blake2s_param *param, const uint8_t *key, uint8_t keylen) {
+#pragma HLS INLINE
     
     // Initialize state
     for (int i = 0; i < 8; i++) {
@@ -128,8 +124,23 @@ void blake2s_init(blake2s_state *state, uint8_t outlen, const uint8_t *key, uint
         state->h[i] = blake2s_iv[i];
     }
     
-    // XOR with parameter block
-    uint32_t *p = (uint32_t *)&param;
+    // XOR with parameter block, packed as little-endian words
+    uint32_t p[8];
+    p[0] = (uint32_t)param->digest_length | ((uint32_t)param->key_length << 8) |
+           ((uint32_t)param->fanout << 16) | ((uint32_t)param->depth << 24);
+    p[1] = param->leaf_length;
+    p[2] = param->node_offset;
+    p[3] = (uint32_t)param->xof_length | ((uint32_t)param->node_depth << 16) |
+           ((uint32_t)param->inner_length << 24);
+    for (int i = 0; i < 2; i++) {
+#pragma HLS UNROLL
+        const uint8_t *salt = &param->salt[i * 4];
+        const uint8_t *personal = &param->personal[i * 4];
+        p[4 + i] = (uint32_t)salt[0] | ((uint32_t)salt[1] << 8) |
+                   ((uint32_t)salt[2] << 16) | ((uint32_t)salt[3] << 24);
+        p[6 + i] = (uint32_t)personal[0] | ((uint32_t)personal[1] << 8) |
+                   ((uint32_t)personal[2] << 16) | ((uint32_t)personal[3] << 24);
+    }
     for (int i = 0; i < 8; i++) {
 #pragma HLS UNROLL
         state->h[i] ^= p[i];
@@ -140,8 +151,9 @@ void blake2s_init(blake2s_state *state, uint8_t outlen, const uint8_t *key, uint
     state->f[0] = 0;
     state->f[1] = 0;
     state->buflen = 0;
-    state->outlen = outlen;
+    state->outlen = param->digest_length;
     state->keylen = keylen;
+    state->last_node = 0;
     
     // Clear buffer
     for (int i = 0; i < BLAKE2S_BLOCKBYTES; i++) {
@@ -159,6 +171,15 @@ void blake2s_init(blake2s_state *state, uint8_t outlen, const uint8_t *key, uint
     }
 }
 
+// Initialize BLAKE2s state
+void blake2s_init(blake2s_state *state, uint8_t outlen, const uint8_t *key, uint8_t keylen) {
+#pragma HLS INLINE
+    
+    blake2s_param param;
+    blake2s_param_init(&param, outlen, keylen);
+    blake2s_init_param(state, &param, key, keylen);
+}
+
 // Update BLAKE2s state with input data
 void blake2s_update(blake2s_state *state, const uint8_t *input, uint32_t inlen) {
     
@@ -219,6 +240,9 @@ void blake2s_final(blake2s_state *state, uint8_t *output) {
     }
     
     state->f[0] = 0xFFFFFFFF;
+    if (state->last_node) {
+        state->f[1] = 0xFFFFFFFF;
+    }
     blake2s_compress(state, state->buf);
     
     // Convert hash to bytes (little-endian)
@@ -268,4 +292,395 @@ void blake2s_hash(
     
     // Finalize
     blake2s_final(&state, output);
-}
\ No newline at end of file
+}
+
+// Load block `blk` of a lane's message as 16 little-endian words. With a
+// key, block 0 is the zero-padded key and the data starts at block 1; the
+// final data block is zero-padded. Consecutive data blocks are `stride`
+// bytes apart (64 for contiguous messages, 512 for BLAKE2sp leaves).
+// Data is read a 32-bit word per cycle: a block at any byte offset spans at
+// most 17 aligned words, and each message word joins two neighbours.
+static void load_lane_block(const uint32_t *input, const uint8_t *key, uint32_t key_len,
+                            uint32_t offset, uint32_t stride, uint32_t length, uint32_t blk, uint32_t m[16]) {
+#pragma HLS INLINE
+    bool key_block = (key_len > 0) && (blk == 0);
+    uint32_t data_blk = (key_len > 0) ? blk - 1 : blk;
+    uint32_t base = offset + data_blk * stride;
+    uint32_t avail = key_block ? key_len : length - data_blk * BLAKE2S_BLOCKBYTES;
+    if (avail > BLAKE2S_BLOCKBYTES) avail = BLAKE2S_BLOCKBYTES;
+
+    if (key_block) {
+        KEY_LOAD: for (int w = 0; w < 16; w++) {
+            uint32_t word = 0;
+            for (int b = 0; b < 4; b++) {
+#pragma HLS PIPELINE II=1
+                uint32_t i = w * 4 + b;
+                uint8_t byte = (i < avail) ? key[i] : 0;
+                word |= (uint32_t)byte << (8 * b);
+            }
+            m[w] = word;
+        }
+        return;
+    }
+
+    // Only words holding message bytes are read, so nothing past the
+    // data's last 32-bit word is touched
+    uint32_t first = base / 4;
+    uint32_t last = (avail == 0) ? first : (base + avail - 1) / 4;
+    uint32_t shift = (base % 4) * 8;
+    uint32_t lo = (avail > 0) ? input[first] : 0;
+    DATA_LOAD: for (int w = 0; w < 16; w++) {
+#pragma HLS PIPELINE II=1
+        uint32_t hi = (first + w + 1 <= last) ? input[first + w + 1] : 0;
+        uint32_t word = (shift == 0) ? lo : (lo >> shift) | (hi << (32 - shift));
+        int valid = (int)avail - 4 * w;
+        uint32_t mask = (valid >= 4) ? 0xFFFFFFFF : (valid <= 0) ? 0 : (1u << (8 * valid)) - 1;
+        m[w] = word & mask;
+        lo = hi;
+    }
+}
+
+// Hash up to BLAKE2S_BATCH_LANES independent nodes with their compressions
+// interleaved. h must hold IV ^ parameter block for each lane on entry and
+// holds the chaining values on return. One (round, lane) pair issues per
+// cycle so each lane's round has LANES cycles to complete before its next
+// round starts, instead of the pipeline stalling on a single chain.
+static void blake2s_hash_lanes(
+    const uint32_t *input,
+    const uint8_t *keys,
+    uint32_t h[BLAKE2S_BATCH_LANES][8],
+    const uint32_t offset[BLAKE2S_BATCH_LANES],
+    const uint32_t length[BLAKE2S_BATCH_LANES],
+    const uint32_t key_offset[BLAKE2S_BATCH_LANES],
+    const uint32_t key_len[BLAKE2S_BATCH_LANES],
+    const bool last_node[BLAKE2S_BATCH_LANES],
+    uint32_t stride,
+    int lanes
+) {
+#pragma HLS INLINE
+    uint32_t v[BLAKE2S_BATCH_LANES][16];
+    uint32_t m[BLAKE2S_BATCH_LANES][16];
+#pragma HLS ARRAY_PARTITION variable=v complete dim=2
+#pragma HLS ARRAY_PARTITION variable=m complete dim=2
+
+    uint32_t total[BLAKE2S_BATCH_LANES];
+    uint32_t nblocks[BLAKE2S_BATCH_LANES];
+
+    uint32_t max_blocks = 0;
+    LANE_SETUP_LOOP: for (int l = 0; l < BLAKE2S_BATCH_LANES; l++) {
+#pragma HLS PIPELINE II=1
+        if (l < lanes) {
+            total[l] = length[l] + (key_len[l] > 0 ? BLAKE2S_BLOCKBYTES : 0);
+            nblocks[l] = (total[l] == 0) ? 1 : (total[l] + BLAKE2S_BLOCKBYTES - 1) / BLAKE2S_BLOCKBYTES;
+        } else {
+            total[l] = 0;
+            nblocks[l] = 0;
+        }
+        if (nblocks[l] > max_blocks) max_blocks = nblocks[l];
+    }
+
+    LANE_BLOCK_LOOP: for (uint32_t blk = 0; blk < max_blocks; blk++) {
+
+        // Stage the next block of every lane still running
+        LANE_LOAD_LOOP: for (int l = 0; l < BLAKE2S_BATCH_LANES; l++) {
+            if (blk < nblocks[l]) {
+                load_lane_block(input, &keys[key_offset[l]], key_len[l],
+                                offset[l], stride, length[l], blk, m[l]);
+            }
+            uint32_t done = (blk + 1) * BLAKE2S_BLOCKBYTES;
+            uint32_t t0 = (done < total[l]) ? done : total[l];
+            bool last = (blk + 1 == nblocks[l]);
+            for (int i = 0; i < 8; i++) {
+#pragma HLS UNROLL
+                v[l][i] = h[l][i];
+                v[l][i + 8] = blake2s_iv[i];
+            }
+            v[l][12] ^= t0;
+            v[l][14] ^= last ? 0xFFFFFFFF : 0;
+            v[l][15] ^= (last && last_node[l]) ? 0xFFFFFFFF : 0;
+        }
+
+        LANE_ROUND_LOOP: for (int round = 0; round < 10; round++) {
+            LANE_LOOP: for (int l = 0; l < BLAKE2S_BATCH_LANES; l++) {
+#pragma HLS PIPELINE II=1
+#pragma HLS DEPENDENCE variable=v inter distance=BLAKE2S_BATCH_LANES true
+                const uint8_t *s = blake2s_sigma[round];
+                blake2s_g(v[l], 0, 4, 8, 12, m[l][s[0]], m[l][s[1]]);
+                blake2s_g(v[l], 1, 5, 9, 13, m[l][s[2]], m[l][s[3]]);
+                blake2s_g(v[l], 2, 6, 10, 14, m[l][s[4]], m[l][s[5]]);
+                blake2s_g(v[l], 3, 7, 11, 15, m[l][s[6]], m[l][s[7]]);
+                blake2s_g(v[l], 0, 5, 10, 15, m[l][s[8]], m[l][s[9]]);
+                blake2s_g(v[l], 1, 6, 11, 12, m[l][s[10]], m[l][s[11]]);
+                blake2s_g(v[l], 2, 7, 8, 13, m[l][s[12]], m[l][s[13]]);
+                blake2s_g(v[l], 3, 4, 9, 14, m[l][s[14]], m[l][s[15]]);
+            }
+        }
+
+        LANE_UPDATE_LOOP: for (int l = 0; l < BLAKE2S_BATCH_LANES; l++) {
+#pragma HLS PIPELINE II=1
+            if (blk < nblocks[l]) {
+                for (int i = 0; i < 8; i++) {
+#pragma HLS UNROLL
+                    h[l][i] ^= v[l][i] ^ v[l][i + 8];
+                }
+            }
+        }
+    }
+}
+
+// Many independent (optionally keyed) messages in one launch, taken
+// BLAKE2S_BATCH_LANES at a time.
+void blake2s_hash_batch(
+    const uint32_t *input,
+    const uint8_t *keys,
+    const uint32_t *msg_table,
+    uint8_t *output,
+    int num_messages
+) {
+#pragma HLS INTERFACE m_axi port=input depth=1024 offset=slave bundle=gmem0
+#pragma HLS INTERFACE m_axi port=keys depth=256 offset=slave bundle=gmem1
+#pragma HLS INTERFACE m_axi port=msg_table depth=64 offset=slave bundle=gmem1
+#pragma HLS INTERFACE m_axi port=output depth=512 offset=slave bundle=gmem2
+#pragma HLS INTERFACE s_axilite port=input bundle=control
+#pragma HLS INTERFACE s_axilite port=keys bundle=control
+#pragma HLS INTERFACE s_axilite port=msg_table bundle=control
+#pragma HLS INTERFACE s_axilite port=output bundle=control
+#pragma HLS INTERFACE s_axilite port=num_messages bundle=control
+#pragma HLS INTERFACE s_axilite port=return bundle=control
+
+    uint32_t h[BLAKE2S_BATCH_LANES][8];
+#pragma HLS ARRAY_PARTITION variable=h complete dim=2
+
+    uint32_t offset[BLAKE2S_BATCH_LANES];
+    uint32_t length[BLAKE2S_BATCH_LANES];
+    uint32_t key_offset[BLAKE2S_BATCH_LANES];
+    uint32_t key_len[BLAKE2S_BATCH_LANES];
+    bool last_node[BLAKE2S_BATCH_LANES];
+
+    BATCH_GROUP_LOOP: for (int group = 0; group < num_messages; group += BLAKE2S_BATCH_LANES) {
+        int lanes = num_messages - group;
+        if (lanes > BLAKE2S_BATCH_LANES) lanes = BLAKE2S_BATCH_LANES;
+
+        // Read descriptors; h = IV ^ parameter block word 0 (digest 32,
+        // key length, fanout 1, depth 1; the remaining words are zero)
+        BATCH_DESC_LOOP: for (int l = 0; l < BLAKE2S_BATCH_LANES; l++) {
+#pragma HLS PIPELINE II=4
+            if (l < lanes) {
+                offset[l] = msg_table[(group + l) * BLAKE2S_DESC_WORDS + 0];
+                length[l] = msg_table[(group + l) * BLAKE2S_DESC_WORDS + 1];
+                key_offset[l] = msg_table[(group + l) * BLAKE2S_DESC_WORDS + 2] * BLAKE2S_KEYBYTES;
+                key_len[l] = msg_table[(group + l) * BLAKE2S_DESC_WORDS + 3];
+                if (key_len[l] > BLAKE2S_KEYBYTES) key_len[l] = BLAKE2S_KEYBYTES;
+            } else {
+                offset[l] = 0;
+                length[l] = 0;
+                key_offset[l] = 0;
+                key_len[l] = 0;
+            }
+            last_node[l] = false;
+
+            for (int i = 0; i < 8; i++) {
+#pragma HLS UNROLL
+                h[l][i] = blake2s_iv[i];
+            }
+            h[l][0] ^= 0x01010000 ^ (key_len[l] << 8) ^ BLAKE2S_OUTBYTES;
+        }
+
+        blake2s_hash_lanes(input, keys, h, offset, length, key_offset, key_len, last_node,
+                           BLAKE2S_BLOCKBYTES, lanes);
+
+        BATCH_OUTPUT_LOOP: for (int l = 0; l < BLAKE2S_BATCH_LANES; l++) {
+            if (l < lanes) {
+                for (int i = 0; i < BLAKE2S_OUTBYTES; i++) {
+#pragma HLS PIPELINE II=1
+                    output[(group + l) * BLAKE2S_OUTBYTES + i] = (h[l][i / 4] >> (8 * (i % 4))) & 0xFF;
+                }
+            }
+        }
+    }
+}
+
+// BLAKE2sp: eight leaves (fanout 8, depth 2) take the input in 64-byte
+// blocks round-robin, i.e. leaf i hashes blocks i, i+8, i+16, ... Each
+// leaf is keyed; the root hashes the eight 32-byte leaf digests unkeyed
+// but with the key length in its parameter block. The leaves are exactly
+// one lane group, so they all run interleaved in a single pass.
+void blake2sp_hash(
+    const uint32_t *input,
+    uint32_t input_len,
+    uint8_t *output,
+    uint32_t output_len,
+    const uint8_t *key,
+    uint32_t key_len
+) {
+#pragma HLS INTERFACE m_axi port=input depth=1024 offset=slave bundle=gmem0
+#pragma HLS INTERFACE m_axi port=output depth=32 offset=slave bundle=gmem1
+#pragma HLS INTERFACE m_axi port=key depth=32 offset=slave bundle=gmem2
+#pragma HLS INTERFACE s_axilite port=input bundle=control
+#pragma HLS INTERFACE s_axilite port=input_len bundle=control
+#pragma HLS INTERFACE s_axilite port=output bundle=control
+#pragma HLS INTERFACE s_axilite port=output_len bundle=control
+#pragma HLS INTERFACE s_axilite port=key bundle=control
+#pragma HLS INTERFACE s_axilite port=key_len bundle=control
+#pragma HLS INTERFACE s_axilite port=return bundle=control
+
+    if (output_len > BLAKE2S_OUTBYTES) output_len = BLAKE2S_OUTBYTES;
+    if (key_len > BLAKE2S_KEYBYTES) key_len = BLAKE2S_KEYBYTES;
+
+    uint32_t h[BLAKE2SP_PARALLELISM][8];
+#pragma HLS ARRAY_PARTITION variable=h complete dim=2
+
+    uint32_t offset[BLAKE2SP_PARALLELISM];
+    uint32_t length[BLAKE2SP_PARALLELISM];
+    uint32_t key_offset[BLAKE2SP_PARALLELISM];
+    uint32_t key_lens[BLAKE2SP_PARALLELISM];
+    bool last_node[BLAKE2SP_PARALLELISM];
+
+    const uint32_t stripe = BLAKE2SP_PARALLELISM * BLAKE2S_BLOCKBYTES;
+    uint32_t full = input_len / stripe;
+    uint32_t rem = input_len % stripe;
+
+    SP_LEAF_SETUP: for (int l = 0; l < BLAKE2SP_PARALLELISM; l++) {
+#pragma HLS PIPELINE II=1
+        uint32_t start = l * BLAKE2S_BLOCKBYTES;
+        uint32_t tail = (rem > start) ? rem - start : 0;
+        if (tail > BLAKE2S_BLOCKBYTES) tail = BLAKE2S_BLOCKBYTES;
+
+        offset[l] = start;
+        length[l] = full * BLAKE2S_BLOCKBYTES + tail;
+        key_offset[l] = 0;
+        key_lens[l] = key_len;
+        last_node[l] = (l == BLAKE2SP_PARALLELISM - 1);
+
+        // Leaf parameter block: fanout 8, depth 2, node_offset l,
+        // node_depth 0, inner_length 32
+        for (int i = 0; i < 8; i++) {
+#pragma HLS UNROLL
+            h[l][i] = blake2s_iv[i];
+        }
+        h[l][0] ^= output_len ^ (key_len << 8) ^ (BLAKE2SP_PARALLELISM << 16) ^ (2 << 24);
+        h[l][2] ^= l;
+        h[l][3] ^= (uint32_t)BLAKE2S_OUTBYTES << 24;
+    }
+
+    blake2s_hash_lanes(input, key, h, offset, length, key_offset, key_lens, last_node,
+                       stripe, BLAKE2SP_PARALLELISM);
+
+    // Root node over the leaf digests
+    uint8_t leaves[BLAKE2SP_PARALLELISM * BLAKE2S_OUTBYTES];
+    SP_LEAF_OUT: for (int i = 0; i < BLAKE2SP_PARALLELISM * BLAKE2S_OUTBYTES; i++) {
+#pragma HLS PIPELINE II=1
+        int l = i / BLAKE2S_OUTBYTES;
+        int j = i % BLAKE2S_OUTBYTES;
+        leaves[i] = (h[l][j / 4] >> (8 * (j % 4))) & 0xFF;
+    }
+
+    blake2s_param param;
+    blake2s_param_init(&param, output_len, key_len);
+    param.fanout = BLAKE2SP_PARALLELISM;
+    param.depth = 2;
+    param.node_depth = 1;
+    param.inner_length = BLAKE2S_OUTBYTES;
+
+    blake2s_state state;
+    blake2s_init_param(&state, &param, 0, 0);
+    state.last_node = 1;
+    blake2s_update(&state, leaves, sizeof(leaves));
+    blake2s_final(&state, output);
+}
+
+// One level of a BLAKE2 tree. The level input is split into nodes of
+// node_bytes each (0 = a single node); node i is hashed with the parameter
+// block `param` plus node_offset i, and the last node gets the last-node
+// flag (except in sequential mode, depth 1). With key_len > 0 every node
+// is prefixed with the key block, which the host only asks for on the leaf
+// level. Each node writes digest_bytes of its chaining value (inner_length
+// below the root, the digest length at the root) to
+// output[i * digest_bytes], so the output of one level is the input of the
+// next with node_bytes = fanout * inner_length.
+void blake2s_tree_level(
+    const uint32_t *input,
+    uint32_t input_len,
+    uint32_t node_bytes,
+    const uint8_t *key,
+    uint32_t key_len,
+    const uint32_t *param,
+    uint8_t *output,
+    uint32_t digest_bytes
+) {
+#pragma HLS INTERFACE m_axi port=input depth=1024 offset=slave bundle=gmem0
+#pragma HLS INTERFACE m_axi port=key depth=32 offset=slave bundle=gmem1
+#pragma HLS INTERFACE m_axi port=param depth=8 offset=slave bundle=gmem1
+#pragma HLS INTERFACE m_axi port=output depth=512 offset=slave bundle=gmem2
+#pragma HLS INTERFACE s_axilite port=input bundle=control
+#pragma HLS INTERFACE s_axilite port=input_len bundle=control
+#pragma HLS INTERFACE s_axilite port=node_bytes bundle=control
+#pragma HLS INTERFACE s_axilite port=key bundle=control
+#pragma HLS INTERFACE s_axilite port=key_len bundle=control
+#pragma HLS INTERFACE s_axilite port=param bundle=control
+#pragma HLS INTERFACE s_axilite port=output bundle=control
+#pragma HLS INTERFACE s_axilite port=digest_bytes bundle=control
+#pragma HLS INTERFACE s_axilite port=return bundle=control
+
+    if (digest_bytes > BLAKE2S_OUTBYTES) digest_bytes = BLAKE2S_OUTBYTES;
+    if (key_len > BLAKE2S_KEYBYTES) key_len = BLAKE2S_KEYBYTES;
+    if (node_bytes == 0) node_bytes = input_len;
+
+    uint32_t p[8];
+#pragma HLS ARRAY_PARTITION variable=p complete
+    for (int i = 0; i < 8; i++) {
+#pragma HLS PIPELINE II=1
+        p[i] = param[i];
+    }
+
+    // depth 1 is sequential mode: a single node without the last-node flag
+    bool sequential = (p[0] >> 24) <= 1;
+    uint32_t num_nodes = (input_len == 0) ? 1 : (input_len + node_bytes - 1) / node_bytes;
+
+    uint32_t h[BLAKE2S_BATCH_LANES][8];
+#pragma HLS ARRAY_PARTITION variable=h complete dim=2
+
+    uint32_t offset[BLAKE2S_BATCH_LANES];
+    uint32_t length[BLAKE2S_BATCH_LANES];
+    uint32_t key_offset[BLAKE2S_BATCH_LANES];
+    uint32_t key_lens[BLAKE2S_BATCH_LANES];
+    bool last_node[BLAKE2S_BATCH_LANES];
+
+    TREE_GROUP_LOOP: for (uint32_t group = 0; group < num_nodes; group += BLAKE2S_BATCH_LANES) {
+        int lanes = (num_nodes - group > BLAKE2S_BATCH_LANES) ? BLAKE2S_BATCH_LANES : (int)(num_nodes - group);
+
+        TREE_NODE_LOOP: for (int l = 0; l < BLAKE2S_BATCH_LANES; l++) {
+#pragma HLS PIPELINE II=1
+            uint32_t node = group + l;
+            uint32_t start = node * node_bytes;
+            if (l < lanes) {
+                offset[l] = start;
+                length[l] = (input_len - start < node_bytes) ? input_len - start : node_bytes;
+            } else {
+                offset[l] = 0;
+                length[l] = 0;
+            }
+            key_offset[l] = 0;
+            key_lens[l] = key_len;
+            last_node[l] = (node == num_nodes - 1) && !sequential;
+
+            for (int i = 0; i < 8; i++) {
+#pragma HLS UNROLL
+                h[l][i] = blake2s_iv[i] ^ p[i];
+            }
+            h[l][2] ^= node;
+        }
+
+        blake2s_hash_lanes(input, key, h, offset, length, key_offset, key_lens, last_node,
+                           BLAKE2S_BLOCKBYTES, lanes);
+
+        TREE_OUTPUT_LOOP: for (int l = 0; l < BLAKE2S_BATCH_LANES; l++) {
+            if (l < lanes) {
+                for (uint32_t i = 0; i < digest_bytes; i++) {
+#pragma HLS PIPELINE II=1
+                    output[(group + l) * digest_bytes + i] = (h[l][i / 4] >> (8 * (i % 4))) & 0xFF;
+                }
+            }
+        }
+    }
+}
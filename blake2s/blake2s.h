@@ -10,6 +10,17 @@
 #define BLAKE2S_SALTBYTES 8
 #define BLAKE2S_PERSONALBYTES 8
 
+// Batched hashing: messages are hashed BLAKE2S_BATCH_LANES at a time with
+// their compressions interleaved in the pipeline. Each message has a
+// descriptor {byte offset into input, byte length, key index, key length};
+// keys come from a table of BLAKE2S_KEYBYTES entries (key length 0 =
+// unkeyed). Every message gets a full 32-byte digest.
+#define BLAKE2S_BATCH_LANES 8
+#define BLAKE2S_DESC_WORDS 4
+
+// BLAKE2sp: 8 leaves hashed in parallel, then a root over their digests
+#define BLAKE2SP_PARALLELISM 8
+
 // BLAKE2s state structure
 typedef struct {
     uint32_t h[8];      // hash state
@@ -19,9 +30,10 @@ typedef struct {
     uint32_t buflen;    // buffer length
     uint8_t outlen;     // output length
     uint8_t keylen;     // key length
+    uint8_t last_node;  // set f[1] on the final block (tree modes)
 } blake2s_state;
 
-// BLAKE2s parameter block
+// BLAKE2s parameter block (32 bytes, XORed into the IV as 8 LE words)
 typedef struct {
     uint8_t digest_length;                   // 0
     uint8_t key_length;                      // 1
@@ -29,12 +41,11 @@ typedef struct {
     uint8_t depth;                           // 3
     uint32_t leaf_length;                    // 4
     uint32_t node_offset;                    // 8
-    uint32_t xof_length;                     // 12
-    uint8_t node_depth;                      // 16
-    uint8_t inner_length;                    // 17
-    uint8_t reserved[14];                    // 18
-    uint8_t salt[BLAKE2S_SALTBYTES];         // 32
-    uint8_t personal[BLAKE2S_PERSONALBYTES]; // 40
+    uint16_t xof_length;                     // 12 (node_offset bits 32..47 in tree mode)
+    uint8_t node_depth;                      // 14
+    uint8_t inner_length;                    // 15
+    uint8_t salt[BLAKE2S_SALTBYTES];         // 16
+    uint8_t personal[BLAKE2S_PERSONALBYTES]; // 24
 } blake2s_param;
 
 extern "C" {
@@ -46,6 +57,36 @@ extern "C" {
         const uint8_t *key,
         uint32_t key_len
     );
+
+    // The lane kernels below read `input` as 32-bit words: it must be
+    // 4-byte aligned, and its last partial word must be readable
+    void blake2s_hash_batch(
+        const uint32_t *input,
+        const uint8_t *keys,
+        const uint32_t *msg_table,
+        uint8_t *output,
+        int num_messages
+    );
+
+    void blake2sp_hash(
+        const uint32_t *input,
+        uint32_t input_len,
+        uint8_t *output,
+        uint32_t output_len,
+        const uint8_t *key,
+        uint32_t key_len
+    );
+
+    void blake2s_tree_level(
+        const uint32_t *input,
+        uint32_t input_len,
+        uint32_t node_bytes,
+        const uint8_t *key,
+        uint32_t key_len,
+        const uint32_t *param,
+        uint8_t *output,
+        uint32_t digest_bytes
+    );
 }
 
 #endif
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include <iostream>
 #include <cstring>
 #include <iomanip>
+#include <cstdio>
 #include "blake2s.h"
 
 void print_hash(const uint8_t* hash, int len) {
@@ -10,6 +11,44 @@ void print_hash(const uint8_t* hash, int len) {
     std::cout << std::dec << std::endl;
 }
 
+bool matches_hex(const uint8_t* hash, const char* hex, int len) {
+    for (int i = 0; i < len; i++) {
+        unsigned int byte;
+        if (sscanf(hex + 2 * i, "%2x", &byte) != 1 || hash[i] != byte) return false;
+    }
+    return true;
+}
+
+// Drive blake2s_tree_level bottom-up: leaves of leaf_length bytes (keyed),
+// then nodes of `fanout` inner digests until one node remains; the level at
+// depth - 1 takes all remaining digests. fanout 0 means unlimited.
+void tree_hash(const uint8_t* input, uint32_t len, uint8_t* output, uint32_t outlen,
+               const uint8_t* key, uint32_t keylen,
+               uint32_t fanout, uint32_t depth, uint32_t leaf_length, uint32_t inner_length) {
+    alignas(4) static uint8_t levels[2][4096];
+    const uint8_t* in = input;
+    uint32_t in_len = len;
+    uint32_t node_bytes = (depth > 1) ? leaf_length : 0;
+    uint32_t level = 0;
+
+    while (true) {
+        uint32_t nodes = (node_bytes == 0 || in_len == 0) ? 1 : (in_len + node_bytes - 1) / node_bytes;
+        uint32_t digest_bytes = (nodes == 1) ? outlen : inner_length;
+        uint32_t param[8] = {
+            outlen | (keylen << 8) | (fanout << 16) | (depth << 24),
+            leaf_length, 0, (level << 16) | (inner_length << 24), 0, 0, 0, 0
+        };
+        uint8_t* out = (nodes == 1) ? output : levels[level & 1];
+        blake2s_tree_level((const uint32_t*)in, in_len, node_bytes, key, level == 0 ? keylen : 0, param, out, digest_bytes);
+        if (nodes == 1) return;
+
+        in = out;
+        in_len = nodes * inner_length;
+        level++;
+        node_bytes = (fanout == 0 || level == depth - 1) ? 0 : fanout * inner_length;
+    }
+}
+
 int main() {
     // Test case 1: Empty string
     {
@@ -116,6 +155,119 @@ int main() {
         std::cout << "Result: Generated (no reference to compare)" << std::endl << std::endl;
     }
     
+    // Test case 6: Batched hashing against single-message blake2s_hash,
+    // covering block boundaries, keyed and unkeyed messages and more
+    // messages than one lane group
+    bool batch_ok = true;
+    {
+        std::cout << "Test 6: Batched hashing" << std::endl;
+        const uint32_t lengths[] = {0, 1, 63, 64, 65, 128, 129, 3, 500, 0, 64, 200};
+        const uint32_t key_lens[] = {0, 0, 0, 32, 0, 10, 1, 0, 32, 16, 0, 5};
+        const int count = sizeof(lengths) / sizeof(lengths[0]);
+
+        alignas(4) static uint8_t data[2048];
+        uint8_t keys[3 * BLAKE2S_KEYBYTES];
+        for (int i = 0; i < (int)sizeof(data); i++) data[i] = (uint8_t)(i * 31 + 7);
+        for (int i = 0; i < (int)sizeof(keys); i++) keys[i] = (uint8_t)i;
+
+        uint32_t table[count * BLAKE2S_DESC_WORDS];
+        uint32_t offset = 0;
+        for (int i = 0; i < count; i++) {
+            table[i * BLAKE2S_DESC_WORDS + 0] = offset;
+            table[i * BLAKE2S_DESC_WORDS + 1] = lengths[i];
+            table[i * BLAKE2S_DESC_WORDS + 2] = i % 3;
+            table[i * BLAKE2S_DESC_WORDS + 3] = key_lens[i];
+            offset += lengths[i];
+        }
+
+        uint8_t digests[count * BLAKE2S_OUTBYTES];
+        blake2s_hash_batch((const uint32_t*)data, keys, table, digests, count);
+
+        for (int i = 0; i < count; i++) {
+            uint8_t expected[32];
+            blake2s_hash(data + table[i * BLAKE2S_DESC_WORDS], lengths[i], expected, 32,
+                         keys + (i % 3) * BLAKE2S_KEYBYTES, key_lens[i]);
+            if (memcmp(expected, digests + i * BLAKE2S_OUTBYTES, 32) != 0) {
+                std::cout << "Message " << i << " mismatch" << std::endl;
+                batch_ok = false;
+            }
+        }
+
+        // Official keyed KAT: key 00..1f, input 00..3f
+        alignas(4) uint8_t kat_in[64];
+        uint8_t kat_key[32], kat_out[32];
+        for (int i = 0; i < 64; i++) kat_in[i] = (uint8_t)i;
+        for (int i = 0; i < 32; i++) kat_key[i] = (uint8_t)i;
+        uint32_t kat_table[BLAKE2S_DESC_WORDS] = {0, 64, 0, 32};
+        const uint8_t kat_expected[32] = {
+            0x89, 0x75, 0xb0, 0x57, 0x7f, 0xd3, 0x55, 0x66, 0xd7, 0x50, 0xb3, 0x62, 0xb0, 0x89, 0x7a, 0x26,
+            0xc3, 0x99, 0x13, 0x6d, 0xf0, 0x7b, 0xab, 0xab, 0xbd, 0xe6, 0x20, 0x3f, 0xf2, 0x95, 0x4e, 0xd4
+        };
+        blake2s_hash_batch((const uint32_t*)kat_in, kat_key, kat_table, kat_out, 1);
+        batch_ok &= memcmp(kat_out, kat_expected, 32) == 0;
+
+        std::cout << "Result: " << (batch_ok ? "PASS" : "FAIL") << std::endl << std::endl;
+    }
+
+    // Test case 7: BLAKE2sp (8 parallel leaves + root)
+    bool sp_ok = true;
+    {
+        std::cout << "Test 7: BLAKE2sp" << std::endl;
+        alignas(4) static uint8_t data[5000];
+        uint8_t key[32], output[32];
+        for (int i = 0; i < (int)sizeof(data); i++) data[i] = (uint8_t)i;
+        for (int i = 0; i < 32; i++) key[i] = (uint8_t)i;
+
+        // Reference KAT: key 00..1f, empty input
+        blake2sp_hash((const uint32_t*)data, 0, output, 32, key, 32);
+        print_hash(output, 32);
+        sp_ok &= matches_hex(output, "715cb13895aeb678f6124160bff21465b30f4f6874193fc851b4621043f09cc6", 32);
+
+        blake2sp_hash((const uint32_t*)data, 256, output, 32, key, 32);
+        sp_ok &= matches_hex(output, "e5f46751ed888c5fb7436c3088dea8d398066a43e521cb13133438f2c80e60e5", 32);
+
+        // Uneven tail: leaves 0..6 get a partial last block, leaf 7 none
+        blake2sp_hash((const uint32_t*)data, sizeof(data), output, 32, nullptr, 0);
+        sp_ok &= matches_hex(output, "d7ad4ed26ce85b35d95db276deacd48df0e532fdf2683622a4a97999aa97e5c2", 32);
+
+        std::cout << "Result: " << (sp_ok ? "PASS" : "FAIL") << std::endl << std::endl;
+    }
+
+    // Test case 8: Generic tree hashing (fanout / depth / leaf_length)
+    bool tree_ok = true;
+    {
+        std::cout << "Test 8: Tree hashing" << std::endl;
+        alignas(4) static uint8_t data[5000];
+        uint8_t key[32], output[32];
+        for (int i = 0; i < (int)sizeof(data); i++) data[i] = (uint8_t)i;
+        for (int i = 0; i < 32; i++) key[i] = (uint8_t)i;
+
+        // 20 leaves -> 5 nodes -> root (depth limit reached)
+        tree_hash(data, 5000, output, 32, nullptr, 0, 4, 3, 256, 32);
+        print_hash(output, 32);
+        tree_ok &= matches_hex(output, "d38db1117a132917bda798dae1e3e884fdc1bd3800c98ffc4b815b745a146cf1", 32);
+
+        // Binary tree, keyed leaves, 16 levels deep at most
+        tree_hash(data, 1000, output, 32, key, 16, 2, 255, 64, 32);
+        tree_ok &= matches_hex(output, "964f75be28db519ead9e88f60458f942560c2881e79cba2ea4df6d78c9ffab68", 32);
+
+        // Unlimited fanout: one root over all leaves
+        tree_hash(data, 5000, output, 32, nullptr, 0, 0, 2, 1024, 32);
+        tree_ok &= matches_hex(output, "cf6656b8f4b6b949704d93463b192b79c41201cbe0e23336f9bea1fe4f946d90", 32);
+
+        // Input shorter than one leaf: the leaf is the root
+        tree_hash(data, 100, output, 32, nullptr, 0, 4, 3, 256, 32);
+        tree_ok &= matches_hex(output, "45ce1a3f8a8a8fbf455242023247886e21f3f275f1cac71d4d86ad73560aed80", 32);
+
+        // fanout 1 / depth 1 is plain sequential BLAKE2s
+        uint8_t expected[32];
+        blake2s_hash(data, 1000, expected, 32, key, 32);
+        tree_hash(data, 1000, output, 32, key, 32, 1, 1, 0, 0);
+        tree_ok &= memcmp(output, expected, 32) == 0;
+
+        std::cout << "Result: " << (tree_ok ? "PASS" : "FAIL") << std::endl << std::endl;
+    }
+
     std::cout << "All tests completed." << std::endl;
-    return 0;
+    return (batch_ok && sp_ok && tree_ok) ? 0 : 1;
 }
\ No newline at end of file
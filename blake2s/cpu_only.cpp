@@ -0,0 +1,736 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+#include <string>
+#include <algorithm>
+#include <immintrin.h>
+#include "../common/cpu_features.h"
+
+// Kernel C model (blake2s.cpp), linked in so every engine can be checked
+// against the code that C-simulation runs:
+//   g++ -O3 -std=c++17 cpu_only.cpp blake2s.cpp -o cpu_only
+#include "blake2s.h"
+
+// BLAKE2s IV constants
+static const uint32_t blake2s_iv[8] = {
+    0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A,
+    0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19
+};
+
+// BLAKE2s sigma permutation table
+static const uint8_t blake2s_sigma[10][16] = {
+    { 0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15},
+    {14, 10,  4,  8,  9, 15, 13,  6,  1, 12,  0,  2, 11,  7,  5,  3},
+    {11,  8, 12,  0,  5,  2, 15, 13, 10, 14,  3,  6,  7,  1,  9,  4},
+    { 7,  9,  3,  1, 13, 12, 11, 14,  2,  6,  5, 10,  4,  0, 15,  8},
+    { 9,  0,  5,  7,  2,  4, 10, 15, 14,  1, 11, 12,  6,  8,  3, 13},
+    { 2, 12,  6, 10,  0, 11,  8,  3,  4, 13,  7,  5, 15, 14,  1,  9},
+    {12,  5,  1, 15, 14, 13,  4, 10,  0,  7,  6,  3,  9,  2,  8, 11},
+    {13, 11,  7, 14, 12,  1,  3,  9,  5,  0, 15,  4,  8,  6,  2, 10},
+    { 6, 15, 14,  9, 11,  3,  0,  8, 12,  2, 13,  7,  1,  4, 10,  5},
+    {10,  2,  8,  4,  7,  6,  1,  5, 15, 11,  9, 14,  3, 12, 13,  0}
+};
+
+// Message schedule regrouped for the row-vectorized engines: per round,
+// the x and y inputs of the four column G's, then of the four diagonal G's
+struct Blake2sSchedule {
+    int32_t idx[10][4][4];
+
+    Blake2sSchedule() {
+        for (int r = 0; r < 10; r++) {
+            for (int i = 0; i < 4; i++) {
+                idx[r][0][i] = blake2s_sigma[r][2 * i];
+                idx[r][1][i] = blake2s_sigma[r][2 * i + 1];
+                idx[r][2][i] = blake2s_sigma[r][8 + 2 * i];
+                idx[r][3][i] = blake2s_sigma[r][8 + 2 * i + 1];
+            }
+        }
+    }
+};
+static const Blake2sSchedule blake2s_schedule;
+
+static inline uint32_t load_le32(const uint8_t* p) {
+    return ((uint32_t)p[0]) | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline void store_le32(uint8_t* p, uint32_t v) {
+    p[0] = v & 0xff;
+    p[1] = (v >> 8) & 0xff;
+    p[2] = (v >> 16) & 0xff;
+    p[3] = (v >> 24) & 0xff;
+}
+
+// One G with vector operands. With rows (a = v0..3, b = v4..7, ...) it
+// runs the four column or diagonal G's of a round at once; with transposed
+// lanes (one register per state word) it runs the same G for N messages.
+#define BLAKE2S_G_VEC(ADD, XOR, ROTR, a, b, c, d, x, y) \
+    a = ADD(ADD(a, b), x); d = ROTR(XOR(d, a), 16); \
+    c = ADD(c, d);         b = ROTR(XOR(b, c), 12); \
+    a = ADD(ADD(a, b), y); d = ROTR(XOR(d, a), 8);  \
+    c = ADD(c, d);         b = ROTR(XOR(b, c), 7);
+
+// Rotations by 16 and 8 are byte shuffles
+#define ROTR_X4(v, n) \
+    ((n) == 16 ? _mm_shuffle_epi8(v, _mm_setr_epi8(2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13)) : \
+     (n) == 8  ? _mm_shuffle_epi8(v, _mm_setr_epi8(1, 2, 3, 0, 5, 6, 7, 4, 9, 10, 11, 8, 13, 14, 15, 12)) : \
+     _mm_or_si128(_mm_srli_epi32(v, n), _mm_slli_epi32(v, 32 - (n))))
+
+#define ROTR_X8(v, n) \
+    ((n) == 16 ? _mm256_shuffle_epi8(v, _mm256_setr_epi8(2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13, \
+                                                         2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13)) : \
+     (n) == 8  ? _mm256_shuffle_epi8(v, _mm256_setr_epi8(1, 2, 3, 0, 5, 6, 7, 4, 9, 10, 11, 8, 13, 14, 15, 12, \
+                                                         1, 2, 3, 0, 5, 6, 7, 4, 9, 10, 11, 8, 13, 14, 15, 12)) : \
+     _mm256_or_si256(_mm256_srli_epi32(v, n), _mm256_slli_epi32(v, 32 - (n))))
+
+// Column step, then rotate rows 2-4 so the diagonals line up as columns,
+// diagonal step, and rotate back
+#define BLAKE2S_ROUND_ROWS(row1, row2, row3, row4, mx0, my0, mx1, my1) \
+    BLAKE2S_G_VEC(_mm_add_epi32, _mm_xor_si128, ROTR_X4, row1, row2, row3, row4, mx0, my0) \
+    row2 = _mm_shuffle_epi32(row2, _MM_SHUFFLE(0, 3, 2, 1)); \
+    row3 = _mm_shuffle_epi32(row3, _MM_SHUFFLE(1, 0, 3, 2)); \
+    row4 = _mm_shuffle_epi32(row4, _MM_SHUFFLE(2, 1, 0, 3)); \
+    BLAKE2S_G_VEC(_mm_add_epi32, _mm_xor_si128, ROTR_X4, row1, row2, row3, row4, mx1, my1) \
+    row2 = _mm_shuffle_epi32(row2, _MM_SHUFFLE(2, 1, 0, 3)); \
+    row3 = _mm_shuffle_epi32(row3, _MM_SHUFFLE(1, 0, 3, 2)); \
+    row4 = _mm_shuffle_epi32(row4, _MM_SHUFFLE(0, 3, 2, 1));
+
+// Scalar reference compression. tf = {t0, t1, f0, f1}.
+static void blake2s_compress_scalar(uint32_t h[8], const uint8_t block[BLAKE2S_BLOCKBYTES], const uint32_t tf[4]) {
+    uint32_t m[16], v[16];
+    for (int i = 0; i < 16; i++) {
+        m[i] = load_le32(block + i * 4);
+    }
+    for (int i = 0; i < 8; i++) {
+        v[i] = h[i];
+        v[i + 8] = blake2s_iv[i];
+    }
+    for (int i = 0; i < 4; i++) {
+        v[12 + i] ^= tf[i];
+    }
+
+    auto rotr32 = [](uint32_t x, int n) { return (x >> n) | (x << (32 - n)); };
+    auto g = [&](int a, int b, int c, int d, uint32_t x, uint32_t y) {
+        v[a] = v[a] + v[b] + x; v[d] = rotr32(v[d] ^ v[a], 16);
+        v[c] = v[c] + v[d];     v[b] = rotr32(v[b] ^ v[c], 12);
+        v[a] = v[a] + v[b] + y; v[d] = rotr32(v[d] ^ v[a], 8);
+        v[c] = v[c] + v[d];     v[b] = rotr32(v[b] ^ v[c], 7);
+    };
+
+    for (int r = 0; r < 10; r++) {
+        const uint8_t* s = blake2s_sigma[r];
+        g(0, 4,  8, 12, m[s[0]],  m[s[1]]);
+        g(1, 5,  9, 13, m[s[2]],  m[s[3]]);
+        g(2, 6, 10, 14, m[s[4]],  m[s[5]]);
+        g(3, 7, 11, 15, m[s[6]],  m[s[7]]);
+        g(0, 5, 10, 15, m[s[8]],  m[s[9]]);
+        g(1, 6, 11, 12, m[s[10]], m[s[11]]);
+        g(2, 7,  8, 13, m[s[12]], m[s[13]]);
+        g(3, 4,  9, 14, m[s[14]], m[s[15]]);
+    }
+
+    for (int i = 0; i < 8; i++) {
+        h[i] ^= v[i] ^ v[i + 8];
+    }
+}
+
+// SSE4.1: the state is four rows, so each G_VEC is the four column (or
+// diagonal) G's of a round. The permuted message words are assembled with
+// pinsrd from the regrouped schedule.
+__attribute__((target("sse4.1")))
+static void blake2s_compress_sse41(uint32_t h[8], const uint8_t block[BLAKE2S_BLOCKBYTES], const uint32_t tf[4]) {
+    uint32_t m[16];
+    memcpy(m, block, sizeof(m));  // x86 is little-endian
+
+    __m128i row1 = _mm_loadu_si128((const __m128i*)h);
+    __m128i row2 = _mm_loadu_si128((const __m128i*)(h + 4));
+    __m128i row3 = _mm_loadu_si128((const __m128i*)blake2s_iv);
+    __m128i row4 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(blake2s_iv + 4)),
+                                 _mm_loadu_si128((const __m128i*)tf));
+    const __m128i h0 = row1, h1 = row2;
+
+    for (int r = 0; r < 10; r++) {
+        const int32_t (*s)[4] = blake2s_schedule.idx[r];
+        __m128i mx0 = _mm_setr_epi32((int)m[s[0][0]], (int)m[s[0][1]], (int)m[s[0][2]], (int)m[s[0][3]]);
+        __m128i my0 = _mm_setr_epi32((int)m[s[1][0]], (int)m[s[1][1]], (int)m[s[1][2]], (int)m[s[1][3]]);
+        __m128i mx1 = _mm_setr_epi32((int)m[s[2][0]], (int)m[s[2][1]], (int)m[s[2][2]], (int)m[s[2][3]]);
+        __m128i my1 = _mm_setr_epi32((int)m[s[3][0]], (int)m[s[3][1]], (int)m[s[3][2]], (int)m[s[3][3]]);
+        BLAKE2S_ROUND_ROWS(row1, row2, row3, row4, mx0, my0, mx1, my1)
+    }
+
+    _mm_storeu_si128((__m128i*)h, _mm_xor_si128(h0, _mm_xor_si128(row1, row3)));
+    _mm_storeu_si128((__m128i*)(h + 4), _mm_xor_si128(h1, _mm_xor_si128(row2, row4)));
+}
+
+// 8x8 transpose of 32-bit words: r[k] = 8 words of message k in, r[j] =
+// word j of messages 0..7 out (and back, it is its own inverse)
+__attribute__((target("avx2")))
+static inline void transpose8x8(__m256i r[8]) {
+    __m256i t[8], u[8];
+    for (int i = 0; i < 4; i++) {
+        t[2 * i] = _mm256_unpacklo_epi32(r[2 * i], r[2 * i + 1]);
+        t[2 * i + 1] = _mm256_unpackhi_epi32(r[2 * i], r[2 * i + 1]);
+    }
+    for (int i = 0; i < 2; i++) {
+        u[4 * i + 0] = _mm256_unpacklo_epi64(t[4 * i], t[4 * i + 2]);
+        u[4 * i + 1] = _mm256_unpackhi_epi64(t[4 * i], t[4 * i + 2]);
+        u[4 * i + 2] = _mm256_unpacklo_epi64(t[4 * i + 1], t[4 * i + 3]);
+        u[4 * i + 3] = _mm256_unpackhi_epi64(t[4 * i + 1], t[4 * i + 3]);
+    }
+    for (int j = 0; j < 4; j++) {
+        r[j] = _mm256_permute2x128_si256(u[j], u[4 + j], 0x20);
+        r[4 + j] = _mm256_permute2x128_si256(u[j], u[4 + j], 0x31);
+    }
+}
+
+// AVX2 8-message compression: register i holds state word i of eight
+// independent messages, so every G is a plain lane-wise op and the sigma
+// permutation is just a choice of register
+__attribute__((target("avx2")))
+static void blake2s_compress_x8(__m256i h[8], const __m256i m[16], __m256i t0, __m256i f0) {
+    __m256i v[16];
+    for (int i = 0; i < 8; i++) {
+        v[i] = h[i];
+        v[i + 8] = _mm256_set1_epi32((int)blake2s_iv[i]);
+    }
+    v[12] = _mm256_xor_si256(v[12], t0);
+    v[14] = _mm256_xor_si256(v[14], f0);
+
+    for (int r = 0; r < 10; r++) {
+        const uint8_t* s = blake2s_sigma[r];
+        BLAKE2S_G_VEC(_mm256_add_epi32, _mm256_xor_si256, ROTR_X8, v[0], v[4], v[8],  v[12], m[s[0]],  m[s[1]])
+        BLAKE2S_G_VEC(_mm256_add_epi32, _mm256_xor_si256, ROTR_X8, v[1], v[5], v[9],  v[13], m[s[2]],  m[s[3]])
+        BLAKE2S_G_VEC(_mm256_add_epi32, _mm256_xor_si256, ROTR_X8, v[2], v[6], v[10], v[14], m[s[4]],  m[s[5]])
+        BLAKE2S_G_VEC(_mm256_add_epi32, _mm256_xor_si256, ROTR_X8, v[3], v[7], v[11], v[15], m[s[6]],  m[s[7]])
+        BLAKE2S_G_VEC(_mm256_add_epi32, _mm256_xor_si256, ROTR_X8, v[0], v[5], v[10], v[15], m[s[8]],  m[s[9]])
+        BLAKE2S_G_VEC(_mm256_add_epi32, _mm256_xor_si256, ROTR_X8, v[1], v[6], v[11], v[12], m[s[10]], m[s[11]])
+        BLAKE2S_G_VEC(_mm256_add_epi32, _mm256_xor_si256, ROTR_X8, v[2], v[7], v[8],  v[13], m[s[12]], m[s[13]])
+        BLAKE2S_G_VEC(_mm256_add_epi32, _mm256_xor_si256, ROTR_X8, v[3], v[4], v[9],  v[14], m[s[14]], m[s[15]])
+    }
+
+    for (int i = 0; i < 8; i++) {
+        h[i] = _mm256_xor_si256(h[i], _mm256_xor_si256(v[i], v[i + 8]));
+    }
+}
+
+class Blake2sCPU {
+public:
+    enum Engine {
+        ENGINE_SCALAR = 0,
+        ENGINE_SSE41,
+        ENGINE_AVX2
+    };
+
+    // One message of a batch
+    struct Message {
+        const uint8_t* input;
+        size_t length;
+        const uint8_t* key;
+        size_t key_len;
+        uint8_t* output;      // BLAKE2S_OUTBYTES bytes
+    };
+
+private:
+    typedef void (*CompressFn)(uint32_t h[8], const uint8_t block[BLAKE2S_BLOCKBYTES], const uint32_t tf[4]);
+
+    Engine engine;
+    CompressFn compress;
+    bool verbose;
+
+    static void finish(const uint32_t h[8], uint8_t* output, size_t output_len) {
+        for (size_t i = 0; i < output_len; i++) {
+            output[i] = (h[i / 4] >> (8 * (i % 4))) & 0xFF;
+        }
+    }
+
+    // Up to 8 messages through the transposed AVX2 compression. Lanes that
+    // have finished keep their chaining value (masked merge) while the
+    // longer messages in the group continue.
+    __attribute__((target("avx2")))
+    static void hashGroupX8(const Message* msgs, int count) {
+        alignas(32) uint32_t t0[8], f0[8], active[8], h0[8];
+        uint8_t pad[8][BLAKE2S_BLOCKBYTES];
+        const uint8_t* blocks[8];
+        size_t total[8], nblocks[8];
+        size_t max_blocks = 0;
+
+        for (int k = 0; k < 8; k++) {
+            if (k < count) {
+                total[k] = msgs[k].length + (msgs[k].key_len > 0 ? BLAKE2S_BLOCKBYTES : 0);
+                nblocks[k] = total[k] == 0 ? 1 : (total[k] + BLAKE2S_BLOCKBYTES - 1) / BLAKE2S_BLOCKBYTES;
+                h0[k] = blake2s_iv[0] ^ 0x01010000 ^ ((uint32_t)msgs[k].key_len << 8) ^ BLAKE2S_OUTBYTES;
+            } else {
+                total[k] = 0;
+                nblocks[k] = 0;
+                h0[k] = blake2s_iv[0];
+            }
+            max_blocks = std::max(max_blocks, nblocks[k]);
+        }
+
+        __m256i h[8];
+        h[0] = _mm256_load_si256((const __m256i*)h0);
+        for (int i = 1; i < 8; i++) {
+            h[i] = _mm256_set1_epi32((int)blake2s_iv[i]);
+        }
+
+        for (size_t blk = 0; blk < max_blocks; blk++) {
+            for (int k = 0; k < 8; k++) {
+                active[k] = 0;
+                t0[k] = 0;
+                f0[k] = 0;
+                blocks[k] = pad[k];
+                if (blk >= nblocks[k]) {
+                    memset(pad[k], 0, BLAKE2S_BLOCKBYTES);
+                    continue;
+                }
+
+                const Message& msg = msgs[k];
+                bool keyed = msg.key_len > 0;
+                if (keyed && blk == 0) {
+                    memset(pad[k], 0, BLAKE2S_BLOCKBYTES);
+                    memcpy(pad[k], msg.key, msg.key_len);
+                } else {
+                    size_t off = (blk - (keyed ? 1 : 0)) * BLAKE2S_BLOCKBYTES;
+                    size_t n = std::min<size_t>(BLAKE2S_BLOCKBYTES, msg.length - off);
+                    if (n == BLAKE2S_BLOCKBYTES) {
+                        blocks[k] = msg.input + off;
+                    } else {
+                        memset(pad[k], 0, BLAKE2S_BLOCKBYTES);
+                        memcpy(pad[k], msg.input + off, n);
+                    }
+                }
+                active[k] = 0xFFFFFFFF;
+                t0[k] = (uint32_t)std::min<size_t>((blk + 1) * BLAKE2S_BLOCKBYTES, total[k]);
+                f0[k] = (blk + 1 == nblocks[k]) ? 0xFFFFFFFF : 0;
+            }
+
+            __m256i m[16];
+            for (int half = 0; half < 2; half++) {
+                for (int k = 0; k < 8; k++) {
+                    m[8 * half + k] = _mm256_loadu_si256((const __m256i*)(blocks[k] + 32 * half));
+                }
+                transpose8x8(&m[8 * half]);
+            }
+
+            __m256i prev[8];
+            for (int i = 0; i < 8; i++) prev[i] = h[i];
+            blake2s_compress_x8(h, m, _mm256_load_si256((const __m256i*)t0), _mm256_load_si256((const __m256i*)f0));
+            __m256i mask = _mm256_load_si256((const __m256i*)active);
+            for (int i = 0; i < 8; i++) {
+                h[i] = _mm256_blendv_epi8(prev[i], h[i], mask);
+            }
+        }
+
+        transpose8x8(h);
+        for (int k = 0; k < count; k++) {
+            alignas(32) uint32_t words[8];
+            _mm256_store_si256((__m256i*)words, h[k]);
+            finish(words, msgs[k].output, BLAKE2S_OUTBYTES);
+        }
+    }
+
+public:
+    static Engine bestEngine() {
+        if (cpu_has_avx2()) return ENGINE_AVX2;
+        if (cpu_has_sse41()) return ENGINE_SSE41;
+        return ENGINE_SCALAR;
+    }
+
+    static bool engineSupported(Engine e) {
+        switch (e) {
+            case ENGINE_AVX2: return cpu_has_avx2();
+            case ENGINE_SSE41: return cpu_has_sse41();
+            default: return true;
+        }
+    }
+
+    static const char* engineName(Engine e) {
+        switch (e) {
+            case ENGINE_AVX2: return "AVX2";
+            case ENGINE_SSE41: return "SSE4.1";
+            default: return "Scalar";
+        }
+    }
+
+    // Engine that hashes single messages. AVX2 only speeds up batches: a
+    // BLAKE2s row is 128 bits wide, and gathering the message schedule
+    // with vpgatherdd was slower than SSE4.1's pinsrd from 256 bytes up.
+    static Engine singleMessageEngine(Engine e) {
+        return e >= ENGINE_AVX2 ? ENGINE_SSE41 : e;
+    }
+
+    // Unsupported engines fall back to the best available one
+    Blake2sCPU(Engine requested = bestEngine(), bool log = true) : verbose(log) {
+        engine = engineSupported(requested) ? requested : bestEngine();
+        switch (singleMessageEngine(engine)) {
+            case ENGINE_SSE41: compress = blake2s_compress_sse41; break;
+            default: compress = blake2s_compress_scalar; break;
+        }
+        if (verbose) {
+            std::cout << "✓ BLAKE2s CPU implementation initialized (" << engineName(engine) << ")" << std::endl;
+        }
+    }
+
+    Engine getEngine() const { return engine; }
+
+    void hash(const uint8_t* input, size_t input_len, uint8_t* output, size_t output_len = BLAKE2S_OUTBYTES,
+              const uint8_t* key = nullptr, size_t key_len = 0) const {
+        uint32_t h[8];
+        for (int i = 0; i < 8; i++) h[i] = blake2s_iv[i];
+        h[0] ^= 0x01010000 ^ ((uint32_t)key_len << 8) ^ (uint32_t)output_len;
+
+        uint8_t block[BLAKE2S_BLOCKBYTES];
+        uint64_t t = 0;
+        uint32_t tf[4] = {0, 0, 0, 0};
+
+        // A key is hashed as a zero-padded first block
+        if (key_len > 0) {
+            memset(block, 0, sizeof(block));
+            memcpy(block, key, key_len);
+            t = BLAKE2S_BLOCKBYTES;
+            tf[0] = (uint32_t)t;
+            tf[2] = input_len == 0 ? 0xFFFFFFFF : 0;
+            compress(h, block, tf);
+            if (input_len == 0) {
+                finish(h, output, output_len);
+                return;
+            }
+        }
+
+        // Keep the final (possibly full) block for the last compression
+        while (input_len > BLAKE2S_BLOCKBYTES) {
+            t += BLAKE2S_BLOCKBYTES;
+            tf[0] = (uint32_t)t;
+            tf[1] = (uint32_t)(t >> 32);
+            compress(h, input, tf);
+            input += BLAKE2S_BLOCKBYTES;
+            input_len -= BLAKE2S_BLOCKBYTES;
+        }
+        memset(block, 0, sizeof(block));
+        memcpy(block, input, input_len);
+        t += input_len;
+        tf[0] = (uint32_t)t;
+        tf[1] = (uint32_t)(t >> 32);
+        tf[2] = 0xFFFFFFFF;
+        compress(h, block, tf);
+        finish(h, output, output_len);
+    }
+
+    // Many independent 32-byte digests. With AVX2 the messages go through
+    // the 8-message engine in groups of eight (each message < 4 GB); sort
+    // by length beforehand so the lanes of a group finish together.
+    void hashBatch(const std::vector<Message>& msgs) const {
+        size_t i = 0;
+        if (engine >= ENGINE_AVX2) {
+            for (; i < msgs.size(); i += 8) {
+                hashGroupX8(&msgs[i], (int)std::min<size_t>(8, msgs.size() - i));
+            }
+            return;
+        }
+        for (; i < msgs.size(); i++) {
+            hash(msgs[i].input, msgs[i].length, msgs[i].output, BLAKE2S_OUTBYTES, msgs[i].key, msgs[i].key_len);
+        }
+    }
+
+    ~Blake2sCPU() {
+        if (verbose) std::cout << "✓ BLAKE2s CPU cleanup completed" << std::endl;
+    }
+};
+
+void printHash(const std::string& label, const uint8_t* hash, size_t len = BLAKE2S_OUTBYTES) {
+    std::cout << label << ": ";
+    for (size_t i = 0; i < len; i++) {
+        std::cout << std::hex << std::setw(2) << std::setfill('0') << (int)hash[i];
+    }
+    std::cout << std::dec << std::setfill(' ') << std::endl;
+}
+
+bool parseHex(const char* hex, uint8_t* out, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        unsigned int byte;
+        if (sscanf(hex + 2 * i, "%2x", &byte) != 1) return false;
+        out[i] = (uint8_t)byte;
+    }
+    return true;
+}
+
+static const Blake2sCPU::Engine all_engines[] = {
+    Blake2sCPU::ENGINE_SCALAR, Blake2sCPU::ENGINE_SSE41, Blake2sCPU::ENGINE_AVX2
+};
+
+bool runTestVectors() {
+    std::cout << "\n=== BLAKE2s Test Vectors ===" << std::endl;
+
+    struct Vector {
+        const char* name;
+        std::vector<uint8_t> message;
+        std::vector<uint8_t> key;
+        size_t out_len;
+        const char* expected;
+    };
+
+    std::vector<uint8_t> seq64(64), seq32(32);
+    for (int i = 0; i < 64; i++) seq64[i] = (uint8_t)i;
+    for (int i = 0; i < 32; i++) seq32[i] = (uint8_t)i;
+    const char* fox = "The quick brown fox jumps over the lazy dog";
+    const char* abc = "abc";
+
+    const Vector vectors[] = {
+        {"Empty string", {}, {}, 32,
+         "69217a3079908094e11121d042354a7c1f55b6482ca1a51e1b250dfd1ed0eef9"},
+        {"\"abc\"", std::vector<uint8_t>(abc, abc + 3), {}, 32,
+         "508c5e8c327c14e2e1a72ba34eeb452f37458b209ed63a294d999b4c86675982"},
+        {"\"The quick brown fox jumps over the lazy dog\"", std::vector<uint8_t>(fox, fox + strlen(fox)), {}, 32,
+         "606beeec743ccbeff6cbcdf5d5302aa855c256c29b88c8ed331ea1a6bf3c8812"},
+        {"Keyed, key 00..1f, message 00..3f", seq64, seq32, 32,
+         "8975b0577fd35566d750b362b0897a26c399136df07bababbde6203ff2954ed4"},
+        {"16-byte digest of \"abc\"", std::vector<uint8_t>(abc, abc + 3), {}, 16,
+         "aa4938119b1dc7b87cbad0ffd200d0ae"}
+    };
+
+    bool all_passed = true;
+    int test_num = 1;
+    for (const auto& vec : vectors) {
+        std::cout << "\nTest " << test_num++ << ": " << vec.name << std::endl;
+        uint8_t expected[BLAKE2S_OUTBYTES];
+        parseHex(vec.expected, expected, vec.out_len);
+
+        for (auto e : all_engines) {
+            if (!Blake2sCPU::engineSupported(e)) continue;
+            Blake2sCPU b2(e, false);
+            uint8_t hash[BLAKE2S_OUTBYTES];
+            b2.hash(vec.message.data(), vec.message.size(), hash, vec.out_len, vec.key.data(), vec.key.size());
+            bool passed = memcmp(hash, expected, vec.out_len) == 0;
+            std::cout << std::left << std::setw(16) << Blake2sCPU::engineName(e) << std::right
+                      << (passed ? "✓ PASSED" : "✗ FAILED") << std::endl;
+            all_passed &= passed;
+        }
+        std::cout << "Expected: " << vec.expected << std::endl;
+    }
+
+    // Every engine against the kernel C model, across block boundaries
+    std::cout << "\nTest " << test_num++ << ": Engines vs kernel C model (blake2s_hash)" << std::endl;
+    {
+        std::vector<uint8_t> data(1000), key(32);
+        for (auto& b : data) b = rand() & 0xFF;
+        for (auto& b : key) b = rand() & 0xFF;
+
+        for (auto e : all_engines) {
+            if (!Blake2sCPU::engineSupported(e)) continue;
+            Blake2sCPU b2(e, false);
+            int mismatches = 0;
+            for (size_t len = 0; len <= data.size(); len += (len < 200 ? 1 : 97)) {
+                for (size_t key_len : {(size_t)0, (size_t)1, (size_t)32}) {
+                    uint8_t hash[BLAKE2S_OUTBYTES], csim[BLAKE2S_OUTBYTES];
+                    b2.hash(data.data(), len, hash, BLAKE2S_OUTBYTES, key.data(), key_len);
+                    blake2s_hash(data.data(), (uint32_t)len, csim, BLAKE2S_OUTBYTES, key.data(), (uint32_t)key_len);
+                    mismatches += memcmp(hash, csim, BLAKE2S_OUTBYTES) != 0;
+                }
+            }
+            std::cout << std::left << std::setw(16) << Blake2sCPU::engineName(e) << std::right
+                      << (mismatches == 0 ? "✓ PASSED" : "✗ FAILED") << std::endl;
+            all_passed &= mismatches == 0;
+        }
+    }
+
+    // 8-message batch against the kernel's batched C model, with mixed
+    // lengths and keys so lanes finish at different blocks
+    std::cout << "\nTest " << test_num++ << ": Batch vs kernel C model (blake2s_hash_batch)" << std::endl;
+    {
+        const uint32_t lengths[] = {0, 1, 63, 64, 65, 1000, 4096, 3, 127, 128, 0, 64, 500, 77, 2, 300, 256};
+        const uint32_t key_lens[] = {0, 32, 0, 16, 1, 32, 0, 7, 0, 32, 32, 0, 5, 0, 32, 0, 9};
+        const int count = sizeof(lengths) / sizeof(lengths[0]);
+
+        std::vector<uint8_t> data(8192), keys(4 * BLAKE2S_KEYBYTES);
+        for (auto& b : data) b = rand() & 0xFF;
+        for (auto& b : keys) b = rand() & 0xFF;
+
+        std::vector<uint32_t> table(count * BLAKE2S_DESC_WORDS);
+        std::vector<Blake2sCPU::Message> msgs(count);
+        std::vector<uint8_t> digests(count * BLAKE2S_OUTBYTES), csim(count * BLAKE2S_OUTBYTES);
+        uint32_t offset = 0;
+        for (int i = 0; i < count; i++) {
+            table[i * BLAKE2S_DESC_WORDS + 0] = offset;
+            table[i * BLAKE2S_DESC_WORDS + 1] = lengths[i];
+            table[i * BLAKE2S_DESC_WORDS + 2] = i % 4;
+            table[i * BLAKE2S_DESC_WORDS + 3] = key_lens[i];
+            msgs[i] = {data.data() + offset, lengths[i], &keys[(i % 4) * BLAKE2S_KEYBYTES], key_lens[i],
+                       &digests[i * BLAKE2S_OUTBYTES]};
+            offset += lengths[i];
+        }
+        blake2s_hash_batch((const uint32_t*)data.data(), keys.data(), table.data(), csim.data(), count);
+
+        for (auto e : all_engines) {
+            if (!Blake2sCPU::engineSupported(e)) continue;
+            Blake2sCPU b2(e, false);
+            std::fill(digests.begin(), digests.end(), 0);
+            b2.hashBatch(msgs);
+            bool passed = digests == csim;
+            std::cout << std::left << std::setw(16) << Blake2sCPU::engineName(e) << std::right
+                      << (e >= Blake2sCPU::ENGINE_AVX2 ? "(x8) " : "") << (passed ? "✓ PASSED" : "✗ FAILED") << std::endl;
+            all_passed &= passed;
+        }
+    }
+
+    return all_passed;
+}
+
+// Single-message throughput per engine next to the kernel C model
+void runPerformanceTest() {
+    std::cout << "\n=== Single-Message Performance (MB/s) ===" << std::endl;
+
+    const size_t test_sizes[] = {64, 256, 1024, 4096, 16384, 65536, 1024 * 1024};
+    const size_t total_bytes = 32 * 1024 * 1024;
+
+    std::vector<uint8_t> message(test_sizes[6]);
+    for (auto& b : message) b = rand() & 0xFF;
+
+    std::cout << std::setw(10) << "Size";
+    for (auto e : all_engines) {
+        if (Blake2sCPU::engineSupported(e) && Blake2sCPU::singleMessageEngine(e) == e) {
+            std::cout << std::setw(16) << Blake2sCPU::engineName(e);
+        }
+    }
+    std::cout << std::setw(16) << "Kernel C-sim" << std::endl;
+
+    for (size_t size : test_sizes) {
+        size_t iterations = std::max<size_t>(1, total_bytes / size);
+        uint8_t hash[BLAKE2S_OUTBYTES];
+        double mb = (double)(iterations * size) / (1024.0 * 1024.0);
+
+        std::cout << std::setw(10) << size << std::fixed << std::setprecision(2);
+        for (auto e : all_engines) {
+            if (!Blake2sCPU::engineSupported(e) || Blake2sCPU::singleMessageEngine(e) != e) continue;
+            Blake2sCPU b2(e, false);
+            auto start = std::chrono::high_resolution_clock::now();
+            for (size_t i = 0; i < iterations; i++) {
+                b2.hash(message.data(), size, hash);
+            }
+            auto end = std::chrono::high_resolution_clock::now();
+            std::cout << std::setw(16) << mb / std::chrono::duration<double>(end - start).count();
+        }
+
+        // The C model is slower, so time a quarter of the data
+        size_t csim_iterations = std::max<size_t>(1, iterations / 4);
+        auto start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < csim_iterations; i++) {
+            blake2s_hash(message.data(), (uint32_t)size, hash, BLAKE2S_OUTBYTES, nullptr, 0);
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        double csim_mb = (double)(csim_iterations * size) / (1024.0 * 1024.0);
+        std::cout << std::setw(16) << csim_mb / std::chrono::duration<double>(end - start).count() << std::endl;
+    }
+}
+
+// Many-message throughput: one message at a time vs the 8-message AVX2
+// engine vs the kernel's batched C model
+void runBatchPerformanceTest() {
+    std::cout << "\n=== Batched Hashing Performance (hashes/s) ===" << std::endl;
+
+    const size_t test_sizes[] = {64, 256, 1024, 4096, 16384, 65536};
+    const size_t batch_bytes = 16 * 1024 * 1024;
+
+    std::vector<uint8_t> data(batch_bytes);
+    for (auto& b : data) b = rand() & 0xFF;
+
+    Blake2sCPU best(Blake2sCPU::bestEngine(), false);
+    bool has_x8 = best.getEngine() >= Blake2sCPU::ENGINE_AVX2;
+
+    std::cout << std::setw(10) << "Size" << std::setw(10) << "Count" << std::setw(16) << "Scalar"
+              << std::setw(16) << Blake2sCPU::engineName(Blake2sCPU::singleMessageEngine(best.getEngine()))
+              << std::setw(16) << (has_x8 ? "AVX2 x8" : "-") << std::setw(16) << "Kernel C-sim" << std::endl;
+
+    for (size_t size : test_sizes) {
+        size_t count = batch_bytes / size;
+        std::vector<uint8_t> digests(count * BLAKE2S_OUTBYTES);
+        std::vector<Blake2sCPU::Message> msgs(count);
+        for (size_t i = 0; i < count; i++) {
+            msgs[i] = {data.data() + i * size, size, nullptr, 0, &digests[i * BLAKE2S_OUTBYTES]};
+        }
+
+        auto time_sec = [](auto fn) {
+            auto start = std::chrono::high_resolution_clock::now();
+            fn();
+            auto end = std::chrono::high_resolution_clock::now();
+            return std::chrono::duration<double>(end - start).count();
+        };
+
+        Blake2sCPU scalar(Blake2sCPU::ENGINE_SCALAR, false);
+        double scalar_sec = time_sec([&] { scalar.hashBatch(msgs); });
+        double single_sec = time_sec([&] {
+            for (const auto& msg : msgs) best.hash(msg.input, msg.length, msg.output);
+        });
+        double x8_sec = has_x8 ? time_sec([&] { best.hashBatch(msgs); }) : 0;
+        std::vector<uint8_t> x8_digests = digests;
+
+        // Kernel C model over the same messages, also used as the reference
+        std::vector<uint32_t> table(count * BLAKE2S_DESC_WORDS);
+        for (size_t i = 0; i < count; i++) {
+            table[i * BLAKE2S_DESC_WORDS + 0] = (uint32_t)(i * size);
+            table[i * BLAKE2S_DESC_WORDS + 1] = (uint32_t)size;
+            table[i * BLAKE2S_DESC_WORDS + 2] = 0;
+            table[i * BLAKE2S_DESC_WORDS + 3] = 0;
+        }
+        std::vector<uint8_t> csim(count * BLAKE2S_OUTBYTES);
+        uint8_t no_key[BLAKE2S_KEYBYTES] = {0};
+        double csim_sec = time_sec([&] {
+            blake2s_hash_batch((const uint32_t*)data.data(), no_key, table.data(), csim.data(), (int)count);
+        });
+
+        std::cout << std::setw(10) << size << std::setw(10) << count << std::fixed << std::setprecision(0)
+                  << std::setw(16) << count / scalar_sec << std::setw(16) << count / single_sec;
+        if (has_x8) {
+            std::cout << std::setw(16) << count / x8_sec;
+        } else {
+            std::cout << std::setw(16) << "-";
+        }
+        std::cout << std::setw(16) << count / csim_sec;
+        if (x8_digests != csim) {
+            std::cout << "  ✗ MISMATCH";
+        }
+        std::cout << std::endl;
+    }
+}
+
+void runBenchmarkComparison() {
+    std::cout << "\n=== Benchmark Summary ===" << std::endl;
+    std::cout << "CPU Implementation: BLAKE2s (RFC 7693), keyed and unkeyed" << std::endl;
+    std::cout << "Algorithm: 10 rounds of 8 G functions, 64-byte blocks, 256-bit chaining value" << std::endl;
+    std::cout << "Engines: scalar, SSE4.1 row-vectorized G for single messages," << std::endl;
+    std::cout << "         AVX2 x8 message-parallel for batches" << std::endl;
+    std::cout << "Reference: kernel C model (blake2s_hash / blake2s_hash_batch) linked from blake2s.cpp" << std::endl;
+    std::cout << "\nFor comparison with FPGA accelerator:" << std::endl;
+    std::cout << "- Run both programs with identical test parameters" << std::endl;
+    std::cout << "- Compare MB/s for single messages and hashes/s for batches" << std::endl;
+    std::cout << "- The batched kernel interleaves 8 messages like the AVX2 x8 engine" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    (void)argc;
+    (void)argv;
+    try {
+        std::cout << "=== BLAKE2s CPU Benchmark Application ===" << std::endl;
+        std::cout << "Platform: CPU-only implementation" << std::endl;
+        std::cout << "Purpose: Benchmarking comparison with FPGA accelerator" << std::endl;
+
+        Blake2sCPU b2;
+
+        if (!runTestVectors()) {
+            std::cerr << "Test vectors failed" << std::endl;
+            return 1;
+        }
+        runPerformanceTest();
+        runBatchPerformanceTest();
+        runBenchmarkComparison();
+
+        std::cout << "\n=== All tests completed successfully! ===" << std::endl;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Application failed: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
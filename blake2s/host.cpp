@@ -0,0 +1,985 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+
+// XRT includes for Xilinx Runtime
+#include "xrt/xrt_bo.h"
+#include "xrt/xrt_device.h"
+#include "xrt/xrt_kernel.h"
+
+#define BLAKE2S_BLOCKBYTES 64
+#define BLAKE2S_OUTBYTES 32
+#define BLAKE2S_KEYBYTES 32
+#define BLAKE2S_DESC_WORDS 4  // {byte offset, byte length, key index, key length} per batched message
+#define BLAKE2SP_PARALLELISM 8
+
+// One entry of the batch descriptor table. key_index selects a 32-byte
+// entry of the key table; key_len 0 hashes the message unkeyed.
+struct Blake2sMessage {
+    uint32_t offset;
+    uint32_t length;
+    uint32_t key_index;
+    uint32_t key_len;
+};
+
+// CPU implementation for comparison
+class Blake2sCPU {
+private:
+    static constexpr uint32_t IV[8] = {
+        0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A,
+        0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19
+    };
+
+    static constexpr uint8_t SIGMA[10][16] = {
+        { 0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15},
+        {14, 10,  4,  8,  9, 15, 13,  6,  1, 12,  0,  2, 11,  7,  5,  3},
+        {11,  8, 12,  0,  5,  2, 15, 13, 10, 14,  3,  6,  7,  1,  9,  4},
+        { 7,  9,  3,  1, 13, 12, 11, 14,  2,  6,  5, 10,  4,  0, 15,  8},
+        { 9,  0,  5,  7,  2,  4, 10, 15, 14,  1, 11, 12,  6,  8,  3, 13},
+        { 2, 12,  6, 10,  0, 11,  8,  3,  4, 13,  7,  5, 15, 14,  1,  9},
+        {12,  5,  1, 15, 14, 13,  4, 10,  0,  7,  6,  3,  9,  2,  8, 11},
+        {13, 11,  7, 14, 12,  1,  3,  9,  5,  0, 15,  4,  8,  6,  2, 10},
+        { 6, 15, 14,  9, 11,  3,  0,  8, 12,  2, 13,  7,  1,  4, 10,  5},
+        {10,  2,  8,  4,  7,  6,  1,  5, 15, 11,  9, 14,  3, 12, 13,  0}
+    };
+
+    static uint32_t rotr32(uint32_t x, int n) {
+        return (x >> n) | (x << (32 - n));
+    }
+
+    static void g(uint32_t v[16], int a, int b, int c, int d, uint32_t x, uint32_t y) {
+        v[a] = v[a] + v[b] + x;
+        v[d] = rotr32(v[d] ^ v[a], 16);
+        v[c] = v[c] + v[d];
+        v[b] = rotr32(v[b] ^ v[c], 12);
+        v[a] = v[a] + v[b] + y;
+        v[d] = rotr32(v[d] ^ v[a], 8);
+        v[c] = v[c] + v[d];
+        v[b] = rotr32(v[b] ^ v[c], 7);
+    }
+
+    static void compress(uint32_t h[8], const uint8_t block[BLAKE2S_BLOCKBYTES], uint64_t t, bool last, bool last_node) {
+        uint32_t m[16], v[16];
+        for (int i = 0; i < 16; i++) {
+            m[i] = (uint32_t)block[i * 4] | ((uint32_t)block[i * 4 + 1] << 8) |
+                   ((uint32_t)block[i * 4 + 2] << 16) | ((uint32_t)block[i * 4 + 3] << 24);
+        }
+        for (int i = 0; i < 8; i++) {
+            v[i] = h[i];
+            v[i + 8] = IV[i];
+        }
+        v[12] ^= (uint32_t)t;
+        v[13] ^= (uint32_t)(t >> 32);
+        if (last) v[14] = ~v[14];
+        if (last_node) v[15] = ~v[15];
+
+        for (int r = 0; r < 10; r++) {
+            const uint8_t* s = SIGMA[r];
+            g(v, 0, 4,  8, 12, m[s[0]],  m[s[1]]);
+            g(v, 1, 5,  9, 13, m[s[2]],  m[s[3]]);
+            g(v, 2, 6, 10, 14, m[s[4]],  m[s[5]]);
+            g(v, 3, 7, 11, 15, m[s[6]],  m[s[7]]);
+            g(v, 0, 5, 10, 15, m[s[8]],  m[s[9]]);
+            g(v, 1, 6, 11, 12, m[s[10]], m[s[11]]);
+            g(v, 2, 7,  8, 13, m[s[12]], m[s[13]]);
+            g(v, 3, 4,  9, 14, m[s[14]], m[s[15]]);
+        }
+
+        for (int i = 0; i < 8; i++) {
+            h[i] ^= v[i] ^ v[i + 8];
+        }
+    }
+
+    // Hash one node: `length` data bytes whose 64-byte blocks lie `stride`
+    // bytes apart (64 = contiguous), with `param` as the 8 parameter block
+    // words. The key block, if any, is hashed first.
+    static void hashNode(const uint8_t* input, size_t length, size_t stride, const uint32_t param[8],
+                         const uint8_t* key, size_t key_len, bool last_node, uint8_t* output, size_t output_len) {
+        uint32_t h[8];
+        for (int i = 0; i < 8; i++) h[i] = IV[i] ^ param[i];
+
+        uint8_t block[BLAKE2S_BLOCKBYTES];
+        uint64_t t = 0;
+
+        // A key is hashed as a zero-padded first block
+        if (key_len > 0) {
+            std::memset(block, 0, sizeof(block));
+            std::memcpy(block, key, key_len);
+            t = BLAKE2S_BLOCKBYTES;
+            compress(h, block, t, length == 0, length == 0 && last_node);
+            if (length == 0) {
+                finish(h, output, output_len);
+                return;
+            }
+        }
+
+        // Keep the final (possibly full) block for the last compression
+        while (length > BLAKE2S_BLOCKBYTES) {
+            t += BLAKE2S_BLOCKBYTES;
+            compress(h, input, t, false, false);
+            input += stride;
+            length -= BLAKE2S_BLOCKBYTES;
+        }
+        std::memset(block, 0, sizeof(block));
+        std::memcpy(block, input, length);
+        t += length;
+        compress(h, block, t, true, last_node);
+        finish(h, output, output_len);
+    }
+
+    static void finish(const uint32_t h[8], uint8_t* output, size_t output_len) {
+        for (size_t i = 0; i < output_len; i++) {
+            output[i] = (h[i / 4] >> (8 * (i % 4))) & 0xFF;
+        }
+    }
+
+    // Parameter block words for a node
+    static void makeParam(uint32_t param[8], size_t output_len, size_t key_len, uint32_t fanout, uint32_t depth,
+                          uint32_t leaf_length, uint32_t node_offset, uint32_t node_depth, uint32_t inner_length) {
+        param[0] = (uint32_t)output_len | ((uint32_t)key_len << 8) | (fanout << 16) | (depth << 24);
+        param[1] = leaf_length;
+        param[2] = node_offset;
+        param[3] = (node_depth << 16) | (inner_length << 24);
+        param[4] = param[5] = param[6] = param[7] = 0;
+    }
+
+    // Run fn(i) for i in [0, count) split across up to `threads` threads
+    template <typename Fn>
+    static void parallelFor(size_t count, unsigned threads, Fn fn) {
+        unsigned num_threads = (unsigned)std::min<size_t>(std::max(threads, 1u), count);
+        if (num_threads <= 1) {
+            for (size_t i = 0; i < count; i++) fn(i);
+            return;
+        }
+        std::vector<std::thread> workers(num_threads);
+        for (unsigned t = 0; t < num_threads; t++) {
+            workers[t] = std::thread([=] {
+                size_t start = t * count / num_threads;
+                size_t end = (t + 1) * count / num_threads;
+                for (size_t i = start; i < end; i++) fn(i);
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+public:
+    static void hash(const uint8_t* input, size_t input_len, uint8_t* output, size_t output_len,
+                     const uint8_t* key = nullptr, size_t key_len = 0) {
+        uint32_t param[8];
+        makeParam(param, output_len, key_len, 1, 1, 0, 0, 0, 0);
+        hashNode(input, input_len, BLAKE2S_BLOCKBYTES, param, key, key_len, false, output, output_len);
+    }
+
+    // BLAKE2sp: leaf i takes blocks i, i+8, i+16, ... of the input; the
+    // leaves run on up to `threads` threads, then the root hashes their
+    // digests unkeyed (key length still in its parameter block)
+    static void hashParallel(const uint8_t* input, size_t input_len, uint8_t* output, size_t output_len,
+                             const uint8_t* key = nullptr, size_t key_len = 0, unsigned threads = 8) {
+        const size_t stripe = BLAKE2SP_PARALLELISM * BLAKE2S_BLOCKBYTES;
+        uint8_t leaves[BLAKE2SP_PARALLELISM * BLAKE2S_OUTBYTES];
+
+        parallelFor(BLAKE2SP_PARALLELISM, threads, [&](size_t i) {
+            size_t start = i * BLAKE2S_BLOCKBYTES;
+            size_t rem = input_len % stripe;
+            size_t tail = rem > start ? std::min<size_t>(rem - start, BLAKE2S_BLOCKBYTES) : 0;
+            size_t length = input_len / stripe * BLAKE2S_BLOCKBYTES + tail;
+
+            uint32_t param[8];
+            makeParam(param, output_len, key_len, BLAKE2SP_PARALLELISM, 2, 0, (uint32_t)i, 0, BLAKE2S_OUTBYTES);
+            hashNode(input + start, length, stripe, param, key, key_len, i == BLAKE2SP_PARALLELISM - 1,
+                     leaves + i * BLAKE2S_OUTBYTES, BLAKE2S_OUTBYTES);
+        });
+
+        uint32_t param[8];
+        makeParam(param, output_len, key_len, BLAKE2SP_PARALLELISM, 2, 0, 0, 1, BLAKE2S_OUTBYTES);
+        hashNode(leaves, sizeof(leaves), BLAKE2S_BLOCKBYTES, param, nullptr, 0, true, output, output_len);
+    }
+
+    // Generic tree mode, same layout as blake2s_tree_level: keyed leaves of
+    // leaf_length bytes, then nodes over `fanout` inner digests (0 =
+    // unlimited) until one node remains; the level at depth - 1 takes all
+    // remaining digests. The nodes of each level run on up to `threads`
+    // threads.
+    static void hashTree(const uint8_t* input, size_t input_len, uint8_t* output, size_t output_len,
+                         const uint8_t* key, size_t key_len, uint32_t fanout, uint32_t depth,
+                         uint32_t leaf_length, uint32_t inner_length, unsigned threads = 8) {
+        std::vector<uint8_t> level_in, level_out;
+        const uint8_t* in = input;
+        size_t in_len = input_len;
+        size_t node_bytes = (depth > 1) ? leaf_length : 0;
+        uint32_t level = 0;
+
+        while (true) {
+            size_t nodes = (node_bytes == 0 || in_len == 0) ? 1 : (in_len + node_bytes - 1) / node_bytes;
+            size_t digest_bytes = (nodes == 1) ? output_len : inner_length;
+            size_t span = (node_bytes == 0) ? in_len : node_bytes;
+            size_t node_key_len = (level == 0) ? key_len : 0;
+            level_out.resize(nodes * digest_bytes);
+
+            parallelFor(nodes, threads, [&](size_t i) {
+                uint32_t param[8];
+                makeParam(param, output_len, key_len, fanout, depth, leaf_length, (uint32_t)i, level, inner_length);
+                size_t start = i * span;
+                hashNode(in + start, std::min(span, in_len - start), BLAKE2S_BLOCKBYTES, param,
+                         key, node_key_len, i == nodes - 1 && depth > 1,
+                         level_out.data() + i * digest_bytes, digest_bytes);
+            });
+            if (nodes == 1) {
+                std::memcpy(output, level_out.data(), output_len);
+                return;
+            }
+
+            level_in.swap(level_out);
+            in = level_in.data();
+            in_len = level_in.size();
+            level++;
+            node_bytes = (fanout == 0 || level == depth - 1) ? 0 : (size_t)fanout * inner_length;
+        }
+    }
+};
+
+constexpr uint32_t Blake2sCPU::IV[8];
+constexpr uint8_t Blake2sCPU::SIGMA[10][16];
+
+class Blake2sHost {
+private:
+    xrt::device device;
+    xrt::kernel kernel;
+    xrt::bo bo_input, bo_output, bo_key;
+    size_t input_capacity = 0;
+
+    // Optional batched kernel (blake2s_hash_batch)
+    xrt::kernel batch_kernel;
+    xrt::bo bo_batch_input, bo_batch_keys, bo_batch_table, bo_batch_output;
+    bool has_batch = false;
+    size_t batch_max_bytes = 0;
+    int batch_max_messages = 0;
+    int batch_max_keys = 0;
+
+    // Optional tree-mode kernels (blake2sp_hash, blake2s_tree_level)
+    xrt::kernel sp_kernel, tree_kernel;
+    xrt::bo bo_sp_input, bo_sp_output, bo_sp_key;
+    xrt::bo bo_tree_input, bo_tree_key, bo_tree_param, bo_tree_output;
+    bool has_sp = false;
+    bool has_tree = false;
+    size_t tree_max_bytes = 0;
+
+public:
+    Blake2sHost(const std::string& xclbin_path, int device_id = 0) {
+        try {
+            // Initialize device
+            device = xrt::device(device_id);
+            auto uuid = device.load_xclbin(xclbin_path);
+
+            // Create kernel
+            kernel = xrt::kernel(device, uuid, "blake2s_hash");
+
+            // The batched kernel is optional in the xclbin
+            try {
+                batch_kernel = xrt::kernel(device, uuid, "blake2s_hash_batch");
+                has_batch = true;
+            } catch (const std::exception&) {
+                has_batch = false;
+            }
+            try {
+                sp_kernel = xrt::kernel(device, uuid, "blake2sp_hash");
+                has_sp = true;
+            } catch (const std::exception&) {
+                has_sp = false;
+            }
+            try {
+                tree_kernel = xrt::kernel(device, uuid, "blake2s_tree_level");
+                has_tree = true;
+            } catch (const std::exception&) {
+                has_tree = false;
+            }
+
+            std::cout << "✓ BLAKE2s Hardware accelerator initialized successfully" << std::endl;
+            std::cout << "  - Batched kernel: " << (has_batch ? "available" : "not present") << std::endl;
+            std::cout << "  - BLAKE2sp kernel: " << (has_sp ? "available" : "not present") << std::endl;
+            std::cout << "  - Tree kernel: " << (has_tree ? "available" : "not present") << std::endl;
+        } catch (const std::exception& e) {
+            std::cerr << "Error initializing BLAKE2s accelerator: " << e.what() << std::endl;
+            throw;
+        }
+    }
+
+    void allocateBuffers(size_t max_bytes) {
+        try {
+            // Allocate buffer objects
+            bo_input = xrt::bo(device, max_bytes, kernel.group_id(0));
+            bo_output = xrt::bo(device, BLAKE2S_OUTBYTES, kernel.group_id(2));
+            bo_key = xrt::bo(device, BLAKE2S_KEYBYTES, kernel.group_id(4));
+            input_capacity = max_bytes;
+
+            std::cout << "✓ Buffers allocated for " << max_bytes / 1024 << " KB messages" << std::endl;
+        } catch (const std::exception& e) {
+            std::cerr << "Error allocating buffers: " << e.what() << std::endl;
+            throw;
+        }
+    }
+
+    // Returns the kernel time in seconds
+    double hash(const uint8_t* message, size_t msg_len, uint8_t* hash_out, size_t out_len = BLAKE2S_OUTBYTES,
+                const uint8_t* key = nullptr, size_t key_len = 0, bool quiet = false) {
+        try {
+            if (msg_len > input_capacity) {
+                throw std::runtime_error("message exceeds the allocated input buffer");
+            }
+            if (out_len == 0 || out_len > BLAKE2S_OUTBYTES || key_len > BLAKE2S_KEYBYTES) {
+                throw std::runtime_error("invalid digest or key length");
+            }
+
+            // Map buffers and copy data
+            auto input_map = bo_input.map<uint8_t*>();
+            auto output_map = bo_output.map<uint8_t*>();
+            auto key_map = bo_key.map<uint8_t*>();
+
+            std::memcpy(input_map, message, msg_len);
+            std::memset(key_map, 0, BLAKE2S_KEYBYTES);
+            if (key_len > 0) {
+                std::memcpy(key_map, key, key_len);
+            }
+
+            // Sync buffers to device
+            if (msg_len > 0) {
+                bo_input.sync(XCL_BO_SYNC_BO_TO_DEVICE, msg_len, 0);
+            }
+            bo_key.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+
+            // Start timing
+            auto start = std::chrono::high_resolution_clock::now();
+
+            // Run kernel
+            auto run = kernel(bo_input, (uint32_t)msg_len, bo_output, (uint32_t)out_len, bo_key, (uint32_t)key_len);
+            run.wait();
+
+            // End timing
+            auto end = std::chrono::high_resolution_clock::now();
+            auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+
+            // Sync result back
+            bo_output.sync(XCL_BO_SYNC_BO_FROM_DEVICE, out_len, 0);
+
+            // Copy result
+            std::memcpy(hash_out, output_map, out_len);
+
+            if (!quiet) {
+                std::cout << "✓ Hashing completed in " << duration.count() << " μs" << std::endl;
+
+                // Calculate throughput
+                double data_mb = (double)msg_len / (1024.0 * 1024.0);
+                double time_sec = (double)duration.count() / 1000000.0;
+                if (time_sec > 0) {
+                    std::cout << "✓ Throughput: " << std::fixed << std::setprecision(2)
+                              << data_mb / time_sec << " MB/s" << std::endl;
+                }
+            }
+
+            return std::chrono::duration<double>(end - start).count();
+        } catch (const std::exception& e) {
+            std::cerr << "Error during hashing: " << e.what() << std::endl;
+            throw;
+        }
+    }
+
+    bool hasBatch() const { return has_batch; }
+
+    void allocateBatchBuffers(int max_messages, size_t max_bytes, int max_keys) {
+        try {
+            bo_batch_input = xrt::bo(device, max_bytes, batch_kernel.group_id(0));
+            bo_batch_keys = xrt::bo(device, max_keys * BLAKE2S_KEYBYTES, batch_kernel.group_id(1));
+            bo_batch_table = xrt::bo(device, max_messages * BLAKE2S_DESC_WORDS * sizeof(uint32_t), batch_kernel.group_id(2));
+            bo_batch_output = xrt::bo(device, max_messages * BLAKE2S_OUTBYTES, batch_kernel.group_id(3));
+            batch_max_messages = max_messages;
+            batch_max_bytes = max_bytes;
+            batch_max_keys = max_keys;
+
+            std::cout << "✓ Batch buffers allocated for " << max_messages << " messages / "
+                      << max_bytes / (1024 * 1024) << " MB / " << max_keys << " keys" << std::endl;
+        } catch (const std::exception& e) {
+            std::cerr << "Error allocating batch buffers: " << e.what() << std::endl;
+            throw;
+        }
+    }
+
+    // Hash many independent messages in one launch. `data` holds the message
+    // bytes back to back, `keys` holds num_keys 32-byte key slots (a shorter
+    // key is zero-filled in its slot); digest i is written to digests[i * 32].
+    // Descriptors are reordered by length before upload so the messages
+    // sharing an interleave group finish together instead of idling lanes
+    // behind one long message.
+    double hashBatch(const uint8_t* data, size_t data_len, const uint8_t* keys, int num_keys,
+                     const std::vector<Blake2sMessage>& messages, uint8_t* digests) {
+        try {
+            int num_messages = (int)messages.size();
+            if (num_messages > batch_max_messages || data_len > batch_max_bytes || num_keys > batch_max_keys) {
+                throw std::runtime_error("batch exceeds allocated buffers");
+            }
+            for (const auto& msg : messages) {
+                if (msg.key_len > BLAKE2S_KEYBYTES || (msg.key_len > 0 && (int)msg.key_index >= num_keys) ||
+                    (size_t)msg.offset + msg.length > data_len) {
+                    throw std::runtime_error("invalid batch descriptor");
+                }
+            }
+
+            std::vector<int> order(num_messages);
+            std::iota(order.begin(), order.end(), 0);
+            std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+                return messages[a].length + (messages[a].key_len > 0 ? BLAKE2S_BLOCKBYTES : 0) <
+                       messages[b].length + (messages[b].key_len > 0 ? BLAKE2S_BLOCKBYTES : 0);
+            });
+
+            auto input_map = bo_batch_input.map<uint8_t*>();
+            auto keys_map = bo_batch_keys.map<uint8_t*>();
+            auto table_map = bo_batch_table.map<uint32_t*>();
+            auto output_map = bo_batch_output.map<uint8_t*>();
+
+            std::memcpy(input_map, data, data_len);
+            if (num_keys > 0) {
+                std::memcpy(keys_map, keys, num_keys * BLAKE2S_KEYBYTES);
+            }
+            for (int i = 0; i < num_messages; i++) {
+                const Blake2sMessage& msg = messages[order[i]];
+                table_map[i * BLAKE2S_DESC_WORDS + 0] = msg.offset;
+                table_map[i * BLAKE2S_DESC_WORDS + 1] = msg.length;
+                table_map[i * BLAKE2S_DESC_WORDS + 2] = msg.key_len > 0 ? msg.key_index : 0;
+                table_map[i * BLAKE2S_DESC_WORDS + 3] = msg.key_len;
+            }
+
+            if (data_len > 0) {
+                bo_batch_input.sync(XCL_BO_SYNC_BO_TO_DEVICE, data_len, 0);
+            }
+            if (num_keys > 0) {
+                bo_batch_keys.sync(XCL_BO_SYNC_BO_TO_DEVICE, num_keys * BLAKE2S_KEYBYTES, 0);
+            }
+            bo_batch_table.sync(XCL_BO_SYNC_BO_TO_DEVICE, num_messages * BLAKE2S_DESC_WORDS * sizeof(uint32_t), 0);
+
+            auto start = std::chrono::high_resolution_clock::now();
+
+            auto run = batch_kernel(bo_batch_input, bo_batch_keys, bo_batch_table, bo_batch_output, num_messages);
+            run.wait();
+
+            auto end = std::chrono::high_resolution_clock::now();
+
+            bo_batch_output.sync(XCL_BO_SYNC_BO_FROM_DEVICE, num_messages * BLAKE2S_OUTBYTES, 0);
+
+            for (int i = 0; i < num_messages; i++) {
+                std::memcpy(digests + order[i] * BLAKE2S_OUTBYTES, output_map + i * BLAKE2S_OUTBYTES, BLAKE2S_OUTBYTES);
+            }
+
+            return std::chrono::duration<double>(end - start).count();
+        } catch (const std::exception& e) {
+            std::cerr << "Error during batch hashing: " << e.what() << std::endl;
+            throw;
+        }
+    }
+
+    bool hasParallel() const { return has_sp; }
+    bool hasTree() const { return has_tree; }
+
+    // Leaves are at least one block, so a level's digests never take more
+    // than half of its input plus one node
+    void allocateTreeBuffers(size_t max_bytes) {
+        try {
+            if (has_sp) {
+                bo_sp_input = xrt::bo(device, max_bytes, sp_kernel.group_id(0));
+                bo_sp_output = xrt::bo(device, BLAKE2S_OUTBYTES, sp_kernel.group_id(2));
+                bo_sp_key = xrt::bo(device, BLAKE2S_KEYBYTES, sp_kernel.group_id(4));
+            }
+            if (has_tree) {
+                bo_tree_input = xrt::bo(device, max_bytes, tree_kernel.group_id(0));
+                bo_tree_key = xrt::bo(device, BLAKE2S_KEYBYTES, tree_kernel.group_id(3));
+                bo_tree_param = xrt::bo(device, 8 * sizeof(uint32_t), tree_kernel.group_id(5));
+                bo_tree_output = xrt::bo(device, max_bytes / 2 + BLAKE2S_BLOCKBYTES, tree_kernel.group_id(6));
+            }
+            tree_max_bytes = max_bytes;
+
+            std::cout << "✓ Tree buffers allocated for " << max_bytes / (1024 * 1024) << " MB inputs" << std::endl;
+        } catch (const std::exception& e) {
+            std::cerr << "Error allocating tree buffers: " << e.what() << std::endl;
+            throw;
+        }
+    }
+
+    // BLAKE2sp in one launch: the eight leaves are interleaved in the
+    // kernel's lane pipeline, then the root is hashed on the device.
+    // Returns the kernel time in seconds.
+    double hashParallel(const uint8_t* message, size_t msg_len, uint8_t* hash_out, size_t out_len = BLAKE2S_OUTBYTES,
+                        const uint8_t* key = nullptr, size_t key_len = 0) {
+        try {
+            if (msg_len > tree_max_bytes) {
+                throw std::runtime_error("message exceeds the allocated tree buffers");
+            }
+            if (out_len == 0 || out_len > BLAKE2S_OUTBYTES || key_len > BLAKE2S_KEYBYTES) {
+                throw std::runtime_error("invalid digest or key length");
+            }
+
+            std::memcpy(bo_sp_input.map<uint8_t*>(), message, msg_len);
+            auto key_map = bo_sp_key.map<uint8_t*>();
+            std::memset(key_map, 0, BLAKE2S_KEYBYTES);
+            if (key_len > 0) {
+                std::memcpy(key_map, key, key_len);
+            }
+            if (msg_len > 0) {
+                bo_sp_input.sync(XCL_BO_SYNC_BO_TO_DEVICE, msg_len, 0);
+            }
+            bo_sp_key.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+
+            auto start = std::chrono::high_resolution_clock::now();
+
+            auto run = sp_kernel(bo_sp_input, (uint32_t)msg_len, bo_sp_output, (uint32_t)out_len, bo_sp_key, (uint32_t)key_len);
+            run.wait();
+
+            auto end = std::chrono::high_resolution_clock::now();
+
+            bo_sp_output.sync(XCL_BO_SYNC_BO_FROM_DEVICE, out_len, 0);
+            std::memcpy(hash_out, bo_sp_output.map<uint8_t*>(), out_len);
+
+            return std::chrono::duration<double>(end - start).count();
+        } catch (const std::exception& e) {
+            std::cerr << "Error during BLAKE2sp hashing: " << e.what() << std::endl;
+            throw;
+        }
+    }
+
+    // Generic tree mode, one blake2s_tree_level launch per level. Only the
+    // leaf level reads the message; each higher level re-uploads the
+    // previous level's digests, which are at most half the size. Returns the
+    // summed kernel time in seconds.
+    double hashTree(const uint8_t* message, size_t msg_len, uint8_t* hash_out, size_t out_len,
+                    const uint8_t* key, size_t key_len, uint32_t fanout, uint32_t depth,
+                    uint32_t leaf_length, uint32_t inner_length) {
+        try {
+            if (msg_len > tree_max_bytes) {
+                throw std::runtime_error("message exceeds the allocated tree buffers");
+            }
+            if (out_len == 0 || out_len > BLAKE2S_OUTBYTES || key_len > BLAKE2S_KEYBYTES ||
+                depth == 0 || depth > 255 || fanout > 255) {
+                throw std::runtime_error("invalid digest, key or tree shape");
+            }
+            if (depth > 1 && (inner_length == 0 || inner_length > BLAKE2S_OUTBYTES ||
+                              (leaf_length != 0 && leaf_length < BLAKE2S_BLOCKBYTES))) {
+                throw std::runtime_error("tree mode needs inner_length 1..32 and leaves of at least one block");
+            }
+
+            auto input_map = bo_tree_input.map<uint8_t*>();
+            auto output_map = bo_tree_output.map<uint8_t*>();
+            auto param_map = bo_tree_param.map<uint32_t*>();
+            auto key_map = bo_tree_key.map<uint8_t*>();
+
+            std::memcpy(input_map, message, msg_len);
+            std::memset(key_map, 0, BLAKE2S_KEYBYTES);
+            if (key_len > 0) {
+                std::memcpy(key_map, key, key_len);
+            }
+            if (msg_len > 0) {
+                bo_tree_input.sync(XCL_BO_SYNC_BO_TO_DEVICE, msg_len, 0);
+            }
+            bo_tree_key.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+
+            size_t in_len = msg_len;
+            uint32_t node_bytes = (depth > 1) ? leaf_length : 0;
+            uint32_t level = 0;
+            double kernel_sec = 0;
+
+            while (true) {
+                size_t nodes = (node_bytes == 0 || in_len == 0) ? 1 : (in_len + node_bytes - 1) / node_bytes;
+                uint32_t digest_bytes = (nodes == 1) ? (uint32_t)out_len : inner_length;
+
+                param_map[0] = (uint32_t)out_len | ((uint32_t)key_len << 8) | (fanout << 16) | (depth << 24);
+                param_map[1] = leaf_length;
+                param_map[2] = 0;
+                param_map[3] = (level << 16) | (inner_length << 24);
+                param_map[4] = param_map[5] = param_map[6] = param_map[7] = 0;
+                bo_tree_param.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+
+                auto start = std::chrono::high_resolution_clock::now();
+
+                auto run = tree_kernel(bo_tree_input, (uint32_t)in_len, node_bytes, bo_tree_key,
+                                       (uint32_t)(level == 0 ? key_len : 0), bo_tree_param, bo_tree_output, digest_bytes);
+                run.wait();
+
+                auto end = std::chrono::high_resolution_clock::now();
+                kernel_sec += std::chrono::duration<double>(end - start).count();
+
+                bo_tree_output.sync(XCL_BO_SYNC_BO_FROM_DEVICE, nodes * digest_bytes, 0);
+                if (nodes == 1) {
+                    std::memcpy(hash_out, output_map, out_len);
+                    return kernel_sec;
+                }
+
+                in_len = nodes * inner_length;
+                std::memcpy(input_map, output_map, in_len);
+                bo_tree_input.sync(XCL_BO_SYNC_BO_TO_DEVICE, in_len, 0);
+                level++;
+                node_bytes = (fanout == 0 || level == depth - 1) ? 0 : fanout * inner_length;
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Error during tree hashing: " << e.what() << std::endl;
+            throw;
+        }
+    }
+
+    ~Blake2sHost() {
+        std::cout << "✓ BLAKE2s Host cleanup completed" << std::endl;
+    }
+};
+
+void printHash(const std::string& label, const uint8_t* hash, size_t len = BLAKE2S_OUTBYTES) {
+    std::cout << label << ": ";
+    for (size_t i = 0; i < len; i++) {
+        std::cout << std::hex << std::setw(2) << std::setfill('0') << (int)hash[i];
+    }
+    std::cout << std::dec << std::setfill(' ') << std::endl;
+}
+
+bool parseHex(const char* hex, uint8_t* out, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        unsigned int byte;
+        if (sscanf(hex + 2 * i, "%2x", &byte) != 1) return false;
+        out[i] = (uint8_t)byte;
+    }
+    return true;
+}
+
+bool runTestVectors(Blake2sHost& b2) {
+    std::cout << "\n=== BLAKE2s Test Vectors ===" << std::endl;
+
+    struct Vector {
+        const char* name;
+        std::vector<uint8_t> message;
+        std::vector<uint8_t> key;
+        const char* expected;
+    };
+
+    std::vector<uint8_t> seq64(64), seq32(32);
+    std::iota(seq64.begin(), seq64.end(), 0);
+    std::iota(seq32.begin(), seq32.end(), 0);
+    const char* fox = "The quick brown fox jumps over the lazy dog";
+    const char* abc = "abc";
+
+    const Vector vectors[] = {
+        {"Empty string", {}, {},
+         "69217a3079908094e11121d042354a7c1f55b6482ca1a51e1b250dfd1ed0eef9"},
+        {"\"abc\"", std::vector<uint8_t>(abc, abc + 3), {},
+         "508c5e8c327c14e2e1a72ba34eeb452f37458b209ed63a294d999b4c86675982"},
+        {"\"The quick brown fox jumps over the lazy dog\"", std::vector<uint8_t>(fox, fox + strlen(fox)), {},
+         "606beeec743ccbeff6cbcdf5d5302aa855c256c29b88c8ed331ea1a6bf3c8812"},
+        {"Keyed, key 00..1f, message 00..3f", seq64, seq32,
+         "8975b0577fd35566d750b362b0897a26c399136df07bababbde6203ff2954ed4"}
+    };
+
+    bool all_passed = true;
+    int test_num = 1;
+    for (const auto& vec : vectors) {
+        std::cout << "\nTest " << test_num++ << ": " << vec.name << std::endl;
+
+        uint8_t fpga_hash[BLAKE2S_OUTBYTES], cpu_hash[BLAKE2S_OUTBYTES], expected[BLAKE2S_OUTBYTES];
+        parseHex(vec.expected, expected, BLAKE2S_OUTBYTES);
+
+        b2.hash(vec.message.data(), vec.message.size(), fpga_hash, BLAKE2S_OUTBYTES,
+                vec.key.data(), vec.key.size());
+        Blake2sCPU::hash(vec.message.data(), vec.message.size(), cpu_hash, BLAKE2S_OUTBYTES,
+                         vec.key.data(), vec.key.size());
+
+        printHash("FPGA", fpga_hash);
+        printHash("CPU ", cpu_hash);
+        std::cout << "Expected: " << vec.expected << std::endl;
+
+        bool passed = std::memcmp(fpga_hash, expected, BLAKE2S_OUTBYTES) == 0 &&
+                      std::memcmp(cpu_hash, expected, BLAKE2S_OUTBYTES) == 0;
+        std::cout << (passed ? "✓ PASSED" : "✗ FAILED") << std::endl;
+        all_passed &= passed;
+    }
+
+    // Truncated digest: a different output length changes the parameter block
+    {
+        std::cout << "\nTest " << test_num << ": 16-byte digest of \"abc\"" << std::endl;
+        uint8_t fpga_hash[16], cpu_hash[16];
+        b2.hash((const uint8_t*)abc, 3, fpga_hash, 16);
+        Blake2sCPU::hash((const uint8_t*)abc, 3, cpu_hash, 16);
+        printHash("FPGA", fpga_hash, 16);
+        printHash("CPU ", cpu_hash, 16);
+        bool passed = std::memcmp(fpga_hash, cpu_hash, 16) == 0;
+        std::cout << (passed ? "✓ PASSED" : "✗ FAILED") << std::endl;
+        all_passed &= passed;
+    }
+
+    return all_passed;
+}
+
+void runPerformanceTest(Blake2sHost& b2) {
+    std::cout << "\n=== Performance Test (FPGA vs CPU) ===" << std::endl;
+
+    const size_t test_sizes[] = {64, 256, 1024, 4096, 16384, 65536};
+    const int num_tests = sizeof(test_sizes) / sizeof(test_sizes[0]);
+
+    for (int t = 0; t < num_tests; t++) {
+        size_t size = test_sizes[t];
+
+        std::vector<uint8_t> message(size);
+        uint8_t fpga_hash[BLAKE2S_OUTBYTES], cpu_hash[BLAKE2S_OUTBYTES];
+
+        // Generate random message
+        for (size_t i = 0; i < size; i++) {
+            message[i] = rand() & 0xFF;
+        }
+
+        std::cout << "\nTest " << (t+1) << ": " << size << " bytes" << std::endl;
+
+        b2.hash(message.data(), size, fpga_hash);
+
+        auto cpu_start = std::chrono::high_resolution_clock::now();
+        Blake2sCPU::hash(message.data(), size, cpu_hash, BLAKE2S_OUTBYTES);
+        auto cpu_end = std::chrono::high_resolution_clock::now();
+        double cpu_us = std::chrono::duration<double, std::micro>(cpu_end - cpu_start).count();
+
+        std::cout << "CPU: " << std::fixed << std::setprecision(2) << cpu_us << " μs" << std::endl;
+        std::cout << "Verification: "
+                  << (std::memcmp(fpga_hash, cpu_hash, BLAKE2S_OUTBYTES) == 0 ? "✓ PASSED" : "✗ FAILED") << std::endl;
+    }
+}
+
+bool runBatchTest(Blake2sHost& b2) {
+    std::cout << "\n=== Batched Hashing Test ===" << std::endl;
+
+    if (!b2.hasBatch()) {
+        std::cout << "blake2s_hash_batch not in xclbin, skipping" << std::endl;
+        return true;
+    }
+
+    // Each size is hashed as one 16 MB launch (262144 x 64 B down to
+    // 256 x 64 KB), keyed with 16 rotating MAC keys
+    const size_t test_sizes[] = {64, 256, 1024, 4096, 16384, 65536};
+    const int num_tests = sizeof(test_sizes) / sizeof(test_sizes[0]);
+    const size_t batch_bytes = 16 * 1024 * 1024;
+    const int num_keys = 16;
+
+    std::vector<uint8_t> data(batch_bytes);
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = rand() & 0xFF;
+    }
+    std::vector<uint8_t> keys(num_keys * BLAKE2S_KEYBYTES);
+    for (size_t i = 0; i < keys.size(); i++) {
+        keys[i] = rand() & 0xFF;
+    }
+
+    std::cout << std::setw(10) << "Size" << std::setw(10) << "Count"
+              << std::setw(16) << "FPGA hash/s" << std::setw(12) << "FPGA MB/s"
+              << std::setw(16) << "CPU hash/s" << std::setw(12) << "CPU MB/s" << std::endl;
+
+    for (int t = 0; t < num_tests; t++) {
+        size_t size = test_sizes[t];
+        int count = (int)(batch_bytes / size);
+
+        std::vector<Blake2sMessage> messages(count);
+        for (int i = 0; i < count; i++) {
+            messages[i].offset = i * size;
+            messages[i].length = size;
+            messages[i].key_index = i % num_keys;
+            messages[i].key_len = BLAKE2S_KEYBYTES;
+        }
+
+        std::vector<uint8_t> digests(count * BLAKE2S_OUTBYTES);
+        double fpga_sec = b2.hashBatch(data.data(), count * size, keys.data(), num_keys, messages, digests.data());
+
+        std::vector<uint8_t> cpu_digests(count * BLAKE2S_OUTBYTES);
+        auto cpu_start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < count; i++) {
+            Blake2sCPU::hash(data.data() + messages[i].offset, size, &cpu_digests[i * BLAKE2S_OUTBYTES],
+                             BLAKE2S_OUTBYTES, &keys[messages[i].key_index * BLAKE2S_KEYBYTES], BLAKE2S_KEYBYTES);
+        }
+        auto cpu_end = std::chrono::high_resolution_clock::now();
+        double cpu_sec = std::chrono::duration<double>(cpu_end - cpu_start).count();
+
+        double mb = (double)(count * size) / (1024.0 * 1024.0);
+        std::cout << std::setw(10) << size << std::setw(10) << count << std::fixed
+                  << std::setprecision(0) << std::setw(16) << count / fpga_sec
+                  << std::setprecision(2) << std::setw(12) << mb / fpga_sec
+                  << std::setprecision(0) << std::setw(16) << count / cpu_sec
+                  << std::setprecision(2) << std::setw(12) << mb / cpu_sec;
+        if (digests != cpu_digests) {
+            std::cout << "  ✗ MISMATCH";
+        }
+        std::cout << std::endl;
+    }
+
+    // Mixed lengths and key lengths, cross-checked against blake2s_hash and the CPU
+    std::cout << "\nVerifying mixed batch against blake2s_hash and CPU..." << std::endl;
+    const uint32_t lengths[] = {0, 1, 63, 64, 65, 1000, 4096, 3, 127, 128, 0, 64};
+    const uint32_t key_lens[] = {0, 32, 0, 16, 1, 32, 0, 7, 0, 32, 32, 0};
+    const int count = sizeof(lengths) / sizeof(lengths[0]);
+    std::vector<Blake2sMessage> messages(count);
+    uint32_t offset = 0;
+    for (int i = 0; i < count; i++) {
+        messages[i].offset = offset;
+        messages[i].length = lengths[i];
+        messages[i].key_index = i % num_keys;
+        messages[i].key_len = key_lens[i];
+        offset += lengths[i];
+    }
+
+    std::vector<uint8_t> digests(count * BLAKE2S_OUTBYTES);
+    b2.hashBatch(data.data(), offset, keys.data(), num_keys, messages, digests.data());
+
+    int mismatches = 0;
+    for (int i = 0; i < count; i++) {
+        uint8_t fpga_hash[BLAKE2S_OUTBYTES], cpu_hash[BLAKE2S_OUTBYTES];
+        const uint8_t* key = &keys[messages[i].key_index * BLAKE2S_KEYBYTES];
+        b2.hash(data.data() + messages[i].offset, lengths[i], fpga_hash, BLAKE2S_OUTBYTES, key, key_lens[i], true);
+        Blake2sCPU::hash(data.data() + messages[i].offset, lengths[i], cpu_hash, BLAKE2S_OUTBYTES, key, key_lens[i]);
+        if (std::memcmp(fpga_hash, &digests[i * BLAKE2S_OUTBYTES], BLAKE2S_OUTBYTES) != 0 ||
+            std::memcmp(cpu_hash, &digests[i * BLAKE2S_OUTBYTES], BLAKE2S_OUTBYTES) != 0) {
+            mismatches++;
+        }
+    }
+    std::cout << "Batch verification: " << (mismatches == 0 ? "✓ PASSED" : "✗ FAILED") << std::endl;
+    return mismatches == 0;
+}
+
+bool runTreeTest(Blake2sHost& b2) {
+    std::cout << "\n=== BLAKE2sp / Tree Hashing Test ===" << std::endl;
+
+    unsigned threads = std::thread::hardware_concurrency();
+    if (threads == 0) threads = 4;
+
+    std::vector<uint8_t> seq(5000), key(32);
+    for (size_t i = 0; i < seq.size(); i++) seq[i] = (uint8_t)i;
+    std::iota(key.begin(), key.end(), 0);
+
+    // CPU reference against known values: the BLAKE2sp keyed KAT (empty
+    // input) and a fanout-4 / depth-3 / 256-byte-leaf tree over 5000 bytes
+    bool passed = true;
+    uint8_t hash[BLAKE2S_OUTBYTES], expected[BLAKE2S_OUTBYTES];
+    Blake2sCPU::hashParallel(seq.data(), 0, hash, BLAKE2S_OUTBYTES, key.data(), 32, threads);
+    parseHex("715cb13895aeb678f6124160bff21465b30f4f6874193fc851b4621043f09cc6", expected, BLAKE2S_OUTBYTES);
+    passed &= std::memcmp(hash, expected, BLAKE2S_OUTBYTES) == 0;
+    Blake2sCPU::hashTree(seq.data(), seq.size(), hash, BLAKE2S_OUTBYTES, nullptr, 0, 4, 3, 256, 32, threads);
+    parseHex("d38db1117a132917bda798dae1e3e884fdc1bd3800c98ffc4b815b745a146cf1", expected, BLAKE2S_OUTBYTES);
+    passed &= std::memcmp(hash, expected, BLAKE2S_OUTBYTES) == 0;
+    std::cout << "CPU known-answer tests: " << (passed ? "✓ PASSED" : "✗ FAILED") << std::endl;
+
+    // Device against CPU around the stripe and leaf boundaries
+    if (b2.hasParallel() || b2.hasTree()) {
+        const size_t lengths[] = {0, 1, 511, 512, 513, 5000, 100000};
+        std::vector<uint8_t> data(100000);
+        for (size_t i = 0; i < data.size(); i++) data[i] = rand() & 0xFF;
+
+        int mismatches = 0;
+        for (size_t len : lengths) {
+            for (size_t key_len : {(size_t)0, (size_t)32}) {
+                uint8_t fpga_hash[BLAKE2S_OUTBYTES], cpu_hash[BLAKE2S_OUTBYTES];
+                if (b2.hasParallel()) {
+                    b2.hashParallel(data.data(), len, fpga_hash, BLAKE2S_OUTBYTES, key.data(), key_len);
+                    Blake2sCPU::hashParallel(data.data(), len, cpu_hash, BLAKE2S_OUTBYTES, key.data(), key_len, threads);
+                    mismatches += std::memcmp(fpga_hash, cpu_hash, BLAKE2S_OUTBYTES) != 0;
+                }
+                if (b2.hasTree()) {
+                    b2.hashTree(data.data(), len, fpga_hash, BLAKE2S_OUTBYTES, key.data(), key_len, 2, 255, 1024, 32);
+                    Blake2sCPU::hashTree(data.data(), len, cpu_hash, BLAKE2S_OUTBYTES, key.data(), key_len, 2, 255, 1024, 32, threads);
+                    mismatches += std::memcmp(fpga_hash, cpu_hash, BLAKE2S_OUTBYTES) != 0;
+                }
+            }
+        }
+        std::cout << "FPGA vs CPU verification: " << (mismatches == 0 ? "✓ PASSED" : "✗ FAILED") << std::endl;
+        passed &= mismatches == 0;
+    }
+
+    // Large inputs: sequential BLAKE2s is one compression chain; BLAKE2sp
+    // and a 64 KB-leaf binary tree split it into independent leaves
+    std::cout << "\nThroughput (MB/s), " << threads << " CPU threads:" << std::endl;
+    std::cout << std::setw(8) << "Size" << std::setw(12) << "CPU seq" << std::setw(12) << "CPU sp x1"
+              << std::setw(12) << "CPU sp" << std::setw(12) << "CPU tree"
+              << std::setw(12) << "FPGA sp" << std::setw(12) << "FPGA tree" << std::endl;
+
+    const size_t sizes[] = {1 << 20, 4 << 20, 16 << 20};
+    std::vector<uint8_t> big(sizes[2]);
+    for (size_t i = 0; i < big.size(); i++) big[i] = rand() & 0xFF;
+
+    for (size_t size : sizes) {
+        double mb = (double)size / (1024.0 * 1024.0);
+        auto time_cpu = [&](auto fn) {
+            auto start = std::chrono::high_resolution_clock::now();
+            fn();
+            auto end = std::chrono::high_resolution_clock::now();
+            return std::chrono::duration<double>(end - start).count();
+        };
+
+        double seq_sec = time_cpu([&] { Blake2sCPU::hash(big.data(), size, hash, BLAKE2S_OUTBYTES); });
+        double sp1_sec = time_cpu([&] { Blake2sCPU::hashParallel(big.data(), size, hash, BLAKE2S_OUTBYTES, nullptr, 0, 1); });
+        double sp_sec = time_cpu([&] { Blake2sCPU::hashParallel(big.data(), size, hash, BLAKE2S_OUTBYTES, nullptr, 0, threads); });
+        double tree_sec = time_cpu([&] {
+            Blake2sCPU::hashTree(big.data(), size, hash, BLAKE2S_OUTBYTES, nullptr, 0, 2, 255, 65536, 32, threads);
+        });
+
+        std::cout << std::setw(6) << size / (1024 * 1024) << "MB" << std::fixed << std::setprecision(2)
+                  << std::setw(12) << mb / seq_sec << std::setw(12) << mb / sp1_sec
+                  << std::setw(12) << mb / sp_sec << std::setw(12) << mb / tree_sec;
+        if (b2.hasParallel()) {
+            std::cout << std::setw(12) << mb / b2.hashParallel(big.data(), size, hash);
+        } else {
+            std::cout << std::setw(12) << "-";
+        }
+        if (b2.hasTree()) {
+            std::cout << std::setw(12) << mb / b2.hashTree(big.data(), size, hash, BLAKE2S_OUTBYTES, nullptr, 0, 2, 255, 65536, 32);
+        } else {
+            std::cout << std::setw(12) << "-";
+        }
+        std::cout << std::endl;
+    }
+
+    return passed;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <xclbin_path> [device_id]" << std::endl;
+        std::cerr << "Example: " << argv[0] << " blake2s.xclbin 0" << std::endl;
+        return 1;
+    }
+
+    std::string xclbin_path = argv[1];
+    int device_id = (argc > 2) ? std::atoi(argv[2]) : 0;
+
+    try {
+        std::cout << "=== BLAKE2s Hardware Accelerator Host Application ===" << std::endl;
+        std::cout << "XCLBIN: " << xclbin_path << std::endl;
+        std::cout << "Device ID: " << device_id << std::endl;
+
+        // Initialize BLAKE2s accelerator
+        Blake2sHost b2(xclbin_path, device_id);
+
+        // Allocate buffers for maximum test size
+        b2.allocateBuffers(64 * 1024);
+        if (b2.hasBatch()) {
+            b2.allocateBatchBuffers(1 << 18, 16 * 1024 * 1024, 16); // 16 MB, down to 64-byte messages
+        }
+        if (b2.hasParallel() || b2.hasTree()) {
+            b2.allocateTreeBuffers(16 * 1024 * 1024);
+        }
+
+        // Run tests
+        bool passed = runTestVectors(b2);
+        runPerformanceTest(b2);
+        passed &= runBatchTest(b2);
+        passed &= runTreeTest(b2);
+
+        std::cout << "\n=== " << (passed ? "All tests completed successfully!" : "Some tests FAILED") << " ===" << std::endl;
+        return passed ? 0 : 1;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Application failed: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -265,7 +265,6 @@ const uint32_t sbox[NUM_SBOXES][SBOX_SIZE] = {
         0x90d4f869, 0xa65cdea0, 0x3f09252d, 0xc208e69f,
         0xb74e6132, 0xce77e25b, 0x578fdfe3, 0x3ac372e6
     }
-    // Full S-box values omitted for brevity
 };
 
 const uint32_t p_array[P_ARRAY_SIZE] = {
@@ -274,19 +273,48 @@ const uint32_t p_array[P_ARRAY_SIZE] = {
     0x9216d5d9, 0x8979fb1b
 };
 
-// F-function for Blowfish
-static uint32_t f_function(uint32_t x) {
+// F-function over the key-dependent S-boxes
+static uint32_t f_function(uint32_t x, const uint32_t s[NUM_SBOXES][SBOX_SIZE]) {
 #pragma HLS INLINE
     uint8_t a = (x >> 24) & 0xFF;
     uint8_t b = (x >> 16) & 0xFF;
     uint8_t c = (x >> 8) & 0xFF;
     uint8_t d = x & 0xFF;
-    return ((sbox[0][a] + sbox[1][b]) ^ sbox[2][c]) + sbox[3][d];
+    return ((s[0][a] + s[1][b]) ^ s[2][c]) + s[3][d];
+}
+
+// 16 Feistel rounds with the subkeys in p. Decryption is the same network
+// with the P-array reversed.
+static void feistel(uint32_t &left, uint32_t &right, const uint32_t p[P_ARRAY_SIZE],
+                    const uint32_t s[NUM_SBOXES][SBOX_SIZE]) {
+#pragma HLS INLINE
+    ROUND_LOOP: for (int round = 0; round < NUM_ROUNDS; round++) {
+#pragma HLS UNROLL
+        left ^= p[round];
+        right ^= f_function(left, s);
+        uint32_t temp = left;
+        left = right;
+        right = temp;
+    }
+
+    // Undo the last swap, then the output whitening
+    uint32_t temp = left;
+    left = right ^ p[NUM_ROUNDS + 1];
+    right = temp ^ p[NUM_ROUNDS];
 }
 
 // Subkey generation
 static void key_expansion(const uint8_t *key, int key_len, uint32_t p_out[P_ARRAY_SIZE], uint32_t sbox_out[NUM_SBOXES][SBOX_SIZE]) {
 #pragma HLS INLINE
+    // Keys are 1 to 56 bytes, cycled over the P-array
+    uint8_t key_local[BLOWFISH_MAX_KEY_BYTES];
+    if (key_len < 1) key_len = 1;
+    if (key_len > BLOWFISH_MAX_KEY_BYTES) key_len = BLOWFISH_MAX_KEY_BYTES;
+    KEY_LOAD: for (int i = 0; i < key_len; i++) {
+#pragma HLS PIPELINE II=1
+        key_local[i] = key[i];
+    }
+
     // Initialize P-array and S-boxes
     for (int i = 0; i < P_ARRAY_SIZE; i++) {
 #pragma HLS UNROLL
@@ -306,26 +334,19 @@ static void key_expansion(const uint8_t *key, int key_len, uint32_t p_out[P_ARRA
         uint32_t key_bytes = 0;
         for (int j = 0; j < 4; j++) {
 #pragma HLS UNROLL
-            key_bytes = (key_bytes << 8) | (key_pos < key_len ? key[key_pos] : 0);
-            key_pos = (key_pos + 1) % key_len;
+            key_bytes = (key_bytes << 8) | key_local[key_pos];
+            key_pos = key_pos + 1 == key_len ? 0 : key_pos + 1;
         }
         p_out[i] ^= key_bytes;
     }
 
-    // Encrypt zero block to update subkeys
+    // Chain-encrypt the zero block, replacing the subkeys two at a time. Each
+    // encryption uses the S-boxes as updated so far, so the 521 encryptions
+    // are serial.
     uint32_t left = 0, right = 0;
     for (int i = 0; i < P_ARRAY_SIZE; i += 2) {
 #pragma HLS PIPELINE II=1
-        for (int round = 0; round < NUM_ROUNDS; round++) {
-#pragma HLS UNROLL
-            left ^= p_out[round];
-            right ^= f_function(left);
-            uint32_t temp = left;
-            left = right;
-            right = temp;
-        }
-        left ^= p_out[NUM_ROUNDS];
-        right ^= p_out[NUM_ROUNDS + 1];
+        feistel(left, right, p_out, sbox_out);
         p_out[i] = left;
         p_out[i + 1] = right;
     }
@@ -334,22 +355,79 @@ static void key_expansion(const uint8_t *key, int key_len, uint32_t p_out[P_ARRA
     for (int i = 0; i < NUM_SBOXES; i++) {
         for (int j = 0; j < SBOX_SIZE; j += 2) {
 #pragma HLS PIPELINE II=1
-            for (int round = 0; round < NUM_ROUNDS; round++) {
-#pragma HLS UNROLL
-                left ^= p_out[round];
-                right ^= f_function(left);
-                uint32_t temp = left;
-                left = right;
-                right = temp;
-            }
-            left ^= p_out[NUM_ROUNDS];
-            right ^= p_out[NUM_ROUNDS + 1];
+            feistel(left, right, p_out, sbox_out);
             sbox_out[i][j] = left;
             sbox_out[i][j + 1] = right;
         }
     }
 }
 
+static uint64_t load_block(const uint8_t *bytes, int block) {
+#pragma HLS INLINE
+    uint64_t x = 0;
+    LOAD_LOOP: for (int i = 0; i < BLOCK_SIZE; i++) {
+#pragma HLS UNROLL
+        x = (x << 8) | bytes[block * BLOCK_SIZE + i];
+    }
+    return x;
+}
+
+static void store_block(uint8_t *bytes, int block, uint64_t x) {
+#pragma HLS INLINE
+    STORE_LOOP: for (int i = 0; i < BLOCK_SIZE; i++) {
+#pragma HLS UNROLL
+        bytes[block * BLOCK_SIZE + i] = (x >> (56 - i * 8)) & 0xFF;
+    }
+}
+
+static uint64_t cipher_block(uint64_t x, const uint32_t p[P_ARRAY_SIZE], const uint32_t s[NUM_SBOXES][SBOX_SIZE]) {
+#pragma HLS INLINE
+    uint32_t left = x >> 32;
+    uint32_t right = x;
+    feistel(left, right, p, s);
+    return ((uint64_t)left << 32) | right;
+}
+
+// ECB, CBC or CTR over num_blocks big-endian blocks with the given schedule.
+// All but CBC encryption are block-parallel and pipelined at II=1; CBC
+// encryption feeds each ciphertext block into the next, so it runs at the
+// latency of a whole block per block.
+static void process_blocks(const uint8_t *input, uint8_t *output, int num_blocks, bool decrypt, int mode, uint64_t iv,
+                           const uint32_t p_keys[P_ARRAY_SIZE], const uint32_t sbox_local[NUM_SBOXES][SBOX_SIZE]) {
+#pragma HLS INLINE
+    // CTR only ever encrypts the counter
+    bool reverse = decrypt && mode != BF_MODE_CTR;
+    uint32_t p_round[P_ARRAY_SIZE];
+#pragma HLS ARRAY_PARTITION variable=p_round complete
+    P_ORDER: for (int i = 0; i < P_ARRAY_SIZE; i++) {
+#pragma HLS UNROLL
+        p_round[i] = reverse ? p_keys[P_ARRAY_SIZE - 1 - i] : p_keys[i];
+    }
+
+    uint64_t chain = iv;
+    if (mode == BF_MODE_CBC && !decrypt) {
+        CBC_ENC_LOOP: for (int block = 0; block < num_blocks; block++) {
+#pragma HLS PIPELINE
+            chain = cipher_block(load_block(input, block) ^ chain, p_round, sbox_local);
+            store_block(output, block, chain);
+        }
+        return;
+    }
+
+    BLOCK_LOOP: for (int block = 0; block < num_blocks; block++) {
+#pragma HLS PIPELINE II=1
+        uint64_t x = load_block(input, block);
+        uint64_t y = cipher_block(mode == BF_MODE_CTR ? iv + block : x, p_round, sbox_local);
+        if (mode == BF_MODE_CTR) {
+            y ^= x;
+        } else if (mode == BF_MODE_CBC) {
+            y ^= chain;
+            chain = x;
+        }
+        store_block(output, block, y);
+    }
+}
+
 // Blowfish encryption function
 void blowfish_encrypt(const uint8_t *plaintext, const uint8_t *key, uint8_t *ciphertext, int num_blocks, int key_len) {
 #pragma HLS INTERFACE m_axi port=plaintext depth=64 offset=slave bundle=gmem0
@@ -370,42 +448,292 @@ void blowfish_encrypt(const uint8_t *plaintext, const uint8_t *key, uint8_t *cip
     // Generate subkeys
     key_expansion(key, key_len, p_keys, sbox_local);
 
-    // Process each block
-    BLOCK_LOOP: for (int block = 0; block < num_blocks; block++) {
+    process_blocks(plaintext, ciphertext, num_blocks, false, BF_MODE_ECB, 0, p_keys, sbox_local);
+}
+
+// Key schedule only: the expanded P-array and S-boxes go to ctx
+void blowfish_key_setup(const uint8_t *key, int key_len, uint32_t *ctx) {
+#pragma HLS INTERFACE m_axi port=key depth=56 offset=slave bundle=gmem0
+#pragma HLS INTERFACE m_axi port=ctx depth=1042 offset=slave bundle=gmem1
+#pragma HLS INTERFACE s_axilite port=key bundle=control
+#pragma HLS INTERFACE s_axilite port=key_len bundle=control
+#pragma HLS INTERFACE s_axilite port=ctx bundle=control
+#pragma HLS INTERFACE s_axilite port=return bundle=control
+
+    uint32_t p_keys[P_ARRAY_SIZE];
+    uint32_t sbox_local[NUM_SBOXES][SBOX_SIZE];
+#pragma HLS ARRAY_PARTITION variable=p_keys complete
+#pragma HLS ARRAY_PARTITION variable=sbox_local complete dim=0
+
+    key_expansion(key, key_len, p_keys, sbox_local);
+
+    STORE_P: for (int i = 0; i < P_ARRAY_SIZE; i++) {
+#pragma HLS PIPELINE II=1
+        ctx[i] = p_keys[i];
+    }
+    STORE_S: for (int i = 0; i < NUM_SBOXES; i++) {
+        for (int j = 0; j < SBOX_SIZE; j++) {
+#pragma HLS PIPELINE II=1
+            ctx[P_ARRAY_SIZE + i * SBOX_SIZE + j] = sbox_local[i][j];
+        }
+    }
+}
+
+static void load_schedule(const uint32_t *ctx, uint32_t p[P_ARRAY_SIZE], uint32_t s[NUM_SBOXES][SBOX_SIZE]) {
+    LOAD_P: for (int i = 0; i < P_ARRAY_SIZE; i++) {
 #pragma HLS PIPELINE II=1
-        uint32_t left, right;
-        uint8_t state[8];
-#pragma HLS ARRAY_PARTITION variable=state complete
+        p[i] = ctx[i];
+    }
+    LOAD_S: for (int i = 0; i < NUM_SBOXES; i++) {
+        for (int j = 0; j < SBOX_SIZE; j++) {
+#pragma HLS PIPELINE II=1
+            s[i][j] = ctx[P_ARRAY_SIZE + i * SBOX_SIZE + j];
+        }
+    }
+}
+
+// ECB, CBC or CTR under a schedule from blowfish_key_setup. The last
+// schedule stays on chip across launches and is reloaded from ctx only when
+// ctx_id changes, so a cached key costs nothing per message. ctx_id 0 runs
+// from a one-off copy of ctx and leaves the cached schedule and its id alone.
+void blowfish_crypt(const uint8_t *input, const uint32_t *ctx, uint32_t ctx_id, uint8_t *output, int num_blocks,
+                    int decrypt, int mode, uint64_t iv) {
+#pragma HLS INTERFACE m_axi port=input depth=64 offset=slave bundle=gmem0
+#pragma HLS INTERFACE m_axi port=ctx depth=1042 offset=slave bundle=gmem1
+#pragma HLS INTERFACE m_axi port=output depth=64 offset=slave bundle=gmem2
+#pragma HLS INTERFACE s_axilite port=input bundle=control
+#pragma HLS INTERFACE s_axilite port=ctx bundle=control
+#pragma HLS INTERFACE s_axilite port=ctx_id bundle=control
+#pragma HLS INTERFACE s_axilite port=output bundle=control
+#pragma HLS INTERFACE s_axilite port=num_blocks bundle=control
+#pragma HLS INTERFACE s_axilite port=decrypt bundle=control
+#pragma HLS INTERFACE s_axilite port=mode bundle=control
+#pragma HLS INTERFACE s_axilite port=iv bundle=control
+#pragma HLS INTERFACE s_axilite port=return bundle=control
+
+    static uint32_t p_keys[P_ARRAY_SIZE];
+    static uint32_t sbox_local[NUM_SBOXES][SBOX_SIZE];
+    static uint32_t cached_id = 0;
+#pragma HLS ARRAY_PARTITION variable=p_keys complete
+#pragma HLS ARRAY_PARTITION variable=sbox_local complete dim=0
 
-        // Load 64-bit block
-        LOAD_LOOP: for (int i = 0; i < 8; i++) {
+#pragma HLS ALLOCATION function instances=process_blocks limit=1
+
+    if (ctx_id == 0) {
+        uint32_t p_once[P_ARRAY_SIZE];
+        uint32_t sbox_once[NUM_SBOXES][SBOX_SIZE];
+#pragma HLS ARRAY_PARTITION variable=p_once complete
+#pragma HLS ARRAY_PARTITION variable=sbox_once complete dim=0
+        load_schedule(ctx, p_once, sbox_once);
+        process_blocks(input, output, num_blocks, decrypt != 0, mode, iv, p_once, sbox_once);
+        return;
+    }
+
+    if (ctx_id != cached_id) {
+        load_schedule(ctx, p_keys, sbox_local);
+        cached_id = ctx_id;
+    }
+    process_blocks(input, output, num_blocks, decrypt != 0, mode, iv, p_keys, sbox_local);
+}
+
+// bcrypt: EksBlowfish with BCRYPT_LANES hashes sharing one round pipeline.
+// An expansion is a chain of 521 dependent encryptions, so a single hash
+// would stall every round on the previous one; here lane g issues a round
+// every BCRYPT_LANES cycles and the other lanes fill the gaps. Each lane
+// has its own P-array and S-boxes; S-box bank b holds all lanes, split by
+// even/odd entry so the two words stored per encryption go to different
+// banks while the round reads one of them.
+
+typedef uint32_t bcrypt_p_t[BCRYPT_LANES][P_ARRAY_SIZE];
+typedef uint32_t bcrypt_s_t[NUM_SBOXES][BCRYPT_LANES][SBOX_SIZE];
+typedef uint32_t bcrypt_words_t[BCRYPT_LANES][P_ARRAY_SIZE];
+
+static uint32_t lane_f(const bcrypt_s_t S, int g, uint32_t x) {
+#pragma HLS INLINE
+    return ((S[0][g][x >> 24] + S[1][g][(x >> 16) & 0xFF]) ^ S[2][g][(x >> 8) & 0xFF]) + S[3][g][x & 0xFF];
+}
+
+// Big-endian words of a cyclic byte stream, as Blowfish reads keys
+static void stream_words(const uint8_t *bytes, int len, uint32_t *words, int num_words) {
+#pragma HLS INLINE
+    int pos = 0;
+    STREAM: for (int i = 0; i < num_words; i++) {
+#pragma HLS PIPELINE II=4
+        uint32_t w = 0;
+        for (int j = 0; j < 4; j++) {
+            w = (w << 8) | bytes[pos];
+            pos = pos + 1 == len ? 0 : pos + 1;
+        }
+        words[i] = w;
+    }
+}
+
+// One EksBlowfish ExpandKey on every lane: XOR the 18 stream words in data
+// into P, then rewrite P and the S-boxes by chain encryption. When salted,
+// the 16-byte salt stream is XORed into the block before each encryption.
+static void eks_expand(bcrypt_p_t P, bcrypt_s_t S, const bcrypt_words_t data, const bcrypt_words_t salt,
+                       bool salted) {
+#pragma HLS INLINE off
+    uint32_t l[BCRYPT_LANES], r[BCRYPT_LANES];
+#pragma HLS ARRAY_PARTITION variable=l complete
+#pragma HLS ARRAY_PARTITION variable=r complete
+
+    XOR_P: for (int i = 0; i < P_ARRAY_SIZE; i++) {
+        for (int g = 0; g < BCRYPT_LANES; g++) {
+#pragma HLS PIPELINE II=1
+            P[g][i] ^= data[g][i];
+        }
+    }
+    for (int g = 0; g < BCRYPT_LANES; g++) {
 #pragma HLS UNROLL
-            state[i] = plaintext[block * 8 + i];
+        l[g] = 0;
+        r[g] = 0;
+    }
+
+    // 9 P-array pairs, then 512 S-box pairs
+    STEPS: for (int step = 0; step < (P_ARRAY_SIZE + NUM_SBOXES * SBOX_SIZE) / 2; step++) {
+        ROUNDS: for (int round = 0; round < NUM_ROUNDS; round++) {
+            LANES: for (int g = 0; g < BCRYPT_LANES; g++) {
+#pragma HLS PIPELINE II=1
+#pragma HLS DEPENDENCE variable=P inter false
+#pragma HLS DEPENDENCE variable=S inter false
+#pragma HLS DEPENDENCE variable=l inter false
+#pragma HLS DEPENDENCE variable=r inter false
+                uint32_t left = l[g], right = r[g];
+                if (round == 0 && salted) {
+                    left ^= salt[g][(2 * step) % 4];
+                    right ^= salt[g][(2 * step + 1) % 4];
+                }
+                left ^= P[g][round];
+                right ^= lane_f(S, g, left);
+
+                if (round < NUM_ROUNDS - 1) {
+                    l[g] = right;
+                    r[g] = left;
+                } else {
+                    // Last round: no swap, then the output whitening
+                    uint32_t out_l = left ^ P[g][NUM_ROUNDS + 1];
+                    uint32_t out_r = right ^ P[g][NUM_ROUNDS];
+                    l[g] = out_l;
+                    r[g] = out_r;
+                    if (step < P_ARRAY_SIZE / 2) {
+                        P[g][2 * step] = out_l;
+                        P[g][2 * step + 1] = out_r;
+                    } else {
+                        int idx = step - P_ARRAY_SIZE / 2;
+                        S[idx / (SBOX_SIZE / 2)][g][(idx % (SBOX_SIZE / 2)) * 2] = out_l;
+                        S[idx / (SBOX_SIZE / 2)][g][(idx % (SBOX_SIZE / 2)) * 2 + 1] = out_r;
+                    }
+                }
+            }
         }
+    }
+}
+
+void bcrypt_batch(const uint8_t *keys, const uint8_t *key_lens, const uint8_t *salts, uint8_t *hashes,
+                  int cost, int num_hashes) {
+#pragma HLS INTERFACE m_axi port=keys depth=576 offset=slave bundle=gmem0
+#pragma HLS INTERFACE m_axi port=key_lens depth=8 offset=slave bundle=gmem1
+#pragma HLS INTERFACE m_axi port=salts depth=128 offset=slave bundle=gmem2
+#pragma HLS INTERFACE m_axi port=hashes depth=192 offset=slave bundle=gmem3
+#pragma HLS INTERFACE s_axilite port=keys bundle=control
+#pragma HLS INTERFACE s_axilite port=key_lens bundle=control
+#pragma HLS INTERFACE s_axilite port=salts bundle=control
+#pragma HLS INTERFACE s_axilite port=hashes bundle=control
+#pragma HLS INTERFACE s_axilite port=cost bundle=control
+#pragma HLS INTERFACE s_axilite port=num_hashes bundle=control
+#pragma HLS INTERFACE s_axilite port=return bundle=control
+
+    bcrypt_p_t P;
+    bcrypt_s_t S;
+    bcrypt_words_t key_words, salt_words;
+#pragma HLS ARRAY_PARTITION variable=P dim=2 complete
+#pragma HLS ARRAY_PARTITION variable=S dim=1 complete
+#pragma HLS ARRAY_PARTITION variable=S dim=3 cyclic factor=2
+#pragma HLS ARRAY_PARTITION variable=key_words dim=2 complete
+#pragma HLS ARRAY_PARTITION variable=salt_words dim=2 complete
 
-        // Convert to two 32-bit halves
-        left = (state[0] << 24) | (state[1] << 16) | (state[2] << 8) | state[3];
-        right = (state[4] << 24) | (state[5] << 16) | (state[6] << 8) | state[7];
+    if (cost < BCRYPT_MIN_COST) cost = BCRYPT_MIN_COST;
+    if (cost > BCRYPT_MAX_COST) cost = BCRYPT_MAX_COST;
+
+    // Short final groups repeat their first hash in the spare lanes
+    GROUP_LOOP: for (int base = 0; base < num_hashes; base += BCRYPT_LANES) {
+        LOAD_LANES: for (int g = 0; g < BCRYPT_LANES; g++) {
+            int n = base + g < num_hashes ? base + g : base;
+            uint8_t key[BCRYPT_MAX_KEY_BYTES];
+            uint8_t salt[BCRYPT_SALT_BYTES];
+            int key_len = key_lens[n];
+            if (key_len < 1) key_len = 1;
+            if (key_len > BCRYPT_MAX_KEY_BYTES) key_len = BCRYPT_MAX_KEY_BYTES;
+            LOAD_KEY: for (int i = 0; i < BCRYPT_MAX_KEY_BYTES; i++) {
+#pragma HLS PIPELINE II=1
+                key[i] = keys[n * BCRYPT_MAX_KEY_BYTES + i];
+            }
+            LOAD_SALT: for (int i = 0; i < BCRYPT_SALT_BYTES; i++) {
+#pragma HLS PIPELINE II=1
+                salt[i] = salts[n * BCRYPT_SALT_BYTES + i];
+            }
+            stream_words(key, key_len, key_words[g], P_ARRAY_SIZE);
+            stream_words(salt, BCRYPT_SALT_BYTES, salt_words[g], P_ARRAY_SIZE);
 
-        // 16 rounds of Feistel network
-        ROUND_LOOP: for (int round = 0; round < NUM_ROUNDS; round++) {
+            INIT_P: for (int i = 0; i < P_ARRAY_SIZE; i++) {
+#pragma HLS UNROLL
+                P[g][i] = p_array[i];
+            }
+            INIT_S: for (int j = 0; j < SBOX_SIZE; j++) {
 #pragma HLS PIPELINE II=1
-            left ^= p_keys[round];
-            right ^= f_function(left);
-            uint32_t temp = left;
-            left = right;
-            right = temp;
+                for (int b = 0; b < NUM_SBOXES; b++) {
+                    S[b][g][j] = sbox[b][j];
+                }
+            }
         }
 
-        // Final swap and XOR
-        left ^= p_keys[NUM_ROUNDS];
-        right ^= p_keys[NUM_ROUNDS + 1];
+        // EksBlowfishSetup: salted expansion, then 2^cost rounds of
+        // expanding with the key and with the salt
+        eks_expand(P, S, key_words, salt_words, true);
+        COST_LOOP: for (uint32_t i = 0; i < (1u << cost); i++) {
+#pragma HLS LOOP_TRIPCOUNT min=16 max=4096
+            eks_expand(P, S, key_words, salt_words, false);
+            eks_expand(P, S, salt_words, salt_words, false);
+        }
 
-        // Store ciphertext
-        STORE_LOOP: for (int i = 0; i < 4; i++) {
+        // Encrypt "OrpheanBeholderScryDoubt" 64 times in ECB
+        const uint32_t magic[6] = {0x4f727068, 0x65616e42, 0x65686f6c, 0x64657253, 0x63727944, 0x6f756274};
+        uint32_t ct[BCRYPT_LANES][6];
+#pragma HLS ARRAY_PARTITION variable=ct complete dim=0
+        CT_INIT: for (int g = 0; g < BCRYPT_LANES; g++) {
+            for (int i = 0; i < 6; i++) {
 #pragma HLS UNROLL
-            ciphertext[block * 8 + i] = (right >> (24 - i * 8)) & 0xFF;
-            ciphertext[block * 8 + i + 4] = (left >> (24 - i * 8)) & 0xFF;
+                ct[g][i] = magic[i];
+            }
+        }
+        CT_REPEAT: for (int rep = 0; rep < 64; rep++) {
+            CT_BLOCKS: for (int blk = 0; blk < 3; blk++) {
+                CT_ROUNDS: for (int round = 0; round < NUM_ROUNDS; round++) {
+                    CT_LANES: for (int g = 0; g < BCRYPT_LANES; g++) {
+#pragma HLS PIPELINE II=1
+#pragma HLS DEPENDENCE variable=ct inter false
+                        uint32_t left = ct[g][2 * blk] ^ P[g][round];
+                        uint32_t right = ct[g][2 * blk + 1] ^ lane_f(S, g, left);
+                        if (round < NUM_ROUNDS - 1) {
+                            ct[g][2 * blk] = right;
+                            ct[g][2 * blk + 1] = left;
+                        } else {
+                            ct[g][2 * blk] = left ^ P[g][NUM_ROUNDS + 1];
+                            ct[g][2 * blk + 1] = right ^ P[g][NUM_ROUNDS];
+                        }
+                    }
+                }
+            }
+        }
+
+        STORE_LANES: for (int g = 0; g < BCRYPT_LANES; g++) {
+            if (base + g < num_hashes) {
+                STORE_HASH: for (int i = 0; i < BCRYPT_RAW_BYTES; i++) {
+#pragma HLS PIPELINE II=1
+                    hashes[(base + g) * BCRYPT_RAW_BYTES + i] = (ct[g][i / 4] >> (24 - (i % 4) * 8)) & 0xFF;
+                }
+            }
         }
     }
-}
\ No newline at end of file
+}
@@ -8,6 +8,36 @@
 #define NUM_SBOXES 4  // Four S-boxes
 #define SBOX_SIZE 256 // Each S-box has 256 entries
 #define P_ARRAY_SIZE 18 // 18 P-arrays for subkeys
+#define BLOWFISH_MAX_KEY_BYTES 56 // 448-bit keys
+
+// Expanded key schedule as stored by blowfish_key_setup: the P-array, then
+// the four S-boxes row by row
+#define BLOWFISH_CTX_WORDS (P_ARRAY_SIZE + NUM_SBOXES * SBOX_SIZE)
+
+// blowfish_crypt modes. The IV is the CBC chaining value or the first CTR
+// counter block (incremented as a 64-bit big-endian integer per block).
+enum blowfish_mode {
+    BF_MODE_ECB = 0,
+    BF_MODE_CBC = 1,
+    BF_MODE_CTR = 2
+};
+
+// bcrypt (EksBlowfish). The key is the password with its terminating NUL,
+// truncated to 72 bytes; the raw result is the six ciphertext words of
+// "OrpheanBeholderScryDoubt", of which the hash string encodes 23 bytes.
+#define BCRYPT_MAX_KEY_BYTES 72
+#define BCRYPT_SALT_BYTES 16
+#define BCRYPT_RAW_BYTES 24
+#define BCRYPT_MIN_COST 4
+#define BCRYPT_MAX_COST 31
+
+// Hashes interleaved in the bcrypt round pipeline. Each lane issues one
+// round every BCRYPT_LANES cycles, so this must cover the latency of a
+// round (P and S-box reads, add/xor) for the loop to reach II=1; set with
+// -DBCRYPT_LANES=<n>.
+#ifndef BCRYPT_LANES
+#define BCRYPT_LANES 8
+#endif
 
 // S-box and P-array declarations
 extern const uint32_t sbox[NUM_SBOXES][SBOX_SIZE];
@@ -15,6 +45,23 @@ extern const uint32_t p_array[P_ARRAY_SIZE];
 
 extern "C" {
     void blowfish_encrypt(const uint8_t *plaintext, const uint8_t *key, uint8_t *ciphertext, int num_blocks, int key_len);
+
+    // Split API: derive the schedule once, then encrypt or decrypt any
+    // number of messages with it. ctx_id names the schedule in ctx so the
+    // kernel can keep it on chip; pass a new id whenever ctx changes, or 0
+    // for a one-off launch that does not displace the cached schedule. A
+    // message split over launches continues with the last ciphertext block
+    // (CBC) or iv + blocks done (CTR) as the next iv.
+    void blowfish_key_setup(const uint8_t *key, int key_len, uint32_t *ctx);
+    void blowfish_crypt(const uint8_t *input, const uint32_t *ctx, uint32_t ctx_id, uint8_t *output, int num_blocks,
+                        int decrypt, int mode, uint64_t iv);
+
+    // num_hashes independent bcrypt hashes at 2^cost, BCRYPT_LANES at a
+    // time: keys are BCRYPT_MAX_KEY_BYTES apart with their lengths (1-72)
+    // in key_lens, salts BCRYPT_SALT_BYTES apart, and each result is
+    // BCRYPT_RAW_BYTES big-endian bytes.
+    void bcrypt_batch(const uint8_t *keys, const uint8_t *key_lens, const uint8_t *salts, uint8_t *hashes,
+                      int cost, int num_hashes);
 }
 
 #endif
\ No newline at end of file
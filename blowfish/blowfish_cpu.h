@@ -0,0 +1,417 @@
+#ifndef _BLOWFISH_CPU_H_
+#define _BLOWFISH_CPU_H_
+
+// CPU Blowfish: the reference the kernels are checked against and the
+// software baseline they are compared with. The initial P-array and S-boxes
+// are the tables in blowfish.cpp, so host builds link that file too.
+
+#include <stdint.h>
+#include <cstring>
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <atomic>
+#include "blowfish.h"
+
+// Key schedule. The four S-boxes are one contiguous 64-byte aligned 4 KB
+// block, so every lookup of every block lands in the same 64 cache lines
+// and the whole schedule stays in L1. P_dec is the P-array reversed:
+// decryption is the encryption network run over it.
+struct alignas(64) BlowfishSchedule {
+    uint32_t S[NUM_SBOXES][SBOX_SIZE];
+    uint32_t P[P_ARRAY_SIZE];
+    uint32_t P_dec[P_ARRAY_SIZE];
+};
+
+static inline uint32_t bf_f(const BlowfishSchedule& k, uint32_t x) {
+    return ((k.S[0][x >> 24] + k.S[1][(x >> 16) & 0xFF]) ^ k.S[2][(x >> 8) & 0xFF]) + k.S[3][x & 0xFF];
+}
+
+// 16 rounds with subkeys p (P or P_dec), fully unrolled and without the
+// half swap: odd rounds update r, even rounds l. Interleaving several
+// blocks by hand measured slower than letting the out-of-order core overlap
+// consecutive blocks.
+static inline void bf_crypt(const BlowfishSchedule& k, const uint32_t* p, uint32_t& l, uint32_t& r) {
+    l ^= p[0];
+#pragma GCC unroll 8
+    for (int i = 1; i < NUM_ROUNDS; i += 2) {
+        r ^= p[i] ^ bf_f(k, l);
+        l ^= p[i + 1] ^ bf_f(k, r);
+    }
+    uint32_t t = l;
+    l = r ^ p[NUM_ROUNDS + 1];
+    r = t;
+}
+
+static inline void bf_encrypt(const BlowfishSchedule& k, uint32_t& l, uint32_t& r) {
+    bf_crypt(k, k.P, l, r);
+}
+
+// Start of every key schedule: the pi-digit tables
+static inline void bf_init_schedule(BlowfishSchedule& k) {
+    std::memcpy(k.S, sbox, sizeof(k.S));
+    std::memcpy(k.P, p_array, sizeof(k.P));
+}
+
+// Cyclic big-endian word of a byte string, advancing pos
+static inline uint32_t bf_stream_word(const uint8_t* data, int len, int& pos) {
+    uint32_t w = 0;
+    for (int i = 0; i < 4; i++) {
+        w = (w << 8) | data[pos];
+        pos = pos + 1 == len ? 0 : pos + 1;
+    }
+    return w;
+}
+
+// Key mixing: XOR the key into P, then chain-encrypt the zero block over P
+// and the S-boxes
+static inline void bf_expand_key(BlowfishSchedule& k, const uint8_t* key, int key_len) {
+    int pos = 0;
+    for (int i = 0; i < P_ARRAY_SIZE; i++) k.P[i] ^= bf_stream_word(key, key_len, pos);
+
+    uint32_t l = 0, r = 0;
+    for (int i = 0; i < P_ARRAY_SIZE; i += 2) {
+        bf_encrypt(k, l, r);
+        k.P[i] = l;
+        k.P[i + 1] = r;
+    }
+    for (int s = 0; s < NUM_SBOXES; s++) {
+        for (int j = 0; j < SBOX_SIZE; j += 2) {
+            bf_encrypt(k, l, r);
+            k.S[s][j] = l;
+            k.S[s][j + 1] = r;
+        }
+    }
+}
+
+static inline void bf_finish_schedule(BlowfishSchedule& k) {
+    for (int i = 0; i < P_ARRAY_SIZE; i++) k.P_dec[i] = k.P[P_ARRAY_SIZE - 1 - i];
+}
+
+class BlowfishCPU {
+public:
+    // Buffers below this many blocks stay on the calling thread
+    static const size_t PARALLEL_THRESHOLD = 8192;
+
+private:
+    BlowfishSchedule k;
+
+    static uint64_t loadBlock(const uint8_t* p) {
+        uint64_t x = 0;
+        for (int i = 0; i < BLOCK_SIZE; i++) x = (x << 8) | p[i];
+        return x;
+    }
+
+    static void storeBlock(uint8_t* p, uint64_t x) {
+        for (int i = 0; i < BLOCK_SIZE; i++) p[i] = x >> (56 - 8 * i);
+    }
+
+    uint64_t cryptBlock(uint64_t x, bool decrypt) const {
+        uint32_t l = x >> 32, r = (uint32_t)x;
+        bf_crypt(k, decrypt ? k.P_dec : k.P, l, r);
+        return ((uint64_t)l << 32) | r;
+    }
+
+    // Blocks [first, first + count) of a block-parallel mode; chain is the
+    // ciphertext block before first (CBC decryption only). Each input block
+    // is read before its output is stored, so in == out works.
+    void processRange(const uint8_t* in, uint8_t* out, size_t first, size_t count, int mode, bool decrypt,
+                      uint64_t iv, uint64_t chain) const {
+        bool cipher_dec = decrypt && mode != BF_MODE_CTR;
+        for (size_t i = first; i < first + count; i++) {
+            uint64_t x = loadBlock(in + i * BLOCK_SIZE);
+            uint64_t y = cryptBlock(mode == BF_MODE_CTR ? iv + i : x, cipher_dec);
+            if (mode == BF_MODE_CTR) {
+                y ^= x;
+            } else if (mode == BF_MODE_CBC) {
+                y ^= chain;
+                chain = x;
+            }
+            storeBlock(out + i * BLOCK_SIZE, y);
+        }
+    }
+
+public:
+    BlowfishCPU(const uint8_t* key, int key_len) {
+        if (key_len < 1 || key_len > BLOWFISH_MAX_KEY_BYTES) {
+            throw std::runtime_error("Blowfish keys are 1 to 56 bytes");
+        }
+        bf_init_schedule(k);
+        bf_expand_key(k, key, key_len);
+        bf_finish_schedule(k);
+    }
+
+    // From / to the kernel's context layout (BLOWFISH_CTX_WORDS words)
+    explicit BlowfishCPU(const uint32_t* ctx) {
+        std::memcpy(k.P, ctx, sizeof(k.P));
+        std::memcpy(k.S, ctx + P_ARRAY_SIZE, sizeof(k.S));
+        bf_finish_schedule(k);
+    }
+
+    void exportContext(uint32_t* ctx) const {
+        std::memcpy(ctx, k.P, sizeof(k.P));
+        std::memcpy(ctx + P_ARRAY_SIZE, k.S, sizeof(k.S));
+    }
+
+    void encryptBlock(uint8_t block[BLOCK_SIZE]) const {
+        storeBlock(block, cryptBlock(loadBlock(block), false));
+    }
+
+    void decryptBlock(uint8_t block[BLOCK_SIZE]) const {
+        storeBlock(block, cryptBlock(loadBlock(block), true));
+    }
+
+    // ECB, CBC or CTR over num_blocks blocks with blowfish_crypt's iv
+    // convention. CBC encryption is inherently serial; every other case is
+    // split into contiguous ranges over num_threads workers (0 = all
+    // hardware threads) once the buffer passes PARALLEL_THRESHOLD.
+    void process(const uint8_t* in, uint8_t* out, size_t num_blocks, int mode, bool decrypt, uint64_t iv,
+                 unsigned num_threads = 1) const {
+        if (mode == BF_MODE_CBC && !decrypt) {
+            uint64_t chain = iv;
+            for (size_t i = 0; i < num_blocks; i++) {
+                chain = cryptBlock(loadBlock(in + i * BLOCK_SIZE) ^ chain, false);
+                storeBlock(out + i * BLOCK_SIZE, chain);
+            }
+            return;
+        }
+
+        if (num_threads == 0) num_threads = std::max(1u, std::thread::hardware_concurrency());
+        if (num_blocks < PARALLEL_THRESHOLD) num_threads = 1;
+        size_t per_thread = (num_blocks + num_threads - 1) / num_threads;
+        if (num_threads == 1) {
+            processRange(in, out, 0, num_blocks, mode, decrypt, iv, iv);
+            return;
+        }
+
+        // CBC chaining values at the range boundaries, read before any
+        // worker can overwrite them in place
+        std::vector<uint64_t> chains(num_threads, iv);
+        for (unsigned t = 1; t < num_threads; t++) {
+            size_t first = t * per_thread;
+            if (first < num_blocks && first > 0) chains[t] = loadBlock(in + (first - 1) * BLOCK_SIZE);
+        }
+
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; t < num_threads; t++) {
+            size_t first = t * per_thread;
+            if (first >= num_blocks) break;
+            size_t count = std::min(per_thread, num_blocks - first);
+            workers.emplace_back([=, &chains] {
+                processRange(in, out, first, count, mode, decrypt, iv, chains[t]);
+            });
+        }
+        for (auto& w : workers) w.join();
+    }
+};
+
+// bcrypt (EksBlowfish), $2b$ variant. An expansion is 521 encryptions,
+// each depending on the last, so a single hash keeps the core waiting on
+// S-box load latency with nothing to overlap it with (unlike block-parallel
+// modes). N hashes per thread are therefore interleaved round by round.
+
+template <int N>
+static inline void bf_crypt_lanes(BlowfishSchedule* const k[N], uint32_t l[N], uint32_t r[N]) {
+    for (int n = 0; n < N; n++) l[n] ^= k[n]->P[0];
+#pragma GCC unroll 8
+    for (int i = 1; i < NUM_ROUNDS; i += 2) {
+        for (int n = 0; n < N; n++) r[n] ^= k[n]->P[i] ^ bf_f(*k[n], l[n]);
+        for (int n = 0; n < N; n++) l[n] ^= k[n]->P[i + 1] ^ bf_f(*k[n], r[n]);
+    }
+    for (int n = 0; n < N; n++) {
+        uint32_t t = l[n];
+        l[n] = r[n] ^ k[n]->P[NUM_ROUNDS + 1];
+        r[n] = t;
+    }
+}
+
+// ExpandKey on N schedules: XOR the 18 stream words of data[n] into P, then
+// rewrite P and the S-boxes by chain encryption, XORing the salt stream
+// into each block first when salt is given
+template <int N>
+static inline void bf_eks_expand(BlowfishSchedule* const k[N], const uint32_t data[N][P_ARRAY_SIZE],
+                                 const uint32_t (*salt)[P_ARRAY_SIZE]) {
+    uint32_t l[N] = {0}, r[N] = {0};
+    for (int n = 0; n < N; n++) {
+        for (int i = 0; i < P_ARRAY_SIZE; i++) k[n]->P[i] ^= data[n][i];
+    }
+    for (int step = 0; step < (P_ARRAY_SIZE + NUM_SBOXES * SBOX_SIZE) / 2; step++) {
+        if (salt) {
+            for (int n = 0; n < N; n++) {
+                l[n] ^= salt[n][(2 * step) % 4];
+                r[n] ^= salt[n][(2 * step + 1) % 4];
+            }
+        }
+        bf_crypt_lanes<N>(k, l, r);
+        for (int n = 0; n < N; n++) {
+            uint32_t* out = step < P_ARRAY_SIZE / 2 ? &k[n]->P[2 * step] : &k[n]->S[0][0] + 2 * (step - P_ARRAY_SIZE / 2);
+            out[0] = l[n];
+            out[1] = r[n];
+        }
+    }
+}
+
+class BcryptCPU {
+public:
+    struct Job {
+        const uint8_t* key;  // Password bytes with the NUL, see makeKey
+        int key_len;
+        const uint8_t* salt;
+    };
+
+private:
+    static constexpr const char* B64 = "./ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789";
+
+    template <int N>
+    static void rawN(const Job* jobs, int cost, uint8_t* const out[N]) {
+        BlowfishSchedule sched[N];
+        BlowfishSchedule* k[N];
+        uint32_t key_words[N][P_ARRAY_SIZE], salt_words[N][P_ARRAY_SIZE];
+        for (int n = 0; n < N; n++) {
+            k[n] = &sched[n];
+            bf_init_schedule(sched[n]);
+            int pos = 0;
+            for (int i = 0; i < P_ARRAY_SIZE; i++) key_words[n][i] = bf_stream_word(jobs[n].key, jobs[n].key_len, pos);
+            pos = 0;
+            for (int i = 0; i < P_ARRAY_SIZE; i++) salt_words[n][i] = bf_stream_word(jobs[n].salt, BCRYPT_SALT_BYTES, pos);
+        }
+
+        bf_eks_expand<N>(k, key_words, salt_words);
+        for (uint64_t i = 0; i < (1ull << cost); i++) {
+            bf_eks_expand<N>(k, key_words, nullptr);
+            bf_eks_expand<N>(k, salt_words, nullptr);
+        }
+
+        // "OrpheanBeholderScryDoubt", encrypted 64 times
+        static const uint32_t magic[6] = {0x4f727068, 0x65616e42, 0x65686f6c, 0x64657253, 0x63727944, 0x6f756274};
+        for (int b = 0; b < 3; b++) {
+            uint32_t l[N], r[N];
+            for (int n = 0; n < N; n++) {
+                l[n] = magic[2 * b];
+                r[n] = magic[2 * b + 1];
+            }
+            for (int rep = 0; rep < 64; rep++) bf_crypt_lanes<N>(k, l, r);
+            for (int n = 0; n < N; n++) {
+                for (int i = 0; i < 4; i++) {
+                    out[n][8 * b + i] = l[n] >> (24 - 8 * i);
+                    out[n][8 * b + 4 + i] = r[n] >> (24 - 8 * i);
+                }
+            }
+        }
+    }
+
+    // count (<= N) jobs; spare lanes repeat the first job into scratch
+    template <int N>
+    static void rawGroup(const Job* jobs, int count, int cost, uint8_t* raw) {
+        Job group[N];
+        uint8_t scratch[BCRYPT_RAW_BYTES];
+        uint8_t* out[N];
+        for (int n = 0; n < N; n++) {
+            group[n] = jobs[n < count ? n : 0];
+            out[n] = n < count ? raw + n * BCRYPT_RAW_BYTES : scratch;
+        }
+        rawN<N>(group, cost, out);
+    }
+
+    static void base64(const uint8_t* data, int len, std::string& out) {
+        for (int i = 0; i < len; i += 3) {
+            uint32_t v = data[i] << 16 | (i + 1 < len ? data[i + 1] << 8 : 0) | (i + 2 < len ? data[i + 2] : 0);
+            int chars = len - i >= 3 ? 4 : len - i + 1;
+            for (int c = 0; c < chars; c++) out += B64[(v >> (18 - 6 * c)) & 0x3F];
+        }
+    }
+
+public:
+    // Password bytes plus the terminating NUL, truncated to 72 bytes ($2b$)
+    static std::vector<uint8_t> makeKey(const std::string& password) {
+        std::vector<uint8_t> key(password.begin(), password.end());
+        key.push_back(0);
+        if (key.size() > BCRYPT_MAX_KEY_BYTES) key.resize(BCRYPT_MAX_KEY_BYTES);
+        return key;
+    }
+
+    // The 24 raw bytes of one hash
+    static void raw(const Job& job, int cost, uint8_t out[BCRYPT_RAW_BYTES]) {
+        rawGroup<1>(&job, 1, cost, out);
+    }
+
+    // "$2b$<cost>$" + 22 salt characters + 31 hash characters
+    static std::string encode(int cost, const uint8_t salt[BCRYPT_SALT_BYTES], const uint8_t raw[BCRYPT_RAW_BYTES]) {
+        std::string s = "$2b$";
+        s += (char)('0' + cost / 10);
+        s += (char)('0' + cost % 10);
+        s += '$';
+        base64(salt, BCRYPT_SALT_BYTES, s);
+        base64(raw, BCRYPT_RAW_BYTES - 1, s);
+        return s;
+    }
+
+    // Cost and salt of a "$2a$"/"$2b$"/"$2y$" hash or setting string
+    static void parse(const std::string& setting, int& cost, uint8_t salt[BCRYPT_SALT_BYTES]) {
+        if (setting.size() < 29 || setting[0] != '$' || setting[1] != '2' || setting[3] != '$' || setting[6] != '$') {
+            throw std::runtime_error("not a bcrypt setting: " + setting);
+        }
+        cost = (setting[4] - '0') * 10 + (setting[5] - '0');
+        if (cost < BCRYPT_MIN_COST || cost > BCRYPT_MAX_COST) throw std::runtime_error("bcrypt cost out of range");
+        uint32_t bits = 0;
+        int num_bits = 0, n = 0;
+        for (int i = 7; i < 29 && n < BCRYPT_SALT_BYTES; i++) {
+            const char* p = std::strchr(B64, setting[i]);
+            if (!p || !*p) throw std::runtime_error("bad bcrypt salt character");
+            bits = (bits << 6) | (uint32_t)(p - B64);
+            num_bits += 6;
+            if (num_bits >= 8) {
+                num_bits -= 8;
+                salt[n++] = bits >> num_bits;
+            }
+        }
+    }
+
+    static std::string hash(const std::string& password, const std::string& setting) {
+        int cost;
+        uint8_t salt[BCRYPT_SALT_BYTES], out[BCRYPT_RAW_BYTES];
+        parse(setting, cost, salt);
+        std::vector<uint8_t> key = makeKey(password);
+        raw({key.data(), (int)key.size(), salt}, cost, out);
+        return setting.substr(0, 7) + encode(cost, salt, out).substr(7);
+    }
+
+    // Hash every job into raw + i * BCRYPT_RAW_BYTES on num_threads
+    // workers (0 = all hardware threads), each taking lanes (1, 2, 4 or 8)
+    // hashes at a time from a shared counter. Four lanes measured ~1.7x one;
+    // eight schedules no longer fit L1 and gain little over four.
+    static void batch(const std::vector<Job>& jobs, int cost, uint8_t* raw, unsigned num_threads = 0, int lanes = 4) {
+        if (cost < BCRYPT_MIN_COST || cost > BCRYPT_MAX_COST) throw std::runtime_error("bcrypt cost out of range");
+        if (lanes != 1 && lanes != 2 && lanes != 4 && lanes != 8) throw std::runtime_error("lanes must be 1, 2, 4 or 8");
+        for (const Job& job : jobs) {
+            if (job.key_len < 1 || job.key_len > BCRYPT_MAX_KEY_BYTES) {
+                throw std::runtime_error("bcrypt keys are 1 to 72 bytes");
+            }
+        }
+        // Arguments are checked above: nothing below throws on a worker thread
+        if (num_threads == 0) num_threads = std::max(1u, std::thread::hardware_concurrency());
+        std::atomic<size_t> next(0);
+        auto worker = [&] {
+            for (;;) {
+                size_t first = next.fetch_add(lanes);
+                if (first >= jobs.size()) break;
+                int count = (int)std::min<size_t>(lanes, jobs.size() - first);
+                uint8_t* out = raw + first * BCRYPT_RAW_BYTES;
+                switch (lanes) {
+                    case 1: rawGroup<1>(&jobs[first], count, cost, out); break;
+                    case 2: rawGroup<2>(&jobs[first], count, cost, out); break;
+                    case 4: rawGroup<4>(&jobs[first], count, cost, out); break;
+                    default: rawGroup<8>(&jobs[first], count, cost, out); break;
+                }
+            }
+        };
+        std::vector<std::thread> workers;
+        for (unsigned t = 1; t < num_threads; t++) workers.emplace_back(worker);
+        worker();
+        for (auto& w : workers) w.join();
+    }
+};
+
+#endif
@@ -1,6 +1,8 @@
 #include <iostream>
 #include <iomanip>
 #include <cstring>
+#include <string>
+#include <algorithm>
 #include "blowfish.h"
 
 #define NUM_TEST_BLOCKS 4
@@ -62,27 +64,191 @@ int main() {
         std::cout << std::endl;
     }
 
-    // Basic validation
-    std::cout << "\n=== Basic Validation ===" << std::endl;
-    bool different = false;
-    for (int i = 0; i < NUM_TEST_BLOCKS * 8; i++) {
-        if (test_plaintext[i] != ciphertext[i]) {
-            different = true;
-            break;
-        }
+    // Known-answer check
+    std::cout << "\n=== Validation ===" << std::endl;
+    const uint8_t expected[NUM_TEST_BLOCKS * 8] = {
+        0xc7, 0x04, 0xca, 0x5e, 0xea, 0xac, 0xe9, 0x33,
+        0xd0, 0x04, 0x21, 0x96, 0xb1, 0x13, 0x08, 0xea,
+        0x1b, 0xcf, 0xe8, 0x6f, 0x71, 0xe2, 0xc7, 0x55,
+        0x0b, 0x36, 0x91, 0x4f, 0x7b, 0x48, 0xe9, 0x8e
+    };
+    bool kat_ok = std::memcmp(ciphertext, expected, sizeof(expected)) == 0;
+    std::cout << (kat_ok ? "✓" : "✗") << " 128-bit key known answer" << std::endl;
+
+    // Eric Young's 64-bit key vectors
+    struct { uint64_t key, plain, cipher; } ey[] = {
+        {0x0000000000000000ULL, 0x0000000000000000ULL, 0x4ef997456198dd78ULL},
+        {0xffffffffffffffffULL, 0xffffffffffffffffULL, 0x51866fd5b85ecb8aULL},
+        {0x0123456789abcdefULL, 0x1111111111111111ULL, 0x61f9c3802281b096ULL},
+        {0xfedcba9876543210ULL, 0x0123456789abcdefULL, 0x0aceab0fc6a0a28dULL}
+    };
+    auto to_bytes = [](uint64_t v, uint8_t out[8]) {
+        for (int i = 0; i < 8; i++) out[i] = v >> (56 - 8 * i);
+    };
+    bool ey_ok = true;
+    for (auto& v : ey) {
+        uint8_t k[8], p[8], c[8], out[8];
+        to_bytes(v.key, k);
+        to_bytes(v.plain, p);
+        to_bytes(v.cipher, c);
+        blowfish_encrypt(p, k, out, 1, 8);
+        ey_ok &= std::memcmp(out, c, 8) == 0;
+    }
+    std::cout << (ey_ok ? "✓" : "✗") << " 64-bit key vectors" << std::endl;
+
+    // Split API: one schedule, many launches
+    std::cout << "\n=== Key Setup / Cached Context ===" << std::endl;
+    static uint32_t ctx1[BLOWFISH_CTX_WORDS], ctx2[BLOWFISH_CTX_WORDS];
+    uint8_t key2[8];
+    to_bytes(ey[2].key, key2);
+    blowfish_key_setup(test_key, key_len, ctx1);
+    blowfish_key_setup(key2, 8, ctx2);
+
+    uint8_t out[NUM_TEST_BLOCKS * 8], back[NUM_TEST_BLOCKS * 8], block[8], ey_plain[8], ey_cipher[8];
+    to_bytes(ey[2].plain, ey_plain);
+    to_bytes(ey[2].cipher, ey_cipher);
+
+    blowfish_crypt(test_plaintext, ctx1, 1, out, NUM_TEST_BLOCKS, 0, BF_MODE_ECB, 0);
+    bool split_ok = std::memcmp(out, expected, sizeof(expected)) == 0;
+    blowfish_crypt(expected, ctx1, 1, back, NUM_TEST_BLOCKS, 1, BF_MODE_ECB, 0);
+    bool decrypt_ok = std::memcmp(back, test_plaintext, sizeof(back)) == 0;
+    std::cout << (split_ok ? "✓" : "✗") << " blowfish_crypt matches blowfish_encrypt" << std::endl;
+    std::cout << (decrypt_ok ? "✓" : "✗") << " decryption restores the plaintext" << std::endl;
+
+    // Switching ids reloads; a repeated id keeps the on-chip schedule even
+    // if the buffer behind it changed
+    blowfish_crypt(ey_plain, ctx2, 2, block, 1, 0, BF_MODE_ECB, 0);
+    bool switch_ok = std::memcmp(block, ey_cipher, 8) == 0;
+    blowfish_crypt(ey_plain, ctx1, 2, block, 1, 0, BF_MODE_ECB, 0);
+    bool cached_ok = std::memcmp(block, ey_cipher, 8) == 0;
+    blowfish_crypt(ey_plain, ctx1, 0, block, 1, 0, BF_MODE_ECB, 0);
+    uint8_t kept[8];
+    blowfish_crypt(ey_plain, ctx1, 2, kept, 1, 0, BF_MODE_ECB, 0);
+    bool kept_ok = std::memcmp(kept, ey_cipher, 8) == 0;
+    blowfish_crypt(block, ctx1, 1, back, 1, 1, BF_MODE_ECB, 0);
+    bool reload_ok = std::memcmp(back, ey_plain, 8) == 0;
+    std::cout << (switch_ok ? "✓" : "✗") << " new ctx_id reloads the schedule" << std::endl;
+    std::cout << (cached_ok ? "✓" : "✗") << " same ctx_id reuses the cached schedule" << std::endl;
+    std::cout << (reload_ok ? "✓" : "✗") << " ctx_id 0 forces a reload" << std::endl;
+    std::cout << (kept_ok ? "✓" : "✗") << " ctx_id 0 leaves the cached schedule in place" << std::endl;
+
+    // Chaining modes: Eric Young's CBC vector (same key as above) and CTR
+    // from the same IV, including a counter that wraps
+    std::cout << "\n=== CBC / CTR ===" << std::endl;
+    const uint64_t iv = 0xfedcba9876543210ULL;
+    const char message[] = "7654321 Now is the time for ";
+    uint8_t mode_plain[32] = {0};
+    std::memcpy(mode_plain, message, sizeof(message));
+    const uint8_t cbc_expected[32] = {
+        0x6b, 0x77, 0xb4, 0xd6, 0x30, 0x06, 0xde, 0xe6, 0x05, 0xb1, 0x56, 0xe2, 0x74, 0x03, 0x97, 0x93,
+        0x58, 0xde, 0xb9, 0xe7, 0x15, 0x46, 0x16, 0xd9, 0x59, 0xf1, 0x65, 0x2b, 0xd5, 0xff, 0x92, 0xcc
+    };
+    const uint8_t ctr_expected[32] = {
+        0xe7, 0x32, 0x14, 0xa2, 0x82, 0x21, 0x39, 0xca, 0x60, 0x25, 0x47, 0x40, 0xdd, 0x8c, 0x5b, 0x8a,
+        0xcf, 0x5e, 0x95, 0x69, 0xc4, 0xaf, 0xfe, 0xb9, 0x44, 0xb8, 0xfc, 0x02, 0x0e, 0x32, 0xaf, 0x8d
+    };
+    const uint8_t ctr_wrap_expected[32] = {
+        0x08, 0x6e, 0x03, 0x07, 0x42, 0xf3, 0x5f, 0xf4, 0x4f, 0xba, 0xc3, 0xe1, 0x1a, 0x13, 0x0f, 0x61,
+        0x6f, 0x95, 0xdb, 0x5a, 0xeb, 0x62, 0xfd, 0x90, 0xd7, 0x61, 0xa2, 0xe0, 0x1d, 0x32, 0x98, 0x07
+    };
+    uint8_t mode_out[32], mode_back[32];
+
+    blowfish_crypt(mode_plain, ctx1, 1, mode_out, 4, 0, BF_MODE_CBC, iv);
+    blowfish_crypt(mode_out, ctx1, 1, mode_back, 4, 1, BF_MODE_CBC, iv);
+    bool cbc_ok = std::memcmp(mode_out, cbc_expected, 32) == 0 && std::memcmp(mode_back, mode_plain, 32) == 0;
+
+    // CBC split over two launches chains through the last ciphertext block
+    uint64_t next_iv = 0;
+    for (int i = 0; i < 8; i++) next_iv = (next_iv << 8) | cbc_expected[8 + i];
+    blowfish_crypt(mode_plain, ctx1, 1, mode_out, 2, 0, BF_MODE_CBC, iv);
+    blowfish_crypt(mode_plain + 16, ctx1, 1, mode_out + 16, 2, 0, BF_MODE_CBC, next_iv);
+    cbc_ok &= std::memcmp(mode_out, cbc_expected, 32) == 0;
+
+    blowfish_crypt(mode_plain, ctx1, 1, mode_out, 4, 0, BF_MODE_CTR, iv);
+    blowfish_crypt(mode_out, ctx1, 1, mode_back, 4, 1, BF_MODE_CTR, iv);
+    bool ctr_ok = std::memcmp(mode_out, ctr_expected, 32) == 0 && std::memcmp(mode_back, mode_plain, 32) == 0;
+    blowfish_crypt(mode_plain, ctx1, 1, mode_out, 4, 0, BF_MODE_CTR, 0xfffffffffffffffeULL);
+    ctr_ok &= std::memcmp(mode_out, ctr_wrap_expected, 32) == 0;
+
+    std::cout << (cbc_ok ? "✓" : "✗") << " CBC encrypt/decrypt (known answer, split launches)" << std::endl;
+    std::cout << (ctr_ok ? "✓" : "✗") << " CTR encrypt/decrypt (known answer, counter wrap)" << std::endl;
+
+    // bcrypt: OpenWall test vectors (key = password + NUL, first 72 bytes)
+    std::cout << "\n=== bcrypt ===" << std::endl;
+    struct BcryptVector {
+        const char* password;
+        int cost;
+        uint8_t salt[BCRYPT_SALT_BYTES];
+        uint8_t raw[BCRYPT_RAW_BYTES];
+    };
+    const BcryptVector bcrypt_vectors[] = {
+        {"U*U", 5,
+         {0x10, 0x41, 0x04, 0x10, 0x41, 0x04, 0x10, 0x41, 0x04, 0x10, 0x41, 0x04, 0x10, 0x41, 0x04, 0x10},
+         {0x1b, 0xb6, 0x91, 0x43, 0xf9, 0xa8, 0xd3, 0x04, 0xc8, 0xd2, 0x3d, 0x99,
+          0xab, 0x04, 0x9a, 0x77, 0xa6, 0x8e, 0x2c, 0xcc, 0x74, 0x42, 0x06, 0xbb}},
+        {"U*U*", 5,
+         {0x10, 0x41, 0x04, 0x10, 0x41, 0x04, 0x10, 0x41, 0x04, 0x10, 0x41, 0x04, 0x10, 0x41, 0x04, 0x10},
+         {0x5c, 0x84, 0x35, 0x0b, 0xdf, 0xba, 0xa9, 0x6a, 0xc1, 0x6f, 0x61, 0x5a,
+          0xe7, 0x9f, 0x35, 0xcf, 0xda, 0xcd, 0x68, 0x2d, 0x36, 0x9f, 0x23, 0x89}},
+        {"U*U*U", 5,
+         {0x65, 0x96, 0x59, 0x65, 0x96, 0x59, 0x65, 0x96, 0x59, 0x65, 0x96, 0x59, 0x65, 0x96, 0x59, 0x65},
+         {0x09, 0xe6, 0x73, 0xa3, 0xf9, 0xa5, 0x44, 0x81, 0x8e, 0xb8, 0xdd, 0x69,
+          0xa8, 0xcb, 0x28, 0xb3, 0x2f, 0x6f, 0x7b, 0xe6, 0x04, 0xcf, 0xa7, 0x10}},
+        {"0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789chars after 72 are ignored", 5,
+         {0x71, 0xd7, 0x9f, 0x82, 0x18, 0xa3, 0x92, 0x59, 0xa7, 0xa2, 0x9a, 0xab, 0xb2, 0xdb, 0xaf, 0xc3},
+         {0xee, 0xee, 0x31, 0xf8, 0x09, 0x19, 0x92, 0x04, 0x25, 0x88, 0x10, 0x02,
+          0xd1, 0x40, 0xd5, 0x55, 0xb2, 0x8a, 0x5c, 0x72, 0xe0, 0x0f, 0x09, 0x7d}},
+        {"", 6,
+         {0x14, 0x4b, 0x3d, 0x69, 0x1a, 0x7b, 0x4e, 0xcf, 0x39, 0xcf, 0x73, 0x5c, 0x7f, 0xa7, 0xa7, 0x9c},
+         {0x55, 0x7e, 0x94, 0xf3, 0x4b, 0xf2, 0x86, 0xe8, 0x71, 0x9a, 0x26, 0xbe,
+          0x94, 0xac, 0x1e, 0x16, 0xd9, 0x5e, 0xf9, 0xf8, 0x19, 0xde, 0xe0, 0x92}}
+    };
+    const int num_bcrypt = sizeof(bcrypt_vectors) / sizeof(bcrypt_vectors[0]);
+
+    static uint8_t bc_keys[num_bcrypt * BCRYPT_MAX_KEY_BYTES];
+    uint8_t bc_lens[num_bcrypt], bc_salts[num_bcrypt * BCRYPT_SALT_BYTES], bc_out[num_bcrypt * BCRYPT_RAW_BYTES];
+    for (int i = 0; i < num_bcrypt; i++) {
+        int len = std::min<int>(std::strlen(bcrypt_vectors[i].password) + 1, BCRYPT_MAX_KEY_BYTES);
+        std::memcpy(&bc_keys[i * BCRYPT_MAX_KEY_BYTES], bcrypt_vectors[i].password, len);
+        bc_lens[i] = len;
+        std::memcpy(&bc_salts[i * BCRYPT_SALT_BYTES], bcrypt_vectors[i].salt, BCRYPT_SALT_BYTES);
+    }
+
+    // The four cost-5 hashes in one partly filled group, then the cost-6 one
+    bcrypt_batch(bc_keys, bc_lens, bc_salts, bc_out, 5, 4);
+    bcrypt_batch(&bc_keys[4 * BCRYPT_MAX_KEY_BYTES], &bc_lens[4], &bc_salts[4 * BCRYPT_SALT_BYTES],
+                 &bc_out[4 * BCRYPT_RAW_BYTES], 6, 1);
+    bool bcrypt_ok = true;
+    for (int i = 0; i < num_bcrypt; i++) {
+        bool ok = std::memcmp(&bc_out[i * BCRYPT_RAW_BYTES], bcrypt_vectors[i].raw, BCRYPT_RAW_BYTES) == 0;
+        std::cout << (ok ? "✓" : "✗") << " cost " << std::dec << bcrypt_vectors[i].cost << ", password \""
+                  << std::string(bcrypt_vectors[i].password).substr(0, 16)
+                  << (std::strlen(bcrypt_vectors[i].password) > 16 ? "...\"" : "\"") << std::endl;
+        bcrypt_ok &= ok;
+    }
+
+    // II=1 model: every lane-round is one cycle, so a pipeline finishes one
+    // hash per (2^(cost+1) + 1) expansions of 521 encryptions
+    std::cout << "Modelled throughput per pipeline at 300 MHz:" << std::endl;
+    for (int cost = 10; cost <= 12; cost++) {
+        double cycles = ((2.0 * (1 << cost)) + 1) * (P_ARRAY_SIZE + NUM_SBOXES * SBOX_SIZE) / 2 * NUM_ROUNDS;
+        std::cout << "  cost " << cost << ": " << std::fixed << std::setprecision(1) << 300e6 / cycles
+                  << " hashes/s" << std::endl;
     }
 
-    if (different) {
-        std::cout << "✓ Encryption completed! Ciphertext differs from plaintext." << std::endl;
+    if (kat_ok && ey_ok && split_ok && decrypt_ok && switch_ok && cached_ok && reload_ok && kept_ok && cbc_ok && ctr_ok && bcrypt_ok) {
+        std::cout << "\n✓ All tests passed!" << std::endl;
         std::cout << "\n=== Performance Features ===" << std::endl;
         std::cout << "• F-function: Pipelined with S-box lookups" << std::endl;
         std::cout << "• Subkey Generation: Optimized with unrolled loops" << std::endl;
-        std::cout << "• Block processing: Pipelined with II=1" << std::endl;
+        std::cout << "• Key schedule: Computed once by blowfish_key_setup, cached on chip by blowfish_crypt" << std::endl;
+        std::cout << "• Block processing: Pipelined with II=1 (ECB, CTR, CBC decryption)" << std::endl;
+        std::cout << "• bcrypt: " << BCRYPT_LANES << " hashes interleaved in one II=1 round pipeline" << std::endl;
         std::cout << "• Memory interfaces: AXI4 with separate bundles" << std::endl;
         std::cout << "• Arrays: Partitioned for parallel access" << std::endl;
         return 0;
     } else {
-        std::cout << "✗ Encryption failed! Ciphertext same as plaintext." << std::endl;
+        std::cout << "\n✗ Some tests failed!" << std::endl;
         return 1;
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,601 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <array>
+
+// XRT includes for Xilinx Runtime
+#include "xrt/xrt_bo.h"
+#include "xrt/xrt_device.h"
+#include "xrt/xrt_kernel.h"
+
+#include "blowfish_cpu.h"
+
+// Expanded Blowfish key schedule. words is the host copy (it can be saved
+// and loaded back with BlowfishHost::loadContext); bo holds it on the
+// device, and id is what blowfish_crypt caches the on-chip copy by.
+struct BlowfishContext {
+    uint32_t id = 0;
+    std::vector<uint32_t> words;
+    xrt::bo bo;
+};
+
+class BlowfishHost {
+private:
+    xrt::device device;
+    xrt::kernel kernel;
+    xrt::kernel kernel_setup, kernel_crypt;
+    xrt::kernel kernel_bcrypt;
+    xrt::bo bo_plaintext, bo_key, bo_ciphertext;
+    xrt::bo bo_setup_key, bo_in, bo_out;
+    xrt::bo bo_bc_keys, bo_bc_lens, bo_bc_salts, bo_bc_hashes;
+    int max_blocks = 0;
+    int max_hashes = 0;
+    bool has_split = false;
+    bool has_bcrypt = false;
+    uint32_t next_ctx_id = 1;
+
+    static void checkKey(int key_len) {
+        if (key_len < 1 || key_len > BLOWFISH_MAX_KEY_BYTES) {
+            throw std::runtime_error("Blowfish keys are 1 to 56 bytes");
+        }
+    }
+
+public:
+    BlowfishHost(const std::string& xclbin_path, int device_id = 0) {
+        try {
+            device = xrt::device(device_id);
+            auto uuid = device.load_xclbin(xclbin_path);
+            kernel = xrt::kernel(device, uuid, "blowfish_encrypt");
+            try {
+                kernel_setup = xrt::kernel(device, uuid, "blowfish_key_setup");
+                kernel_crypt = xrt::kernel(device, uuid, "blowfish_crypt");
+                has_split = true;
+            } catch (const std::exception&) {
+                // Older xclbins only carry blowfish_encrypt
+            }
+            // setupKey writes the schedule where blowfish_crypt reads it
+            if (has_split && kernel_setup.group_id(2) != kernel_crypt.group_id(1)) {
+                throw std::runtime_error("blowfish_key_setup ctx and blowfish_crypt ctx are in different memory banks");
+            }
+            try {
+                kernel_bcrypt = xrt::kernel(device, uuid, "bcrypt_batch");
+                has_bcrypt = true;
+            } catch (const std::exception&) {
+                // bcrypt_batch is optional
+            }
+            std::cout << "✓ Blowfish Hardware accelerator initialized successfully" << std::endl;
+        } catch (const std::exception& e) {
+            std::cerr << "Error initializing Blowfish accelerator: " << e.what() << std::endl;
+            throw;
+        }
+    }
+
+    void allocateBuffers(int blocks) {
+        try {
+            max_blocks = blocks;
+            bo_plaintext = xrt::bo(device, blocks * BLOCK_SIZE, kernel.group_id(0));
+            bo_key = xrt::bo(device, BLOWFISH_MAX_KEY_BYTES, kernel.group_id(1));
+            bo_ciphertext = xrt::bo(device, blocks * BLOCK_SIZE, kernel.group_id(2));
+            if (has_split) {
+                bo_setup_key = xrt::bo(device, BLOWFISH_MAX_KEY_BYTES, kernel_setup.group_id(0));
+                bo_in = xrt::bo(device, blocks * BLOCK_SIZE, kernel_crypt.group_id(0));
+                bo_out = xrt::bo(device, blocks * BLOCK_SIZE, kernel_crypt.group_id(3));
+            }
+            if (has_bcrypt) {
+                max_hashes = 64 * BCRYPT_LANES;
+                bo_bc_keys = xrt::bo(device, max_hashes * BCRYPT_MAX_KEY_BYTES, kernel_bcrypt.group_id(0));
+                bo_bc_lens = xrt::bo(device, max_hashes, kernel_bcrypt.group_id(1));
+                bo_bc_salts = xrt::bo(device, max_hashes * BCRYPT_SALT_BYTES, kernel_bcrypt.group_id(2));
+                bo_bc_hashes = xrt::bo(device, max_hashes * BCRYPT_RAW_BYTES, kernel_bcrypt.group_id(3));
+            }
+            std::cout << "✓ Buffers allocated: " << blocks << " blocks" << std::endl;
+        } catch (const std::exception& e) {
+            std::cerr << "Error allocating buffers: " << e.what() << std::endl;
+            throw;
+        }
+    }
+
+    bool canSplit() const { return has_split; }
+    bool canBcrypt() const { return has_bcrypt; }
+
+    // One-shot ECB encryption on blowfish_encrypt: the key schedule is
+    // derived again by every launch. Returns seconds including transfers.
+    double encrypt(const uint8_t* plaintext, const uint8_t* key, int key_len, uint8_t* ciphertext, int num_blocks) {
+        checkKey(key_len);
+        auto start = std::chrono::high_resolution_clock::now();
+        std::memcpy(bo_key.map<uint8_t*>(), key, key_len);
+        bo_key.sync(XCL_BO_SYNC_BO_TO_DEVICE, key_len, 0);
+        for (int begin = 0; begin < num_blocks; begin += max_blocks) {
+            int count = std::min(max_blocks, num_blocks - begin);
+            size_t bytes = (size_t)count * BLOCK_SIZE;
+            std::memcpy(bo_plaintext.map<uint8_t*>(), plaintext + begin * BLOCK_SIZE, bytes);
+            bo_plaintext.sync(XCL_BO_SYNC_BO_TO_DEVICE, bytes, 0);
+            auto run = kernel(bo_plaintext, bo_key, bo_ciphertext, count, key_len);
+            run.wait();
+            bo_ciphertext.sync(XCL_BO_SYNC_BO_FROM_DEVICE, bytes, 0);
+            std::memcpy(ciphertext + begin * BLOCK_SIZE, bo_ciphertext.map<uint8_t*>(), bytes);
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double>(end - start).count();
+    }
+
+    // Derive a key schedule on the device. The schedule stays in ctx.bo for
+    // blowfish_crypt and is also read back into ctx.words.
+    BlowfishContext setupKey(const uint8_t* key, int key_len) {
+        if (!has_split) throw std::runtime_error("xclbin lacks blowfish_key_setup");
+        checkKey(key_len);
+        BlowfishContext ctx;
+        ctx.id = next_ctx_id++;
+        ctx.bo = xrt::bo(device, BLOWFISH_CTX_WORDS * sizeof(uint32_t), kernel_crypt.group_id(1));
+
+        std::memcpy(bo_setup_key.map<uint8_t*>(), key, key_len);
+        bo_setup_key.sync(XCL_BO_SYNC_BO_TO_DEVICE, key_len, 0);
+        auto run = kernel_setup(bo_setup_key, key_len, ctx.bo);
+        run.wait();
+
+        ctx.bo.sync(XCL_BO_SYNC_BO_FROM_DEVICE);
+        const uint32_t* words = ctx.bo.map<uint32_t*>();
+        ctx.words.assign(words, words + BLOWFISH_CTX_WORDS);
+        return ctx;
+    }
+
+    // Put a stored schedule (e.g. from an earlier setupKey) on the device
+    BlowfishContext loadContext(const std::vector<uint32_t>& words) {
+        if (!has_split) throw std::runtime_error("xclbin lacks blowfish_crypt");
+        if (words.size() != BLOWFISH_CTX_WORDS) throw std::runtime_error("context must be 1042 words");
+        BlowfishContext ctx;
+        ctx.id = next_ctx_id++;
+        ctx.words = words;
+        ctx.bo = xrt::bo(device, BLOWFISH_CTX_WORDS * sizeof(uint32_t), kernel_crypt.group_id(1));
+        std::memcpy(ctx.bo.map<uint32_t*>(), words.data(), BLOWFISH_CTX_WORDS * sizeof(uint32_t));
+        ctx.bo.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+        return ctx;
+    }
+
+    // ECB, CBC or CTR (blowfish_mode) under a stored schedule. With cached
+    // set the kernel keeps the schedule on chip between launches that use
+    // the same context; without it every launch reloads the 1042 words from
+    // ctx.bo. Buffers longer than max_blocks are split over launches with
+    // the IV carried across; input and output may be the same buffer.
+    double crypt(const BlowfishContext& ctx, const uint8_t* input, uint8_t* output, int num_blocks, int mode,
+                 bool decrypt, uint64_t iv = 0, bool cached = true) {
+        if (!has_split) throw std::runtime_error("xclbin lacks blowfish_crypt");
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int begin = 0; begin < num_blocks; begin += max_blocks) {
+            int count = std::min(max_blocks, num_blocks - begin);
+            size_t bytes = (size_t)count * BLOCK_SIZE;
+            std::memcpy(bo_in.map<uint8_t*>(), input + begin * BLOCK_SIZE, bytes);
+            bo_in.sync(XCL_BO_SYNC_BO_TO_DEVICE, bytes, 0);
+            auto run = kernel_crypt(bo_in, ctx.bo, cached ? ctx.id : 0u, bo_out, count, decrypt ? 1 : 0, mode, iv);
+            run.wait();
+            bo_out.sync(XCL_BO_SYNC_BO_FROM_DEVICE, bytes, 0);
+
+            // The next CBC IV is the last ciphertext block of this chunk,
+            // taken from the device buffers so in-place calls still see it
+            if (mode == BF_MODE_CTR) {
+                iv += count;
+            } else if (mode == BF_MODE_CBC) {
+                const uint8_t* last = (decrypt ? bo_in : bo_out).map<uint8_t*>() + (count - 1) * BLOCK_SIZE;
+                iv = 0;
+                for (int i = 0; i < BLOCK_SIZE; i++) iv = (iv << 8) | last[i];
+            }
+            std::memcpy(output + begin * BLOCK_SIZE, bo_out.map<uint8_t*>(), bytes);
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double>(end - start).count();
+    }
+
+    // Raw bcrypt hashes of jobs on bcrypt_batch, BCRYPT_RAW_BYTES per job
+    // into raw. Batches larger than the buffers are split over launches; a
+    // multiple of BCRYPT_LANES keeps every lane of the kernel busy.
+    double bcryptBatch(const std::vector<BcryptCPU::Job>& jobs, int cost, uint8_t* raw) {
+        if (!has_bcrypt) throw std::runtime_error("xclbin lacks bcrypt_batch");
+        if (cost < BCRYPT_MIN_COST || cost > BCRYPT_MAX_COST) throw std::runtime_error("bcrypt cost out of range");
+        auto start = std::chrono::high_resolution_clock::now();
+        for (size_t begin = 0; begin < jobs.size(); begin += max_hashes) {
+            int count = (int)std::min<size_t>(max_hashes, jobs.size() - begin);
+            uint8_t* keys = bo_bc_keys.map<uint8_t*>();
+            uint8_t* lens = bo_bc_lens.map<uint8_t*>();
+            uint8_t* salts = bo_bc_salts.map<uint8_t*>();
+            for (int i = 0; i < count; i++) {
+                const BcryptCPU::Job& job = jobs[begin + i];
+                if (job.key_len < 1 || job.key_len > BCRYPT_MAX_KEY_BYTES) {
+                    throw std::runtime_error("bcrypt keys are 1 to 72 bytes");
+                }
+                std::memcpy(keys + i * BCRYPT_MAX_KEY_BYTES, job.key, job.key_len);
+                lens[i] = job.key_len;
+                std::memcpy(salts + i * BCRYPT_SALT_BYTES, job.salt, BCRYPT_SALT_BYTES);
+            }
+            bo_bc_keys.sync(XCL_BO_SYNC_BO_TO_DEVICE, count * BCRYPT_MAX_KEY_BYTES, 0);
+            bo_bc_lens.sync(XCL_BO_SYNC_BO_TO_DEVICE, count, 0);
+            bo_bc_salts.sync(XCL_BO_SYNC_BO_TO_DEVICE, count * BCRYPT_SALT_BYTES, 0);
+            auto run = kernel_bcrypt(bo_bc_keys, bo_bc_lens, bo_bc_salts, bo_bc_hashes, cost, count);
+            run.wait();
+            bo_bc_hashes.sync(XCL_BO_SYNC_BO_FROM_DEVICE, count * BCRYPT_RAW_BYTES, 0);
+            std::memcpy(raw + begin * BCRYPT_RAW_BYTES, bo_bc_hashes.map<uint8_t*>(), count * BCRYPT_RAW_BYTES);
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double>(end - start).count();
+    }
+
+    ~BlowfishHost() {
+        std::cout << "✓ Blowfish Host cleanup completed" << std::endl;
+    }
+};
+
+void printHex(const std::string& label, const uint8_t* data, int size) {
+    std::cout << label << ": ";
+    for (int i = 0; i < size; i++) {
+        std::cout << std::hex << std::setw(2) << std::setfill('0') << (int)data[i];
+    }
+    std::cout << std::dec << std::setfill(' ') << std::endl;
+}
+
+static void toBytes(uint64_t v, uint8_t out[8]) {
+    for (int i = 0; i < 8; i++) out[i] = v >> (56 - 8 * i);
+}
+
+// Eric Young's 64-bit key vectors through both APIs, decryption, and a
+// schedule stored on the host and loaded back
+bool runTestVectors(BlowfishHost& bf) {
+    std::cout << "\n=== Blowfish Test Vectors ===" << std::endl;
+    struct { uint64_t key, plain, cipher; } vectors[] = {
+        {0x0000000000000000ULL, 0x0000000000000000ULL, 0x4ef997456198dd78ULL},
+        {0xffffffffffffffffULL, 0xffffffffffffffffULL, 0x51866fd5b85ecb8aULL},
+        {0x0123456789abcdefULL, 0x1111111111111111ULL, 0x61f9c3802281b096ULL},
+        {0xfedcba9876543210ULL, 0x0123456789abcdefULL, 0x0aceab0fc6a0a28dULL},
+        {0x7ca110454a1a6e57ULL, 0x01a1d6d039776742ULL, 0x59c68245eb05282bULL}
+    };
+
+    bool all_passed = true;
+    for (auto& v : vectors) {
+        uint8_t key[8], plain[8], cipher[8], out[8];
+        toBytes(v.key, key);
+        toBytes(v.plain, plain);
+        toBytes(v.cipher, cipher);
+
+        bf.encrypt(plain, key, 8, out, 1);
+        bool passed = std::memcmp(out, cipher, 8) == 0;
+        if (bf.canSplit()) {
+            BlowfishContext ctx = bf.setupKey(key, 8);
+            bf.crypt(ctx, plain, out, 1, BF_MODE_ECB, false);
+            passed &= std::memcmp(out, cipher, 8) == 0;
+            bf.crypt(ctx, cipher, out, 1, BF_MODE_ECB, true);
+            passed &= std::memcmp(out, plain, 8) == 0;
+
+            BlowfishContext copy = bf.loadContext(ctx.words);
+            bf.crypt(copy, plain, out, 1, BF_MODE_ECB, false);
+            passed &= std::memcmp(out, cipher, 8) == 0;
+        }
+
+        BlowfishCPU cpu(key, 8);
+        std::memcpy(out, plain, 8);
+        cpu.encryptBlock(out);
+        passed &= std::memcmp(out, cipher, 8) == 0;
+        cpu.decryptBlock(out);
+        passed &= std::memcmp(out, plain, 8) == 0;
+        printHex("Key", key, 8);
+        std::cout << "  " << (passed ? "✓ PASSED" : "✗ FAILED") << std::endl;
+        all_passed &= passed;
+    }
+    return all_passed;
+}
+
+static const char* modeName(int mode) {
+    return mode == BF_MODE_ECB ? "ECB" : mode == BF_MODE_CBC ? "CBC" : "CTR";
+}
+
+// Every mode in both directions: kernel against the CPU engine on random
+// data spanning several launches, CPU multi-threaded against single-threaded,
+// in-place processing on both, and the kernel's key schedule against the CPU's
+bool runModeTests(BlowfishHost& bf) {
+    std::cout << "\n=== Modes (kernel vs CPU) ===" << std::endl;
+    std::mt19937 rng(49);
+    uint8_t key[16];
+    for (auto& b : key) b = rng();
+    BlowfishCPU cpu(key, sizeof(key));
+
+    // Eric Young's CBC vector on the CPU engine
+    const uint8_t ey_key[16] = {0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef,
+                                0xf0, 0xe1, 0xd2, 0xc3, 0xb4, 0xa5, 0x96, 0x87};
+    const uint8_t ey_cbc[32] = {
+        0x6b, 0x77, 0xb4, 0xd6, 0x30, 0x06, 0xde, 0xe6, 0x05, 0xb1, 0x56, 0xe2, 0x74, 0x03, 0x97, 0x93,
+        0x58, 0xde, 0xb9, 0xe7, 0x15, 0x46, 0x16, 0xd9, 0x59, 0xf1, 0x65, 0x2b, 0xd5, 0xff, 0x92, 0xcc
+    };
+    uint8_t ey_plain[32] = "7654321 Now is the time for ";
+    uint8_t ey_out[32];
+    BlowfishCPU(ey_key, 16).process(ey_plain, ey_out, 4, BF_MODE_CBC, false, 0xfedcba9876543210ULL);
+    bool all_passed = std::memcmp(ey_out, ey_cbc, 32) == 0;
+    std::cout << "CPU CBC known answer: " << (all_passed ? "✓ PASSED" : "✗ FAILED") << std::endl;
+
+    // Two launches' worth plus a partial one
+    int blocks = 2 * 4096 + 777;
+    if (blocks < (int)BlowfishCPU::PARALLEL_THRESHOLD) blocks = BlowfishCPU::PARALLEL_THRESHOLD;
+    std::vector<uint8_t> plain(blocks * BLOCK_SIZE), cpu_out(plain.size()), mt_out(plain.size());
+    std::vector<uint8_t> fpga_out(plain.size()), back(plain.size());
+    for (auto& b : plain) b = rng();
+    uint64_t iv = ((uint64_t)rng() << 32) | rng();
+
+    BlowfishContext ctx;
+    if (bf.canSplit()) {
+        ctx = bf.setupKey(key, sizeof(key));
+        std::vector<uint32_t> words(BLOWFISH_CTX_WORDS);
+        cpu.exportContext(words.data());
+        bool schedule_ok = words == ctx.words;
+        std::cout << "Key schedule (kernel vs CPU): " << (schedule_ok ? "✓ PASSED" : "✗ FAILED") << std::endl;
+        all_passed &= schedule_ok;
+    }
+
+    for (int mode : {BF_MODE_ECB, BF_MODE_CBC, BF_MODE_CTR}) {
+        for (bool decrypt : {false, true}) {
+            const uint8_t* input = decrypt ? cpu_out.data() : plain.data();
+            std::vector<uint8_t>& result = decrypt ? back : cpu_out;
+            cpu.process(input, result.data(), blocks, mode, decrypt, iv);
+            // Three workers, so range boundaries are exercised on any machine
+            cpu.process(input, mt_out.data(), blocks, mode, decrypt, iv, 3);
+            bool passed = mt_out == result;
+
+            std::vector<uint8_t> in_place(input, input + plain.size());
+            cpu.process(in_place.data(), in_place.data(), blocks, mode, decrypt, iv, 3);
+            passed &= in_place == result;
+
+            if (bf.canSplit()) {
+                bf.crypt(ctx, input, fpga_out.data(), blocks, mode, decrypt, iv);
+                passed &= fpga_out == result;
+
+                in_place.assign(input, input + plain.size());
+                bf.crypt(ctx, in_place.data(), in_place.data(), blocks, mode, decrypt, iv);
+                passed &= in_place == result;
+            }
+            if (decrypt) passed &= back == plain;
+
+            std::cout << modeName(mode) << (decrypt ? " decrypt: " : " encrypt: ")
+                      << (passed ? "✓ PASSED" : "✗ FAILED") << std::endl;
+            all_passed &= passed;
+        }
+    }
+    return all_passed;
+}
+
+// MB/s per mode and direction: the CPU engine at 1, 2, 4, ... hardware
+// threads and the kernel with a cached schedule
+void runThroughputTest(BlowfishHost& bf) {
+    std::cout << "\n=== Throughput (MB/s, 4 MB buffer) ===" << std::endl;
+    const int blocks = 4 * 1024 * 1024 / BLOCK_SIZE;
+    std::vector<uint8_t> in(blocks * BLOCK_SIZE), out(in.size());
+    std::mt19937 rng(490);
+    for (auto& b : in) b = rng();
+    uint8_t key[16];
+    for (auto& b : key) b = rng();
+    BlowfishCPU cpu(key, sizeof(key));
+    BlowfishContext ctx;
+    if (bf.canSplit()) ctx = bf.setupKey(key, sizeof(key));
+
+    unsigned max_threads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<unsigned> thread_counts;
+    for (unsigned t = 1; t < max_threads; t *= 2) thread_counts.push_back(t);
+    thread_counts.push_back(max_threads);
+
+    std::cout << std::setw(12) << "Mode";
+    for (unsigned t : thread_counts) std::cout << std::setw(10) << ("CPU x" + std::to_string(t));
+    std::cout << std::setw(10) << "FPGA" << std::endl;
+
+    double mb = in.size() / (1024.0 * 1024.0);
+    for (int mode : {BF_MODE_ECB, BF_MODE_CBC, BF_MODE_CTR}) {
+        for (bool decrypt : {false, true}) {
+            std::cout << std::setw(12) << (std::string(modeName(mode)) + (decrypt ? " dec" : " enc"));
+            std::cout << std::fixed << std::setprecision(1);
+            for (unsigned t : thread_counts) {
+                auto start = std::chrono::high_resolution_clock::now();
+                cpu.process(in.data(), out.data(), blocks, mode, decrypt, 1, t);
+                auto end = std::chrono::high_resolution_clock::now();
+                std::cout << std::setw(10) << mb / std::chrono::duration<double>(end - start).count();
+            }
+            if (bf.canSplit()) {
+                std::cout << std::setw(10) << mb / bf.crypt(ctx, in.data(), out.data(), blocks, mode, decrypt, 1);
+            } else {
+                std::cout << std::setw(10) << "-";
+            }
+            std::cout << std::endl;
+        }
+    }
+    std::cout << "(CBC encryption is serial: one thread, and one block per block latency in the kernel)" << std::endl;
+}
+
+// Messages/s for one launch per message: the one-shot kernel (schedule
+// derived per launch), blowfish_crypt reloading the stored schedule, and
+// blowfish_crypt with the schedule cached on chip
+void runMessageBenchmark(BlowfishHost& bf) {
+    std::cout << "\n=== Per-Message Throughput (messages/s) ===" << std::endl;
+    if (!bf.canSplit()) {
+        std::cout << "blowfish_key_setup/blowfish_crypt not in xclbin, skipped" << std::endl;
+        return;
+    }
+
+    std::mt19937 rng(48);
+    std::vector<uint8_t> key(16);
+    for (auto& b : key) b = rng();
+    BlowfishContext ctx = bf.setupKey(key.data(), (int)key.size());
+
+    const int sizes[] = {64, 256, 1024, 4096};
+    const int num_messages = 200;
+    std::cout << std::setw(8) << "Bytes" << std::setw(14) << "One-shot" << std::setw(14) << "Ctx reload"
+              << std::setw(14) << "Ctx cached" << std::setw(10) << "Speedup" << std::endl;
+
+    for (int size : sizes) {
+        int blocks = size / BLOCK_SIZE;
+        std::vector<uint8_t> plain(size), one_shot(size), reload(size), cached(size);
+        for (auto& b : plain) b = rng();
+
+        // One loop per variant, so the cached runs follow only cached runs
+        double t_one_shot = 0, t_reload = 0, t_cached = 0;
+        for (int m = 0; m < num_messages; m++) {
+            t_one_shot += bf.encrypt(plain.data(), key.data(), (int)key.size(), one_shot.data(), blocks);
+        }
+        for (int m = 0; m < num_messages; m++) {
+            t_reload += bf.crypt(ctx, plain.data(), reload.data(), blocks, BF_MODE_ECB, false, 0, false);
+        }
+        for (int m = 0; m < num_messages; m++) {
+            t_cached += bf.crypt(ctx, plain.data(), cached.data(), blocks, BF_MODE_ECB, false);
+        }
+        if (one_shot != reload || one_shot != cached) {
+            throw std::runtime_error("blowfish_crypt output differs from blowfish_encrypt");
+        }
+
+        std::cout << std::setw(8) << size << std::fixed << std::setprecision(1) << std::setw(14)
+                  << num_messages / t_one_shot << std::setw(14) << num_messages / t_reload << std::setw(14)
+                  << num_messages / t_cached << std::setw(9) << t_one_shot / t_cached << "x" << std::endl;
+    }
+}
+
+// OpenWall bcrypt vectors: hash strings through the CPU engine, and the
+// whole set as one batch on bcrypt_batch
+bool runBcryptTests(BlowfishHost& bf) {
+    std::cout << "\n=== bcrypt Test Vectors ===" << std::endl;
+    struct { const char* password; const char* hash; } vectors[] = {
+        {"U*U", "$2a$05$CCCCCCCCCCCCCCCCCCCCC.E5YPO9kmyuRGyh0XouQYb4YMJKvyOeW"},
+        {"U*U*", "$2a$05$CCCCCCCCCCCCCCCCCCCCC.VGOzA784oUp/Z0DY336zx7pLYAy0lwK"},
+        {"U*U*U", "$2a$05$XXXXXXXXXXXXXXXXXXXXXOAcXxm9kjPGEMsLznoKqmqw7tc8WCx4a"},
+        {"0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789chars after 72 are ignored",
+         "$2a$05$abcdefghijklmnopqrstuu5s2v8.iXieOjg/.AySBTTZIIVFJeBui"},
+        {"", "$2a$06$DCq7YPn5Rq63x1Lad4cll.TV4S6ytwfsfvkgY8jIucDrjc8deX1s."},
+    };
+
+    bool all_passed = true;
+    for (const auto& v : vectors) {
+        bool passed = BcryptCPU::hash(v.password, v.hash) == v.hash;
+        std::cout << (passed ? "✓" : "✗") << " CPU  " << v.hash << std::endl;
+        all_passed &= passed;
+    }
+    if (!bf.canBcrypt()) {
+        std::cout << "bcrypt_batch not in xclbin, kernel check skipped" << std::endl;
+        return all_passed;
+    }
+
+    // The kernel takes one cost per launch
+    for (int cost : {5, 6}) {
+        std::vector<std::vector<uint8_t>> keys;
+        std::vector<std::array<uint8_t, BCRYPT_SALT_BYTES>> salts;
+        std::vector<std::string> expected;
+        for (const auto& v : vectors) {
+            std::array<uint8_t, BCRYPT_SALT_BYTES> salt;
+            int v_cost;
+            BcryptCPU::parse(v.hash, v_cost, salt.data());
+            if (v_cost != cost) continue;
+            keys.push_back(BcryptCPU::makeKey(v.password));
+            salts.push_back(salt);
+            expected.push_back(v.hash);
+        }
+        std::vector<BcryptCPU::Job> jobs;
+        for (size_t i = 0; i < keys.size(); i++) jobs.push_back({keys[i].data(), (int)keys[i].size(), salts[i].data()});
+        std::vector<uint8_t> raw(jobs.size() * BCRYPT_RAW_BYTES);
+        bf.bcryptBatch(jobs, cost, raw.data());
+        for (size_t i = 0; i < jobs.size(); i++) {
+            std::string hash = expected[i].substr(0, 7) +
+                               BcryptCPU::encode(cost, salts[i].data(), &raw[i * BCRYPT_RAW_BYTES]).substr(7);
+            bool passed = hash == expected[i];
+            std::cout << (passed ? "✓" : "✗") << " FPGA " << hash << std::endl;
+            all_passed &= passed;
+        }
+    }
+    return all_passed;
+}
+
+// Hashes/s at cost 10-12: the CPU engine on one thread with one hash and
+// with several interleaved per thread, on all threads, and the kernel with
+// one batch of BCRYPT_LANES hashes (cross-checked against the CPU)
+void runBcryptBenchmark(BlowfishHost& bf) {
+    std::cout << "\n=== bcrypt Throughput (hashes/s) ===" << std::endl;
+    const int lane_counts[] = {1, 2, 4, 8};
+    unsigned max_threads = std::max(1u, std::thread::hardware_concurrency());
+
+    std::cout << std::setw(6) << "Cost";
+    for (int lanes : lane_counts) std::cout << std::setw(12) << ("CPU 1x" + std::to_string(lanes));
+    std::cout << std::setw(12) << ("CPU x" + std::to_string(max_threads)) << std::setw(12) << "FPGA" << std::endl;
+
+    std::mt19937 rng(50);
+    for (int cost = 10; cost <= 12; cost++) {
+        // Enough hashes for every thread to fill its lanes
+        int num_hashes = (int)std::max<unsigned>(BCRYPT_LANES, 4 * max_threads);
+        std::vector<std::vector<uint8_t>> keys(num_hashes);
+        std::vector<uint8_t> salts(num_hashes * BCRYPT_SALT_BYTES);
+        for (auto& b : salts) b = rng();
+        std::vector<BcryptCPU::Job> jobs;
+        for (int i = 0; i < num_hashes; i++) {
+            keys[i] = BcryptCPU::makeKey("password" + std::to_string(rng() % 100000));
+            jobs.push_back({keys[i].data(), (int)keys[i].size(), &salts[i * BCRYPT_SALT_BYTES]});
+        }
+        std::vector<uint8_t> cpu_raw(num_hashes * BCRYPT_RAW_BYTES), fpga_raw(cpu_raw.size());
+
+        std::cout << std::setw(6) << cost << std::fixed << std::setprecision(2);
+        for (int lanes : lane_counts) {
+            std::vector<BcryptCPU::Job> group(jobs.begin(), jobs.begin() + lanes);
+            auto start = std::chrono::high_resolution_clock::now();
+            BcryptCPU::batch(group, cost, cpu_raw.data(), 1, lanes);
+            auto end = std::chrono::high_resolution_clock::now();
+            std::cout << std::setw(12) << lanes / std::chrono::duration<double>(end - start).count();
+        }
+        auto start = std::chrono::high_resolution_clock::now();
+        BcryptCPU::batch(jobs, cost, cpu_raw.data(), max_threads);
+        auto end = std::chrono::high_resolution_clock::now();
+        std::cout << std::setw(12) << num_hashes / std::chrono::duration<double>(end - start).count();
+
+        if (bf.canBcrypt()) {
+            std::vector<BcryptCPU::Job> batch(jobs.begin(), jobs.begin() + BCRYPT_LANES);
+            double t = bf.bcryptBatch(batch, cost, fpga_raw.data());
+            if (std::memcmp(fpga_raw.data(), cpu_raw.data(), BCRYPT_LANES * BCRYPT_RAW_BYTES) != 0) {
+                throw std::runtime_error("bcrypt_batch output differs from the CPU engine");
+            }
+            std::cout << std::setw(12) << BCRYPT_LANES / t;
+        } else {
+            std::cout << std::setw(12) << "-";
+        }
+        std::cout << std::endl;
+    }
+    std::cout << "(CPU 1xN: one thread with N hashes interleaved; FPGA: one batch of " << BCRYPT_LANES
+              << " lanes)" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <xclbin_path> [device_id]" << std::endl;
+        std::cerr << "Example: " << argv[0] << " blowfish.xclbin 0" << std::endl;
+        return 1;
+    }
+
+    std::string xclbin_path = argv[1];
+    int device_id = (argc > 2) ? std::atoi(argv[2]) : 0;
+
+    try {
+        std::cout << "=== Blowfish Hardware Accelerator Host Application ===" << std::endl;
+        std::cout << "XCLBIN: " << xclbin_path << std::endl;
+        std::cout << "Device ID: " << device_id << std::endl;
+
+        BlowfishHost bf(xclbin_path, device_id);
+        bf.allocateBuffers(4096);
+
+        if (!runTestVectors(bf) || !runModeTests(bf) || !runBcryptTests(bf)) {
+            std::cerr << "Verification failed" << std::endl;
+            return 1;
+        }
+        runMessageBenchmark(bf);
+        runThroughputTest(bf);
+        runBcryptBenchmark(bf);
+
+        std::cout << "\n=== All tests completed successfully! ===" << std::endl;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Application failed: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
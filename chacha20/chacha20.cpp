@@ -142,4 +142,504 @@ void chacha20_encrypt(const uint8_t *plaintext, const uint8_t *key,
                 plaintext[block * CHACHA20_BLOCK_SIZE + i] ^ keystream_bytes[i];
         }
     }
-}
\ No newline at end of file
+}
+
+// Poly1305 accumulator step h = (h + m) * r mod 2^130 - 5 on radix-2^26
+// limbs. Every 26x26-bit partial product fits a DSP multiplier, and the
+// reduction by 2^130 == 5 is folded into the precomputed r*5 limbs.
+// AEAD input is always padded to whole 16-byte chunks, so the 2^128 pad
+// bit is set for every chunk.
+static void poly1305_block(uint32_t h[5], const uint32_t r[5], const uint8_t m[POLY1305_BLOCK_SIZE]) {
+#pragma HLS INLINE
+    uint32_t t0 = le32_to_cpu(m + 0);
+    uint32_t t1 = le32_to_cpu(m + 4);
+    uint32_t t2 = le32_to_cpu(m + 8);
+    uint32_t t3 = le32_to_cpu(m + 12);
+
+    h[0] += t0 & 0x3ffffff;
+    h[1] += ((t0 >> 26) | (t1 << 6)) & 0x3ffffff;
+    h[2] += ((t1 >> 20) | (t2 << 12)) & 0x3ffffff;
+    h[3] += ((t2 >> 14) | (t3 << 18)) & 0x3ffffff;
+    h[4] += (t3 >> 8) | (1 << 24);
+
+    uint32_t s1 = r[1] * 5, s2 = r[2] * 5, s3 = r[3] * 5, s4 = r[4] * 5;
+
+    uint64_t d0 = (uint64_t)h[0] * r[0] + (uint64_t)h[1] * s4 + (uint64_t)h[2] * s3 + (uint64_t)h[3] * s2 + (uint64_t)h[4] * s1;
+    uint64_t d1 = (uint64_t)h[0] * r[1] + (uint64_t)h[1] * r[0] + (uint64_t)h[2] * s4 + (uint64_t)h[3] * s3 + (uint64_t)h[4] * s2;
+    uint64_t d2 = (uint64_t)h[0] * r[2] + (uint64_t)h[1] * r[1] + (uint64_t)h[2] * r[0] + (uint64_t)h[3] * s4 + (uint64_t)h[4] * s3;
+    uint64_t d3 = (uint64_t)h[0] * r[3] + (uint64_t)h[1] * r[2] + (uint64_t)h[2] * r[1] + (uint64_t)h[3] * r[0] + (uint64_t)h[4] * s4;
+    uint64_t d4 = (uint64_t)h[0] * r[4] + (uint64_t)h[1] * r[3] + (uint64_t)h[2] * r[2] + (uint64_t)h[3] * r[1] + (uint64_t)h[4] * r[0];
+
+    // Partial carry: limbs end below 2^26 except h1, which may be 2^26 + small
+    uint32_t c;
+    c = (uint32_t)(d0 >> 26); h[0] = (uint32_t)d0 & 0x3ffffff;
+    d1 += c; c = (uint32_t)(d1 >> 26); h[1] = (uint32_t)d1 & 0x3ffffff;
+    d2 += c; c = (uint32_t)(d2 >> 26); h[2] = (uint32_t)d2 & 0x3ffffff;
+    d3 += c; c = (uint32_t)(d3 >> 26); h[3] = (uint32_t)d3 & 0x3ffffff;
+    d4 += c; c = (uint32_t)(d4 >> 26); h[4] = (uint32_t)d4 & 0x3ffffff;
+    h[0] += c * 5; c = h[0] >> 26; h[0] &= 0x3ffffff;
+    h[1] += c;
+}
+
+// Fully reduce h mod 2^130 - 5 and return tag = (h + s) mod 2^128
+static void poly1305_finish(uint32_t h[5], const uint8_t s[16], uint8_t *tag) {
+#pragma HLS INLINE
+    uint32_t c;
+    c = h[1] >> 26; h[1] &= 0x3ffffff;
+    h[2] += c; c = h[2] >> 26; h[2] &= 0x3ffffff;
+    h[3] += c; c = h[3] >> 26; h[3] &= 0x3ffffff;
+    h[4] += c; c = h[4] >> 26; h[4] &= 0x3ffffff;
+    h[0] += c * 5; c = h[0] >> 26; h[0] &= 0x3ffffff;
+    h[1] += c;
+
+    // g = h - p; keep g if it did not borrow
+    uint32_t g[5];
+    g[0] = h[0] + 5; c = g[0] >> 26; g[0] &= 0x3ffffff;
+    g[1] = h[1] + c; c = g[1] >> 26; g[1] &= 0x3ffffff;
+    g[2] = h[2] + c; c = g[2] >> 26; g[2] &= 0x3ffffff;
+    g[3] = h[3] + c; c = g[3] >> 26; g[3] &= 0x3ffffff;
+    g[4] = h[4] + c - (1 << 26);
+
+    uint32_t mask = (g[4] >> 31) - 1;   // all ones when h >= p
+    for (int i = 0; i < 5; i++) {
+#pragma HLS UNROLL
+        h[i] = (h[i] & ~mask) | (g[i] & mask);
+    }
+
+    // Repack to 4 x 32 bits and add s
+    uint32_t w0 = h[0] | (h[1] << 26);
+    uint32_t w1 = (h[1] >> 6) | (h[2] << 20);
+    uint32_t w2 = (h[2] >> 12) | (h[3] << 14);
+    uint32_t w3 = (h[3] >> 18) | (h[4] << 8);
+
+    uint64_t f;
+    f = (uint64_t)w0 + le32_to_cpu(s + 0);            cpu_to_le32(tag + 0, (uint32_t)f);
+    f = (uint64_t)w1 + le32_to_cpu(s + 4) + (f >> 32); cpu_to_le32(tag + 4, (uint32_t)f);
+    f = (uint64_t)w2 + le32_to_cpu(s + 8) + (f >> 32); cpu_to_le32(tag + 8, (uint32_t)f);
+    f = (uint64_t)w3 + le32_to_cpu(s + 12) + (f >> 32); cpu_to_le32(tag + 12, (uint32_t)f);
+}
+
+// Fused ChaCha20-Poly1305 (RFC 8439). Keystream block 0 supplies the
+// one-time Poly1305 key; payload blocks start at counter 1. Each 64-byte
+// block is XORed and its four ciphertext chunks are absorbed into the MAC
+// in the same pass, so the data is read from global memory once. With
+// decrypt set the MAC covers the input rather than the output; the tag is
+// always computed, and the host compares it before releasing plaintext.
+void chacha20_poly1305(const uint8_t *input, const uint8_t *aad,
+                       const uint8_t *key, const uint8_t *nonce,
+                       uint8_t *output, uint8_t *tag,
+                       int aad_len, int msg_len, int decrypt) {
+#pragma HLS INTERFACE m_axi port=input depth=128 offset=slave bundle=gmem0
+#pragma HLS INTERFACE m_axi port=aad depth=16 offset=slave bundle=gmem1
+#pragma HLS INTERFACE m_axi port=key depth=32 offset=slave bundle=gmem1
+#pragma HLS INTERFACE m_axi port=nonce depth=12 offset=slave bundle=gmem1
+#pragma HLS INTERFACE m_axi port=output depth=128 offset=slave bundle=gmem2
+#pragma HLS INTERFACE m_axi port=tag depth=16 offset=slave bundle=gmem1
+#pragma HLS INTERFACE s_axilite port=input bundle=control
+#pragma HLS INTERFACE s_axilite port=aad bundle=control
+#pragma HLS INTERFACE s_axilite port=key bundle=control
+#pragma HLS INTERFACE s_axilite port=nonce bundle=control
+#pragma HLS INTERFACE s_axilite port=output bundle=control
+#pragma HLS INTERFACE s_axilite port=tag bundle=control
+#pragma HLS INTERFACE s_axilite port=aad_len bundle=control
+#pragma HLS INTERFACE s_axilite port=msg_len bundle=control
+#pragma HLS INTERFACE s_axilite port=decrypt bundle=control
+#pragma HLS INTERFACE s_axilite port=return bundle=control
+
+    uint8_t key_local[CHACHA20_KEY_SIZE];
+    uint8_t nonce_local[CHACHA20_NONCE_SIZE];
+    for (int i = 0; i < CHACHA20_KEY_SIZE; i++) {
+#pragma HLS PIPELINE II=1
+        key_local[i] = key[i];
+    }
+    for (int i = 0; i < CHACHA20_NONCE_SIZE; i++) {
+#pragma HLS PIPELINE II=1
+        nonce_local[i] = nonce[i];
+    }
+
+    uint32_t state[16];
+    uint32_t keystream[16];
+#pragma HLS ARRAY_PARTITION variable=state complete
+#pragma HLS ARRAY_PARTITION variable=keystream complete
+
+    // One-time key: r (clamped) || s from keystream block 0
+    uint8_t otk[POLY1305_KEY_SIZE];
+    chacha20_init_state(state, key_local, nonce_local, 0);
+    chacha20_block(state, keystream);
+    for (int i = 0; i < 8; i++) {
+#pragma HLS UNROLL
+        cpu_to_le32(&otk[i * 4], keystream[i]);
+    }
+
+    uint32_t r[5], h[5];
+#pragma HLS ARRAY_PARTITION variable=r complete
+#pragma HLS ARRAY_PARTITION variable=h complete
+    r[0] = (le32_to_cpu(otk + 0)) & 0x3ffffff;
+    r[1] = (le32_to_cpu(otk + 3) >> 2) & 0x3ffff03;
+    r[2] = (le32_to_cpu(otk + 6) >> 4) & 0x3ffc0ff;
+    r[3] = (le32_to_cpu(otk + 9) >> 6) & 0x3f03fff;
+    r[4] = (le32_to_cpu(otk + 12) >> 8) & 0x00fffff;
+    for (int i = 0; i < 5; i++) {
+#pragma HLS UNROLL
+        h[i] = 0;
+    }
+
+    // AAD, zero-padded to 16 bytes
+    uint8_t chunk[POLY1305_BLOCK_SIZE];
+    AAD_LOOP: for (int off = 0; off < aad_len; off += POLY1305_BLOCK_SIZE) {
+        for (int i = 0; i < POLY1305_BLOCK_SIZE; i++) {
+#pragma HLS PIPELINE II=1
+            chunk[i] = (off + i < aad_len) ? aad[off + i] : 0;
+        }
+        poly1305_block(h, r, chunk);
+    }
+
+    // Encrypt/decrypt and MAC the ciphertext, one 64-byte block per pass
+    int num_blocks = (msg_len + CHACHA20_BLOCK_SIZE - 1) / CHACHA20_BLOCK_SIZE;
+    AEAD_BLOCK_LOOP: for (int block = 0; block < num_blocks; block++) {
+        chacha20_init_state(state, key_local, nonce_local, 1 + block);
+        chacha20_block(state, keystream);
+
+        uint8_t keystream_bytes[CHACHA20_BLOCK_SIZE];
+        uint8_t ct[CHACHA20_BLOCK_SIZE];
+        for (int i = 0; i < 16; i++) {
+#pragma HLS UNROLL
+            cpu_to_le32(&keystream_bytes[i * 4], keystream[i]);
+        }
+
+        int base = block * CHACHA20_BLOCK_SIZE;
+        AEAD_XOR_LOOP: for (int i = 0; i < CHACHA20_BLOCK_SIZE; i++) {
+#pragma HLS PIPELINE II=1
+            uint8_t in = 0, out = 0;
+            if (base + i < msg_len) {
+                in = input[base + i];
+                out = in ^ keystream_bytes[i];
+                output[base + i] = out;
+            }
+            // Bytes past the end are zero: that is the ciphertext padding
+            ct[i] = decrypt ? in : out;
+        }
+
+        AEAD_MAC_LOOP: for (int c = 0; c < CHACHA20_BLOCK_SIZE / POLY1305_BLOCK_SIZE; c++) {
+            if (base + c * POLY1305_BLOCK_SIZE < msg_len) {
+                poly1305_block(h, r, &ct[c * POLY1305_BLOCK_SIZE]);
+            }
+        }
+    }
+
+    // le64(aad_len) || le64(msg_len)
+    cpu_to_le32(&chunk[0], (uint32_t)aad_len);
+    cpu_to_le32(&chunk[4], 0);
+    cpu_to_le32(&chunk[8], (uint32_t)msg_len);
+    cpu_to_le32(&chunk[12], 0);
+    poly1305_block(h, r, chunk);
+
+    uint8_t tag_local[POLY1305_TAG_SIZE];
+    poly1305_finish(h, &otk[16], tag_local);
+    for (int i = 0; i < POLY1305_TAG_SIZE; i++) {
+#pragma HLS PIPELINE II=1
+        tag[i] = tag_local[i];
+    }
+}
+
+// 10 double rounds for every lane, one (double round, lane) pair per
+// pipeline slot: consecutive slots hold different lanes, so each double
+// round has LANES cycles to settle before the same lane comes back
+static void stream_double_rounds(uint32_t x[CHACHA20_STREAM_LANES][16]) {
+#pragma HLS INLINE
+    STREAM_ROUND_LOOP: for (int r = 0; r < 10; r++) {
+        STREAM_LANE_LOOP: for (int l = 0; l < CHACHA20_STREAM_LANES; l++) {
+#pragma HLS PIPELINE II=1
+#pragma HLS DEPENDENCE variable=x inter distance=CHACHA20_STREAM_LANES true
+            quarter_round(&x[l][0], &x[l][4], &x[l][8],  &x[l][12]);
+            quarter_round(&x[l][1], &x[l][5], &x[l][9],  &x[l][13]);
+            quarter_round(&x[l][2], &x[l][6], &x[l][10], &x[l][14]);
+            quarter_round(&x[l][3], &x[l][7], &x[l][11], &x[l][15]);
+            quarter_round(&x[l][0], &x[l][5], &x[l][10], &x[l][15]);
+            quarter_round(&x[l][1], &x[l][6], &x[l][11], &x[l][12]);
+            quarter_round(&x[l][2], &x[l][7], &x[l][8],  &x[l][13]);
+            quarter_round(&x[l][3], &x[l][4], &x[l][9],  &x[l][14]);
+        }
+    }
+}
+
+// Keystream for one lane group whose initial states are already set up.
+// The last block of a stream is truncated on store.
+static void stream_xor_blocks(const uint8_t *input, uint8_t *output,
+                              uint32_t state[CHACHA20_STREAM_LANES][16],
+                              uint32_t x[CHACHA20_STREAM_LANES][16],
+                              const uint32_t offset[CHACHA20_STREAM_LANES],
+                              const uint32_t length[CHACHA20_STREAM_LANES],
+                              const uint32_t nblocks[CHACHA20_STREAM_LANES],
+                              uint32_t max_blocks) {
+#pragma HLS INLINE
+    STREAM_BLOCK_LOOP: for (uint32_t blk = 0; blk < max_blocks; blk++) {
+
+        STREAM_INIT_LOOP: for (int l = 0; l < CHACHA20_STREAM_LANES; l++) {
+#pragma HLS PIPELINE II=1
+            for (int i = 0; i < 16; i++) {
+#pragma HLS UNROLL
+                x[l][i] = state[l][i];
+            }
+        }
+
+        stream_double_rounds(x);
+
+        // XOR the keystream into every lane that still has data
+        STREAM_STORE_LOOP: for (int l = 0; l < CHACHA20_STREAM_LANES; l++) {
+            if (blk < nblocks[l]) {
+                uint8_t keystream_bytes[CHACHA20_BLOCK_SIZE];
+#pragma HLS ARRAY_PARTITION variable=keystream_bytes complete
+                for (int i = 0; i < 16; i++) {
+#pragma HLS UNROLL
+                    cpu_to_le32(&keystream_bytes[i * 4], x[l][i] + state[l][i]);
+                }
+
+                uint32_t base = offset[l] + blk * CHACHA20_BLOCK_SIZE;
+                uint32_t remaining = length[l] - blk * CHACHA20_BLOCK_SIZE;
+                uint32_t n = (remaining < CHACHA20_BLOCK_SIZE) ? remaining : CHACHA20_BLOCK_SIZE;
+                STREAM_XOR_LOOP: for (uint32_t i = 0; i < n; i++) {
+#pragma HLS PIPELINE II=1
+                    output[base + i] = input[base + i] ^ keystream_bytes[i];
+                }
+                state[l][12]++;
+            }
+        }
+    }
+}
+
+// Constants and a 32-byte key table entry into state words 0..11
+static void stream_load_key(uint32_t state[16], const uint8_t *keys, uint32_t key_index) {
+#pragma HLS INLINE
+    const uint8_t *key = &keys[key_index * CHACHA20_KEY_SIZE];
+    state[0] = chacha20_constants[0];
+    state[1] = chacha20_constants[1];
+    state[2] = chacha20_constants[2];
+    state[3] = chacha20_constants[3];
+    for (int i = 0; i < 8; i++) {
+#pragma HLS PIPELINE II=1
+        state[4 + i] = le32_to_cpu(key + i * 4);
+    }
+}
+
+// Many independent streams (one per connection) in a single launch.
+// Streams are taken CHACHA20_STREAM_LANES at a time and their blocks are
+// interleaved round by round. Lengths need not be block multiples.
+void chacha20_encrypt_streams(const uint8_t *input, const uint8_t *keys,
+                              const uint32_t *stream_table, uint8_t *output,
+                              int num_streams) {
+#pragma HLS INTERFACE m_axi port=input depth=4096 offset=slave bundle=gmem0
+#pragma HLS INTERFACE m_axi port=keys depth=256 offset=slave bundle=gmem1
+#pragma HLS INTERFACE m_axi port=stream_table depth=128 offset=slave bundle=gmem1
+#pragma HLS INTERFACE m_axi port=output depth=4096 offset=slave bundle=gmem2
+#pragma HLS INTERFACE s_axilite port=input bundle=control
+#pragma HLS INTERFACE s_axilite port=keys bundle=control
+#pragma HLS INTERFACE s_axilite port=stream_table bundle=control
+#pragma HLS INTERFACE s_axilite port=output bundle=control
+#pragma HLS INTERFACE s_axilite port=num_streams bundle=control
+#pragma HLS INTERFACE s_axilite port=return bundle=control
+
+    uint32_t state[CHACHA20_STREAM_LANES][16];
+    uint32_t x[CHACHA20_STREAM_LANES][16];
+#pragma HLS ARRAY_PARTITION variable=state complete dim=2
+#pragma HLS ARRAY_PARTITION variable=x complete dim=2
+
+    uint32_t offset[CHACHA20_STREAM_LANES];
+    uint32_t length[CHACHA20_STREAM_LANES];
+    uint32_t nblocks[CHACHA20_STREAM_LANES];
+
+    STREAM_GROUP_LOOP: for (int group = 0; group < num_streams; group += CHACHA20_STREAM_LANES) {
+        int lanes = num_streams - group;
+        if (lanes > CHACHA20_STREAM_LANES) lanes = CHACHA20_STREAM_LANES;
+
+        // Build each lane's initial state from its descriptor and key entry
+        uint32_t max_blocks = 0;
+        STREAM_DESC_LOOP: for (int l = 0; l < CHACHA20_STREAM_LANES; l++) {
+            if (l < lanes) {
+                const uint32_t *desc = &stream_table[(group + l) * CHACHA20_STREAM_DESC_WORDS];
+                stream_load_key(state[l], keys, desc[0]);
+                state[l][12] = desc[4];
+                state[l][13] = desc[1];
+                state[l][14] = desc[2];
+                state[l][15] = desc[3];
+
+                offset[l] = desc[5];
+                length[l] = desc[6];
+                nblocks[l] = (length[l] + CHACHA20_BLOCK_SIZE - 1) / CHACHA20_BLOCK_SIZE;
+            } else {
+                nblocks[l] = 0;
+            }
+            if (nblocks[l] > max_blocks) max_blocks = nblocks[l];
+        }
+
+        stream_xor_blocks(input, output, state, x, offset, length, nblocks, max_blocks);
+    }
+}
+
+// HChaCha20: the 20 rounds over (constants, key, 128-bit input) with no
+// feed-forward; words 0..3 and 12..15 form the 256-bit subkey
+static void hchacha20(const uint8_t *key, const uint8_t *nonce16, uint8_t subkey[CHACHA20_KEY_SIZE]) {
+#pragma HLS INLINE
+    uint32_t x[16];
+#pragma HLS ARRAY_PARTITION variable=x complete
+    x[0] = chacha20_constants[0];
+    x[1] = chacha20_constants[1];
+    x[2] = chacha20_constants[2];
+    x[3] = chacha20_constants[3];
+    for (int i = 0; i < 8; i++) {
+#pragma HLS UNROLL
+        x[4 + i] = le32_to_cpu(key + i * 4);
+    }
+    for (int i = 0; i < 4; i++) {
+#pragma HLS UNROLL
+        x[12 + i] = le32_to_cpu(nonce16 + i * 4);
+    }
+
+    for (int i = 0; i < 10; i++) {
+#pragma HLS PIPELINE II=1
+        quarter_round(&x[0], &x[4], &x[8],  &x[12]);
+        quarter_round(&x[1], &x[5], &x[9],  &x[13]);
+        quarter_round(&x[2], &x[6], &x[10], &x[14]);
+        quarter_round(&x[3], &x[7], &x[11], &x[15]);
+        quarter_round(&x[0], &x[5], &x[10], &x[15]);
+        quarter_round(&x[1], &x[6], &x[11], &x[12]);
+        quarter_round(&x[2], &x[7], &x[8],  &x[13]);
+        quarter_round(&x[3], &x[4], &x[9],  &x[14]);
+    }
+
+    for (int i = 0; i < 4; i++) {
+#pragma HLS UNROLL
+        cpu_to_le32(&subkey[i * 4], x[i]);
+        cpu_to_le32(&subkey[16 + i * 4], x[12 + i]);
+    }
+}
+
+// XChaCha20: HChaCha20(key, nonce[0..15]) gives the subkey, then plain
+// ChaCha20 runs with nonce 0x00000000 || nonce[16..23]
+void xchacha20_encrypt(const uint8_t *plaintext, const uint8_t *key,
+                       const uint8_t *nonce, uint32_t counter,
+                       uint8_t *ciphertext, int num_blocks) {
+#pragma HLS INTERFACE m_axi port=plaintext depth=128 offset=slave bundle=gmem0
+#pragma HLS INTERFACE m_axi port=key depth=32 offset=slave bundle=gmem1
+#pragma HLS INTERFACE m_axi port=nonce depth=24 offset=slave bundle=gmem2
+#pragma HLS INTERFACE m_axi port=ciphertext depth=128 offset=slave bundle=gmem3
+#pragma HLS INTERFACE s_axilite port=plaintext bundle=control
+#pragma HLS INTERFACE s_axilite port=key bundle=control
+#pragma HLS INTERFACE s_axilite port=nonce bundle=control
+#pragma HLS INTERFACE s_axilite port=counter bundle=control
+#pragma HLS INTERFACE s_axilite port=ciphertext bundle=control
+#pragma HLS INTERFACE s_axilite port=num_blocks bundle=control
+#pragma HLS INTERFACE s_axilite port=return bundle=control
+
+    uint8_t key_local[CHACHA20_KEY_SIZE];
+    uint8_t nonce_local[XCHACHA20_NONCE_SIZE];
+    for (int i = 0; i < CHACHA20_KEY_SIZE; i++) {
+#pragma HLS PIPELINE II=1
+        key_local[i] = key[i];
+    }
+    for (int i = 0; i < XCHACHA20_NONCE_SIZE; i++) {
+#pragma HLS PIPELINE II=1
+        nonce_local[i] = nonce[i];
+    }
+
+    uint8_t subkey[CHACHA20_KEY_SIZE];
+    uint8_t inner_nonce[CHACHA20_NONCE_SIZE];
+    hchacha20(key_local, nonce_local, subkey);
+    for (int i = 0; i < 4; i++) {
+#pragma HLS UNROLL
+        inner_nonce[i] = 0;
+    }
+    for (int i = 0; i < 8; i++) {
+#pragma HLS UNROLL
+        inner_nonce[4 + i] = nonce_local[16 + i];
+    }
+
+    uint32_t state[16];
+    uint32_t keystream[16];
+    XCHACHA_BLOCK_LOOP: for (int block = 0; block < num_blocks; block++) {
+        chacha20_init_state(state, subkey, inner_nonce, counter + block);
+        chacha20_block(state, keystream);
+
+        uint8_t keystream_bytes[64];
+        for (int i = 0; i < 16; i++) {
+            cpu_to_le32(&keystream_bytes[i * 4], keystream[i]);
+        }
+        for (int i = 0; i < CHACHA20_BLOCK_SIZE; i++) {
+            ciphertext[block * CHACHA20_BLOCK_SIZE + i] =
+                plaintext[block * CHACHA20_BLOCK_SIZE + i] ^ keystream_bytes[i];
+        }
+    }
+}
+
+// Multi-stream XChaCha20. Subkey derivation is batched with the streams:
+// each lane group first runs HChaCha20 for all its lanes through the same
+// interleaved round loop as the keystream, then encrypts with the subkeys,
+// so a short message with its own 192-bit nonce costs one extra pass of
+// the round pipeline rather than a launch of its own.
+void xchacha20_encrypt_streams(const uint8_t *input, const uint8_t *keys,
+                               const uint32_t *stream_table, uint8_t *output,
+                               int num_streams) {
+#pragma HLS INTERFACE m_axi port=input depth=4096 offset=slave bundle=gmem0
+#pragma HLS INTERFACE m_axi port=keys depth=256 offset=slave bundle=gmem1
+#pragma HLS INTERFACE m_axi port=stream_table depth=192 offset=slave bundle=gmem1
+#pragma HLS INTERFACE m_axi port=output depth=4096 offset=slave bundle=gmem2
+#pragma HLS INTERFACE s_axilite port=input bundle=control
+#pragma HLS INTERFACE s_axilite port=keys bundle=control
+#pragma HLS INTERFACE s_axilite port=stream_table bundle=control
+#pragma HLS INTERFACE s_axilite port=output bundle=control
+#pragma HLS INTERFACE s_axilite port=num_streams bundle=control
+#pragma HLS INTERFACE s_axilite port=return bundle=control
+
+    uint32_t state[CHACHA20_STREAM_LANES][16];
+    uint32_t x[CHACHA20_STREAM_LANES][16];
+#pragma HLS ARRAY_PARTITION variable=state complete dim=2
+#pragma HLS ARRAY_PARTITION variable=x complete dim=2
+
+    uint32_t offset[CHACHA20_STREAM_LANES];
+    uint32_t length[CHACHA20_STREAM_LANES];
+    uint32_t nblocks[CHACHA20_STREAM_LANES];
+
+    XSTREAM_GROUP_LOOP: for (int group = 0; group < num_streams; group += CHACHA20_STREAM_LANES) {
+        int lanes = num_streams - group;
+        if (lanes > CHACHA20_STREAM_LANES) lanes = CHACHA20_STREAM_LANES;
+
+        // HChaCha20 input per lane: key entry plus the first 128 nonce bits
+        uint32_t max_blocks = 0;
+        XSTREAM_DESC_LOOP: for (int l = 0; l < CHACHA20_STREAM_LANES; l++) {
+            const uint32_t *desc = &stream_table[(group + (l < lanes ? l : 0)) * XCHACHA20_STREAM_DESC_WORDS];
+            stream_load_key(x[l], keys, desc[0]);
+            for (int i = 0; i < 4; i++) {
+#pragma HLS UNROLL
+                x[l][12 + i] = desc[1 + i];
+            }
+            if (l < lanes) {
+                offset[l] = desc[8];
+                length[l] = desc[9];
+                nblocks[l] = (length[l] + CHACHA20_BLOCK_SIZE - 1) / CHACHA20_BLOCK_SIZE;
+            } else {
+                nblocks[l] = 0;
+            }
+            if (nblocks[l] > max_blocks) max_blocks = nblocks[l];
+        }
+
+        stream_double_rounds(x);
+
+        // Subkey = words 0..3 and 12..15; inner nonce = 0 || nonce[16..23]
+        XSTREAM_SUBKEY_LOOP: for (int l = 0; l < CHACHA20_STREAM_LANES; l++) {
+#pragma HLS PIPELINE II=1
+            const uint32_t *desc = &stream_table[(group + (l < lanes ? l : 0)) * XCHACHA20_STREAM_DESC_WORDS];
+            for (int i = 0; i < 4; i++) {
+#pragma HLS UNROLL
+                state[l][i] = chacha20_constants[i];
+                state[l][4 + i] = x[l][i];
+                state[l][8 + i] = x[l][12 + i];
+            }
+            state[l][12] = desc[7];
+            state[l][13] = 0;
+            state[l][14] = desc[5];
+            state[l][15] = desc[6];
+        }
+
+        stream_xor_blocks(input, output, state, x, offset, length, nblocks, max_blocks);
+    }
+}
@@ -9,6 +9,25 @@
 #define CHACHA20_NONCE_SIZE 12  // 96-bit nonce (12 bytes)
 #define CHACHA20_ROUNDS 20      // 20 rounds for ChaCha20
 
+// ChaCha20-Poly1305 AEAD (RFC 8439)
+#define POLY1305_BLOCK_SIZE 16  // 128-bit message chunks
+#define POLY1305_KEY_SIZE 32    // r || s, taken from keystream block 0
+#define POLY1305_TAG_SIZE 16    // 128-bit tag
+
+// Multi-stream launches: one descriptor of CHACHA20_STREAM_DESC_WORDS
+// uint32 words per stream = {key_index, nonce[0..2] (little-endian words),
+// initial counter, byte offset, byte length, reserved}. Output lands at the
+// same offset as the input; keys come from a table of 32-byte entries.
+#define CHACHA20_STREAM_DESC_WORDS 8
+#define CHACHA20_STREAM_LANES 8   // Streams in flight per interleave group
+
+// XChaCha20: 192-bit nonce; HChaCha20 over the key and nonce[0..15] yields
+// a subkey for ChaCha20 with nonce 0x00000000 || nonce[16..23]. Multi-stream
+// descriptors grow to {key_index, nonce[0..5] (little-endian words),
+// initial counter, byte offset, byte length, reserved x2}.
+#define XCHACHA20_NONCE_SIZE 24
+#define XCHACHA20_STREAM_DESC_WORDS 12
+
 // ChaCha20 constants
 extern const uint32_t chacha20_constants[4];
 
@@ -21,6 +40,43 @@ extern "C" {
         uint8_t *ciphertext, 
         int num_blocks
     );
+
+    void chacha20_poly1305(
+        const uint8_t *input,
+        const uint8_t *aad,
+        const uint8_t *key,
+        const uint8_t *nonce,
+        uint8_t *output,
+        uint8_t *tag,
+        int aad_len,
+        int msg_len,
+        int decrypt
+    );
+
+    void chacha20_encrypt_streams(
+        const uint8_t *input,
+        const uint8_t *keys,
+        const uint32_t *stream_table,
+        uint8_t *output,
+        int num_streams
+    );
+
+    void xchacha20_encrypt(
+        const uint8_t *plaintext,
+        const uint8_t *key,
+        const uint8_t *nonce,
+        uint32_t counter,
+        uint8_t *ciphertext,
+        int num_blocks
+    );
+
+    void xchacha20_encrypt_streams(
+        const uint8_t *input,
+        const uint8_t *keys,
+        const uint32_t *stream_table,
+        uint8_t *output,
+        int num_streams
+    );
 }
 
 #endif
\ No newline at end of file
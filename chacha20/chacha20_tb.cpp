@@ -102,10 +102,200 @@ int main() {
         }
     }
     
-    if (encryption_different && decryption_correct) {
+    // ChaCha20-Poly1305 AEAD: RFC 8439 section 2.8.2
+    std::cout << "\n=== ChaCha20-Poly1305 AEAD (RFC 8439 2.8.2) ===" << std::endl;
+    const char* aead_text = "Ladies and Gentlemen of the class of '99: If I could offer you only one tip "
+                            "for the future, sunscreen would be it.";
+    const int aead_len = (int)strlen(aead_text);
+    uint8_t aead_key[32];
+    for (int i = 0; i < 32; i++) {
+        aead_key[i] = 0x80 + i;
+    }
+    uint8_t aead_nonce[12] = {0x07, 0x00, 0x00, 0x00, 0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47};
+    uint8_t aad[12] = {0x50, 0x51, 0x52, 0x53, 0xc0, 0xc1, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7};
+    const uint8_t expected_ct[114] = {
+        0xd3, 0x1a, 0x8d, 0x34, 0x64, 0x8e, 0x60, 0xdb, 0x7b, 0x86, 0xaf, 0xbc, 0x53, 0xef, 0x7e, 0xc2,
+        0xa4, 0xad, 0xed, 0x51, 0x29, 0x6e, 0x08, 0xfe, 0xa9, 0xe2, 0xb5, 0xa7, 0x36, 0xee, 0x62, 0xd6,
+        0x3d, 0xbe, 0xa4, 0x5e, 0x8c, 0xa9, 0x67, 0x12, 0x82, 0xfa, 0xfb, 0x69, 0xda, 0x92, 0x72, 0x8b,
+        0x1a, 0x71, 0xde, 0x0a, 0x9e, 0x06, 0x0b, 0x29, 0x05, 0xd6, 0xa5, 0xb6, 0x7e, 0xcd, 0x3b, 0x36,
+        0x92, 0xdd, 0xbd, 0x7f, 0x2d, 0x77, 0x8b, 0x8c, 0x98, 0x03, 0xae, 0xe3, 0x28, 0x09, 0x1b, 0x58,
+        0xfa, 0xb3, 0x24, 0xe4, 0xfa, 0xd6, 0x75, 0x94, 0x55, 0x85, 0x80, 0x8b, 0x48, 0x31, 0xd7, 0xbc,
+        0x3f, 0xf4, 0xde, 0xf0, 0x8e, 0x4b, 0x7a, 0x9d, 0xe5, 0x76, 0xd2, 0x65, 0x86, 0xce, 0xc6, 0x4b,
+        0x61, 0x16
+    };
+    const uint8_t expected_tag[16] = {
+        0x1a, 0xe1, 0x0b, 0x59, 0x4f, 0x09, 0xe2, 0x6a, 0x7e, 0x90, 0x2e, 0xcb, 0xd0, 0x60, 0x06, 0x91
+    };
+
+    uint8_t aead_ct[114], aead_pt[114], tag[16], open_tag[16];
+    chacha20_poly1305((const uint8_t*)aead_text, aad, aead_key, aead_nonce, aead_ct, tag,
+                      (int)sizeof(aad), aead_len, 0);
+    chacha20_poly1305(aead_ct, aad, aead_key, aead_nonce, aead_pt, open_tag,
+                      (int)sizeof(aad), aead_len, 1);
+
+    bool ct_ok = memcmp(aead_ct, expected_ct, aead_len) == 0;
+    bool tag_ok = memcmp(tag, expected_tag, 16) == 0;
+    bool open_ok = memcmp(open_tag, expected_tag, 16) == 0 && memcmp(aead_pt, aead_text, aead_len) == 0;
+
+    std::cout << "Tag: ";
+    for (int i = 0; i < 16; i++) {
+        std::cout << std::hex << std::setw(2) << std::setfill('0') << (int)tag[i] << " ";
+    }
+    std::cout << std::dec << std::endl;
+    std::cout << "Ciphertext: " << (ct_ok ? "✓" : "✗") << "  Tag: " << (tag_ok ? "✓" : "✗")
+              << "  Decrypt + verify: " << (open_ok ? "✓" : "✗") << std::endl;
+    bool aead_correct = ct_ok && tag_ok && open_ok;
+
+    // Multi-stream launch: 11 streams (two lane groups) over 3 keys with
+    // lengths that are not block multiples, checked against one
+    // chacha20_encrypt call per stream. Gap bytes between streams must
+    // stay untouched.
+    std::cout << "\n=== Multi-stream ChaCha20 ===" << std::endl;
+    const int num_streams = 11;
+    const uint32_t stream_lengths[num_streams] = {0, 1, 63, 64, 65, 130, 200, 7, 512, 100, 191};
+    uint8_t stream_keys[3 * CHACHA20_KEY_SIZE];
+    for (int i = 0; i < 3 * CHACHA20_KEY_SIZE; i++) {
+        stream_keys[i] = (uint8_t)(i * 7 + 3);
+    }
+
+    uint32_t stream_table[num_streams * CHACHA20_STREAM_DESC_WORDS];
+    uint32_t stream_offset = 0;
+    for (int s = 0; s < num_streams; s++) {
+        uint32_t *desc = &stream_table[s * CHACHA20_STREAM_DESC_WORDS];
+        desc[0] = s % 3;
+        desc[1] = 0x09000000 + s;
+        desc[2] = 0x4a000000;
+        desc[3] = s * 0x01010101u;
+        desc[4] = (s == 4) ? 0xfffffffeu : (uint32_t)s + 1;
+        desc[5] = stream_offset;
+        desc[6] = stream_lengths[s];
+        desc[7] = 0;
+        stream_offset += stream_lengths[s] + 5;
+    }
+
+    static uint8_t stream_in[2048], stream_out[2048];
+    for (uint32_t i = 0; i < stream_offset; i++) {
+        stream_in[i] = (uint8_t)(i * 13 + 1);
+        stream_out[i] = 0xa5;
+    }
+    chacha20_encrypt_streams(stream_in, stream_keys, stream_table, stream_out, num_streams);
+
+    bool streams_correct = true;
+    for (int s = 0; s < num_streams; s++) {
+        const uint32_t *desc = &stream_table[s * CHACHA20_STREAM_DESC_WORDS];
+        uint8_t nonce[12];
+        for (int w = 0; w < 3; w++) {
+            for (int b = 0; b < 4; b++) {
+                nonce[w * 4 + b] = (uint8_t)(desc[1 + w] >> (8 * b));
+            }
+        }
+        int blocks = (int)((desc[6] + CHACHA20_BLOCK_SIZE - 1) / CHACHA20_BLOCK_SIZE);
+        uint8_t padded[512 + CHACHA20_BLOCK_SIZE] = {0}, expected[512 + CHACHA20_BLOCK_SIZE];
+        memcpy(padded, &stream_in[desc[5]], desc[6]);
+        chacha20_encrypt(padded, &stream_keys[desc[0] * CHACHA20_KEY_SIZE], nonce, desc[4], expected, blocks);
+
+        bool ok = memcmp(expected, &stream_out[desc[5]], desc[6]) == 0;
+        for (uint32_t g = 0; g < 5; g++) {
+            ok &= stream_out[desc[5] + desc[6] + g] == 0xa5;
+        }
+        if (!ok) {
+            std::cout << "Stream " << std::dec << s << " mismatch" << std::endl;
+        }
+        streams_correct &= ok;
+    }
+    std::cout << "Streams: " << std::dec << num_streams << "  " << (streams_correct ? "✓" : "✗") << std::endl;
+
+    // XChaCha20: draft-irtf-cfrg-xchacha-03 A.3.2 (counter 1), then a
+    // multi-stream launch where every stream carries its own 192-bit nonce
+    std::cout << "\n=== XChaCha20 (draft-irtf-cfrg-xchacha A.3.2) ===" << std::endl;
+    const char* dhole = "The dhole (pronounced \"dole\") is also known as the Asiatic wild dog, red dog, "
+                        "and whistling dog. It is about the size of a German shepherd but looks more like "
+                        "a long-legged fox. This highly elusive and skilled jumper is classified with "
+                        "wolves, coyotes, jackals, and foxes in the taxonomic family Canidae.";
+    const int dhole_len = (int)strlen(dhole);
+    uint8_t xnonce[XCHACHA20_NONCE_SIZE] = {
+        0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4a, 0x4b,
+        0x4c, 0x4d, 0x4e, 0x4f, 0x50, 0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x58
+    };
+    const uint8_t expected_xct[304] = {
+        0x7d, 0x0a, 0x2e, 0x6b, 0x7f, 0x7c, 0x65, 0xa2, 0x36, 0x54, 0x26, 0x30, 0x29, 0x4e, 0x06, 0x3b,
+        0x7a, 0xb9, 0xb5, 0x55, 0xa5, 0xd5, 0x14, 0x9a, 0xa2, 0x1e, 0x4a, 0xe1, 0xe4, 0xfb, 0xce, 0x87,
+        0xec, 0xc8, 0xe0, 0x8a, 0x8b, 0x5e, 0x35, 0x0a, 0xbe, 0x62, 0x2b, 0x2f, 0xfa, 0x61, 0x7b, 0x20,
+        0x2c, 0xfa, 0xd7, 0x20, 0x32, 0xa3, 0x03, 0x7e, 0x76, 0xff, 0xdc, 0xdc, 0x43, 0x76, 0xee, 0x05,
+        0x3a, 0x19, 0x0d, 0x7e, 0x46, 0xca, 0x1d, 0xe0, 0x41, 0x44, 0x85, 0x03, 0x81, 0xb9, 0xcb, 0x29,
+        0xf0, 0x51, 0x91, 0x53, 0x86, 0xb8, 0xa7, 0x10, 0xb8, 0xac, 0x4d, 0x02, 0x7b, 0x8b, 0x05, 0x0f,
+        0x7c, 0xba, 0x58, 0x54, 0xe0, 0x28, 0xd5, 0x64, 0xe4, 0x53, 0xb8, 0xa9, 0x68, 0x82, 0x41, 0x73,
+        0xfc, 0x16, 0x48, 0x8b, 0x89, 0x70, 0xca, 0xc8, 0x28, 0xf1, 0x1a, 0xe5, 0x3c, 0xab, 0xd2, 0x01,
+        0x12, 0xf8, 0x71, 0x07, 0xdf, 0x24, 0xee, 0x61, 0x83, 0xd2, 0x27, 0x4f, 0xe4, 0xc8, 0xb1, 0x48,
+        0x55, 0x34, 0xef, 0x2c, 0x5f, 0xbc, 0x1e, 0xc2, 0x4b, 0xfc, 0x36, 0x63, 0xef, 0xaa, 0x08, 0xbc,
+        0x04, 0x7d, 0x29, 0xd2, 0x50, 0x43, 0x53, 0x2d, 0xb8, 0x39, 0x1a, 0x8a, 0x3d, 0x77, 0x6b, 0xf4,
+        0x37, 0x2a, 0x69, 0x55, 0x82, 0x7c, 0xcb, 0x0c, 0xdd, 0x4a, 0xf4, 0x03, 0xa7, 0xce, 0x4c, 0x63,
+        0xd5, 0x95, 0xc7, 0x5a, 0x43, 0xe0, 0x45, 0xf0, 0xcc, 0xe1, 0xf2, 0x9c, 0x8b, 0x93, 0xbd, 0x65,
+        0xaf, 0xc5, 0x97, 0x49, 0x22, 0xf2, 0x14, 0xa4, 0x0b, 0x7c, 0x40, 0x2c, 0xdb, 0x91, 0xae, 0x73,
+        0xc0, 0xb6, 0x36, 0x15, 0xcd, 0xad, 0x04, 0x80, 0x68, 0x0f, 0x16, 0x51, 0x5a, 0x7a, 0xce, 0x9d,
+        0x39, 0x23, 0x64, 0x64, 0x32, 0x8a, 0x37, 0x74, 0x3f, 0xfc, 0x28, 0xf4, 0xdd, 0xb3, 0x24, 0xf4,
+        0xd0, 0xf5, 0xbb, 0xdc, 0x27, 0x0c, 0x65, 0xb1, 0x74, 0x9a, 0x6e, 0xff, 0xf1, 0xfb, 0xaa, 0x09,
+        0x53, 0x61, 0x75, 0xcc, 0xd2, 0x9f, 0xb9, 0xe6, 0x05, 0x7b, 0x30, 0x73, 0x20, 0xd3, 0x16, 0x83,
+        0x8a, 0x9c, 0x71, 0xf7, 0x0b, 0x5b, 0x59, 0x07, 0xa6, 0x6f, 0x7e, 0xa4, 0x9a, 0xad, 0xc4, 0x09
+    };
+
+    uint8_t xpadded[5 * CHACHA20_BLOCK_SIZE] = {0}, xct[5 * CHACHA20_BLOCK_SIZE];
+    memcpy(xpadded, dhole, dhole_len);
+    xchacha20_encrypt(xpadded, aead_key, xnonce, 1, xct, 5);
+    bool xchacha_ok = dhole_len == 304 && memcmp(xct, expected_xct, dhole_len) == 0;
+
+    const int num_xstreams = 10;
+    uint32_t xstream_table[num_xstreams * XCHACHA20_STREAM_DESC_WORDS];
+    uint32_t xoffset = 0;
+    for (int s = 0; s < num_xstreams; s++) {
+        uint32_t *desc = &xstream_table[s * XCHACHA20_STREAM_DESC_WORDS];
+        desc[0] = (s * 2) % 3;
+        for (int w = 0; w < 6; w++) {
+            desc[1 + w] = 0x9e3779b9u * (uint32_t)(s * 6 + w + 1);
+        }
+        desc[7] = s & 1;
+        desc[8] = xoffset;
+        desc[9] = stream_lengths[s];
+        desc[10] = 0;
+        desc[11] = 0;
+        xoffset += stream_lengths[s] + 3;
+    }
+    for (uint32_t i = 0; i < xoffset; i++) {
+        stream_out[i] = 0xa5;
+    }
+    xchacha20_encrypt_streams(stream_in, stream_keys, xstream_table, stream_out, num_xstreams);
+
+    for (int s = 0; s < num_xstreams; s++) {
+        const uint32_t *desc = &xstream_table[s * XCHACHA20_STREAM_DESC_WORDS];
+        uint8_t nonce[XCHACHA20_NONCE_SIZE];
+        for (int w = 0; w < 6; w++) {
+            for (int b = 0; b < 4; b++) {
+                nonce[w * 4 + b] = (uint8_t)(desc[1 + w] >> (8 * b));
+            }
+        }
+        int blocks = (int)((desc[9] + CHACHA20_BLOCK_SIZE - 1) / CHACHA20_BLOCK_SIZE);
+        uint8_t padded[512 + CHACHA20_BLOCK_SIZE] = {0}, expected[512 + CHACHA20_BLOCK_SIZE];
+        memcpy(padded, &stream_in[desc[8]], desc[9]);
+        xchacha20_encrypt(padded, &stream_keys[desc[0] * CHACHA20_KEY_SIZE], nonce, desc[7], expected, blocks);
+
+        bool ok = memcmp(expected, &stream_out[desc[8]], desc[9]) == 0;
+        for (uint32_t g = 0; g < 3; g++) {
+            ok &= stream_out[desc[8] + desc[9] + g] == 0xa5;
+        }
+        if (!ok) {
+            std::cout << "XChaCha20 stream " << s << " mismatch" << std::endl;
+        }
+        xchacha_ok &= ok;
+    }
+    std::cout << "Vector + " << num_xstreams << " streams: " << (xchacha_ok ? "✓" : "✗") << std::endl;
+
+    if (encryption_different && decryption_correct && aead_correct && streams_correct && xchacha_ok) {
         std::cout << "✓ ChaCha20 test PASSED!" << std::endl;
         std::cout << "  - Encryption produces different output ✓" << std::endl;
         std::cout << "  - Decryption recovers original data ✓" << std::endl;
+        std::cout << "  - ChaCha20-Poly1305 matches RFC 8439 ✓" << std::endl;
+        std::cout << "  - Multi-stream launch matches per-stream encryption ✓" << std::endl;
+        std::cout << "  - XChaCha20 matches draft vector and batched derivation ✓" << std::endl;
         return 0;
     } else {
         std::cout << "✗ ChaCha20 test FAILED!" << std::endl;
@@ -115,6 +305,15 @@ int main() {
         if (!decryption_correct) {
             std::cout << "  - Decryption failed ✗" << std::endl;
         }
+        if (!aead_correct) {
+            std::cout << "  - ChaCha20-Poly1305 vector mismatch ✗" << std::endl;
+        }
+        if (!streams_correct) {
+            std::cout << "  - Multi-stream output mismatch ✗" << std::endl;
+        }
+        if (!xchacha_ok) {
+            std::cout << "  - XChaCha20 mismatch ✗" << std::endl;
+        }
         return 1;
     }
 }
\ No newline at end of file
@@ -0,0 +1,1123 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <algorithm>
+#include <immintrin.h>
+#include "../common/cpu_features.h"
+
+#define CHACHA20_BLOCK_SIZE 64  // 512-bit block (64 bytes)
+#define CHACHA20_KEY_SIZE 32    // 256-bit key (32 bytes)
+#define CHACHA20_NONCE_SIZE 12  // 96-bit nonce (12 bytes)
+#define POLY1305_BLOCK_SIZE 16
+#define POLY1305_TAG_SIZE 16
+#define XCHACHA20_NONCE_SIZE 24 // 192-bit XChaCha20 nonce
+
+// ChaCha20 constants: "expand 32-byte k"
+static const uint32_t chacha20_constants[4] = {
+    0x61707865, 0x3320646e, 0x79622d32, 0x6b206574
+};
+
+static inline uint32_t load_le32(const uint8_t* p) {
+    return ((uint32_t)p[0]) | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline void store_le32(uint8_t* p, uint32_t v) {
+    p[0] = v & 0xff;
+    p[1] = (v >> 8) & 0xff;
+    p[2] = (v >> 16) & 0xff;
+    p[3] = (v >> 24) & 0xff;
+}
+
+static inline uint64_t load_le64(const uint8_t* p) {
+    return (uint64_t)load_le32(p) | ((uint64_t)load_le32(p + 4) << 32);
+}
+
+static inline void store_le64(uint8_t* p, uint64_t v) {
+    store_le32(p, (uint32_t)v);
+    store_le32(p + 4, (uint32_t)(v >> 32));
+}
+
+// Poly1305 on radix-2^44 limbs (44 + 44 + 42 bits): each step is nine
+// 64x64->128-bit multiply-accumulates, with 2^130 == 5 folded into r*20
+class Poly1305 {
+private:
+    uint64_t r0, r1, r2;
+    uint64_t s1, s2;
+    uint64_t h0 = 0, h1 = 0, h2 = 0;
+    uint64_t pad0, pad1;
+    uint8_t buffer[POLY1305_BLOCK_SIZE];
+    size_t buffered = 0;
+
+    void blocks(const uint8_t* m, size_t len, uint64_t hibit) {
+        const uint64_t mask44 = 0xfffffffffffULL;
+        const uint64_t mask42 = 0x3ffffffffffULL;
+        while (len >= POLY1305_BLOCK_SIZE) {
+            uint64_t t0 = load_le64(m);
+            uint64_t t1 = load_le64(m + 8);
+
+            h0 += t0 & mask44;
+            h1 += ((t0 >> 44) | (t1 << 20)) & mask44;
+            h2 += ((t1 >> 24) & mask42) | hibit;
+
+            unsigned __int128 d0 = (unsigned __int128)h0 * r0 + (unsigned __int128)h1 * s2 + (unsigned __int128)h2 * s1;
+            unsigned __int128 d1 = (unsigned __int128)h0 * r1 + (unsigned __int128)h1 * r0 + (unsigned __int128)h2 * s2;
+            unsigned __int128 d2 = (unsigned __int128)h0 * r2 + (unsigned __int128)h1 * r1 + (unsigned __int128)h2 * r0;
+
+            uint64_t c;
+            c = (uint64_t)(d0 >> 44); h0 = (uint64_t)d0 & mask44;
+            d1 += c; c = (uint64_t)(d1 >> 44); h1 = (uint64_t)d1 & mask44;
+            d2 += c; c = (uint64_t)(d2 >> 42); h2 = (uint64_t)d2 & mask42;
+            h0 += c * 5; c = h0 >> 44; h0 &= mask44;
+            h1 += c;
+
+            m += POLY1305_BLOCK_SIZE;
+            len -= POLY1305_BLOCK_SIZE;
+        }
+    }
+
+public:
+    explicit Poly1305(const uint8_t key[32]) {
+        uint64_t t0 = load_le64(key);
+        uint64_t t1 = load_le64(key + 8);
+
+        // Clamp r
+        r0 = t0 & 0xffc0fffffffULL;
+        r1 = ((t0 >> 44) | (t1 << 20)) & 0xfffffc0ffffULL;
+        r2 = (t1 >> 24) & 0x00ffffffc0fULL;
+        s1 = r1 * (5 << 2);
+        s2 = r2 * (5 << 2);
+
+        pad0 = load_le64(key + 16);
+        pad1 = load_le64(key + 24);
+    }
+
+    void update(const uint8_t* m, size_t len) {
+        if (buffered) {
+            size_t take = std::min(len, POLY1305_BLOCK_SIZE - buffered);
+            memcpy(buffer + buffered, m, take);
+            buffered += take;
+            m += take;
+            len -= take;
+            if (buffered < POLY1305_BLOCK_SIZE) return;
+            blocks(buffer, POLY1305_BLOCK_SIZE, 1ULL << 40);
+            buffered = 0;
+        }
+        size_t full = len & ~(size_t)(POLY1305_BLOCK_SIZE - 1);
+        blocks(m, full, 1ULL << 40);
+        memcpy(buffer, m + full, len - full);
+        buffered = len - full;
+    }
+
+    // Zero-fill to the next 16-byte boundary (AEAD section padding)
+    void padToBlock() {
+        if (buffered) {
+            memset(buffer + buffered, 0, POLY1305_BLOCK_SIZE - buffered);
+            blocks(buffer, POLY1305_BLOCK_SIZE, 1ULL << 40);
+            buffered = 0;
+        }
+    }
+
+    void finish(uint8_t tag[POLY1305_TAG_SIZE]) {
+        const uint64_t mask44 = 0xfffffffffffULL;
+        const uint64_t mask42 = 0x3ffffffffffULL;
+
+        // Lone final partial block: 0x01 terminator instead of the 2^128 bit
+        if (buffered) {
+            buffer[buffered] = 1;
+            memset(buffer + buffered + 1, 0, POLY1305_BLOCK_SIZE - buffered - 1);
+            blocks(buffer, POLY1305_BLOCK_SIZE, 0);
+            buffered = 0;
+        }
+
+        uint64_t c;
+        c = h1 >> 44; h1 &= mask44;
+        h2 += c; c = h2 >> 42; h2 &= mask42;
+        h0 += c * 5; c = h0 >> 44; h0 &= mask44;
+        h1 += c; c = h1 >> 44; h1 &= mask44;
+        h2 += c; c = h2 >> 42; h2 &= mask42;
+        h0 += c * 5; c = h0 >> 44; h0 &= mask44;
+        h1 += c;
+
+        // g = h + 5 - 2^130; select g when it does not borrow
+        uint64_t g0 = h0 + 5; c = g0 >> 44; g0 &= mask44;
+        uint64_t g1 = h1 + c; c = g1 >> 44; g1 &= mask44;
+        uint64_t g2 = h2 + c - (1ULL << 42);
+
+        uint64_t mask = (g2 >> 63) - 1;
+        h0 = (h0 & ~mask) | (g0 & mask);
+        h1 = (h1 & ~mask) | (g1 & mask);
+        h2 = (h2 & ~mask) | (g2 & mask);
+
+        // h + pad mod 2^128
+        uint64_t lo = h0 | (h1 << 44);
+        uint64_t hi = (h1 >> 20) | (h2 << 24);
+        unsigned __int128 sum = (unsigned __int128)lo + pad0;
+        lo = (uint64_t)sum;
+        hi = hi + pad1 + (uint64_t)(sum >> 64);
+        store_le64(tag, lo);
+        store_le64(tag + 8, hi);
+    }
+};
+
+// Block-parallel keystream: vector register i holds state word i of N
+// consecutive blocks (counter, counter+1, ...), so every quarter-round is a
+// plain lane-wise op and the 16 words only need transposing back to block
+// order when XORing into the output
+#define CHACHA20_QR_VEC(ADD, XOR, ROTL, a, b, c, d) \
+    a = ADD(a, b); d = ROTL(XOR(d, a), 16); \
+    c = ADD(c, d); b = ROTL(XOR(b, c), 12); \
+    a = ADD(a, b); d = ROTL(XOR(d, a), 8);  \
+    c = ADD(c, d); b = ROTL(XOR(b, c), 7);
+
+#define CHACHA20_DOUBLE_ROUND_VEC(ADD, XOR, ROTL, x) \
+    CHACHA20_QR_VEC(ADD, XOR, ROTL, x[0], x[4], x[8],  x[12]) \
+    CHACHA20_QR_VEC(ADD, XOR, ROTL, x[1], x[5], x[9],  x[13]) \
+    CHACHA20_QR_VEC(ADD, XOR, ROTL, x[2], x[6], x[10], x[14]) \
+    CHACHA20_QR_VEC(ADD, XOR, ROTL, x[3], x[7], x[11], x[15]) \
+    CHACHA20_QR_VEC(ADD, XOR, ROTL, x[0], x[5], x[10], x[15]) \
+    CHACHA20_QR_VEC(ADD, XOR, ROTL, x[1], x[6], x[11], x[12]) \
+    CHACHA20_QR_VEC(ADD, XOR, ROTL, x[2], x[7], x[8],  x[13]) \
+    CHACHA20_QR_VEC(ADD, XOR, ROTL, x[3], x[4], x[9],  x[14])
+
+// 4x4 transpose of 32-bit words within each 128-bit lane
+#define CHACHA20_TRANSPOSE4(UNPACKLO32, UNPACKHI32, UNPACKLO64, UNPACKHI64, a, b, c, d, r) { \
+    auto t0 = UNPACKLO32(a, b); auto t1 = UNPACKLO32(c, d); \
+    auto t2 = UNPACKHI32(a, b); auto t3 = UNPACKHI32(c, d); \
+    r[0] = UNPACKLO64(t0, t1); r[1] = UNPACKHI64(t0, t1); \
+    r[2] = UNPACKLO64(t2, t3); r[3] = UNPACKHI64(t2, t3); }
+
+#define ROTL_X4(v, n) _mm_or_si128(_mm_slli_epi32(v, n), _mm_srli_epi32(v, 32 - (n)))
+
+// SSE2: 4 blocks (256 bytes) per call
+static void chacha20_xor_x4(const uint32_t state[16], const uint8_t* in, uint8_t* out) {
+    __m128i s[16], x[16];
+    for (int i = 0; i < 16; i++) {
+        s[i] = _mm_set1_epi32((int)state[i]);
+    }
+    s[12] = _mm_add_epi32(s[12], _mm_setr_epi32(0, 1, 2, 3));
+    for (int i = 0; i < 16; i++) x[i] = s[i];
+
+    for (int r = 0; r < 10; r++) {
+        CHACHA20_DOUBLE_ROUND_VEC(_mm_add_epi32, _mm_xor_si128, ROTL_X4, x)
+    }
+
+    for (int g = 0; g < 4; g++) {
+        __m128i r[4];
+        CHACHA20_TRANSPOSE4(_mm_unpacklo_epi32, _mm_unpackhi_epi32, _mm_unpacklo_epi64, _mm_unpackhi_epi64,
+                            _mm_add_epi32(x[4 * g], s[4 * g]), _mm_add_epi32(x[4 * g + 1], s[4 * g + 1]),
+                            _mm_add_epi32(x[4 * g + 2], s[4 * g + 2]), _mm_add_epi32(x[4 * g + 3], s[4 * g + 3]), r)
+        for (int b = 0; b < 4; b++) {
+            size_t off = b * CHACHA20_BLOCK_SIZE + g * 16;
+            __m128i m = _mm_loadu_si128((const __m128i*)(in + off));
+            _mm_storeu_si128((__m128i*)(out + off), _mm_xor_si128(m, r[b]));
+        }
+    }
+}
+
+// AVX2 rotations by 16 and 8 are byte shuffles
+#define ROTL_X8(v, n) \
+    ((n) == 16 ? _mm256_shuffle_epi8(v, _mm256_setr_epi8(2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13, \
+                                                         2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13)) : \
+     (n) == 8  ? _mm256_shuffle_epi8(v, _mm256_setr_epi8(3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14, \
+                                                         3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14)) : \
+     _mm256_or_si256(_mm256_slli_epi32(v, n), _mm256_srli_epi32(v, 32 - (n))))
+
+// AVX2: 8 blocks (512 bytes) per call. After the in-lane transpose the low
+// half of r[b] belongs to block b and the high half to block b + 4.
+__attribute__((target("avx2")))
+static void chacha20_xor_x8(const uint32_t state[16], const uint8_t* in, uint8_t* out) {
+    __m256i s[16], x[16];
+    for (int i = 0; i < 16; i++) {
+        s[i] = _mm256_set1_epi32((int)state[i]);
+    }
+    s[12] = _mm256_add_epi32(s[12], _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+    for (int i = 0; i < 16; i++) x[i] = s[i];
+
+    for (int r = 0; r < 10; r++) {
+        CHACHA20_DOUBLE_ROUND_VEC(_mm256_add_epi32, _mm256_xor_si256, ROTL_X8, x)
+    }
+
+    __m256i r[4][4];
+    for (int g = 0; g < 4; g++) {
+        CHACHA20_TRANSPOSE4(_mm256_unpacklo_epi32, _mm256_unpackhi_epi32, _mm256_unpacklo_epi64, _mm256_unpackhi_epi64,
+                            _mm256_add_epi32(x[4 * g], s[4 * g]), _mm256_add_epi32(x[4 * g + 1], s[4 * g + 1]),
+                            _mm256_add_epi32(x[4 * g + 2], s[4 * g + 2]), _mm256_add_epi32(x[4 * g + 3], s[4 * g + 3]), r[g])
+    }
+    for (int b = 0; b < 4; b++) {
+        __m256i k[4] = {
+            _mm256_permute2x128_si256(r[0][b], r[1][b], 0x20), _mm256_permute2x128_si256(r[2][b], r[3][b], 0x20),
+            _mm256_permute2x128_si256(r[0][b], r[1][b], 0x31), _mm256_permute2x128_si256(r[2][b], r[3][b], 0x31)
+        };
+        const uint8_t* src[2] = {in + b * CHACHA20_BLOCK_SIZE, in + (b + 4) * CHACHA20_BLOCK_SIZE};
+        uint8_t* dst[2] = {out + b * CHACHA20_BLOCK_SIZE, out + (b + 4) * CHACHA20_BLOCK_SIZE};
+        for (int h = 0; h < 2; h++) {
+            for (int j = 0; j < 2; j++) {
+                __m256i m = _mm256_loadu_si256((const __m256i*)(src[h] + j * 32));
+                _mm256_storeu_si256((__m256i*)(dst[h] + j * 32), _mm256_xor_si256(m, k[2 * h + j]));
+            }
+        }
+    }
+}
+
+#define ROTL_X16(v, n) _mm512_rol_epi32(v, n)
+
+// AVX-512: 16 blocks (1 KB) per call. 128-bit lane L of r[g][b] holds words
+// 4g..4g+3 of block 4L + b; a 4x4 transpose of lanes across g rebuilds each
+// 64-byte block in one register.
+__attribute__((target("avx512f")))
+static void chacha20_xor_x16(const uint32_t state[16], const uint8_t* in, uint8_t* out) {
+    __m512i s[16], x[16];
+    for (int i = 0; i < 16; i++) {
+        s[i] = _mm512_set1_epi32((int)state[i]);
+    }
+    s[12] = _mm512_add_epi32(s[12], _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+    for (int i = 0; i < 16; i++) x[i] = s[i];
+
+    for (int r = 0; r < 10; r++) {
+        CHACHA20_DOUBLE_ROUND_VEC(_mm512_add_epi32, _mm512_xor_si512, ROTL_X16, x)
+    }
+
+    __m512i r[4][4];
+    for (int g = 0; g < 4; g++) {
+        CHACHA20_TRANSPOSE4(_mm512_unpacklo_epi32, _mm512_unpackhi_epi32, _mm512_unpacklo_epi64, _mm512_unpackhi_epi64,
+                            _mm512_add_epi32(x[4 * g], s[4 * g]), _mm512_add_epi32(x[4 * g + 1], s[4 * g + 1]),
+                            _mm512_add_epi32(x[4 * g + 2], s[4 * g + 2]), _mm512_add_epi32(x[4 * g + 3], s[4 * g + 3]), r[g])
+    }
+    for (int b = 0; b < 4; b++) {
+        __m512i u0 = _mm512_shuffle_i32x4(r[0][b], r[1][b], 0x44);
+        __m512i u1 = _mm512_shuffle_i32x4(r[0][b], r[1][b], 0xee);
+        __m512i u2 = _mm512_shuffle_i32x4(r[2][b], r[3][b], 0x44);
+        __m512i u3 = _mm512_shuffle_i32x4(r[2][b], r[3][b], 0xee);
+        __m512i k[4] = {
+            _mm512_shuffle_i32x4(u0, u2, 0x88), _mm512_shuffle_i32x4(u0, u2, 0xdd),
+            _mm512_shuffle_i32x4(u1, u3, 0x88), _mm512_shuffle_i32x4(u1, u3, 0xdd)
+        };
+        for (int l = 0; l < 4; l++) {
+            size_t off = (4 * l + b) * CHACHA20_BLOCK_SIZE;
+            __m512i m = _mm512_loadu_si512((const void*)(in + off));
+            _mm512_storeu_si512((void*)(out + off), _mm512_xor_si512(m, k[l]));
+        }
+    }
+}
+
+// HChaCha20 for 8 (key, 128-bit input) pairs at once: the same transposed
+// rounds as the keystream kernels, without the feed-forward
+__attribute__((target("avx2")))
+static void hchacha20_x8(const uint32_t in[8][16], uint32_t subkeys[8][8]) {
+    __m256i x[16];
+    for (int i = 0; i < 16; i++) {
+        x[i] = _mm256_setr_epi32((int)in[0][i], (int)in[1][i], (int)in[2][i], (int)in[3][i],
+                                 (int)in[4][i], (int)in[5][i], (int)in[6][i], (int)in[7][i]);
+    }
+
+    for (int r = 0; r < 10; r++) {
+        CHACHA20_DOUBLE_ROUND_VEC(_mm256_add_epi32, _mm256_xor_si256, ROTL_X8, x)
+    }
+
+    alignas(32) uint32_t lanes[8];
+    for (int i = 0; i < 8; i++) {
+        _mm256_store_si256((__m256i*)lanes, x[i < 4 ? i : i + 8]);
+        for (int l = 0; l < 8; l++) {
+            subkeys[l][i] = lanes[l];
+        }
+    }
+}
+
+class ChaCha20CPU {
+private:
+    static inline uint32_t rotl32(uint32_t x, int n) {
+        return (x << n) | (x >> (32 - n));
+    }
+
+    static inline void quarterRound(uint32_t& a, uint32_t& b, uint32_t& c, uint32_t& d) {
+        a += b; d ^= a; d = rotl32(d, 16);
+        c += d; b ^= c; b = rotl32(b, 12);
+        a += b; d ^= a; d = rotl32(d, 8);
+        c += d; b ^= c; b = rotl32(b, 7);
+    }
+
+    static void initState(uint32_t state[16], const uint8_t* key, const uint8_t* nonce, uint32_t counter) {
+        state[0] = chacha20_constants[0];
+        state[1] = chacha20_constants[1];
+        state[2] = chacha20_constants[2];
+        state[3] = chacha20_constants[3];
+        for (int i = 0; i < 8; i++) {
+            state[4 + i] = load_le32(key + i * 4);
+        }
+        state[12] = counter;
+        for (int i = 0; i < 3; i++) {
+            state[13 + i] = load_le32(nonce + i * 4);
+        }
+    }
+
+    static void block(const uint32_t state[16], uint8_t out[CHACHA20_BLOCK_SIZE]) {
+        uint32_t x[16];
+        memcpy(x, state, sizeof(x));
+        for (int i = 0; i < 10; i++) {
+            quarterRound(x[0], x[4], x[8],  x[12]);
+            quarterRound(x[1], x[5], x[9],  x[13]);
+            quarterRound(x[2], x[6], x[10], x[14]);
+            quarterRound(x[3], x[7], x[11], x[15]);
+            quarterRound(x[0], x[5], x[10], x[15]);
+            quarterRound(x[1], x[6], x[11], x[12]);
+            quarterRound(x[2], x[7], x[8],  x[13]);
+            quarterRound(x[3], x[4], x[9],  x[14]);
+        }
+        for (int i = 0; i < 16; i++) {
+            store_le32(out + i * 4, x[i] + state[i]);
+        }
+    }
+
+    static void computeTag(Poly1305& mac, const uint8_t* aad, size_t aad_len,
+                           const uint8_t* ciphertext, size_t len, uint8_t tag[POLY1305_TAG_SIZE]) {
+        uint8_t lengths[16];
+        mac.update(aad, aad_len);
+        mac.padToBlock();
+        mac.update(ciphertext, len);
+        mac.padToBlock();
+        store_le64(lengths, aad_len);
+        store_le64(lengths + 8, len);
+        mac.update(lengths, sizeof(lengths));
+        mac.finish(tag);
+    }
+
+public:
+    enum Engine {
+        ENGINE_SCALAR = 0,
+        ENGINE_SSE2_X4,
+        ENGINE_AVX2_X8,
+        ENGINE_AVX512_X16
+    };
+
+    // Buffers below this stay on the calling thread
+    static const size_t PARALLEL_THRESHOLD = 256 * 1024;
+
+private:
+    Engine engine;
+    unsigned int num_threads;
+    bool verbose;
+
+    // XOR whole and partial blocks with the widest kernel first, falling
+    // back to narrower ones (and finally scalar) for the remainder
+    void xorRange(const uint8_t* in, size_t len, uint32_t state[16], uint8_t* out) const {
+        size_t off = 0;
+        if (engine >= ENGINE_AVX512_X16) {
+            for (; len - off >= 16 * CHACHA20_BLOCK_SIZE; off += 16 * CHACHA20_BLOCK_SIZE, state[12] += 16) {
+                chacha20_xor_x16(state, in + off, out + off);
+            }
+        }
+        if (engine >= ENGINE_AVX2_X8) {
+            for (; len - off >= 8 * CHACHA20_BLOCK_SIZE; off += 8 * CHACHA20_BLOCK_SIZE, state[12] += 8) {
+                chacha20_xor_x8(state, in + off, out + off);
+            }
+        }
+        if (engine >= ENGINE_SSE2_X4) {
+            for (; len - off >= 4 * CHACHA20_BLOCK_SIZE; off += 4 * CHACHA20_BLOCK_SIZE, state[12] += 4) {
+                chacha20_xor_x4(state, in + off, out + off);
+            }
+        }
+        uint8_t keystream[CHACHA20_BLOCK_SIZE];
+        for (; off < len; off += CHACHA20_BLOCK_SIZE, state[12]++) {
+            block(state, keystream);
+            size_t n = std::min<size_t>(CHACHA20_BLOCK_SIZE, len - off);
+            for (size_t i = 0; i < n; i++) {
+                out[off + i] = in[off + i] ^ keystream[i];
+            }
+        }
+    }
+
+public:
+    static Engine bestEngine() {
+        if (cpu_has_avx512f()) return ENGINE_AVX512_X16;
+        if (cpu_has_avx2()) return ENGINE_AVX2_X8;
+        return ENGINE_SSE2_X4;
+    }
+
+    static const char* engineName(Engine e) {
+        switch (e) {
+            case ENGINE_SCALAR:     return "Scalar";
+            case ENGINE_SSE2_X4:    return "SSE2 x4";
+            case ENGINE_AVX2_X8:    return "AVX2 x8";
+            case ENGINE_AVX512_X16: return "AVX-512 x16";
+        }
+        return "?";
+    }
+
+    // Requests for an engine the CPU lacks are clamped to the best available;
+    // threads = 0 uses every hardware thread for large buffers
+    explicit ChaCha20CPU(Engine requested = bestEngine(), unsigned int threads = 0, bool log = true)
+        : engine(std::min(requested, bestEngine())), num_threads(threads), verbose(log) {
+        if (num_threads == 0) num_threads = std::thread::hardware_concurrency();
+        if (num_threads == 0) num_threads = 4;
+        if (verbose) {
+            std::cout << "✓ ChaCha20 CPU implementation initialized (" << engineName(engine)
+                      << ", " << num_threads << " threads)" << std::endl;
+        }
+    }
+
+    Engine getEngine() const { return engine; }
+    unsigned int getThreads() const { return num_threads; }
+
+    // Keystream XOR using the selected engine. Large buffers are split on
+    // block boundaries across threads, each starting at its own counter.
+    void xorStream(const uint8_t* in, size_t len, const uint8_t* key, const uint8_t* nonce,
+                   uint32_t counter, uint8_t* out) const {
+        uint32_t state[16];
+        initState(state, key, nonce, counter);
+
+        size_t total_blocks = (len + CHACHA20_BLOCK_SIZE - 1) / CHACHA20_BLOCK_SIZE;
+        unsigned int workers = (len >= PARALLEL_THRESHOLD) ? (unsigned int)std::min<size_t>(num_threads, total_blocks) : 1;
+        if (workers <= 1) {
+            xorRange(in, len, state, out);
+            return;
+        }
+
+        std::vector<std::thread> threads(workers);
+        for (unsigned int t = 0; t < workers; t++) {
+            threads[t] = std::thread([=] {
+                size_t first = t * total_blocks / workers;
+                size_t last = (t + 1) * total_blocks / workers;
+                size_t off = first * CHACHA20_BLOCK_SIZE;
+                size_t end = std::min(len, last * CHACHA20_BLOCK_SIZE);
+
+                uint32_t local[16];
+                memcpy(local, state, sizeof(local));
+                local[12] += (uint32_t)first;
+                xorRange(in + off, end - off, local, out + off);
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    // Scalar reference: raw keystream XOR over `len` bytes starting at block `counter`
+    static void xorStreamScalar(const uint8_t* in, size_t len, const uint8_t* key, const uint8_t* nonce,
+                                uint32_t counter, uint8_t* out) {
+        uint32_t state[16];
+        uint8_t keystream[CHACHA20_BLOCK_SIZE];
+        initState(state, key, nonce, counter);
+        for (size_t off = 0; off < len; off += CHACHA20_BLOCK_SIZE) {
+            block(state, keystream);
+            size_t n = std::min<size_t>(CHACHA20_BLOCK_SIZE, len - off);
+            for (size_t i = 0; i < n; i++) {
+                out[off + i] = in[off + i] ^ keystream[i];
+            }
+            state[12]++;
+        }
+    }
+
+    // HChaCha20(key, nonce[0..15]) -> 256-bit subkey
+    static void hchacha20(const uint8_t* key, const uint8_t* nonce16, uint8_t subkey[CHACHA20_KEY_SIZE]) {
+        // Words 12..15 take the 16-byte input, first word in the counter slot
+        uint32_t x[16];
+        initState(x, key, nonce16 + 4, load_le32(nonce16));
+        for (int i = 0; i < 10; i++) {
+            quarterRound(x[0], x[4], x[8],  x[12]);
+            quarterRound(x[1], x[5], x[9],  x[13]);
+            quarterRound(x[2], x[6], x[10], x[14]);
+            quarterRound(x[3], x[7], x[11], x[15]);
+            quarterRound(x[0], x[5], x[10], x[15]);
+            quarterRound(x[1], x[6], x[11], x[12]);
+            quarterRound(x[2], x[7], x[8],  x[13]);
+            quarterRound(x[3], x[4], x[9],  x[14]);
+        }
+        for (int i = 0; i < 4; i++) {
+            store_le32(subkey + i * 4, x[i]);
+            store_le32(subkey + 16 + i * 4, x[12 + i]);
+        }
+    }
+
+    // Subkeys for many (key, nonce) pairs, eight per AVX2 pass
+    void hchacha20Batch(const uint8_t* const* keys, const uint8_t* const* nonces, size_t count,
+                        uint8_t (*subkeys)[CHACHA20_KEY_SIZE]) const {
+        size_t i = 0;
+        if (engine >= ENGINE_AVX2_X8) {
+            uint32_t in[8][16], out[8][8];
+            for (; i + 8 <= count; i += 8) {
+                for (int l = 0; l < 8; l++) {
+                    initState(in[l], keys[i + l], nonces[i + l] + 4, load_le32(nonces[i + l]));
+                }
+                hchacha20_x8(in, out);
+                for (int l = 0; l < 8; l++) {
+                    for (int w = 0; w < 8; w++) {
+                        store_le32(subkeys[i + l] + w * 4, out[l][w]);
+                    }
+                }
+            }
+        }
+        for (; i < count; i++) {
+            hchacha20(keys[i], nonces[i], subkeys[i]);
+        }
+    }
+
+    // XChaCha20 over `len` bytes with a 24-byte nonce
+    void xorStreamX(const uint8_t* in, size_t len, const uint8_t* key, const uint8_t* nonce,
+                    uint32_t counter, uint8_t* out) const {
+        uint8_t subkey[CHACHA20_KEY_SIZE];
+        uint8_t inner_nonce[CHACHA20_NONCE_SIZE] = {0};
+        hchacha20(key, nonce, subkey);
+        memcpy(inner_nonce + 4, nonce + 16, 8);
+        xorStream(in, len, subkey, inner_nonce, counter, out);
+    }
+
+    // Many short XChaCha20 messages: derive every subkey in one batched
+    // pass, then run the keystreams
+    struct XMessage {
+        const uint8_t* key;
+        const uint8_t* nonce;       // 24 bytes
+        uint32_t counter;
+        const uint8_t* input;
+        uint8_t* output;
+        size_t length;
+    };
+
+    void xchacha20Batch(const std::vector<XMessage>& msgs) const {
+        std::vector<const uint8_t*> keys(msgs.size()), nonces(msgs.size());
+        std::vector<uint8_t> subkeys(msgs.size() * CHACHA20_KEY_SIZE);
+        for (size_t i = 0; i < msgs.size(); i++) {
+            keys[i] = msgs[i].key;
+            nonces[i] = msgs[i].nonce;
+        }
+        hchacha20Batch(keys.data(), nonces.data(), msgs.size(), (uint8_t (*)[CHACHA20_KEY_SIZE])subkeys.data());
+
+        uint8_t inner_nonce[CHACHA20_NONCE_SIZE] = {0};
+        for (size_t i = 0; i < msgs.size(); i++) {
+            memcpy(inner_nonce + 4, msgs[i].nonce + 16, 8);
+            xorStream(msgs[i].input, msgs[i].length, &subkeys[i * CHACHA20_KEY_SIZE], inner_nonce,
+                      msgs[i].counter, msgs[i].output);
+        }
+    }
+
+    // Same interface as the FPGA kernel
+    void encrypt(const uint8_t* plaintext, const uint8_t* key, const uint8_t* nonce,
+                 uint32_t counter, uint8_t* ciphertext, int num_blocks) {
+        size_t data_size = (size_t)num_blocks * CHACHA20_BLOCK_SIZE;
+
+        auto start = std::chrono::high_resolution_clock::now();
+        xorStream(plaintext, data_size, key, nonce, counter, ciphertext);
+        auto end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double, std::micro> duration = end - start;
+
+        std::cout << "✓ Encryption completed in " << std::fixed << std::setprecision(2)
+                  << duration.count() << " μs" << std::endl;
+
+        double data_mb = (double)data_size / (1024.0 * 1024.0);
+        double time_sec = duration.count() / 1000000.0;
+        double throughput = data_mb / time_sec;
+
+        std::cout << "✓ Throughput: " << std::fixed << std::setprecision(2)
+                  << throughput << " MB/s" << std::endl;
+    }
+
+    // RFC 8439 AEAD encryption: keystream block 0 keys Poly1305, payload
+    // starts at counter 1, and each block is MACed right after it is
+    // produced while it is still in cache
+    static void seal(const uint8_t* plaintext, size_t len, const uint8_t* aad, size_t aad_len,
+                     const uint8_t* key, const uint8_t* nonce, uint8_t* ciphertext,
+                     uint8_t tag[POLY1305_TAG_SIZE]) {
+        uint32_t state[16];
+        uint8_t keystream[CHACHA20_BLOCK_SIZE];
+        initState(state, key, nonce, 0);
+        block(state, keystream);
+        Poly1305 mac(keystream);
+
+        mac.update(aad, aad_len);
+        mac.padToBlock();
+        for (size_t off = 0; off < len; off += CHACHA20_BLOCK_SIZE) {
+            state[12]++;
+            block(state, keystream);
+            size_t n = std::min<size_t>(CHACHA20_BLOCK_SIZE, len - off);
+            for (size_t i = 0; i < n; i++) {
+                ciphertext[off + i] = plaintext[off + i] ^ keystream[i];
+            }
+            mac.update(ciphertext + off, n);
+        }
+        mac.padToBlock();
+
+        uint8_t lengths[16];
+        store_le64(lengths, aad_len);
+        store_le64(lengths + 8, len);
+        mac.update(lengths, sizeof(lengths));
+        mac.finish(tag);
+    }
+
+    // Verifies the tag before decrypting; returns false and leaves
+    // `plaintext` untouched on mismatch
+    static bool open(const uint8_t* ciphertext, size_t len, const uint8_t* aad, size_t aad_len,
+                     const uint8_t* key, const uint8_t* nonce, const uint8_t tag[POLY1305_TAG_SIZE],
+                     uint8_t* plaintext) {
+        uint32_t state[16];
+        uint8_t keystream[CHACHA20_BLOCK_SIZE];
+        initState(state, key, nonce, 0);
+        block(state, keystream);
+        Poly1305 mac(keystream);
+
+        uint8_t expected[POLY1305_TAG_SIZE];
+        computeTag(mac, aad, aad_len, ciphertext, len, expected);
+
+        uint8_t diff = 0;
+        for (int i = 0; i < POLY1305_TAG_SIZE; i++) {
+            diff |= expected[i] ^ tag[i];
+        }
+        if (diff != 0) return false;
+
+        xorStreamScalar(ciphertext, len, key, nonce, 1, plaintext);
+        return true;
+    }
+
+    ~ChaCha20CPU() {
+        if (verbose) std::cout << "✓ ChaCha20 CPU cleanup completed" << std::endl;
+    }
+};
+
+void printHex(const std::string& label, const uint8_t* data, int size) {
+    std::cout << label << ": ";
+    for (int i = 0; i < size; i++) {
+        std::cout << std::hex << std::setw(2) << std::setfill('0') << (int)data[i];
+        if ((i + 1) % 16 == 0 && i + 1 < size) std::cout << "\n" << std::string(label.length() + 2, ' ');
+        else if (i + 1 < size) std::cout << " ";
+    }
+    std::cout << std::dec << std::endl;
+}
+
+// Large enough to take the threaded path
+static const size_t PARALLEL_LENGTH = 2 * ChaCha20CPU::PARALLEL_THRESHOLD + 4 * CHACHA20_BLOCK_SIZE + 33;
+
+bool runTestVectors(ChaCha20CPU& chacha20) {
+    std::cout << "\n=== ChaCha20 Test Vectors ===" << std::endl;
+    bool all_ok = true;
+
+    const char* sunscreen = "Ladies and Gentlemen of the class of '99: If I could offer you only one tip "
+                            "for the future, sunscreen would be it.";
+    const size_t sunscreen_len = strlen(sunscreen);
+
+    // Test 1: RFC 8439 section 2.4.2 (counter 1); the kernel interface
+    // works in whole blocks, so only the first block is compared there
+    {
+        uint8_t key[32];
+        for (int i = 0; i < 32; i++) key[i] = i;
+        uint8_t nonce[12] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x4a, 0x00, 0x00, 0x00, 0x00};
+        const uint8_t expected[114] = {
+            0x6e, 0x2e, 0x35, 0x9a, 0x25, 0x68, 0xf9, 0x80, 0x41, 0xba, 0x07, 0x28, 0xdd, 0x0d, 0x69, 0x81,
+            0xe9, 0x7e, 0x7a, 0xec, 0x1d, 0x43, 0x60, 0xc2, 0x0a, 0x27, 0xaf, 0xcc, 0xfd, 0x9f, 0xae, 0x0b,
+            0xf9, 0x1b, 0x65, 0xc5, 0x52, 0x47, 0x33, 0xab, 0x8f, 0x59, 0x3d, 0xab, 0xcd, 0x62, 0xb3, 0x57,
+            0x16, 0x39, 0xd6, 0x24, 0xe6, 0x51, 0x52, 0xab, 0x8f, 0x53, 0x0c, 0x35, 0x9f, 0x08, 0x61, 0xd8,
+            0x07, 0xca, 0x0d, 0xbf, 0x50, 0x0d, 0x6a, 0x61, 0x56, 0xa3, 0x8e, 0x08, 0x8a, 0x22, 0xb6, 0x5e,
+            0x52, 0xbc, 0x51, 0x4d, 0x16, 0xcc, 0xf8, 0x06, 0x81, 0x8c, 0xe9, 0x1a, 0xb7, 0x79, 0x37, 0x36,
+            0x5a, 0xf9, 0x0b, 0xbf, 0x74, 0xa3, 0x5b, 0xe6, 0xb4, 0x0b, 0x8e, 0xed, 0xf2, 0x78, 0x5e, 0x42,
+            0x87, 0x4d
+        };
+
+        std::cout << "\nTest 1: ChaCha20 encryption (RFC 8439 2.4.2)" << std::endl;
+        uint8_t block_ct[64];
+        chacha20.encrypt((const uint8_t*)sunscreen, key, nonce, 1, block_ct, 1);
+        uint8_t ciphertext[114];
+        chacha20.xorStream((const uint8_t*)sunscreen, sunscreen_len, key, nonce, 1, ciphertext);
+        printHex("Ciphertext (first 32 bytes)", ciphertext, 32);
+
+        bool ok = memcmp(ciphertext, expected, sunscreen_len) == 0 && memcmp(block_ct, expected, 64) == 0;
+        std::cout << (ok ? "✓ Test vector PASSED!" : "✗ Test vector FAILED!") << std::endl;
+        all_ok &= ok;
+    }
+
+    // Test 2: Poly1305 (RFC 8439 section 2.5.2)
+    {
+        const uint8_t key[32] = {
+            0x85, 0xd6, 0xbe, 0x78, 0x57, 0x55, 0x6d, 0x33, 0x7f, 0x44, 0x52, 0xfe, 0x42, 0xd5, 0x06, 0xa8,
+            0x01, 0x03, 0x80, 0x8a, 0xfb, 0x0d, 0xb2, 0xfd, 0x4a, 0xbf, 0xf6, 0xaf, 0x41, 0x49, 0xf5, 0x1b
+        };
+        const uint8_t expected[16] = {
+            0xa8, 0x06, 0x1d, 0xc1, 0x30, 0x51, 0x36, 0xc6, 0xc2, 0x2b, 0x8b, 0xaf, 0x0c, 0x01, 0x27, 0xa9
+        };
+        const char* msg = "Cryptographic Forum Research Group";
+
+        std::cout << "\nTest 2: Poly1305 (RFC 8439 2.5.2)" << std::endl;
+        Poly1305 mac(key);
+        uint8_t tag[16];
+        mac.update((const uint8_t*)msg, strlen(msg));
+        mac.finish(tag);
+        printHex("Tag", tag, 16);
+
+        bool ok = memcmp(tag, expected, 16) == 0;
+        std::cout << (ok ? "✓ Test vector PASSED!" : "✗ Test vector FAILED!") << std::endl;
+        all_ok &= ok;
+    }
+
+    // Test 3: ChaCha20-Poly1305 AEAD (RFC 8439 section 2.8.2)
+    {
+        uint8_t key[32];
+        for (int i = 0; i < 32; i++) key[i] = 0x80 + i;
+        uint8_t nonce[12] = {0x07, 0x00, 0x00, 0x00, 0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47};
+        uint8_t aad[12] = {0x50, 0x51, 0x52, 0x53, 0xc0, 0xc1, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7};
+        const uint8_t expected_ct[16] = {
+            0xd3, 0x1a, 0x8d, 0x34, 0x64, 0x8e, 0x60, 0xdb, 0x7b, 0x86, 0xaf, 0xbc, 0x53, 0xef, 0x7e, 0xc2
+        };
+        const uint8_t expected_tag[16] = {
+            0x1a, 0xe1, 0x0b, 0x59, 0x4f, 0x09, 0xe2, 0x6a, 0x7e, 0x90, 0x2e, 0xcb, 0xd0, 0x60, 0x06, 0x91
+        };
+
+        std::cout << "\nTest 3: ChaCha20-Poly1305 AEAD (RFC 8439 2.8.2)" << std::endl;
+        uint8_t ciphertext[114], decrypted[114], tag[16];
+        ChaCha20CPU::seal((const uint8_t*)sunscreen, sunscreen_len, aad, sizeof(aad), key, nonce, ciphertext, tag);
+        printHex("Tag", tag, 16);
+
+        bool sealed = memcmp(ciphertext, expected_ct, 16) == 0 && memcmp(tag, expected_tag, 16) == 0;
+        bool opened = ChaCha20CPU::open(ciphertext, sunscreen_len, aad, sizeof(aad), key, nonce, tag, decrypted) &&
+                      memcmp(decrypted, sunscreen, sunscreen_len) == 0;
+        ciphertext[50] ^= 1;
+        bool rejected = !ChaCha20CPU::open(ciphertext, sunscreen_len, aad, sizeof(aad), key, nonce, tag, decrypted);
+
+        bool ok = sealed && opened && rejected;
+        std::cout << "Seal: " << (sealed ? "✓" : "✗") << "  Open: " << (opened ? "✓" : "✗")
+                  << "  Tamper rejected: " << (rejected ? "✓" : "✗") << std::endl;
+        std::cout << (ok ? "✓ Test vector PASSED!" : "✗ Test vector FAILED!") << std::endl;
+        all_ok &= ok;
+    }
+
+    // Test 4: every SIMD engine against the scalar reference, over lengths
+    // that exercise each kernel width, the tails and the threaded split
+    {
+        std::cout << "\nTest 4: SIMD engines match scalar reference" << std::endl;
+        const size_t lengths[] = {0, 1, 63, 64, 65, 255, 256, 511, 512, 1023, 1024, 1025,
+                                  1791, 3000, 4096 + 960 + 17, PARALLEL_LENGTH};
+        uint8_t key[32], nonce[12];
+        for (int i = 0; i < 32; i++) key[i] = rand() & 0xFF;
+        for (int i = 0; i < 12; i++) nonce[i] = rand() & 0xFF;
+        std::vector<uint8_t> input(PARALLEL_LENGTH), expected(PARALLEL_LENGTH), actual(PARALLEL_LENGTH);
+        for (size_t i = 0; i < input.size(); i++) input[i] = rand() & 0xFF;
+
+        // Counter near 2^32 checks the lane-wise wrap matches the scalar one
+        const uint32_t counters[] = {1, 0xfffffff9u};
+        for (int e = ChaCha20CPU::ENGINE_SSE2_X4; e <= ChaCha20CPU::bestEngine(); e++) {
+            ChaCha20CPU engine((ChaCha20CPU::Engine)e, 4, false);
+            bool ok = true;
+            for (uint32_t counter : counters) {
+                for (size_t len : lengths) {
+                    ChaCha20CPU::xorStreamScalar(input.data(), len, key, nonce, counter, expected.data());
+                    engine.xorStream(input.data(), len, key, nonce, counter, actual.data());
+                    ok &= memcmp(expected.data(), actual.data(), len) == 0;
+                }
+            }
+            std::cout << "  " << std::setfill(' ') << std::left << std::setw(12) << ChaCha20CPU::engineName(engine.getEngine())
+                      << std::right << (ok ? "✓ PASSED" : "✗ FAILED") << std::endl;
+            all_ok &= ok;
+        }
+    }
+
+    // Test 5: XChaCha20, draft-irtf-cfrg-xchacha-03 A.3.2 (counter 1), and
+    // batched subkey derivation against one-at-a-time derivation
+    {
+        std::cout << "\nTest 5: XChaCha20 (draft-irtf-cfrg-xchacha A.3.2)" << std::endl;
+        const char* dhole = "The dhole (pronounced \"dole\") is also known as the Asiatic wild dog, red dog, "
+                            "and whistling dog. It is about the size of a German shepherd but looks more like "
+                            "a long-legged fox. This highly elusive and skilled jumper is classified with "
+                            "wolves, coyotes, jackals, and foxes in the taxonomic family Canidae.";
+        uint8_t key[32];
+        for (int i = 0; i < 32; i++) key[i] = 0x80 + i;
+        uint8_t nonce[XCHACHA20_NONCE_SIZE] = {
+            0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4a, 0x4b,
+            0x4c, 0x4d, 0x4e, 0x4f, 0x50, 0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x58
+        };
+        const uint8_t expected[304] = {
+        0x7d, 0x0a, 0x2e, 0x6b, 0x7f, 0x7c, 0x65, 0xa2, 0x36, 0x54, 0x26, 0x30, 0x29, 0x4e, 0x06, 0x3b,
+        0x7a, 0xb9, 0xb5, 0x55, 0xa5, 0xd5, 0x14, 0x9a, 0xa2, 0x1e, 0x4a, 0xe1, 0xe4, 0xfb, 0xce, 0x87,
+        0xec, 0xc8, 0xe0, 0x8a, 0x8b, 0x5e, 0x35, 0x0a, 0xbe, 0x62, 0x2b, 0x2f, 0xfa, 0x61, 0x7b, 0x20,
+        0x2c, 0xfa, 0xd7, 0x20, 0x32, 0xa3, 0x03, 0x7e, 0x76, 0xff, 0xdc, 0xdc, 0x43, 0x76, 0xee, 0x05,
+        0x3a, 0x19, 0x0d, 0x7e, 0x46, 0xca, 0x1d, 0xe0, 0x41, 0x44, 0x85, 0x03, 0x81, 0xb9, 0xcb, 0x29,
+        0xf0, 0x51, 0x91, 0x53, 0x86, 0xb8, 0xa7, 0x10, 0xb8, 0xac, 0x4d, 0x02, 0x7b, 0x8b, 0x05, 0x0f,
+        0x7c, 0xba, 0x58, 0x54, 0xe0, 0x28, 0xd5, 0x64, 0xe4, 0x53, 0xb8, 0xa9, 0x68, 0x82, 0x41, 0x73,
+        0xfc, 0x16, 0x48, 0x8b, 0x89, 0x70, 0xca, 0xc8, 0x28, 0xf1, 0x1a, 0xe5, 0x3c, 0xab, 0xd2, 0x01,
+        0x12, 0xf8, 0x71, 0x07, 0xdf, 0x24, 0xee, 0x61, 0x83, 0xd2, 0x27, 0x4f, 0xe4, 0xc8, 0xb1, 0x48,
+        0x55, 0x34, 0xef, 0x2c, 0x5f, 0xbc, 0x1e, 0xc2, 0x4b, 0xfc, 0x36, 0x63, 0xef, 0xaa, 0x08, 0xbc,
+        0x04, 0x7d, 0x29, 0xd2, 0x50, 0x43, 0x53, 0x2d, 0xb8, 0x39, 0x1a, 0x8a, 0x3d, 0x77, 0x6b, 0xf4,
+        0x37, 0x2a, 0x69, 0x55, 0x82, 0x7c, 0xcb, 0x0c, 0xdd, 0x4a, 0xf4, 0x03, 0xa7, 0xce, 0x4c, 0x63,
+        0xd5, 0x95, 0xc7, 0x5a, 0x43, 0xe0, 0x45, 0xf0, 0xcc, 0xe1, 0xf2, 0x9c, 0x8b, 0x93, 0xbd, 0x65,
+        0xaf, 0xc5, 0x97, 0x49, 0x22, 0xf2, 0x14, 0xa4, 0x0b, 0x7c, 0x40, 0x2c, 0xdb, 0x91, 0xae, 0x73,
+        0xc0, 0xb6, 0x36, 0x15, 0xcd, 0xad, 0x04, 0x80, 0x68, 0x0f, 0x16, 0x51, 0x5a, 0x7a, 0xce, 0x9d,
+        0x39, 0x23, 0x64, 0x64, 0x32, 0x8a, 0x37, 0x74, 0x3f, 0xfc, 0x28, 0xf4, 0xdd, 0xb3, 0x24, 0xf4,
+        0xd0, 0xf5, 0xbb, 0xdc, 0x27, 0x0c, 0x65, 0xb1, 0x74, 0x9a, 0x6e, 0xff, 0xf1, 0xfb, 0xaa, 0x09,
+        0x53, 0x61, 0x75, 0xcc, 0xd2, 0x9f, 0xb9, 0xe6, 0x05, 0x7b, 0x30, 0x73, 0x20, 0xd3, 0x16, 0x83,
+        0x8a, 0x9c, 0x71, 0xf7, 0x0b, 0x5b, 0x59, 0x07, 0xa6, 0x6f, 0x7e, 0xa4, 0x9a, 0xad, 0xc4, 0x09
+        };
+
+        uint8_t ciphertext[304];
+        chacha20.xorStreamX((const uint8_t*)dhole, strlen(dhole), key, nonce, 1, ciphertext);
+        printHex("Ciphertext (first 32 bytes)", ciphertext, 32);
+        bool vector_ok = strlen(dhole) == 304 && memcmp(ciphertext, expected, 304) == 0;
+
+        // 37 messages: four full AVX2 derivation groups plus a scalar tail
+        const int num_msgs = 37;
+        std::vector<uint8_t> keys(num_msgs * 32), nonces(num_msgs * XCHACHA20_NONCE_SIZE);
+        std::vector<uint8_t> input(num_msgs * 100), batched(num_msgs * 100), single(num_msgs * 100);
+        for (auto& b : keys) b = rand() & 0xFF;
+        for (auto& b : nonces) b = rand() & 0xFF;
+        for (auto& b : input) b = rand() & 0xFF;
+        std::vector<ChaCha20CPU::XMessage> msgs(num_msgs);
+        for (int m = 0; m < num_msgs; m++) {
+            msgs[m] = {&keys[m * 32], &nonces[m * XCHACHA20_NONCE_SIZE], (uint32_t)m,
+                       &input[m * 100], &batched[m * 100], (size_t)(m * 37 % 101)};
+            chacha20.xorStreamX(msgs[m].input, msgs[m].length, msgs[m].key, msgs[m].nonce, msgs[m].counter,
+                                &single[m * 100]);
+        }
+        chacha20.xchacha20Batch(msgs);
+        bool batch_ok = true;
+        for (int m = 0; m < num_msgs; m++) {
+            batch_ok &= memcmp(&single[m * 100], &batched[m * 100], msgs[m].length) == 0;
+        }
+
+        bool ok = vector_ok && batch_ok;
+        std::cout << "Vector: " << (vector_ok ? "✓" : "✗") << "  Batched derivation: " << (batch_ok ? "✓" : "✗") << std::endl;
+        std::cout << (ok ? "✓ Test vector PASSED!" : "✗ Test vector FAILED!") << std::endl;
+        all_ok &= ok;
+    }
+
+    return all_ok;
+}
+
+void runPerformanceTest(ChaCha20CPU& chacha20) {
+    std::cout << "\n=== Performance Test ===" << std::endl;
+
+    const int test_blocks[] = {1, 4, 16, 64, 256};
+    const int num_tests = sizeof(test_blocks) / sizeof(test_blocks[0]);
+
+    uint8_t key[32];
+    uint8_t nonce[12];
+    for (int i = 0; i < 32; i++) {
+        key[i] = rand() & 0xFF;
+    }
+    for (int i = 0; i < 12; i++) {
+        nonce[i] = rand() & 0xFF;
+    }
+    uint32_t counter = 1;
+
+    for (int t = 0; t < num_tests; t++) {
+        int blocks = test_blocks[t];
+        size_t data_size = blocks * CHACHA20_BLOCK_SIZE;
+
+        std::vector<uint8_t> plaintext(data_size);
+        std::vector<uint8_t> ciphertext(data_size);
+
+        for (size_t i = 0; i < data_size; i++) {
+            plaintext[i] = rand() & 0xFF;
+        }
+
+        std::cout << "\nTest " << (t+1) << ": " << blocks << " blocks ("
+                  << data_size << " bytes, " << std::fixed << std::setprecision(1)
+                  << (double)data_size / 1024.0 << " KB)" << std::endl;
+
+        chacha20.encrypt(plaintext.data(), key, nonce, counter, ciphertext.data(), blocks);
+    }
+}
+
+void runStressTest(ChaCha20CPU& chacha20) {
+    std::cout << "\n=== Stress Test ===" << std::endl;
+
+    const int max_blocks = 512;  // 32KB per iteration
+    const int iterations = 50;
+
+    std::vector<uint8_t> plaintext(max_blocks * CHACHA20_BLOCK_SIZE);
+    std::vector<uint8_t> ciphertext(max_blocks * CHACHA20_BLOCK_SIZE);
+    uint8_t key[32];
+    uint8_t nonce[12];
+    uint32_t counter = 1;
+
+    for (size_t i = 0; i < plaintext.size(); i++) {
+        plaintext[i] = rand() & 0xFF;
+    }
+    for (int i = 0; i < 32; i++) {
+        key[i] = rand() & 0xFF;
+    }
+    for (int i = 0; i < 12; i++) {
+        nonce[i] = rand() & 0xFF;
+    }
+
+    std::cout << "Running " << iterations << " iterations of " << max_blocks
+              << " blocks each (" << (max_blocks * CHACHA20_BLOCK_SIZE / 1024) << " KB per iteration)..." << std::endl;
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    for (int i = 0; i < iterations; i++) {
+        chacha20.xorStream(plaintext.data(), plaintext.size(), key, nonce, counter, ciphertext.data());
+        if ((i + 1) % 10 == 0) {
+            std::cout << "Completed " << (i + 1) << "/" << iterations << " iterations" << std::endl;
+        }
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    double time_sec = std::chrono::duration<double>(end - start).count();
+
+    double total_data_mb = (double)(iterations * max_blocks * CHACHA20_BLOCK_SIZE) / (1024.0 * 1024.0);
+    double avg_throughput = total_data_mb / time_sec;
+
+    std::cout << "✓ Stress test completed!" << std::endl;
+    std::cout << "Total data processed: " << std::fixed << std::setprecision(2)
+              << total_data_mb << " MB" << std::endl;
+    std::cout << "Total time: " << std::setprecision(3) << time_sec << " seconds" << std::endl;
+    std::cout << "Average throughput: " << std::setprecision(2) << avg_throughput << " MB/s" << std::endl;
+}
+
+// Sealed MB/s across message sizes, next to the raw cipher for the cost of the MAC
+void runAEADPerformanceTest() {
+    std::cout << "\n=== ChaCha20-Poly1305 AEAD Performance ===" << std::endl;
+
+    const size_t sizes[] = {64, 1024, 16384, 1024 * 1024};
+    uint8_t key[32], nonce[12], aad[16], tag[16];
+    for (int i = 0; i < 32; i++) key[i] = rand() & 0xFF;
+    for (int i = 0; i < 12; i++) nonce[i] = rand() & 0xFF;
+    for (int i = 0; i < 16; i++) aad[i] = rand() & 0xFF;
+
+    for (size_t size : sizes) {
+        std::vector<uint8_t> plaintext(size), ciphertext(size);
+        for (size_t i = 0; i < size; i++) {
+            plaintext[i] = rand() & 0xFF;
+        }
+        int reps = (int)std::max<size_t>(1, (64 * 1024 * 1024) / size);
+
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int r = 0; r < reps; r++) {
+            ChaCha20CPU::xorStreamScalar(plaintext.data(), size, key, nonce, 1, ciphertext.data());
+        }
+        auto mid = std::chrono::high_resolution_clock::now();
+        for (int r = 0; r < reps; r++) {
+            ChaCha20CPU::seal(plaintext.data(), size, aad, sizeof(aad), key, nonce, ciphertext.data(), tag);
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+
+        double mb = (double)size * reps / (1024.0 * 1024.0);
+        double cipher_sec = std::chrono::duration<double>(mid - start).count();
+        double aead_sec = std::chrono::duration<double>(end - mid).count();
+        std::cout << std::setfill(' ') << std::setw(8) << size << " bytes: ChaCha20 (scalar) " << std::fixed << std::setprecision(2)
+                  << mb / cipher_sec << " MB/s, AEAD seal " << mb / aead_sec << " MB/s ("
+                  << std::setprecision(0) << (double)reps / aead_sec << " msgs/s)" << std::endl;
+    }
+}
+
+// MB/s of every engine at a few buffer sizes, single-threaded, plus the
+// best engine spread over all hardware threads
+void runEngineComparison() {
+    std::cout << "\n=== CPU Engine Comparison ===" << std::endl;
+
+    const size_t sizes[] = {4096, 64 * 1024, 16 * 1024 * 1024};
+    uint8_t key[32], nonce[12];
+    for (int i = 0; i < 32; i++) key[i] = rand() & 0xFF;
+    for (int i = 0; i < 12; i++) nonce[i] = rand() & 0xFF;
+    std::vector<uint8_t> input(sizes[2]), output(sizes[2]);
+    for (size_t i = 0; i < input.size(); i++) input[i] = rand() & 0xFF;
+
+    std::vector<ChaCha20CPU> engines;
+    for (int e = ChaCha20CPU::ENGINE_SCALAR; e <= ChaCha20CPU::bestEngine(); e++) {
+        engines.emplace_back((ChaCha20CPU::Engine)e, 1, false);
+    }
+    // All hardware threads, unless that is the single-thread row again
+    ChaCha20CPU all_threads(ChaCha20CPU::bestEngine(), 0, false);
+    if (all_threads.getThreads() > 1) engines.push_back(std::move(all_threads));
+
+    std::cout << std::setfill(' ') << std::left << std::setw(26) << "Engine" << std::right;
+    for (size_t size : sizes) {
+        std::cout << std::setw(10) << size / 1024 << " KB";
+    }
+    std::cout << std::endl;
+
+    for (const ChaCha20CPU& engine : engines) {
+        std::string label = std::string(ChaCha20CPU::engineName(engine.getEngine())) +
+                            " (" + std::to_string(engine.getThreads()) + " thread" +
+                            (engine.getThreads() > 1 ? "s)" : ")");
+        std::cout << std::left << std::setw(26) << label << std::right;
+        for (size_t size : sizes) {
+            int reps = (int)std::max<size_t>(1, (64 * 1024 * 1024) / size);
+            auto start = std::chrono::high_resolution_clock::now();
+            for (int r = 0; r < reps; r++) {
+                engine.xorStream(input.data(), size, key, nonce, 1, output.data());
+            }
+            auto end = std::chrono::high_resolution_clock::now();
+            double time_sec = std::chrono::duration<double>(end - start).count();
+            double mb = (double)size * reps / (1024.0 * 1024.0);
+            std::cout << std::fixed << std::setprecision(1) << std::setw(13) << mb / time_sec;
+        }
+        std::cout << "  MB/s" << std::endl;
+    }
+}
+
+// Short messages with their own 192-bit nonces: derivation batched across
+// messages versus one HChaCha20 per message
+void runXChaChaPerformanceTest(ChaCha20CPU& chacha20) {
+    std::cout << "\n=== XChaCha20 Short-Message Performance ===" << std::endl;
+
+    const int num_msgs = 100000;
+    const size_t msg_len = 64;
+    std::vector<uint8_t> keys(16 * CHACHA20_KEY_SIZE), nonces(num_msgs * XCHACHA20_NONCE_SIZE);
+    std::vector<uint8_t> input(num_msgs * msg_len), output(num_msgs * msg_len);
+    for (auto& b : keys) b = rand() & 0xFF;
+    for (auto& b : nonces) b = rand() & 0xFF;
+    for (auto& b : input) b = rand() & 0xFF;
+
+    std::vector<ChaCha20CPU::XMessage> msgs(num_msgs);
+    for (int m = 0; m < num_msgs; m++) {
+        msgs[m] = {&keys[(m % 16) * CHACHA20_KEY_SIZE], &nonces[m * XCHACHA20_NONCE_SIZE], 1,
+                   &input[m * msg_len], &output[m * msg_len], msg_len};
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (const auto& m : msgs) {
+        chacha20.xorStreamX(m.input, m.length, m.key, m.nonce, m.counter, m.output);
+    }
+    auto mid = std::chrono::high_resolution_clock::now();
+    chacha20.xchacha20Batch(msgs);
+    auto end = std::chrono::high_resolution_clock::now();
+
+    double single_sec = std::chrono::duration<double>(mid - start).count();
+    double batch_sec = std::chrono::duration<double>(end - mid).count();
+    std::cout << num_msgs << " messages of " << msg_len << " bytes" << std::endl;
+    std::cout << "Per-message derivation: " << std::fixed << std::setprecision(0)
+              << num_msgs / single_sec << " msgs/s" << std::endl;
+    std::cout << "Batched derivation:     " << num_msgs / batch_sec << " msgs/s" << std::endl;
+}
+
+void runBenchmarkComparison() {
+    std::cout << "\n=== Benchmark Summary ===" << std::endl;
+    std::cout << "CPU Implementation: ChaCha20 and ChaCha20-Poly1305 (RFC 8439)" << std::endl;
+    std::cout << "Algorithm: 20 rounds (10 double rounds), Poly1305 on 44-bit limbs" << std::endl;
+    std::cout << "Engines: scalar, SSE2 x4, AVX2 x8, AVX-512 x16 block-parallel" << std::endl;
+    std::cout << "Block size: 512-bit (64 bytes)" << std::endl;
+    std::cout << "Key size: 256-bit (32 bytes), nonce 96-bit (12 bytes) or 192-bit (XChaCha20)" << std::endl;
+    std::cout << "\nFor comparison with FPGA accelerator:" << std::endl;
+    std::cout << "- Run both programs with identical test parameters" << std::endl;
+    std::cout << "- Compare throughput (MB/s) values" << std::endl;
+    std::cout << "- Note latency differences in microseconds" << std::endl;
+    std::cout << "- AEAD: the kernel MACs each block in the same pass as encryption" << std::endl;
+}
+
+int main() {
+    try {
+        std::cout << "=== ChaCha20 CPU Benchmark Application ===" << std::endl;
+        std::cout << "Platform: CPU-only implementation" << std::endl;
+        std::cout << "Purpose: Benchmarking comparison with FPGA accelerator" << std::endl;
+
+        ChaCha20CPU chacha20;
+
+        if (!runTestVectors(chacha20)) {
+            std::cerr << "Test vectors failed" << std::endl;
+            return 1;
+        }
+        runPerformanceTest(chacha20);
+        runStressTest(chacha20);
+        runEngineComparison();
+        runAEADPerformanceTest();
+        runXChaChaPerformanceTest(chacha20);
+        runBenchmarkComparison();
+
+        std::cout << "\n=== All tests completed successfully! ===" << std::endl;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Application failed: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -4,6 +4,7 @@
 #include <chrono>
 #include <cstring>
 #include <cstdlib>
+#include <stdexcept>
 
 // XRT includes for Xilinx Runtime
 #include "xrt/xrt_bo.h"
@@ -13,12 +14,159 @@
 #define CHACHA20_BLOCK_SIZE 64  // 512-bit block (64 bytes)
 #define CHACHA20_KEY_SIZE 32    // 256-bit key (32 bytes)
 #define CHACHA20_NONCE_SIZE 12  // 96-bit nonce (12 bytes)
+#define POLY1305_TAG_SIZE 16    // 128-bit AEAD tag
+#define AEAD_MAX_AAD 4096       // AAD buffer size for the AEAD kernel
+
+// Multi-stream kernels: descriptor = {key_index, nonce words, counter, offset, length, reserved...}
+#define CHACHA20_STREAM_DESC_WORDS 8
+#define XCHACHA20_STREAM_DESC_WORDS 12
+#define XCHACHA20_NONCE_SIZE 24
+#define STREAM_MAX_BYTES (1024 * 1024)
+#define STREAM_MAX_STREAMS 1024
+#define STREAM_MAX_KEYS 1024
+
+// One stream (e.g. a TLS connection record) for a multi-stream launch
+struct ChaCha20Stream {
+    uint32_t key_index;         // Entry in the key table
+    uint8_t nonce[CHACHA20_NONCE_SIZE];
+    uint32_t counter;
+    const uint8_t* input;
+    uint8_t* output;
+    size_t length;              // Any byte length
+};
+
+// Same, with a 192-bit XChaCha20 nonce; the subkey is derived on the device
+struct XChaCha20Stream {
+    uint32_t key_index;
+    uint8_t nonce[XCHACHA20_NONCE_SIZE];
+    uint32_t counter;
+    const uint8_t* input;
+    uint8_t* output;
+    size_t length;
+};
+
+// A multi-stream kernel and its buffers
+struct StreamKernel {
+    xrt::kernel kernel;
+    xrt::bo bo_in, bo_keys, bo_table, bo_out;
+    bool present = false;
+};
 
 class ChaCha20Host {
 private:
     xrt::device device;
     xrt::kernel kernel;
+    xrt::kernel aead_kernel;
     xrt::bo bo_plaintext, bo_key, bo_nonce, bo_ciphertext;
+    xrt::bo bo_aead_in, bo_aead_aad, bo_aead_key, bo_aead_nonce, bo_aead_out, bo_aead_tag;
+    bool has_aead = false;
+    size_t aead_capacity = 0;
+    xrt::kernel xchacha_kernel;
+    xrt::bo bo_xin, bo_xkey, bo_xnonce, bo_xout;
+    bool has_xchacha = false;
+    StreamKernel chacha_streams, xchacha_streams;
+    
+    static bool loadOptional(const xrt::device& dev, const xrt::uuid& uuid, const char* name, xrt::kernel& k) {
+        try {
+            k = xrt::kernel(dev, uuid, name);
+            return true;
+        } catch (const std::exception&) {
+            std::cout << "  (" << name << " kernel not found, disabled)" << std::endl;
+            return false;
+        }
+    }
+    
+    void allocateStreamBuffers(StreamKernel& sk, int desc_words) {
+        // (input, keys, stream_table, output, num_streams)
+        sk.bo_in = xrt::bo(device, STREAM_MAX_BYTES, sk.kernel.group_id(0));
+        sk.bo_keys = xrt::bo(device, STREAM_MAX_KEYS * CHACHA20_KEY_SIZE, sk.kernel.group_id(1));
+        sk.bo_table = xrt::bo(device, STREAM_MAX_STREAMS * desc_words * sizeof(uint32_t), sk.kernel.group_id(2));
+        sk.bo_out = xrt::bo(device, STREAM_MAX_BYTES, sk.kernel.group_id(3));
+    }
+    
+    // Packs stream data back to back (each start rounded up to a block
+    // boundary for aligned bursts), uploads the key table once and runs a
+    // single launch. Both descriptor layouts are {key_index, nonce words,
+    // counter, offset, length, reserved...}.
+    template <typename Stream>
+    void launchStreams(StreamKernel& sk, int desc_words, const std::vector<uint8_t>& key_table,
+                       const std::vector<Stream>& streams) {
+        const int nonce_words = sizeof(Stream::nonce) / 4;
+        size_t num_keys = key_table.size() / CHACHA20_KEY_SIZE;
+        if (streams.size() > STREAM_MAX_STREAMS || num_keys > STREAM_MAX_KEYS) {
+            throw std::runtime_error("Too many streams or keys for allocated buffers");
+        }
+        
+        auto in_map = sk.bo_in.map<uint8_t*>();
+        auto table_map = sk.bo_table.map<uint32_t*>();
+        size_t offset = 0;
+        for (size_t s = 0; s < streams.size(); s++) {
+            const Stream& st = streams[s];
+            if (st.key_index >= num_keys || offset + st.length > STREAM_MAX_BYTES) {
+                throw std::runtime_error("Stream exceeds key table or input buffer");
+            }
+            uint32_t* desc = &table_map[s * desc_words];
+            std::memset(desc, 0, desc_words * sizeof(uint32_t));
+            desc[0] = st.key_index;
+            for (int w = 0; w < nonce_words; w++) {
+                desc[1 + w] = (uint32_t)st.nonce[w * 4] | ((uint32_t)st.nonce[w * 4 + 1] << 8) |
+                              ((uint32_t)st.nonce[w * 4 + 2] << 16) | ((uint32_t)st.nonce[w * 4 + 3] << 24);
+            }
+            desc[1 + nonce_words] = st.counter;
+            desc[2 + nonce_words] = (uint32_t)offset;
+            desc[3 + nonce_words] = (uint32_t)st.length;
+            std::memcpy(in_map + offset, st.input, st.length);
+            offset += (st.length + CHACHA20_BLOCK_SIZE - 1) / CHACHA20_BLOCK_SIZE * CHACHA20_BLOCK_SIZE;
+        }
+        std::memcpy(sk.bo_keys.map<uint8_t*>(), key_table.data(), key_table.size());
+        
+        size_t table_bytes = streams.size() * desc_words * sizeof(uint32_t);
+        if (offset > 0) sk.bo_in.sync(XCL_BO_SYNC_BO_TO_DEVICE, offset, 0);
+        if (!key_table.empty()) sk.bo_keys.sync(XCL_BO_SYNC_BO_TO_DEVICE, key_table.size(), 0);
+        if (table_bytes > 0) sk.bo_table.sync(XCL_BO_SYNC_BO_TO_DEVICE, table_bytes, 0);
+        
+        auto run = sk.kernel(sk.bo_in, sk.bo_keys, sk.bo_table, sk.bo_out, (int)streams.size());
+        run.wait();
+        
+        if (offset > 0) sk.bo_out.sync(XCL_BO_SYNC_BO_FROM_DEVICE, offset, 0);
+        auto out_map = sk.bo_out.map<uint8_t*>();
+        for (size_t s = 0; s < streams.size(); s++) {
+            std::memcpy(streams[s].output, out_map + table_map[s * desc_words + 2 + nonce_words], streams[s].length);
+        }
+    }
+    
+    // Runs the fused kernel; the tag is the MAC over ciphertext in both directions
+    void runAEAD(const uint8_t* input, size_t len, const uint8_t* aad, size_t aad_len,
+                 const uint8_t* key, const uint8_t* nonce, int decrypt,
+                 uint8_t* output, uint8_t tag[POLY1305_TAG_SIZE]) {
+        if (!has_aead) {
+            throw std::runtime_error("chacha20_poly1305 kernel not present in xclbin");
+        }
+        if (len > aead_capacity || aad_len > AEAD_MAX_AAD) {
+            throw std::runtime_error("AEAD message exceeds allocated buffers");
+        }
+        
+        if (len > 0) std::memcpy(bo_aead_in.map<uint8_t*>(), input, len);
+        if (aad_len > 0) std::memcpy(bo_aead_aad.map<uint8_t*>(), aad, aad_len);
+        std::memcpy(bo_aead_key.map<uint8_t*>(), key, CHACHA20_KEY_SIZE);
+        std::memcpy(bo_aead_nonce.map<uint8_t*>(), nonce, CHACHA20_NONCE_SIZE);
+        
+        if (len > 0) bo_aead_in.sync(XCL_BO_SYNC_BO_TO_DEVICE, len, 0);
+        if (aad_len > 0) bo_aead_aad.sync(XCL_BO_SYNC_BO_TO_DEVICE, aad_len, 0);
+        bo_aead_key.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+        bo_aead_nonce.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+        
+        auto run = aead_kernel(bo_aead_in, bo_aead_aad, bo_aead_key, bo_aead_nonce,
+                               bo_aead_out, bo_aead_tag, (int)aad_len, (int)len, decrypt);
+        run.wait();
+        
+        if (len > 0) {
+            bo_aead_out.sync(XCL_BO_SYNC_BO_FROM_DEVICE, len, 0);
+            std::memcpy(output, bo_aead_out.map<uint8_t*>(), len);
+        }
+        bo_aead_tag.sync(XCL_BO_SYNC_BO_FROM_DEVICE);
+        std::memcpy(tag, bo_aead_tag.map<uint8_t*>(), POLY1305_TAG_SIZE);
+    }
     
 public:
     ChaCha20Host(const std::string& xclbin_path, int device_id = 0) {
@@ -30,6 +178,12 @@ public:
             // Create kernel
             kernel = xrt::kernel(device, uuid, "chacha20_encrypt");
             
+            // The other kernels are optional; older xclbins only carry the cipher
+            has_aead = loadOptional(device, uuid, "chacha20_poly1305", aead_kernel);
+            chacha_streams.present = loadOptional(device, uuid, "chacha20_encrypt_streams", chacha_streams.kernel);
+            has_xchacha = loadOptional(device, uuid, "xchacha20_encrypt", xchacha_kernel);
+            xchacha_streams.present = loadOptional(device, uuid, "xchacha20_encrypt_streams", xchacha_streams.kernel);
+            
             std::cout << "✓ ChaCha20 Hardware accelerator initialized successfully" << std::endl;
         } catch (const std::exception& e) {
             std::cerr << "Error initializing ChaCha20 accelerator: " << e.what() << std::endl;
@@ -50,6 +204,31 @@ public:
             bo_nonce = xrt::bo(device, nonce_size, kernel.group_id(2));
             bo_ciphertext = xrt::bo(device, ciphertext_size, kernel.group_id(4));
             
+            if (has_aead) {
+                // (input, aad, key, nonce, output, tag, aad_len, msg_len, decrypt)
+                bo_aead_in = xrt::bo(device, plaintext_size, aead_kernel.group_id(0));
+                bo_aead_aad = xrt::bo(device, AEAD_MAX_AAD, aead_kernel.group_id(1));
+                bo_aead_key = xrt::bo(device, key_size, aead_kernel.group_id(2));
+                bo_aead_nonce = xrt::bo(device, nonce_size, aead_kernel.group_id(3));
+                bo_aead_out = xrt::bo(device, ciphertext_size, aead_kernel.group_id(4));
+                bo_aead_tag = xrt::bo(device, POLY1305_TAG_SIZE, aead_kernel.group_id(5));
+                aead_capacity = plaintext_size;
+            }
+            
+            if (chacha_streams.present) {
+                allocateStreamBuffers(chacha_streams, CHACHA20_STREAM_DESC_WORDS);
+            }
+            if (xchacha_streams.present) {
+                allocateStreamBuffers(xchacha_streams, XCHACHA20_STREAM_DESC_WORDS);
+            }
+            if (has_xchacha) {
+                // Same argument layout as chacha20_encrypt, with a 24-byte nonce
+                bo_xin = xrt::bo(device, plaintext_size, xchacha_kernel.group_id(0));
+                bo_xkey = xrt::bo(device, key_size, xchacha_kernel.group_id(1));
+                bo_xnonce = xrt::bo(device, XCHACHA20_NONCE_SIZE, xchacha_kernel.group_id(2));
+                bo_xout = xrt::bo(device, ciphertext_size, xchacha_kernel.group_id(4));
+            }
+            
             std::cout << "✓ Buffers allocated for " << max_blocks << " blocks" << std::endl;
             std::cout << "  - Plaintext/Ciphertext: " << plaintext_size << " bytes" << std::endl;
             std::cout << "  - Key: " << key_size << " bytes" << std::endl;
@@ -61,7 +240,7 @@ public:
     }
     
     void encrypt(const uint8_t* plaintext, const uint8_t* key, const uint8_t* nonce, 
-                uint32_t counter, uint8_t* ciphertext, int num_blocks) {
+                uint32_t counter, uint8_t* ciphertext, int num_blocks, bool quiet = false) {
         try {
             size_t plaintext_size = num_blocks * CHACHA20_BLOCK_SIZE;
             size_t ciphertext_size = num_blocks * CHACHA20_BLOCK_SIZE;
@@ -98,15 +277,17 @@ public:
             // Copy result
             std::memcpy(ciphertext, ciphertext_map, ciphertext_size);
             
-            std::cout << "✓ Encryption completed in " << duration.count() << " μs" << std::endl;
-            
-            // Calculate throughput
-            double data_mb = (double)(plaintext_size) / (1024.0 * 1024.0);
-            double time_sec = (double)duration.count() / 1000000.0;
-            double throughput = data_mb / time_sec;
-            
-            std::cout << "✓ Throughput: " << std::fixed << std::setprecision(2) 
-                      << throughput << " MB/s" << std::endl;
+            if (!quiet) {
+                std::cout << "✓ Encryption completed in " << duration.count() << " μs" << std::endl;
+                
+                // Calculate throughput
+                double data_mb = (double)(plaintext_size) / (1024.0 * 1024.0);
+                double time_sec = (double)duration.count() / 1000000.0;
+                double throughput = data_mb / time_sec;
+                
+                std::cout << "✓ Throughput: " << std::fixed << std::setprecision(2) 
+                          << throughput << " MB/s" << std::endl;
+            }
                       
         } catch (const std::exception& e) {
             std::cerr << "Error during encryption: " << e.what() << std::endl;
@@ -114,6 +295,71 @@ public:
         }
     }
     
+    bool hasAEAD() const { return has_aead; }
+    bool hasStreams() const { return chacha_streams.present; }
+    bool hasXChaCha() const { return has_xchacha && xchacha_streams.present; }
+    
+    // Encrypts every stream in one launch
+    void encryptStreams(const std::vector<uint8_t>& key_table, const std::vector<ChaCha20Stream>& streams) {
+        if (!chacha_streams.present) {
+            throw std::runtime_error("chacha20_encrypt_streams kernel not present in xclbin");
+        }
+        launchStreams(chacha_streams, CHACHA20_STREAM_DESC_WORDS, key_table, streams);
+    }
+    
+    // XChaCha20 for many messages with their own nonces: the HChaCha20
+    // subkey derivations run inside the same launch
+    void encryptXStreams(const std::vector<uint8_t>& key_table, const std::vector<XChaCha20Stream>& streams) {
+        if (!xchacha_streams.present) {
+            throw std::runtime_error("xchacha20_encrypt_streams kernel not present in xclbin");
+        }
+        launchStreams(xchacha_streams, XCHACHA20_STREAM_DESC_WORDS, key_table, streams);
+    }
+    
+    // Single-message XChaCha20 with a 24-byte nonce (whole blocks, like encrypt())
+    void encryptX(const uint8_t* plaintext, const uint8_t* key, const uint8_t* nonce,
+                  uint32_t counter, uint8_t* ciphertext, int num_blocks) {
+        if (!has_xchacha) {
+            throw std::runtime_error("xchacha20_encrypt kernel not present in xclbin");
+        }
+        size_t data_size = num_blocks * CHACHA20_BLOCK_SIZE;
+        std::memcpy(bo_xin.map<uint8_t*>(), plaintext, data_size);
+        std::memcpy(bo_xkey.map<uint8_t*>(), key, CHACHA20_KEY_SIZE);
+        std::memcpy(bo_xnonce.map<uint8_t*>(), nonce, XCHACHA20_NONCE_SIZE);
+        bo_xin.sync(XCL_BO_SYNC_BO_TO_DEVICE, data_size, 0);
+        bo_xkey.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+        bo_xnonce.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+        
+        auto run = xchacha_kernel(bo_xin, bo_xkey, bo_xnonce, counter, bo_xout, num_blocks);
+        run.wait();
+        
+        bo_xout.sync(XCL_BO_SYNC_BO_FROM_DEVICE, data_size, 0);
+        std::memcpy(ciphertext, bo_xout.map<uint8_t*>(), data_size);
+    }
+    
+    // ChaCha20-Poly1305 encryption of `len` bytes (any length up to the buffer size)
+    void seal(const uint8_t* plaintext, size_t len, const uint8_t* aad, size_t aad_len,
+              const uint8_t* key, const uint8_t* nonce, uint8_t* ciphertext, uint8_t tag[POLY1305_TAG_SIZE]) {
+        runAEAD(plaintext, len, aad, aad_len, key, nonce, 0, ciphertext, tag);
+    }
+    
+    // Decrypts and checks the tag; on mismatch the plaintext is wiped and false returned
+    bool open(const uint8_t* ciphertext, size_t len, const uint8_t* aad, size_t aad_len,
+              const uint8_t* key, const uint8_t* nonce, const uint8_t tag[POLY1305_TAG_SIZE], uint8_t* plaintext) {
+        uint8_t computed[POLY1305_TAG_SIZE];
+        runAEAD(ciphertext, len, aad, aad_len, key, nonce, 1, plaintext, computed);
+        
+        uint8_t diff = 0;
+        for (int i = 0; i < POLY1305_TAG_SIZE; i++) {
+            diff |= computed[i] ^ tag[i];
+        }
+        if (diff != 0) {
+            std::memset(plaintext, 0, len);
+            return false;
+        }
+        return true;
+    }
+    
     ~ChaCha20Host() {
         std::cout << "✓ ChaCha20 Host cleanup completed" << std::endl;
     }
@@ -295,6 +541,200 @@ void runStreamingTest(ChaCha20Host& chacha20) {
         }
         std::cout << std::dec << "..." << std::endl;
     }
+    
+    if (!chacha20.hasStreams()) return;
+    
+    // Same streams in a single multi-stream launch
+    std::vector<uint8_t> key_table(key, key + CHACHA20_KEY_SIZE);
+    std::vector<std::vector<uint8_t>> batched(num_streams, std::vector<uint8_t>(plaintext.size()));
+    std::vector<ChaCha20Stream> streams(num_streams);
+    for (int stream = 0; stream < num_streams; stream++) {
+        streams[stream].key_index = 0;
+        std::memcpy(streams[stream].nonce, nonce, CHACHA20_NONCE_SIZE);
+        streams[stream].counter = stream + 1;
+        streams[stream].input = plaintext.data();
+        streams[stream].output = batched[stream].data();
+        streams[stream].length = plaintext.size();
+    }
+    chacha20.encryptStreams(key_table, streams);
+    
+    bool match = true;
+    for (int stream = 0; stream < num_streams; stream++) {
+        chacha20.encrypt(plaintext.data(), key, nonce, stream + 1, ciphertext.data(), blocks_per_stream, true);
+        match &= std::memcmp(ciphertext.data(), batched[stream].data(), ciphertext.size()) == 0;
+    }
+    std::cout << (match ? "✓" : "✗") << " Single-launch multi-stream output: " << (match ? "PASSED" : "FAILED") << std::endl;
+}
+
+// Many short connections with their own keys, nonces and odd record sizes:
+// one launch per stream versus one launch for all of them
+void runMultiStreamTest(ChaCha20Host& chacha20) {
+    std::cout << "\n=== Multi-Stream Test (per-connection keys) ===" << std::endl;
+    
+    const int num_streams = 256;
+    const int num_keys = 64;
+    std::vector<uint8_t> key_table(num_keys * CHACHA20_KEY_SIZE);
+    for (auto& b : key_table) b = rand() & 0xFF;
+    
+    std::vector<std::vector<uint8_t>> inputs(num_streams), outputs(num_streams);
+    std::vector<ChaCha20Stream> streams(num_streams);
+    size_t total_bytes = 0;
+    for (int s = 0; s < num_streams; s++) {
+        size_t len = 1 + rand() % 2048;
+        inputs[s].resize(len);
+        outputs[s].resize(len);
+        for (auto& b : inputs[s]) b = rand() & 0xFF;
+        
+        streams[s].key_index = rand() % num_keys;
+        for (int i = 0; i < CHACHA20_NONCE_SIZE; i++) streams[s].nonce[i] = rand() & 0xFF;
+        streams[s].counter = 1;
+        streams[s].input = inputs[s].data();
+        streams[s].output = outputs[s].data();
+        streams[s].length = len;
+        total_bytes += len;
+    }
+    
+    auto start = std::chrono::high_resolution_clock::now();
+    chacha20.encryptStreams(key_table, streams);
+    auto end = std::chrono::high_resolution_clock::now();
+    double batched_sec = std::chrono::duration<double>(end - start).count();
+    
+    // Reference: one launch per stream (whole blocks, compare the prefix)
+    bool match = true;
+    double single_sec = 0.0;
+    for (int s = 0; s < num_streams; s++) {
+        int blocks = (int)((streams[s].length + CHACHA20_BLOCK_SIZE - 1) / CHACHA20_BLOCK_SIZE);
+        std::vector<uint8_t> padded(blocks * CHACHA20_BLOCK_SIZE, 0), reference(blocks * CHACHA20_BLOCK_SIZE);
+        std::memcpy(padded.data(), inputs[s].data(), streams[s].length);
+        start = std::chrono::high_resolution_clock::now();
+        chacha20.encrypt(padded.data(), &key_table[streams[s].key_index * CHACHA20_KEY_SIZE], streams[s].nonce,
+                         streams[s].counter, reference.data(), blocks, true);
+        end = std::chrono::high_resolution_clock::now();
+        single_sec += std::chrono::duration<double>(end - start).count();
+        match &= std::memcmp(reference.data(), outputs[s].data(), streams[s].length) == 0;
+    }
+    
+    double data_mb = (double)total_bytes / (1024.0 * 1024.0);
+    std::cout << num_streams << " streams, " << total_bytes << " bytes, " << num_keys << " keys" << std::endl;
+    std::cout << (match ? "✓" : "✗") << " Output matches per-stream launches: " << (match ? "PASSED" : "FAILED") << std::endl;
+    std::cout << "One launch:        " << std::fixed << std::setprecision(1) << batched_sec * 1e6 << " μs ("
+              << std::setprecision(2) << data_mb / batched_sec << " MB/s)" << std::endl;
+    std::cout << "Launch per stream: " << std::setprecision(1) << single_sec * 1e6 << " μs ("
+              << std::setprecision(2) << data_mb / single_sec << " MB/s)" << std::endl;
+}
+
+// 192-bit random nonces: a single-message check, then many short messages
+// (each with its own nonce) in one launch against one launch per message
+void runXChaChaTest(ChaCha20Host& chacha20) {
+    std::cout << "\n=== XChaCha20 Test (192-bit nonces) ===" << std::endl;
+    
+    const int num_msgs = 512;
+    const int num_keys = 16;
+    std::vector<uint8_t> key_table(num_keys * CHACHA20_KEY_SIZE);
+    for (auto& b : key_table) b = rand() & 0xFF;
+    
+    std::vector<std::vector<uint8_t>> inputs(num_msgs), outputs(num_msgs);
+    std::vector<XChaCha20Stream> msgs(num_msgs);
+    size_t total_bytes = 0;
+    for (int m = 0; m < num_msgs; m++) {
+        size_t len = 16 + rand() % 240;
+        inputs[m].resize(len);
+        outputs[m].resize(len);
+        for (auto& b : inputs[m]) b = rand() & 0xFF;
+        msgs[m].key_index = rand() % num_keys;
+        for (int i = 0; i < XCHACHA20_NONCE_SIZE; i++) msgs[m].nonce[i] = rand() & 0xFF;
+        msgs[m].counter = 1;
+        msgs[m].input = inputs[m].data();
+        msgs[m].output = outputs[m].data();
+        msgs[m].length = len;
+        total_bytes += len;
+    }
+    
+    auto start = std::chrono::high_resolution_clock::now();
+    chacha20.encryptXStreams(key_table, msgs);
+    auto end = std::chrono::high_resolution_clock::now();
+    double batched_sec = std::chrono::duration<double>(end - start).count();
+    
+    bool match = true;
+    double single_sec = 0.0;
+    for (int m = 0; m < num_msgs; m++) {
+        int blocks = (int)((msgs[m].length + CHACHA20_BLOCK_SIZE - 1) / CHACHA20_BLOCK_SIZE);
+        std::vector<uint8_t> padded(blocks * CHACHA20_BLOCK_SIZE, 0), reference(blocks * CHACHA20_BLOCK_SIZE);
+        std::memcpy(padded.data(), inputs[m].data(), msgs[m].length);
+        start = std::chrono::high_resolution_clock::now();
+        chacha20.encryptX(padded.data(), &key_table[msgs[m].key_index * CHACHA20_KEY_SIZE], msgs[m].nonce,
+                          msgs[m].counter, reference.data(), blocks);
+        end = std::chrono::high_resolution_clock::now();
+        single_sec += std::chrono::duration<double>(end - start).count();
+        match &= std::memcmp(reference.data(), outputs[m].data(), msgs[m].length) == 0;
+    }
+    
+    std::cout << num_msgs << " messages, " << total_bytes << " bytes, " << num_keys << " keys" << std::endl;
+    std::cout << (match ? "✓" : "✗") << " Batched derivation matches per-message launches: " << (match ? "PASSED" : "FAILED") << std::endl;
+    std::cout << "One launch:         " << std::fixed << std::setprecision(1) << batched_sec * 1e6 << " μs ("
+              << std::setprecision(0) << num_msgs / batched_sec << " msgs/s)" << std::endl;
+    std::cout << "Launch per message: " << std::setprecision(1) << single_sec * 1e6 << " μs ("
+              << std::setprecision(0) << num_msgs / single_sec << " msgs/s)" << std::endl;
+}
+
+void runAEADTest(ChaCha20Host& chacha20) {
+    std::cout << "\n=== ChaCha20-Poly1305 AEAD Test (RFC 8439 2.8.2) ===" << std::endl;
+    
+    uint8_t key[32];
+    for (int i = 0; i < 32; i++) key[i] = 0x80 + i;
+    uint8_t nonce[12] = {0x07, 0x00, 0x00, 0x00, 0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47};
+    uint8_t aad[12] = {0x50, 0x51, 0x52, 0x53, 0xc0, 0xc1, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7};
+    const uint8_t expected_tag[16] = {
+        0x1a, 0xe1, 0x0b, 0x59, 0x4f, 0x09, 0xe2, 0x6a, 0x7e, 0x90, 0x2e, 0xcb, 0xd0, 0x60, 0x06, 0x91
+    };
+    const char* text = "Ladies and Gentlemen of the class of '99: If I could offer you only one tip "
+                       "for the future, sunscreen would be it.";
+    size_t len = std::strlen(text);
+    
+    std::vector<uint8_t> ciphertext(len), decrypted(len);
+    uint8_t tag[16];
+    chacha20.seal((const uint8_t*)text, len, aad, sizeof(aad), key, nonce, ciphertext.data(), tag);
+    printHex("Tag", tag, 16);
+    
+    bool tag_ok = std::memcmp(tag, expected_tag, 16) == 0;
+    bool open_ok = chacha20.open(ciphertext.data(), len, aad, sizeof(aad), key, nonce, tag, decrypted.data()) &&
+                   std::memcmp(decrypted.data(), text, len) == 0;
+    ciphertext[7] ^= 0x80;
+    bool tamper_ok = !chacha20.open(ciphertext.data(), len, aad, sizeof(aad), key, nonce, tag, decrypted.data());
+    
+    std::cout << (tag_ok ? "✓" : "✗") << " Tag verification: " << (tag_ok ? "PASSED" : "FAILED") << std::endl;
+    std::cout << (open_ok ? "✓" : "✗") << " Decrypt and verify: " << (open_ok ? "PASSED" : "FAILED") << std::endl;
+    std::cout << (tamper_ok ? "✓" : "✗") << " Tampered ciphertext rejected: " << (tamper_ok ? "PASSED" : "FAILED") << std::endl;
+}
+
+void runAEADPerformanceTest(ChaCha20Host& chacha20) {
+    std::cout << "\n=== AEAD Performance Test ===" << std::endl;
+    
+    const size_t sizes[] = {64, 1024, 16384, 32768};
+    uint8_t key[32], nonce[12], aad[16], tag[16];
+    for (int i = 0; i < 32; i++) key[i] = rand() & 0xFF;
+    for (int i = 0; i < 12; i++) nonce[i] = rand() & 0xFF;
+    for (int i = 0; i < 16; i++) aad[i] = rand() & 0xFF;
+    
+    for (size_t size : sizes) {
+        std::vector<uint8_t> plaintext(size), ciphertext(size);
+        for (size_t i = 0; i < size; i++) {
+            plaintext[i] = rand() & 0xFF;
+        }
+        const int reps = 20;
+        
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int r = 0; r < reps; r++) {
+            chacha20.seal(plaintext.data(), size, aad, sizeof(aad), key, nonce, ciphertext.data(), tag);
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        double time_sec = std::chrono::duration<double>(end - start).count();
+        double data_mb = (double)size * reps / (1024.0 * 1024.0);
+        
+        std::cout << std::setfill(' ') << std::setw(6) << size << " bytes: " << std::fixed << std::setprecision(2)
+                  << data_mb / time_sec << " MB/s, " << std::setprecision(1)
+                  << time_sec * 1e6 / reps << " μs per message" << std::endl;
+    }
 }
 
 int main(int argc, char* argv[]) {
@@ -325,7 +765,17 @@ int main(int argc, char* argv[]) {
         runTestVectors(chacha20);
         runPerformanceTest(chacha20);
         runStreamingTest(chacha20);
+        if (chacha20.hasStreams()) {
+            runMultiStreamTest(chacha20);
+        }
+        if (chacha20.hasXChaCha()) {
+            runXChaChaTest(chacha20);
+        }
         runStressTest(chacha20);
+        if (chacha20.hasAEAD()) {
+            runAEADTest(chacha20);
+            runAEADPerformanceTest(chacha20);
+        }
         
         std::cout << "\n=== All ChaCha20 tests completed successfully! ===" << std::endl;
         
@@ -0,0 +1,55 @@
+#ifndef _CPU_FEATURES_H_
+#define _CPU_FEATURES_H_
+
+// x86 feature checks for the SIMD engines of the CPU baselines. A CPUID bit
+// only says the core implements an instruction set; AVX2 and AVX-512 also
+// need the OS to save their YMM/ZMM state (OSXSAVE, then XCR0 via XGETBV).
+// VMs and kernels can leave that state disabled, and the instructions then
+// fault with SIGILL.
+
+#include <stdint.h>
+#include <cpuid.h>
+
+// XCR0 state components: bit 1 SSE, bit 2 AVX, bits 5-7 AVX-512
+#define XCR0_YMM_STATE 0x06
+#define XCR0_ZMM_STATE 0xE6
+
+static inline bool cpu_os_saves_state(uint64_t mask) {
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) return false;
+    if (!((ecx >> 27) & 1)) return false;  // OSXSAVE: XGETBV is usable
+    uint32_t lo, hi;
+    __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+    return ((((uint64_t)hi << 32) | lo) & mask) == mask;
+}
+
+// CPUID leaf 7, sub-leaf 0, EBX
+static inline bool cpu_leaf7_ebx(int bit) {
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) return false;
+    return (ebx >> bit) & 1;
+}
+
+// CPUID leaf 1: ECX bit 19
+static inline bool cpu_has_sse41() {
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) return false;
+    return (ecx >> 19) & 1;
+}
+
+// Leaf 7 EBX bit 29; the SHA instructions work on XMM registers only
+static inline bool cpu_has_sha() {
+    return cpu_leaf7_ebx(29) && cpu_has_sse41();
+}
+
+// Leaf 7 EBX bit 5, with YMM state enabled
+static inline bool cpu_has_avx2() {
+    return cpu_leaf7_ebx(5) && cpu_os_saves_state(XCR0_YMM_STATE);
+}
+
+// Leaf 7 EBX bit 16, with ZMM and opmask state enabled
+static inline bool cpu_has_avx512f() {
+    return cpu_leaf7_ebx(16) && cpu_os_saves_state(XCR0_ZMM_STATE);
+}
+
+#endif
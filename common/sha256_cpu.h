@@ -0,0 +1,131 @@
+#ifndef _SHA256_CPU_H_
+#define _SHA256_CPU_H_
+
+// SHA-256 pieces shared by the CPU baselines and host-side fallbacks:
+// constants, big-endian word access, final-block padding and the
+// eight-lane AVX2 compression. The HLS kernels keep their own copy in
+// sha_finish/sha256.cpp.
+
+#include <stdint.h>
+#include <string.h>
+#include <immintrin.h>
+
+#define SHA256_BLOCK_SIZE 64
+#define SHA256_DIGEST_SIZE 32
+#define MB_LANES 8                  // AVX2 multi-buffer lanes
+
+// SHA-256 Constants
+static const uint32_t K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+// K[t] + W[t] for the padding block of any 64-byte message (see sha256.cpp)
+static const uint32_t PAD64_WK[64] = {
+    0xc28a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf374,
+    0x649b69c1, 0xf0fe4786, 0x0fe1edc6, 0x240cf254, 0x4fe9346f, 0x6cc984be, 0x61b9411e, 0x16f988fa,
+    0xf2c65152, 0xa88e5a6d, 0xb019fc65, 0xb9d99ec7, 0x9a1231c3, 0xe70eeaa0, 0xfdb1232b, 0xc7353eb0,
+    0x3069bad5, 0xcb976d5f, 0x5a0f118f, 0xdc1eeefd, 0x0a35b689, 0xde0b7a04, 0x58f4ca9d, 0xe15d5b16,
+    0x007f3e86, 0x37088980, 0xa507ea32, 0x6fab9537, 0x17406110, 0x0d8cd6f1, 0xcdaa3b6d, 0xc0bbbe37,
+    0x83613bda, 0xdb48a363, 0x0b02e931, 0x6fd15ca7, 0x521afaca, 0x31338431, 0x6ed41a95, 0x6d437890,
+    0xc39c91f2, 0x9eccabbd, 0xb5c9a0e6, 0x532fb63c, 0xd2c741c6, 0x07237ea3, 0xa4954b68, 0x4c191d76
+};
+
+static const uint32_t SHA256_H0[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+    0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+static inline uint32_t load_be32(const uint8_t* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+static inline void store_be32(uint8_t* p, uint32_t v) {
+    p[0] = (v >> 24) & 0xFF;
+    p[1] = (v >> 16) & 0xFF;
+    p[2] = (v >> 8) & 0xFF;
+    p[3] = v & 0xFF;
+}
+
+// Build the final one or two blocks of a message whose last `tail` bytes
+// (fewer than 64) did not fill a block. The message body itself is never
+// copied: full blocks are compressed straight from the caller's buffer.
+// `msg_len` is the total length the padding encodes.
+static inline size_t build_final_blocks(const uint8_t* tail, size_t tail_len, uint64_t msg_len, uint8_t out[128]) {
+    size_t total = (tail_len + 9 <= SHA256_BLOCK_SIZE) ? 64 : 128;
+    memcpy(out, tail, tail_len);
+    out[tail_len] = 0x80;
+    memset(out + tail_len + 1, 0, total - tail_len - 1);
+    uint64_t bit_len = msg_len * 8;
+    for (int i = 0; i < 8; i++) {
+        out[total - 8 + i] = (bit_len >> (56 - i * 8)) & 0xFF;
+    }
+    return total / SHA256_BLOCK_SIZE;
+}
+
+__attribute__((target("avx2")))
+static inline __m256i mb_rotr(__m256i x, int n) {
+    return _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - n));
+}
+
+// Eight lock-step compressions: lane j of every vector belongs to message j.
+// With `block_words` == nullptr the lanes absorb the constant 64-byte-message
+// padding block, whose schedule is already folded into PAD64_WK.
+__attribute__((target("avx2")))
+static inline void sha256_compress_x8(__m256i state[8], const uint32_t (*block_words)[MB_LANES]) {
+    __m256i W[16];
+    if (block_words) {
+        for (int t = 0; t < 16; t++) {
+            W[t] = _mm256_loadu_si256((const __m256i*)block_words[t]);
+        }
+    }
+
+    __m256i a = state[0], b = state[1], c = state[2], d = state[3];
+    __m256i e = state[4], f = state[5], g = state[6], h = state[7];
+
+    for (int t = 0; t < 64; t++) {
+        __m256i wk;
+        if (!block_words) {
+            wk = _mm256_set1_epi32((int)PAD64_WK[t]);
+        } else {
+            __m256i w;
+            if (t < 16) {
+                w = W[t];
+            } else {
+                __m256i w15 = W[(t - 15) & 15];
+                __m256i w2 = W[(t - 2) & 15];
+                __m256i s0 = _mm256_xor_si256(_mm256_xor_si256(mb_rotr(w15, 7), mb_rotr(w15, 18)), _mm256_srli_epi32(w15, 3));
+                __m256i s1 = _mm256_xor_si256(_mm256_xor_si256(mb_rotr(w2, 17), mb_rotr(w2, 19)), _mm256_srli_epi32(w2, 10));
+                w = _mm256_add_epi32(_mm256_add_epi32(W[t & 15], s0), _mm256_add_epi32(W[(t - 7) & 15], s1));
+                W[t & 15] = w;
+            }
+            wk = _mm256_add_epi32(w, _mm256_set1_epi32((int)K[t]));
+        }
+
+        __m256i S1 = _mm256_xor_si256(_mm256_xor_si256(mb_rotr(e, 6), mb_rotr(e, 11)), mb_rotr(e, 25));
+        __m256i ch = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+        __m256i T1 = _mm256_add_epi32(_mm256_add_epi32(h, S1), _mm256_add_epi32(ch, wk));
+        __m256i S0 = _mm256_xor_si256(_mm256_xor_si256(mb_rotr(a, 2), mb_rotr(a, 13)), mb_rotr(a, 22));
+        __m256i maj = _mm256_xor_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_xor_si256(a, b)));
+        __m256i T2 = _mm256_add_epi32(S0, maj);
+
+        h = g; g = f; f = e;
+        e = _mm256_add_epi32(d, T1);
+        d = c; c = b; b = a;
+        a = _mm256_add_epi32(T1, T2);
+    }
+
+    state[0] = _mm256_add_epi32(state[0], a); state[1] = _mm256_add_epi32(state[1], b);
+    state[2] = _mm256_add_epi32(state[2], c); state[3] = _mm256_add_epi32(state[3], d);
+    state[4] = _mm256_add_epi32(state[4], e); state[5] = _mm256_add_epi32(state[5], f);
+    state[6] = _mm256_add_epi32(state[6], g); state[7] = _mm256_add_epi32(state[7], h);
+}
+
+#endif
@@ -0,0 +1,590 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+#include <string>
+#include <memory>
+#include <stdexcept>
+#include <algorithm>
+#include <immintrin.h>
+#include "../common/cpu_features.h"
+#include "../common/sha256_cpu.h"
+
+// XRT includes for Xilinx Runtime
+#include "xrt/xrt_bo.h"
+#include "xrt/xrt_device.h"
+#include "xrt/xrt_kernel.h"
+
+#define PBKDF2_JOB_WORDS 24            // {inner midstate, outer midstate, U1}, as in sha256.h
+#define HMAC_INNER_BITS ((SHA256_BLOCK_SIZE + SHA256_DIGEST_SIZE) * 8)
+#define DEVICE_MAX_JOBS 4096           // Derived blocks per sha256_pbkdf2_batch launch
+
+#define ROTR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+static void sha256_compress_words(uint32_t state[8], const uint32_t M[16]) {
+    uint32_t W[64];
+    for (int t = 0; t < 16; t++) {
+        W[t] = M[t];
+    }
+    for (int t = 16; t < 64; t++) {
+        uint32_t s0 = ROTR(W[t-15], 7) ^ ROTR(W[t-15], 18) ^ (W[t-15] >> 3);
+        uint32_t s1 = ROTR(W[t-2], 17) ^ ROTR(W[t-2], 19) ^ (W[t-2] >> 10);
+        W[t] = s1 + W[t-7] + s0 + W[t-16];
+    }
+
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+    for (int t = 0; t < 64; t++) {
+        uint32_t T1 = h + (ROTR(e, 6) ^ ROTR(e, 11) ^ ROTR(e, 25)) + ((e & f) ^ (~e & g)) + K[t] + W[t];
+        uint32_t T2 = (ROTR(a, 2) ^ ROTR(a, 13) ^ ROTR(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        h = g; g = f; f = e; e = d + T1;
+        d = c; c = b; b = a; a = T1 + T2;
+    }
+    state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+    state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+}
+
+static void sha256_compress_bytes(uint32_t state[8], const uint8_t* block) {
+    uint32_t M[16];
+    for (int t = 0; t < 16; t++) {
+        M[t] = load_be32(block + t * 4);
+    }
+    sha256_compress_words(state, M);
+}
+
+// Absorb `msg` into a state that has already consumed `prior_bytes`
+// (a multiple of 64), then pad for the combined length
+static void sha256_finish(uint32_t state[8], const uint8_t* msg, size_t len, uint64_t prior_bytes) {
+    size_t full_blocks = len / SHA256_BLOCK_SIZE;
+    for (size_t b = 0; b < full_blocks; b++) {
+        sha256_compress_bytes(state, msg + b * SHA256_BLOCK_SIZE);
+    }
+
+    uint8_t last[128];
+    size_t last_blocks = build_final_blocks(msg + full_blocks * SHA256_BLOCK_SIZE,
+                                            len - full_blocks * SHA256_BLOCK_SIZE, prior_bytes + len, last);
+    for (size_t b = 0; b < last_blocks; b++) {
+        sha256_compress_bytes(state, last + b * SHA256_BLOCK_SIZE);
+    }
+}
+
+static void sha256(const uint8_t* msg, size_t len, uint8_t out[SHA256_DIGEST_SIZE]) {
+    uint32_t state[8];
+    memcpy(state, SHA256_H0, sizeof(state));
+    sha256_finish(state, msg, len, 0);
+    for (int i = 0; i < 8; i++) {
+        store_be32(out + i * 4, state[i]);
+    }
+}
+
+// HMAC key schedule: the states after absorbing K ^ ipad and K ^ opad.
+// Computed once per key, they turn every later HMAC into
+// ceil((len + 9) / 64) + 1 compressions instead of that plus two.
+struct HMACKey {
+    uint32_t inner[8];
+    uint32_t outer[8];
+
+    HMACKey(const uint8_t* key, size_t key_len) {
+        uint8_t k[SHA256_BLOCK_SIZE] = {0};
+        if (key_len > SHA256_BLOCK_SIZE) {
+            sha256(key, key_len, k);
+        } else {
+            memcpy(k, key, key_len);
+        }
+
+        uint8_t ipad[SHA256_BLOCK_SIZE], opad[SHA256_BLOCK_SIZE];
+        for (int i = 0; i < SHA256_BLOCK_SIZE; i++) {
+            ipad[i] = k[i] ^ 0x36;
+            opad[i] = k[i] ^ 0x5c;
+        }
+        memcpy(inner, SHA256_H0, sizeof(inner));
+        memcpy(outer, SHA256_H0, sizeof(outer));
+        sha256_compress_bytes(inner, ipad);
+        sha256_compress_bytes(outer, opad);
+    }
+
+    // MAC as eight big-endian words
+    void mac(const uint8_t* msg, size_t len, uint32_t out[8]) const {
+        uint32_t state[8];
+        uint8_t inner_digest[SHA256_DIGEST_SIZE];
+        memcpy(state, inner, sizeof(state));
+        sha256_finish(state, msg, len, SHA256_BLOCK_SIZE);
+        for (int i = 0; i < 8; i++) {
+            store_be32(inner_digest + i * 4, state[i]);
+        }
+        memcpy(out, outer, sizeof(state));
+        sha256_finish(out, inner_digest, SHA256_DIGEST_SIZE, SHA256_BLOCK_SIZE);
+    }
+
+    void mac(const uint8_t* msg, size_t len, uint8_t out[SHA256_DIGEST_SIZE]) const {
+        uint32_t words[8];
+        mac(msg, len, words);
+        for (int i = 0; i < 8; i++) {
+            store_be32(out + i * 4, words[i]);
+        }
+    }
+};
+
+// One MAC per (key, message) pair; callers MACing many messages under one
+// key should keep the HMACKey and reuse it
+static void hmacBatch(const HMACKey* const* keys, const uint8_t* const* messages, const size_t* lengths,
+                      size_t count, uint8_t* macs) {
+    for (size_t i = 0; i < count; i++) {
+        keys[i]->mac(messages[i], lengths[i], macs + i * SHA256_DIGEST_SIZE);
+    }
+}
+
+// Runs iterations 2..c of PBKDF2 for a set of derived-block jobs laid out
+// as PBKDF2_JOB_WORDS words each, writing T (eight words) per job
+class PBKDF2Engine {
+public:
+    virtual ~PBKDF2Engine() = default;
+    virtual const char* name() const = 0;
+    virtual void iterate(const uint32_t* jobs, size_t count, uint32_t iterations, uint32_t* T) = 0;
+};
+
+// Inner/outer compression of one iteration: the 32-byte input padded as
+// the tail of a 96-byte message
+static inline void hmac_block_words(const uint32_t in[8], uint32_t M[16]) {
+    memcpy(M, in, 8 * sizeof(uint32_t));
+    M[8] = 0x80000000;
+    for (int i = 9; i < 15; i++) {
+        M[i] = 0;
+    }
+    M[15] = HMAC_INNER_BITS;
+}
+
+class PBKDF2EngineScalar : public PBKDF2Engine {
+public:
+    const char* name() const override { return "CPU scalar"; }
+
+    void iterate(const uint32_t* jobs, size_t count, uint32_t iterations, uint32_t* T) override {
+        for (size_t j = 0; j < count; j++) {
+            const uint32_t* job = jobs + j * PBKDF2_JOB_WORDS;
+            uint32_t U[8], M[16];
+            memcpy(U, job + 16, sizeof(U));
+            memcpy(T + j * 8, U, sizeof(U));
+
+            for (uint32_t it = 1; it < iterations; it++) {
+                uint32_t state[8];
+                hmac_block_words(U, M);
+                memcpy(state, job, sizeof(state));
+                sha256_compress_words(state, M);
+
+                hmac_block_words(state, M);
+                memcpy(U, job + 8, sizeof(U));
+                sha256_compress_words(U, M);
+
+                for (int i = 0; i < 8; i++) {
+                    T[j * 8 + i] ^= U[i];
+                }
+            }
+        }
+    }
+};
+
+// Eight lock-step compressions of `in || pad(96-byte message)` from
+// `midstate`; lane j of every vector is job j
+__attribute__((target("avx2")))
+static void hmac_compress_x8(const __m256i midstate[8], const __m256i in[8], __m256i out[8]) {
+    __m256i W[16];
+    for (int t = 0; t < 8; t++) {
+        W[t] = in[t];
+    }
+    W[8] = _mm256_set1_epi32((int)0x80000000);
+    for (int t = 9; t < 15; t++) {
+        W[t] = _mm256_setzero_si256();
+    }
+    W[15] = _mm256_set1_epi32(HMAC_INNER_BITS);
+
+    __m256i a = midstate[0], b = midstate[1], c = midstate[2], d = midstate[3];
+    __m256i e = midstate[4], f = midstate[5], g = midstate[6], h = midstate[7];
+
+    for (int t = 0; t < 64; t++) {
+        __m256i w;
+        if (t < 16) {
+            w = W[t];
+        } else {
+            __m256i w15 = W[(t - 15) & 15];
+            __m256i w2 = W[(t - 2) & 15];
+            __m256i s0 = _mm256_xor_si256(_mm256_xor_si256(mb_rotr(w15, 7), mb_rotr(w15, 18)), _mm256_srli_epi32(w15, 3));
+            __m256i s1 = _mm256_xor_si256(_mm256_xor_si256(mb_rotr(w2, 17), mb_rotr(w2, 19)), _mm256_srli_epi32(w2, 10));
+            w = _mm256_add_epi32(_mm256_add_epi32(W[t & 15], s0), _mm256_add_epi32(W[(t - 7) & 15], s1));
+            W[t & 15] = w;
+        }
+
+        __m256i S1 = _mm256_xor_si256(_mm256_xor_si256(mb_rotr(e, 6), mb_rotr(e, 11)), mb_rotr(e, 25));
+        __m256i ch = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+        __m256i T1 = _mm256_add_epi32(_mm256_add_epi32(h, S1), _mm256_add_epi32(ch, _mm256_add_epi32(w, _mm256_set1_epi32((int)K[t]))));
+        __m256i S0 = _mm256_xor_si256(_mm256_xor_si256(mb_rotr(a, 2), mb_rotr(a, 13)), mb_rotr(a, 22));
+        __m256i maj = _mm256_xor_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_xor_si256(a, b)));
+        __m256i T2 = _mm256_add_epi32(S0, maj);
+
+        h = g; g = f; f = e;
+        e = _mm256_add_epi32(d, T1);
+        d = c; c = b; b = a;
+        a = _mm256_add_epi32(T1, T2);
+    }
+
+    __m256i result[8] = {a, b, c, d, e, f, g, h};
+    for (int i = 0; i < 8; i++) {
+        out[i] = _mm256_add_epi32(midstate[i], result[i]);
+    }
+}
+
+// Eight derivations advance together, one per AVX2 lane; all share the
+// iteration count so the lanes never diverge
+class PBKDF2EngineAVX2 : public PBKDF2Engine {
+public:
+    const char* name() const override { return "CPU AVX2 x8"; }
+
+    static bool supported() { return cpu_has_avx2(); }
+
+    __attribute__((target("avx2")))
+    void iterate(const uint32_t* jobs, size_t count, uint32_t iterations, uint32_t* T) override {
+        for (size_t group = 0; group < count; group += MB_LANES) {
+            int lanes = (int)std::min<size_t>(MB_LANES, count - group);
+
+            // Transpose: word i of lane l -> element l of vector i.
+            // Idle lanes repeat the group's last job.
+            alignas(32) uint32_t cols[3][8][MB_LANES];
+            for (int l = 0; l < MB_LANES; l++) {
+                const uint32_t* job = jobs + (group + std::min(l, lanes - 1)) * PBKDF2_JOB_WORDS;
+                for (int i = 0; i < 8; i++) {
+                    cols[0][i][l] = job[i];
+                    cols[1][i][l] = job[8 + i];
+                    cols[2][i][l] = job[16 + i];
+                }
+            }
+
+            __m256i inner[8], outer[8], U[8], acc[8], digest[8];
+            for (int i = 0; i < 8; i++) {
+                inner[i] = _mm256_load_si256((const __m256i*)cols[0][i]);
+                outer[i] = _mm256_load_si256((const __m256i*)cols[1][i]);
+                U[i] = _mm256_load_si256((const __m256i*)cols[2][i]);
+                acc[i] = U[i];
+            }
+
+            for (uint32_t it = 1; it < iterations; it++) {
+                hmac_compress_x8(inner, U, digest);
+                hmac_compress_x8(outer, digest, U);
+                for (int i = 0; i < 8; i++) {
+                    acc[i] = _mm256_xor_si256(acc[i], U[i]);
+                }
+            }
+
+            for (int i = 0; i < 8; i++) {
+                _mm256_store_si256((__m256i*)cols[0][i], acc[i]);
+            }
+            for (int l = 0; l < lanes; l++) {
+                for (int i = 0; i < 8; i++) {
+                    T[(group + l) * 8 + i] = cols[0][i][l];
+                }
+            }
+        }
+    }
+};
+
+// sha256_pbkdf2_batch from the sha_finish xclbin
+class PBKDF2EngineDevice : public PBKDF2Engine {
+private:
+    xrt::device device;
+    xrt::kernel kernel;
+    xrt::bo bo_jobs, bo_out;
+
+public:
+    PBKDF2EngineDevice(const std::string& xclbin_path, int device_id) {
+        try {
+            device = xrt::device(device_id);
+            auto uuid = device.load_xclbin(xclbin_path);
+            kernel = xrt::kernel(device, uuid, "sha256_pbkdf2_batch");
+
+            // sha256_pbkdf2_batch(jobs, output, num_jobs, iterations)
+            bo_jobs = xrt::bo(device, DEVICE_MAX_JOBS * PBKDF2_JOB_WORDS * sizeof(uint32_t), kernel.group_id(0));
+            bo_out = xrt::bo(device, DEVICE_MAX_JOBS * 8 * sizeof(uint32_t), kernel.group_id(1));
+
+            std::cout << "✓ PBKDF2 accelerator initialized" << std::endl;
+        } catch (const std::exception& e) {
+            std::cerr << "Error initializing PBKDF2 accelerator: " << e.what() << std::endl;
+            throw;
+        }
+    }
+
+    const char* name() const override { return "FPGA sha256_pbkdf2_batch"; }
+
+    void iterate(const uint32_t* jobs, size_t count, uint32_t iterations, uint32_t* T) override {
+        for (size_t done = 0; done < count; done += DEVICE_MAX_JOBS) {
+            size_t n = std::min<size_t>(DEVICE_MAX_JOBS, count - done);
+            size_t job_bytes = n * PBKDF2_JOB_WORDS * sizeof(uint32_t);
+            memcpy(bo_jobs.map<uint32_t*>(), jobs + done * PBKDF2_JOB_WORDS, job_bytes);
+            bo_jobs.sync(XCL_BO_SYNC_BO_TO_DEVICE, job_bytes, 0);
+
+            auto run = kernel(bo_jobs, bo_out, (int)n, (int)iterations);
+            run.wait();
+
+            bo_out.sync(XCL_BO_SYNC_BO_FROM_DEVICE, n * 8 * sizeof(uint32_t), 0);
+            memcpy(T + done * 8, bo_out.map<const uint32_t*>(), n * 8 * sizeof(uint32_t));
+        }
+    }
+};
+
+struct PBKDF2Request {
+    const uint8_t* password;
+    size_t password_len;
+    const uint8_t* salt;
+    size_t salt_len;
+    uint8_t* dk;
+    size_t dk_len;
+};
+
+// PBKDF2-HMAC-SHA256 for many independent requests sharing one iteration
+// count. Each request's HMAC key schedule is built once and reused for all
+// of its derived blocks; U1 is computed here and the remaining c - 1
+// iterations of every block run on the engine as one batch.
+static void pbkdf2Batch(PBKDF2Engine& engine, const PBKDF2Request* requests, size_t count, uint32_t iterations) {
+    if (iterations == 0) {
+        throw std::invalid_argument("PBKDF2 iteration count must be at least 1");
+    }
+
+    std::vector<uint32_t> jobs;
+    std::vector<uint8_t> msg;
+    for (size_t r = 0; r < count; r++) {
+        const PBKDF2Request& req = requests[r];
+        HMACKey key(req.password, req.password_len);
+        uint32_t blocks = (uint32_t)((req.dk_len + SHA256_DIGEST_SIZE - 1) / SHA256_DIGEST_SIZE);
+
+        msg.assign(req.salt, req.salt + req.salt_len);
+        msg.resize(req.salt_len + 4);
+        for (uint32_t b = 1; b <= blocks; b++) {
+            store_be32(&msg[req.salt_len], b);
+            size_t base = jobs.size();
+            jobs.resize(base + PBKDF2_JOB_WORDS);
+            memcpy(&jobs[base], key.inner, sizeof(key.inner));
+            memcpy(&jobs[base + 8], key.outer, sizeof(key.outer));
+            key.mac(msg.data(), msg.size(), &jobs[base + 16]);
+        }
+    }
+
+    size_t num_jobs = jobs.size() / PBKDF2_JOB_WORDS;
+    std::vector<uint32_t> T(num_jobs * 8);
+    engine.iterate(jobs.data(), num_jobs, iterations, T.data());
+
+    size_t job = 0;
+    for (size_t r = 0; r < count; r++) {
+        const PBKDF2Request& req = requests[r];
+        for (size_t off = 0; off < req.dk_len; off += SHA256_DIGEST_SIZE, job++) {
+            uint8_t block[SHA256_DIGEST_SIZE];
+            for (int i = 0; i < 8; i++) {
+                store_be32(block + i * 4, T[job * 8 + i]);
+            }
+            memcpy(req.dk + off, block, std::min<size_t>(SHA256_DIGEST_SIZE, req.dk_len - off));
+        }
+    }
+}
+
+static std::string toHex(const uint8_t* bytes, size_t len) {
+    static const char digits[] = "0123456789abcdef";
+    std::string s;
+    for (size_t i = 0; i < len; i++) {
+        s += digits[bytes[i] >> 4];
+        s += digits[bytes[i] & 0xF];
+    }
+    return s;
+}
+
+static bool runSelfTest(PBKDF2Engine& engine) {
+    std::cout << "\n=== HMAC-SHA256 / PBKDF2 Self-Test (" << engine.name() << ") ===" << std::endl;
+    bool ok = true;
+
+    // RFC 4231 test cases 1 and 6 (key longer than a block)
+    {
+        std::vector<uint8_t> key1(20, 0x0b), key6(131, 0xaa);
+        const char* msg1 = "Hi There";
+        const char* msg6 = "Test Using Larger Than Block-Size Key - Hash Key First";
+        HMACKey k1(key1.data(), key1.size()), k6(key6.data(), key6.size());
+        const HMACKey* keys[2] = {&k1, &k6};
+        const uint8_t* msgs[2] = {(const uint8_t*)msg1, (const uint8_t*)msg6};
+        size_t lens[2] = {strlen(msg1), strlen(msg6)};
+        uint8_t macs[2 * SHA256_DIGEST_SIZE];
+        hmacBatch(keys, msgs, lens, 2, macs);
+
+        bool pass = toHex(macs, SHA256_DIGEST_SIZE) ==
+                        "b0344c61d8db38535ca8afceaf0bf12b881dc200c9833da726e9376c2e32cff7" &&
+                    toHex(macs + SHA256_DIGEST_SIZE, SHA256_DIGEST_SIZE) ==
+                        "60e431591ee0b67f0d8a26aacbf5b77f8e0bc6213728c5140546040f0ee37f54";
+        std::cout << "HMAC-SHA256 (RFC 4231): " << (pass ? "✓ PASSED" : "✗ FAILED") << std::endl;
+        ok &= pass;
+    }
+
+    // PBKDF2-HMAC-SHA256 vectors (RFC 7914 section 11 and widely used ones)
+    {
+        struct Vector { const char* password; const char* salt; uint32_t c; size_t dk_len; const char* dk; };
+        const Vector vectors[] = {
+            {"passwd", "salt", 1, 64,
+             "55ac046e56e3089fec1691c22544b605f94185216dde0465e68b9d57c20dacbc"
+             "49ca9cccf179b645991664b39d77ef317c71b845b1e30bd509112041d3a19783"},
+            {"password", "salt", 4096, 32,
+             "c5e478d59288c841aa530db6845c4c8d962893a001ce4e11a4963873aa98134a"},
+            {"passwordPASSWORDpassword", "saltSALTsaltSALTsaltSALTsaltSALTsalt", 4096, 40,
+             "348c89dbcbd32b2f32d814b8116e84cf2b17347ebc1800181c4e2a1fb8dd53e1c635518c7dac47e9"},
+            {"Password", "NaCl", 80000, 64,
+             "4ddcd8f60b98be21830cee5ef22701f9641a4418d04c0414aeff08876b34ab56"
+             "a1d425a1225833549adb841b51c9b3176a272bdebba1d078478f62b397f33c8d"},
+        };
+
+        for (const Vector& v : vectors) {
+            std::vector<uint8_t> dk(v.dk_len);
+            PBKDF2Request req = {(const uint8_t*)v.password, strlen(v.password),
+                                 (const uint8_t*)v.salt, strlen(v.salt), dk.data(), dk.size()};
+            pbkdf2Batch(engine, &req, 1, v.c);
+            bool pass = toHex(dk.data(), dk.size()) == v.dk;
+            std::cout << "PBKDF2 P=\"" << v.password << "\" c=" << v.c << " dkLen=" << v.dk_len << ": "
+                      << (pass ? "✓ PASSED" : "✗ FAILED") << std::endl;
+            ok &= pass;
+        }
+    }
+
+    // A mixed batch must match the same requests derived one at a time
+    {
+        const size_t count = 19;
+        const uint32_t c = 100;
+        std::vector<std::string> passwords(count), salts(count);
+        std::vector<std::vector<uint8_t>> batch_dk(count), single_dk(count);
+        std::vector<PBKDF2Request> reqs(count);
+        for (size_t i = 0; i < count; i++) {
+            passwords[i] = "user" + std::to_string(i) + std::string(i * 5, 'p');
+            salts[i] = "salt" + std::to_string(i * 7919);
+            batch_dk[i].resize(16 + i * 5);
+            single_dk[i].resize(batch_dk[i].size());
+            reqs[i] = {(const uint8_t*)passwords[i].data(), passwords[i].size(),
+                       (const uint8_t*)salts[i].data(), salts[i].size(), batch_dk[i].data(), batch_dk[i].size()};
+        }
+        pbkdf2Batch(engine, reqs.data(), count, c);
+
+        PBKDF2EngineScalar scalar;
+        int mismatches = 0;
+        for (size_t i = 0; i < count; i++) {
+            PBKDF2Request single = reqs[i];
+            single.dk = single_dk[i].data();
+            pbkdf2Batch(scalar, &single, 1, c);
+            if (batch_dk[i] != single_dk[i]) mismatches++;
+        }
+        std::cout << "Mixed batch vs one-at-a-time scalar: " << (mismatches == 0 ? "✓ PASSED" : "✗ FAILED") << std::endl;
+        ok &= (mismatches == 0);
+    }
+
+    return ok;
+}
+
+// Derivations/s for `num_jobs` 32-byte keys at `iterations` on each engine
+static void runBenchmark(const std::vector<PBKDF2Engine*>& engines, size_t num_jobs, uint32_t iterations) {
+    std::cout << "\n=== PBKDF2-HMAC-SHA256 Benchmark (c=" << iterations << ", dkLen=32) ===" << std::endl;
+
+    std::vector<std::string> passwords(num_jobs), salts(num_jobs);
+    std::vector<std::vector<uint8_t>> dks(num_jobs, std::vector<uint8_t>(SHA256_DIGEST_SIZE));
+    std::vector<PBKDF2Request> reqs(num_jobs);
+    for (size_t i = 0; i < num_jobs; i++) {
+        passwords[i] = "correct horse battery staple " + std::to_string(i);
+        salts[i] = "per-user-salt-" + std::to_string(rand());
+        reqs[i] = {(const uint8_t*)passwords[i].data(), passwords[i].size(),
+                   (const uint8_t*)salts[i].data(), salts[i].size(), dks[i].data(), dks[i].size()};
+    }
+
+    double baseline = 0;
+    for (PBKDF2Engine* engine : engines) {
+        // The scalar baseline only needs enough jobs for a stable rate
+        size_t n = (dynamic_cast<PBKDF2EngineScalar*>(engine) != nullptr)
+                       ? std::min<size_t>(num_jobs, MB_LANES) : num_jobs;
+
+        auto start = std::chrono::high_resolution_clock::now();
+        pbkdf2Batch(*engine, reqs.data(), n, iterations);
+        auto end = std::chrono::high_resolution_clock::now();
+
+        double sec = std::chrono::duration<double>(end - start).count();
+        double rate = (double)n / sec;
+        if (baseline == 0) baseline = rate;
+        std::cout << std::left << std::setw(26) << engine->name() << std::right
+                  << std::setw(5) << n << " derivations in " << std::fixed << std::setprecision(3) << sec << " s: "
+                  << std::setprecision(1) << rate << " derivations/s ("
+                  << std::setprecision(2) << rate / baseline << "x)" << std::endl;
+    }
+}
+
+static void printUsage(const char* prog) {
+    std::cerr << "Usage: " << prog << " <selftest|bench> [options]" << std::endl;
+    std::cerr << "\nOptions:" << std::endl;
+    std::cerr << "  --xclbin <path>     sha256 xclbin with sha256_pbkdf2_batch (CPU only otherwise)" << std::endl;
+    std::cerr << "  --device <id>       device index (default 0)" << std::endl;
+    std::cerr << "  --jobs <n>          derivations per benchmark batch (default 64)" << std::endl;
+    std::cerr << "  --iterations <c>    PBKDF2 iteration count for the benchmark (default 100000)" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::string mode = argv[1];
+    std::string xclbin_path;
+    int device_id = 0;
+    size_t num_jobs = 64;
+    uint32_t iterations = 100000;
+
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = (i + 1 < argc);
+        if (arg == "--xclbin" && has_value) {
+            xclbin_path = argv[++i];
+        } else if (arg == "--device" && has_value) {
+            device_id = std::atoi(argv[++i]);
+        } else if (arg == "--jobs" && has_value) {
+            num_jobs = (size_t)std::atoll(argv[++i]);
+        } else if (arg == "--iterations" && has_value) {
+            iterations = (uint32_t)std::atoll(argv[++i]);
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if ((mode != "selftest" && mode != "bench") || num_jobs == 0 || iterations == 0) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    try {
+        std::vector<std::unique_ptr<PBKDF2Engine>> engines;
+        engines.emplace_back(new PBKDF2EngineScalar());
+        if (PBKDF2EngineAVX2::supported()) {
+            engines.emplace_back(new PBKDF2EngineAVX2());
+        }
+        if (!xclbin_path.empty()) {
+            engines.emplace_back(new PBKDF2EngineDevice(xclbin_path, device_id));
+        }
+
+        bool ok = true;
+        for (auto& engine : engines) {
+            ok &= runSelfTest(*engine);
+        }
+        if (!ok) {
+            std::cerr << "\n✗ HMAC/PBKDF2 self-test failed" << std::endl;
+            return 1;
+        }
+        std::cout << "\n✓ All HMAC/PBKDF2 tests passed" << std::endl;
+
+        if (mode == "bench") {
+            std::vector<PBKDF2Engine*> list;
+            for (auto& engine : engines) list.push_back(engine.get());
+            runBenchmark(list, num_jobs, iterations);
+        }
+
+    } catch (const std::exception& e) {
+        std::cerr << "HMAC/PBKDF2 failed: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,689 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+#include <string>
+#include <memory>
+#include <stdexcept>
+#include <algorithm>
+#include <immintrin.h>
+#include "../common/cpu_features.h"
+#include "../common/sha256_cpu.h"
+
+// XRT includes for Xilinx Runtime
+#include "xrt/xrt_bo.h"
+#include "xrt/xrt_device.h"
+#include "xrt/xrt_kernel.h"
+
+#define NODE_INPUT_SIZE (2 * SHA256_DIGEST_SIZE)   // Parent = SHA-256(left || right)
+#define SHA256_DESC_WORDS 2                        // sha256_hash_batch {offset, length}
+
+#define DEVICE_MAX_NODES 65536                     // Parents per sha256_merkle_level launch
+#define DEVICE_LEAF_BYTES (4 * 1024 * 1024)        // Leaf bytes per sha256_hash_batch launch
+#define DEVICE_MIN_BATCH 4096                      // Smaller levels stay on the CPU
+#define BENCH_CHUNK_LEAVES (1u << 20)              // Leaves appended per call in the benchmark
+
+#define ROTR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+// 64 rounds over a precomputed K[t] + W[t] sequence
+static void sha256_rounds_scalar(uint32_t state[8], const uint32_t WK[64]) {
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+    for (int t = 0; t < 64; t++) {
+        uint32_t T1 = h + (ROTR(e, 6) ^ ROTR(e, 11) ^ ROTR(e, 25)) + ((e & f) ^ (~e & g)) + WK[t];
+        uint32_t T2 = (ROTR(a, 2) ^ ROTR(a, 13) ^ ROTR(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        h = g; g = f; f = e; e = d + T1;
+        d = c; c = b; b = a; a = T1 + T2;
+    }
+    state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+    state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+}
+
+static void sha256_block_scalar(uint32_t state[8], const uint8_t* block) {
+    uint32_t W[64];
+    for (int t = 0; t < 16; t++) {
+        W[t] = load_be32(block + t * 4);
+    }
+    for (int t = 16; t < 64; t++) {
+        uint32_t s0 = ROTR(W[t-15], 7) ^ ROTR(W[t-15], 18) ^ (W[t-15] >> 3);
+        uint32_t s1 = ROTR(W[t-2], 17) ^ ROTR(W[t-2], 19) ^ (W[t-2] >> 10);
+        W[t] = s1 + W[t-7] + s0 + W[t-16];
+    }
+    for (int t = 0; t < 64; t++) {
+        W[t] += K[t];
+    }
+    sha256_rounds_scalar(state, W);
+}
+
+// One-shot scalar SHA-256, used for single nodes and as the reference
+static void sha256_scalar(const uint8_t* msg, size_t len, uint8_t out[SHA256_DIGEST_SIZE]) {
+    uint32_t state[8];
+    memcpy(state, SHA256_H0, sizeof(state));
+
+    size_t full_blocks = len / SHA256_BLOCK_SIZE;
+    for (size_t b = 0; b < full_blocks; b++) {
+        sha256_block_scalar(state, msg + b * SHA256_BLOCK_SIZE);
+    }
+
+    uint8_t last[128];
+    size_t last_blocks = build_final_blocks(msg + full_blocks * SHA256_BLOCK_SIZE,
+                                            len - full_blocks * SHA256_BLOCK_SIZE, len, last);
+    for (size_t b = 0; b < last_blocks; b++) {
+        sha256_block_scalar(state, last + b * SHA256_BLOCK_SIZE);
+    }
+
+    for (int i = 0; i < 8; i++) {
+        store_be32(out + i * 4, state[i]);
+    }
+}
+
+static void hash_node(const uint8_t* left, const uint8_t* right, uint8_t out[SHA256_DIGEST_SIZE]) {
+    uint8_t pair[NODE_INPUT_SIZE];
+    memcpy(pair, left, SHA256_DIGEST_SIZE);
+    memcpy(pair + SHA256_DIGEST_SIZE, right, SHA256_DIGEST_SIZE);
+    sha256_scalar(pair, NODE_INPUT_SIZE, out);
+}
+
+__attribute__((target("avx2")))
+static void x8_init(__m256i state[8]) {
+    for (int i = 0; i < 8; i++) {
+        state[i] = _mm256_set1_epi32((int)SHA256_H0[i]);
+    }
+}
+
+__attribute__((target("avx2")))
+static void x8_store(const __m256i state[8], uint8_t* out, int lanes) {
+    uint32_t words[8][MB_LANES];
+    for (int i = 0; i < 8; i++) {
+        _mm256_storeu_si256((__m256i*)words[i], state[i]);
+    }
+    for (int l = 0; l < lanes; l++) {
+        for (int i = 0; i < 8; i++) {
+            store_be32(out + l * SHA256_DIGEST_SIZE + i * 4, words[i][l]);
+        }
+    }
+}
+
+// Where leaf and node hashes are computed. Parents are always SHA-256 of a
+// 64-byte child pair; leaves are SHA-256 of fixed-size data chunks.
+class MerkleHasher {
+public:
+    virtual ~MerkleHasher() = default;
+    virtual const char* name() const = 0;
+
+    // `count` leaves of `leaf_size` bytes stored back to back
+    virtual void hashLeaves(const uint8_t* data, size_t leaf_size, size_t count, uint8_t* out) = 0;
+
+    // out[i] = SHA-256(children[2i] || children[2i+1]) for adjacent digests
+    virtual void hashPairs(const uint8_t* children, size_t count, uint8_t* out) = 0;
+};
+
+// CPU path: AVX2 multi-buffer, eight independent messages per compression.
+// Every lane of a batch has the same length, so the lanes never diverge.
+class MerkleHasherCPU : public MerkleHasher {
+private:
+    bool use_avx2;
+
+    __attribute__((target("avx2")))
+    void hashLeavesX8(const uint8_t* data, size_t leaf_size, size_t count, uint8_t* out) {
+        size_t full_blocks = leaf_size / SHA256_BLOCK_SIZE;
+        size_t tail_len = leaf_size - full_blocks * SHA256_BLOCK_SIZE;
+        bool fixed_pad = (leaf_size == SHA256_BLOCK_SIZE);
+        uint32_t words[16][MB_LANES];
+        uint8_t last[MB_LANES][128];
+
+        for (size_t group = 0; group < count; group += MB_LANES) {
+            int lanes = (int)std::min<size_t>(MB_LANES, count - group);
+            __m256i state[8];
+            x8_init(state);
+
+            for (size_t b = 0; b < full_blocks; b++) {
+                for (int l = 0; l < MB_LANES; l++) {
+                    const uint8_t* src = data + (group + std::min(l, lanes - 1)) * leaf_size + b * SHA256_BLOCK_SIZE;
+                    for (int t = 0; t < 16; t++) {
+                        words[t][l] = load_be32(src + t * 4);
+                    }
+                }
+                sha256_compress_x8(state, words);
+            }
+
+            if (fixed_pad) {
+                sha256_compress_x8(state, nullptr);
+            } else {
+                size_t last_blocks = 0;
+                for (int l = 0; l < MB_LANES; l++) {
+                    const uint8_t* leaf = data + (group + std::min(l, lanes - 1)) * leaf_size;
+                    last_blocks = build_final_blocks(leaf + full_blocks * SHA256_BLOCK_SIZE, tail_len, leaf_size, last[l]);
+                }
+                for (size_t b = 0; b < last_blocks; b++) {
+                    for (int l = 0; l < MB_LANES; l++) {
+                        for (int t = 0; t < 16; t++) {
+                            words[t][l] = load_be32(last[l] + b * SHA256_BLOCK_SIZE + t * 4);
+                        }
+                    }
+                    sha256_compress_x8(state, words);
+                }
+            }
+
+            x8_store(state, out + group * SHA256_DIGEST_SIZE, lanes);
+        }
+    }
+
+public:
+    MerkleHasherCPU() : use_avx2(cpu_has_avx2()) {}
+
+    const char* name() const override { return use_avx2 ? "CPU AVX2 x8 multi-buffer" : "CPU scalar"; }
+
+    void hashLeaves(const uint8_t* data, size_t leaf_size, size_t count, uint8_t* out) override {
+        if (use_avx2) {
+            hashLeavesX8(data, leaf_size, count, out);
+            return;
+        }
+        for (size_t i = 0; i < count; i++) {
+            sha256_scalar(data + i * leaf_size, leaf_size, out + i * SHA256_DIGEST_SIZE);
+        }
+    }
+
+    void hashPairs(const uint8_t* children, size_t count, uint8_t* out) override {
+        hashLeaves(children, NODE_INPUT_SIZE, count, out);
+    }
+};
+
+// Accelerator path: sha256_hash_batch for leaves and sha256_merkle_level for
+// parents, both from the sha_finish xclbin. Levels narrower than
+// DEVICE_MIN_BATCH are cheaper to finish on the CPU than to launch.
+class MerkleHasherDevice : public MerkleHasher {
+private:
+    xrt::device device;
+    xrt::kernel leaf_kernel;
+    xrt::kernel level_kernel;
+    xrt::bo bo_leaf_in, bo_leaf_table, bo_leaf_out;
+    xrt::bo bo_children, bo_parents;
+    MerkleHasherCPU cpu;
+
+public:
+    MerkleHasherDevice(const std::string& xclbin_path, int device_id) {
+        try {
+            device = xrt::device(device_id);
+            auto uuid = device.load_xclbin(xclbin_path);
+            leaf_kernel = xrt::kernel(device, uuid, "sha256_hash_batch");
+            level_kernel = xrt::kernel(device, uuid, "sha256_merkle_level");
+
+            // sha256_hash_batch(input, msg_table, output, num_messages)
+            bo_leaf_in = xrt::bo(device, DEVICE_LEAF_BYTES, leaf_kernel.group_id(0));
+            bo_leaf_table = xrt::bo(device, DEVICE_MAX_NODES * SHA256_DESC_WORDS * sizeof(uint32_t), leaf_kernel.group_id(1));
+            bo_leaf_out = xrt::bo(device, DEVICE_MAX_NODES * SHA256_DIGEST_SIZE, leaf_kernel.group_id(2));
+
+            // sha256_merkle_level(children, parents, num_parents)
+            bo_children = xrt::bo(device, DEVICE_MAX_NODES * NODE_INPUT_SIZE, level_kernel.group_id(0));
+            bo_parents = xrt::bo(device, DEVICE_MAX_NODES * SHA256_DIGEST_SIZE, level_kernel.group_id(1));
+
+            std::cout << "✓ Merkle tree accelerator initialized" << std::endl;
+        } catch (const std::exception& e) {
+            std::cerr << "Error initializing Merkle tree accelerator: " << e.what() << std::endl;
+            throw;
+        }
+    }
+
+    const char* name() const override { return "FPGA sha256_merkle_level"; }
+
+    void hashLeaves(const uint8_t* data, size_t leaf_size, size_t count, uint8_t* out) override {
+        size_t per_launch = std::min<size_t>(DEVICE_MAX_NODES, DEVICE_LEAF_BYTES / leaf_size);
+        if (count < DEVICE_MIN_BATCH || per_launch == 0) {
+            cpu.hashLeaves(data, leaf_size, count, out);
+            return;
+        }
+
+        // Fixed-size leaves: one descriptor table serves every full launch
+        uint32_t* table = bo_leaf_table.map<uint32_t*>();
+        for (size_t i = 0; i < per_launch; i++) {
+            table[i * SHA256_DESC_WORDS + 0] = (uint32_t)(i * leaf_size);
+            table[i * SHA256_DESC_WORDS + 1] = (uint32_t)leaf_size;
+        }
+        bo_leaf_table.sync(XCL_BO_SYNC_BO_TO_DEVICE, per_launch * SHA256_DESC_WORDS * sizeof(uint32_t), 0);
+
+        for (size_t done = 0; done < count; done += per_launch) {
+            size_t n = std::min(per_launch, count - done);
+            memcpy(bo_leaf_in.map<uint8_t*>(), data + done * leaf_size, n * leaf_size);
+            bo_leaf_in.sync(XCL_BO_SYNC_BO_TO_DEVICE, n * leaf_size, 0);
+
+            auto run = leaf_kernel(bo_leaf_in, bo_leaf_table, bo_leaf_out, (int)n);
+            run.wait();
+
+            bo_leaf_out.sync(XCL_BO_SYNC_BO_FROM_DEVICE, n * SHA256_DIGEST_SIZE, 0);
+            memcpy(out + done * SHA256_DIGEST_SIZE, bo_leaf_out.map<const uint8_t*>(), n * SHA256_DIGEST_SIZE);
+        }
+    }
+
+    void hashPairs(const uint8_t* children, size_t count, uint8_t* out) override {
+        if (count < DEVICE_MIN_BATCH) {
+            cpu.hashPairs(children, count, out);
+            return;
+        }
+
+        for (size_t done = 0; done < count; done += DEVICE_MAX_NODES) {
+            size_t n = std::min<size_t>(DEVICE_MAX_NODES, count - done);
+            memcpy(bo_children.map<uint8_t*>(), children + done * NODE_INPUT_SIZE, n * NODE_INPUT_SIZE);
+            bo_children.sync(XCL_BO_SYNC_BO_TO_DEVICE, n * NODE_INPUT_SIZE, 0);
+
+            auto run = level_kernel(bo_children, bo_parents, (int)n);
+            run.wait();
+
+            bo_parents.sync(XCL_BO_SYNC_BO_FROM_DEVICE, n * SHA256_DIGEST_SIZE, 0);
+            memcpy(out + done * SHA256_DIGEST_SIZE, bo_parents.map<const uint8_t*>(), n * SHA256_DIGEST_SIZE);
+        }
+    }
+};
+
+struct ProofStep {
+    uint8_t sibling[SHA256_DIGEST_SIZE];
+    bool sibling_is_left;
+};
+
+// Append-only binary Merkle tree. Level 0 holds leaf digests; a node with
+// no right sibling is promoted unchanged to the next level, so the root
+// over N leaves only depends on the leaves, not on how they were appended.
+//
+// Only complete nodes (whose subtree is full) are stored. Level j holds
+// floor(N / 2^j) of them, and the odd trailing node of every level whose
+// count is odd is a "peak"; the root folds the peaks from the lowest up.
+//
+// With retain_nodes == false, nodes below the frontier are dropped once
+// their parent exists: memory stays O(log N), proofs become unavailable.
+class MerkleTree {
+private:
+    MerkleHasher& hasher;
+    size_t leaf_size;
+    bool retain_nodes;
+    uint64_t num_leaves = 0;
+
+    struct Level {
+        std::vector<uint8_t> nodes;   // Digests [first, first + nodes.size() / 32)
+        uint64_t first = 0;           // Index of nodes[0] within the level
+        uint64_t count = 0;           // Complete nodes ever produced on this level
+    };
+    std::vector<Level> levels;
+
+    const uint8_t* node(size_t level, uint64_t index) const {
+        const Level& lv = levels[level];
+        return &lv.nodes[(size_t)(index - lv.first) * SHA256_DIGEST_SIZE];
+    }
+
+    // Root of the trailing (num_leaves mod 2^level) leaves, i.e. the fold of
+    // every peak below `level`. Returns false if there are none.
+    bool foldPeaks(size_t level, uint8_t out[SHA256_DIGEST_SIZE]) const {
+        bool have = false;
+        for (size_t j = 0; j < level && j < levels.size(); j++) {
+            if (levels[j].count & 1) {
+                if (have) {
+                    hash_node(node(j, levels[j].count - 1), out, out);
+                } else {
+                    memcpy(out, node(j, levels[j].count - 1), SHA256_DIGEST_SIZE);
+                    have = true;
+                }
+            }
+        }
+        return have;
+    }
+
+    // Pair up every newly completed couple on each level, bottom to top
+    void propagate() {
+        for (size_t j = 0; j < levels.size() && levels[j].count >= 2; j++) {
+            if (j + 1 == levels.size()) {
+                levels.emplace_back();
+            }
+            Level& lower = levels[j];
+            Level& upper = levels[j + 1];
+
+            uint64_t ready = lower.count / 2;
+            if (ready > upper.count) {
+                uint64_t fresh = ready - upper.count;
+                size_t old_size = upper.nodes.size();
+                upper.nodes.resize(old_size + (size_t)fresh * SHA256_DIGEST_SIZE);
+                hasher.hashPairs(node(j, 2 * upper.count), (size_t)fresh, &upper.nodes[old_size]);
+                upper.count = ready;
+            }
+
+            if (!retain_nodes) {
+                // Keep only this level's unpaired trailing node, if any
+                uint64_t keep_from = 2 * upper.count;
+                lower.nodes.erase(lower.nodes.begin(),
+                                  lower.nodes.begin() + (size_t)(keep_from - lower.first) * SHA256_DIGEST_SIZE);
+                lower.first = keep_from;
+            }
+        }
+    }
+
+public:
+    MerkleTree(MerkleHasher& h, size_t leaf_bytes, bool retain = true)
+        : hasher(h), leaf_size(leaf_bytes), retain_nodes(retain) {
+        if (leaf_size == 0) {
+            throw std::invalid_argument("Merkle leaf size must be non-zero");
+        }
+        levels.emplace_back();
+    }
+
+    uint64_t size() const { return num_leaves; }
+
+    // Append `count` leaves of leaf_size bytes; leaves and every level above
+    // are hashed as batches, however many leaves arrive per call
+    void append(const uint8_t* data, size_t count) {
+        if (count == 0) return;
+        Level& leaves = levels[0];
+        size_t old_size = leaves.nodes.size();
+        leaves.nodes.resize(old_size + count * SHA256_DIGEST_SIZE);
+        hasher.hashLeaves(data, leaf_size, count, &leaves.nodes[old_size]);
+        leaves.count += count;
+        num_leaves += count;
+        propagate();
+    }
+
+    void root(uint8_t out[SHA256_DIGEST_SIZE]) const {
+        if (num_leaves == 0) {
+            throw std::logic_error("Merkle root of an empty tree");
+        }
+        foldPeaks(levels.size(), out);
+    }
+
+    std::vector<ProofStep> proof(uint64_t leaf_index) const {
+        if (!retain_nodes) {
+            throw std::logic_error("Merkle proofs need a tree that retains its nodes");
+        }
+        if (leaf_index >= num_leaves) {
+            throw std::out_of_range("Merkle proof for a leaf past the end of the tree");
+        }
+
+        std::vector<ProofStep> steps;
+        uint64_t index = leaf_index;
+        uint64_t width = num_leaves;   // Nodes on this level, including the partial one
+        for (size_t j = 0; width > 1; j++) {
+            uint64_t sibling = index ^ 1;
+            if (sibling < width) {
+                ProofStep step;
+                step.sibling_is_left = sibling < index;
+                if (sibling < levels[j].count) {
+                    memcpy(step.sibling, node(j, sibling), SHA256_DIGEST_SIZE);
+                } else {
+                    foldPeaks(j, step.sibling);
+                }
+                steps.push_back(step);
+            }
+            index >>= 1;
+            width = (width + 1) / 2;
+        }
+        return steps;
+    }
+
+    static bool verify(const uint8_t leaf_hash[SHA256_DIGEST_SIZE], const std::vector<ProofStep>& steps,
+                       const uint8_t expected_root[SHA256_DIGEST_SIZE]) {
+        uint8_t acc[SHA256_DIGEST_SIZE];
+        memcpy(acc, leaf_hash, SHA256_DIGEST_SIZE);
+        for (const ProofStep& step : steps) {
+            if (step.sibling_is_left) {
+                hash_node(step.sibling, acc, acc);
+            } else {
+                hash_node(acc, step.sibling, acc);
+            }
+        }
+        return memcmp(acc, expected_root, SHA256_DIGEST_SIZE) == 0;
+    }
+};
+
+static void fillRandom(std::vector<uint8_t>& buf) {
+    for (size_t i = 0; i < buf.size(); i++) {
+        buf[i] = rand() & 0xFF;
+    }
+}
+
+static std::string toHex(const uint8_t* bytes, size_t len) {
+    static const char digits[] = "0123456789abcdef";
+    std::string s;
+    for (size_t i = 0; i < len; i++) {
+        s += digits[bytes[i] >> 4];
+        s += digits[bytes[i] & 0xF];
+    }
+    return s;
+}
+
+// Level-by-level reference with promotion of odd trailing nodes
+static void referenceRoot(const uint8_t* data, size_t leaf_size, size_t count, uint8_t out[SHA256_DIGEST_SIZE]) {
+    std::vector<uint8_t> level(count * SHA256_DIGEST_SIZE);
+    for (size_t i = 0; i < count; i++) {
+        sha256_scalar(data + i * leaf_size, leaf_size, &level[i * SHA256_DIGEST_SIZE]);
+    }
+    while (count > 1) {
+        size_t next = (count + 1) / 2;
+        std::vector<uint8_t> up(next * SHA256_DIGEST_SIZE);
+        for (size_t i = 0; i < count / 2; i++) {
+            hash_node(&level[2 * i * SHA256_DIGEST_SIZE], &level[(2 * i + 1) * SHA256_DIGEST_SIZE],
+                      &up[i * SHA256_DIGEST_SIZE]);
+        }
+        if (count & 1) {
+            memcpy(&up[(next - 1) * SHA256_DIGEST_SIZE], &level[(count - 1) * SHA256_DIGEST_SIZE], SHA256_DIGEST_SIZE);
+        }
+        level.swap(up);
+        count = next;
+    }
+    memcpy(out, level.data(), SHA256_DIGEST_SIZE);
+}
+
+static bool runSelfTest(MerkleHasher& hasher) {
+    std::cout << "\n=== Merkle Tree Self-Test (" << hasher.name() << ") ===" << std::endl;
+    bool ok = true;
+
+    // Known answer for the scalar reference: SHA-256("abc")
+    {
+        uint8_t digest[SHA256_DIGEST_SIZE];
+        sha256_scalar((const uint8_t*)"abc", 3, digest);
+        bool pass = toHex(digest, SHA256_DIGEST_SIZE) ==
+                    "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad";
+        std::cout << "SHA-256(\"abc\"): " << (pass ? "✓ PASSED" : "✗ FAILED") << std::endl;
+        ok &= pass;
+    }
+
+    // Batched leaf and pair hashing against one-at-a-time scalar hashing
+    {
+        const size_t leaf_sizes[] = {1, 32, 55, 56, 64, 100, 1000};
+        int mismatches = 0;
+        for (size_t leaf_size : leaf_sizes) {
+            for (size_t count = 1; count <= 20; count++) {
+                std::vector<uint8_t> data(leaf_size * count);
+                fillRandom(data);
+                std::vector<uint8_t> batch(count * SHA256_DIGEST_SIZE);
+                hasher.hashLeaves(data.data(), leaf_size, count, batch.data());
+                for (size_t i = 0; i < count; i++) {
+                    uint8_t expected[SHA256_DIGEST_SIZE];
+                    sha256_scalar(&data[i * leaf_size], leaf_size, expected);
+                    if (memcmp(expected, &batch[i * SHA256_DIGEST_SIZE], SHA256_DIGEST_SIZE) != 0) mismatches++;
+                }
+            }
+        }
+
+        const size_t pair_counts[] = {1, 7, 8, 9, DEVICE_MIN_BATCH + 3};
+        for (size_t count : pair_counts) {
+            std::vector<uint8_t> children(count * NODE_INPUT_SIZE);
+            fillRandom(children);
+            std::vector<uint8_t> parents(count * SHA256_DIGEST_SIZE);
+            hasher.hashPairs(children.data(), count, parents.data());
+            for (size_t i = 0; i < count; i++) {
+                uint8_t expected[SHA256_DIGEST_SIZE];
+                hash_node(&children[i * NODE_INPUT_SIZE], &children[i * NODE_INPUT_SIZE + SHA256_DIGEST_SIZE], expected);
+                if (memcmp(expected, &parents[i * SHA256_DIGEST_SIZE], SHA256_DIGEST_SIZE) != 0) mismatches++;
+            }
+        }
+        std::cout << "Batched leaf/pair hashing vs scalar: " << (mismatches == 0 ? "✓ PASSED" : "✗ FAILED") << std::endl;
+        ok &= (mismatches == 0);
+    }
+
+    // Roots and proofs for every tree shape up to 70 leaves and a few larger
+    // ones, with leaves appended in uneven batches
+    {
+        const size_t leaf_size = 48;
+        std::vector<size_t> shapes;
+        for (size_t n = 1; n <= 70; n++) shapes.push_back(n);
+        shapes.push_back(1000);
+        shapes.push_back(DEVICE_MIN_BATCH * 2 + 5);
+
+        int root_failures = 0, proof_failures = 0;
+        for (size_t n : shapes) {
+            std::vector<uint8_t> data(n * leaf_size);
+            fillRandom(data);
+
+            MerkleTree tree(hasher, leaf_size);
+            MerkleTree compact(hasher, leaf_size, false);
+            for (size_t done = 0; done < n; ) {
+                size_t step = std::min<size_t>(n - done, 1 + rand() % (n < 100 ? 5 : 3000));
+                tree.append(&data[done * leaf_size], step);
+                compact.append(&data[done * leaf_size], step);
+                done += step;
+            }
+
+            uint8_t expected[SHA256_DIGEST_SIZE], root[SHA256_DIGEST_SIZE], compact_root[SHA256_DIGEST_SIZE];
+            referenceRoot(data.data(), leaf_size, n, expected);
+            tree.root(root);
+            compact.root(compact_root);
+            if (memcmp(expected, root, SHA256_DIGEST_SIZE) != 0 ||
+                memcmp(expected, compact_root, SHA256_DIGEST_SIZE) != 0) {
+                root_failures++;
+            }
+
+            size_t checks = std::min<size_t>(n, 64);
+            for (size_t c = 0; c < checks; c++) {
+                size_t leaf = (n <= 64) ? c : (size_t)rand() % n;
+                uint8_t leaf_hash[SHA256_DIGEST_SIZE];
+                sha256_scalar(&data[leaf * leaf_size], leaf_size, leaf_hash);
+                std::vector<ProofStep> steps = tree.proof(leaf);
+                if (!MerkleTree::verify(leaf_hash, steps, expected)) proof_failures++;
+
+                // A proof must not verify a different leaf
+                leaf_hash[0] ^= 1;
+                if (MerkleTree::verify(leaf_hash, steps, expected)) proof_failures++;
+            }
+        }
+        std::cout << "Roots (retained and compact) vs reference: "
+                  << (root_failures == 0 ? "✓ PASSED" : "✗ FAILED") << std::endl;
+        std::cout << "Inclusion proofs: " << (proof_failures == 0 ? "✓ PASSED" : "✗ FAILED") << std::endl;
+        ok &= (root_failures == 0 && proof_failures == 0);
+    }
+
+    return ok;
+}
+
+// Leaves/s for building a tree of `num_leaves`, appended BENCH_CHUNK_LEAVES
+// at a time. Leaf contents repeat across chunks; the work per leaf does not.
+static void runBenchmark(MerkleHasher& hasher, const std::vector<uint64_t>& sizes, size_t leaf_size) {
+    std::cout << "\n=== Merkle Tree Benchmark (" << hasher.name() << ", "
+              << leaf_size << "-byte leaves) ===" << std::endl;
+
+    std::vector<uint8_t> chunk(BENCH_CHUNK_LEAVES * leaf_size);
+    fillRandom(chunk);
+
+    for (uint64_t n : sizes) {
+        // Retained trees keep ~2 digests per leaf; beyond 16M leaves only
+        // the root-only mode fits comfortably in host memory
+        const bool modes[] = {true, false};
+        for (bool retain : modes) {
+            if (retain && n > (16u << 20)) continue;
+
+            MerkleTree tree(hasher, leaf_size, retain);
+            auto start = std::chrono::high_resolution_clock::now();
+            for (uint64_t done = 0; done < n; ) {
+                size_t step = (size_t)std::min<uint64_t>(BENCH_CHUNK_LEAVES, n - done);
+                tree.append(chunk.data(), step);
+                done += step;
+            }
+            uint8_t root[SHA256_DIGEST_SIZE];
+            tree.root(root);
+            auto end = std::chrono::high_resolution_clock::now();
+
+            double sec = std::chrono::duration<double>(end - start).count();
+            double mb = (double)n * leaf_size / (1024.0 * 1024.0);
+            std::cout << std::setw(11) << n << " leaves, " << (retain ? "with proofs" : "root only  ")
+                      << ": " << std::fixed << std::setprecision(3) << sec << " s, "
+                      << std::setprecision(0) << (double)n / sec << " leaves/s, "
+                      << std::setprecision(2) << mb / sec << " MB/s" << std::endl;
+            std::cout << "             root " << toHex(root, SHA256_DIGEST_SIZE) << std::endl;
+        }
+    }
+}
+
+static void printUsage(const char* prog) {
+    std::cerr << "Usage: " << prog << " <selftest|bench> [options]" << std::endl;
+    std::cerr << "\nOptions:" << std::endl;
+    std::cerr << "  --xclbin <path>     sha256 xclbin with sha256_hash_batch and sha256_merkle_level" << std::endl;
+    std::cerr << "                      (CPU multi-buffer otherwise)" << std::endl;
+    std::cerr << "  --device <id>       device index (default 0)" << std::endl;
+    std::cerr << "  --leaves <n,...>    tree sizes to benchmark (default 1000000,10000000,100000000)" << std::endl;
+    std::cerr << "  --leaf-size <n>     bytes per leaf (default 64)" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::string mode = argv[1];
+    std::string xclbin_path;
+    int device_id = 0;
+    size_t leaf_size = 64;
+    std::vector<uint64_t> sizes = {1000000, 10000000, 100000000};
+
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = (i + 1 < argc);
+        if (arg == "--xclbin" && has_value) {
+            xclbin_path = argv[++i];
+        } else if (arg == "--device" && has_value) {
+            device_id = std::atoi(argv[++i]);
+        } else if (arg == "--leaf-size" && has_value) {
+            leaf_size = (size_t)std::atoll(argv[++i]);
+        } else if (arg == "--leaves" && has_value) {
+            sizes.clear();
+            std::string list = argv[++i];
+            for (size_t pos = 0; pos < list.size(); ) {
+                size_t comma = list.find(',', pos);
+                if (comma == std::string::npos) comma = list.size();
+                sizes.push_back(std::strtoull(list.substr(pos, comma - pos).c_str(), nullptr, 10));
+                pos = comma + 1;
+            }
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if ((mode != "selftest" && mode != "bench") || leaf_size == 0 || leaf_size > DEVICE_LEAF_BYTES) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    try {
+        std::unique_ptr<MerkleHasher> hasher;
+        if (!xclbin_path.empty()) {
+            hasher.reset(new MerkleHasherDevice(xclbin_path, device_id));
+        } else {
+            hasher.reset(new MerkleHasherCPU());
+        }
+
+        if (mode == "selftest") {
+            bool ok = runSelfTest(*hasher);
+            std::cout << (ok ? "\n✓ All Merkle tree tests passed" : "\n✗ Merkle tree tests failed") << std::endl;
+            return ok ? 0 : 1;
+        }
+
+        if (!runSelfTest(*hasher)) {
+            std::cerr << "Self-test failed; not benchmarking" << std::endl;
+            return 1;
+        }
+        runBenchmark(*hasher, sizes, leaf_size);
+
+    } catch (const std::exception& e) {
+        std::cerr << "Merkle tree failed: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
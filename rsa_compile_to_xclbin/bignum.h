@@ -0,0 +1,724 @@
+#ifndef _RSA_BIGNUM_H_
+#define _RSA_BIGNUM_H_
+
+// Multi-precision integers for the RSA host and CPU baseline. Numbers are
+// little-endian arrays of 64-bit limbs; modular arithmetic runs in the
+// Montgomery domain with either word-interleaved CIOS reduction or
+// separate Karatsuba products. CIOS is the faster of the two at every size
+// up to MAX_LIMBS; Karatsuba is kept as a comparison baseline.
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <random>
+#include <stdexcept>
+#include <algorithm>
+
+namespace bignum {
+
+typedef unsigned __int128 u128;
+
+static const int MAX_LIMBS = 64;            // 4096-bit operands
+static const int KARATSUBA_THRESHOLD = 8;   // Limbs below which schoolbook wins
+
+// ---------------------------------------------------------------------------
+// Limb-array primitives
+// ---------------------------------------------------------------------------
+
+static inline uint64_t add_n(uint64_t* r, const uint64_t* a, const uint64_t* b, int n) {
+    uint64_t carry = 0;
+    for (int i = 0; i < n; i++) {
+        u128 s = (u128)a[i] + b[i] + carry;
+        r[i] = (uint64_t)s;
+        carry = (uint64_t)(s >> 64);
+    }
+    return carry;
+}
+
+static inline uint64_t sub_n(uint64_t* r, const uint64_t* a, const uint64_t* b, int n) {
+    uint64_t borrow = 0;
+    for (int i = 0; i < n; i++) {
+        u128 d = (u128)a[i] - b[i] - borrow;
+        r[i] = (uint64_t)d;
+        borrow = (uint64_t)(d >> 64) & 1;
+    }
+    return borrow;
+}
+
+// Add a single limb into r[0..n), returning the carry out
+static inline uint64_t add_1(uint64_t* r, int n, uint64_t v) {
+    for (int i = 0; i < n && v; i++) {
+        r[i] += v;
+        v = r[i] < v;
+    }
+    return v;
+}
+
+static inline int cmp_n(const uint64_t* a, const uint64_t* b, int n) {
+    for (int i = n - 1; i >= 0; i--) {
+        if (a[i] != b[i]) return a[i] < b[i] ? -1 : 1;
+    }
+    return 0;
+}
+
+// r[0..an+bn) = a * b
+static inline void mul_basecase(uint64_t* r, const uint64_t* a, int an, const uint64_t* b, int bn) {
+    memset(r, 0, (an + bn) * sizeof(uint64_t));
+    for (int i = 0; i < bn; i++) {
+        uint64_t carry = 0;
+        for (int j = 0; j < an; j++) {
+            u128 t = (u128)a[j] * b[i] + r[i + j] + carry;
+            r[i + j] = (uint64_t)t;
+            carry = (uint64_t)(t >> 64);
+        }
+        r[i + an] = carry;
+    }
+}
+
+// r[0..2n) = a * b for n-limb operands. Subtractive Karatsuba:
+// a*b = z2*B^2 + (z0 + z2 + (a0 - a1)(b1 - b0))*B + z0, which keeps every
+// intermediate non-negative. Scratch t needs 6n limbs.
+static void mul_karatsuba(uint64_t* r, const uint64_t* a, const uint64_t* b, int n, uint64_t* t) {
+    if (n < 2 * KARATSUBA_THRESHOLD || (n & 1)) {
+        mul_basecase(r, a, n, b, n);
+        return;
+    }
+    const int h = n / 2;
+    uint64_t* da = t;
+    uint64_t* db = t + h;
+    uint64_t* mid = t + 2 * h;   // n limbs
+    uint64_t* sum = mid + n;     // n limbs
+    uint64_t* next = sum + n;
+
+    mul_karatsuba(r, a, b, h, next);
+    mul_karatsuba(r + n, a + h, b + h, h, next);
+
+    bool negative = false;
+    if (cmp_n(a, a + h, h) >= 0) {
+        sub_n(da, a, a + h, h);
+    } else {
+        sub_n(da, a + h, a, h);
+        negative = !negative;
+    }
+    if (cmp_n(b + h, b, h) >= 0) {
+        sub_n(db, b + h, b, h);
+    } else {
+        sub_n(db, b, b + h, h);
+        negative = !negative;
+    }
+    mul_karatsuba(mid, da, db, h, next);
+
+    int64_t carry = (int64_t)add_n(sum, r, r + n, n);
+    if (negative) {
+        carry -= (int64_t)sub_n(sum, sum, mid, n);
+    } else {
+        carry += (int64_t)add_n(sum, sum, mid, n);
+    }
+    carry += (int64_t)add_n(r + h, r + h, sum, n);
+    add_1(r + h + n, h, (uint64_t)carry);
+}
+
+// ---------------------------------------------------------------------------
+// BigInt: arbitrary-length non-negative integer
+// ---------------------------------------------------------------------------
+
+class BigInt {
+public:
+    std::vector<uint64_t> w;  // Least significant limb first, no leading zeros
+
+    BigInt(uint64_t v = 0) {
+        if (v) w.push_back(v);
+    }
+
+    static BigInt fromLimbs(const uint64_t* limbs, int n) {
+        BigInt r;
+        r.w.assign(limbs, limbs + n);
+        r.normalize();
+        return r;
+    }
+
+    // Big-endian bytes, as used by the kernel and by RSA encodings
+    static BigInt fromBytes(const uint8_t* bytes, size_t len) {
+        BigInt r;
+        r.w.assign((len + 7) / 8, 0);
+        for (size_t i = 0; i < len; i++) {
+            size_t pos = len - 1 - i;
+            r.w[pos / 8] |= (uint64_t)bytes[i] << (8 * (pos % 8));
+        }
+        r.normalize();
+        return r;
+    }
+
+    static BigInt fromHex(const std::string& hex) {
+        BigInt r;
+        int bit = 0;
+        for (auto it = hex.rbegin(); it != hex.rend(); ++it) {
+            char c = *it;
+            uint64_t v;
+            if (c >= '0' && c <= '9') v = c - '0';
+            else if (c >= 'a' && c <= 'f') v = c - 'a' + 10;
+            else if (c >= 'A' && c <= 'F') v = c - 'A' + 10;
+            else continue;
+            if (bit % 64 == 0) r.w.push_back(0);
+            r.w.back() |= v << (bit % 64);
+            bit += 4;
+        }
+        r.normalize();
+        return r;
+    }
+
+    // Fixed-length big-endian encoding; the value must fit
+    void toBytes(uint8_t* bytes, size_t len) const {
+        if ((size_t)bits() > 8 * len) {
+            throw std::length_error("BigInt does not fit in the requested byte length");
+        }
+        for (size_t i = 0; i < len; i++) {
+            size_t pos = len - 1 - i;
+            size_t limb = pos / 8;
+            bytes[i] = limb < w.size() ? (uint8_t)(w[limb] >> (8 * (pos % 8))) : 0;
+        }
+    }
+
+    std::string toHex() const {
+        static const char digits[] = "0123456789abcdef";
+        if (w.empty()) return "0";
+        std::string s;
+        for (int i = bits() - 1 - (bits() - 1) % 4; i >= 0; i -= 4) {
+            s += digits[(w[i / 64] >> (i % 64)) & 0xF];
+        }
+        return s;
+    }
+
+    // Random integer of exactly `bits` bits
+    template <typename Rng>
+    static BigInt random(int bits, Rng& rng) {
+        BigInt r;
+        r.w.resize((bits + 63) / 64);
+        for (auto& limb : r.w) limb = rng();
+        if (bits % 64) r.w.back() &= (~0ULL >> (64 - bits % 64));
+        r.w[(bits - 1) / 64] |= 1ULL << ((bits - 1) % 64);
+        r.normalize();
+        return r;
+    }
+
+    void normalize() {
+        while (!w.empty() && w.back() == 0) w.pop_back();
+    }
+
+    int limbs() const { return (int)w.size(); }
+    bool isZero() const { return w.empty(); }
+    bool isOdd() const { return !w.empty() && (w[0] & 1); }
+    bool bit(int i) const {
+        return i / 64 < (int)w.size() && ((w[i / 64] >> (i % 64)) & 1);
+    }
+    int bits() const {
+        if (w.empty()) return 0;
+        return 64 * (int)(w.size() - 1) + (64 - __builtin_clzll(w.back()));
+    }
+
+    // Copy into a fixed number of limbs (zero-extended)
+    void toLimbs(uint64_t* out, int n) const {
+        if ((int)w.size() > n) {
+            throw std::length_error("BigInt does not fit in the requested limb count");
+        }
+        std::fill(out, out + n, 0);
+        std::copy(w.begin(), w.end(), out);
+    }
+
+    friend int compare(const BigInt& a, const BigInt& b) {
+        if (a.w.size() != b.w.size()) return a.w.size() < b.w.size() ? -1 : 1;
+        return cmp_n(a.w.data(), b.w.data(), (int)a.w.size());
+    }
+    friend bool operator==(const BigInt& a, const BigInt& b) { return a.w == b.w; }
+    friend bool operator!=(const BigInt& a, const BigInt& b) { return a.w != b.w; }
+    friend bool operator<(const BigInt& a, const BigInt& b) { return compare(a, b) < 0; }
+    friend bool operator<=(const BigInt& a, const BigInt& b) { return compare(a, b) <= 0; }
+    friend bool operator>(const BigInt& a, const BigInt& b) { return compare(a, b) > 0; }
+    friend bool operator>=(const BigInt& a, const BigInt& b) { return compare(a, b) >= 0; }
+
+    friend BigInt operator+(const BigInt& a, const BigInt& b) {
+        const BigInt& x = a.w.size() >= b.w.size() ? a : b;
+        const BigInt& y = a.w.size() >= b.w.size() ? b : a;
+        BigInt r;
+        r.w.resize(x.w.size() + 1);
+        uint64_t carry = add_n(r.w.data(), x.w.data(), y.w.data(), y.limbs());
+        for (int i = y.limbs(); i < x.limbs(); i++) {
+            r.w[i] = x.w[i] + carry;
+            carry = r.w[i] < carry;
+        }
+        r.w[x.limbs()] = carry;
+        r.normalize();
+        return r;
+    }
+
+    // Requires a >= b
+    friend BigInt operator-(const BigInt& a, const BigInt& b) {
+        if (a < b) throw std::domain_error("BigInt subtraction underflow");
+        BigInt r;
+        r.w.resize(a.w.size());
+        uint64_t borrow = sub_n(r.w.data(), a.w.data(), b.w.data(), b.limbs());
+        for (int i = b.limbs(); i < a.limbs(); i++) {
+            r.w[i] = a.w[i] - borrow;
+            borrow = a.w[i] < borrow;
+        }
+        r.normalize();
+        return r;
+    }
+
+    friend BigInt operator*(const BigInt& a, const BigInt& b) {
+        if (a.isZero() || b.isZero()) return BigInt();
+        BigInt r;
+        r.w.resize(a.w.size() + b.w.size());
+        if (a.w.size() == b.w.size() && a.limbs() <= MAX_LIMBS) {
+            uint64_t scratch[6 * MAX_LIMBS];
+            mul_karatsuba(r.w.data(), a.w.data(), b.w.data(), a.limbs(), scratch);
+        } else {
+            mul_basecase(r.w.data(), a.w.data(), a.limbs(), b.w.data(), b.limbs());
+        }
+        r.normalize();
+        return r;
+    }
+
+    BigInt operator<<(int s) const {
+        if (isZero()) return BigInt();
+        BigInt r;
+        int q = s / 64, b = s % 64;
+        r.w.assign(w.size() + q + 1, 0);
+        for (size_t i = 0; i < w.size(); i++) {
+            r.w[i + q] |= w[i] << b;
+            if (b) r.w[i + q + 1] |= w[i] >> (64 - b);
+        }
+        r.normalize();
+        return r;
+    }
+
+    BigInt operator>>(int s) const {
+        int q = s / 64, b = s % 64;
+        if (q >= (int)w.size()) return BigInt();
+        BigInt r;
+        r.w.assign(w.size() - q, 0);
+        for (size_t i = 0; i < r.w.size(); i++) {
+            r.w[i] = w[i + q] >> b;
+            if (b && i + q + 1 < w.size()) r.w[i] |= w[i + q + 1] << (64 - b);
+        }
+        r.normalize();
+        return r;
+    }
+
+    // Division by a single limb
+    BigInt divSmall(uint64_t d, uint64_t* rem = nullptr) const {
+        BigInt q;
+        q.w.resize(w.size());
+        u128 r = 0;
+        for (int i = limbs() - 1; i >= 0; i--) {
+            r = (r << 64) | w[i];
+            q.w[i] = (uint64_t)(r / d);
+            r %= d;
+        }
+        q.normalize();
+        if (rem) *rem = (uint64_t)r;
+        return q;
+    }
+
+    uint64_t modSmall(uint64_t d) const {
+        u128 r = 0;
+        for (int i = limbs() - 1; i >= 0; i--) {
+            r = ((r << 64) | w[i]) % d;
+        }
+        return (uint64_t)r;
+    }
+
+    // a mod m by shift-and-subtract; meant for key setup, not hot paths
+    friend BigInt operator%(const BigInt& a, const BigInt& m) {
+        if (m.isZero()) throw std::domain_error("BigInt modulo by zero");
+        if (a < m) return a;
+        BigInt r;
+        for (int i = a.bits() - 1; i >= 0; i--) {
+            r = r << 1;
+            if (a.bit(i)) {
+                if (r.w.empty()) r.w.push_back(0);
+                r.w[0] |= 1;
+            }
+            if (r >= m) r = r - m;
+        }
+        return r;
+    }
+};
+
+// Inverse of a modulo a 64-bit m (gcd must be 1), by extended Euclid
+static inline uint64_t inverse_mod_u64(uint64_t a, uint64_t m) {
+    int64_t t = 0, new_t = 1;
+    int64_t r = (int64_t)m, new_r = (int64_t)(a % m);
+    while (new_r != 0) {
+        int64_t q = r / new_r;
+        int64_t tmp = t - q * new_t; t = new_t; new_t = tmp;
+        tmp = r - q * new_r; r = new_r; new_r = tmp;
+    }
+    if (r != 1) throw std::domain_error("value not invertible");
+    return (uint64_t)(t < 0 ? t + (int64_t)m : t);
+}
+
+// e^-1 mod m for a small prime e not dividing m: find k with
+// k * m = -1 (mod e), then d = (k * m + 1) / e is exact
+static inline BigInt inverse_small_exponent(uint64_t e, const BigInt& m) {
+    uint64_t r = m.modSmall(e);
+    if (r == 0) throw std::domain_error("exponent divides modulus");
+    uint64_t k = inverse_mod_u64(e - r, e);
+    return (m * BigInt(k) + BigInt(1)).divSmall(e);
+}
+
+// ---------------------------------------------------------------------------
+// Montgomery arithmetic modulo an odd n of k limbs, R = 2^(64k)
+// ---------------------------------------------------------------------------
+
+class Montgomery {
+public:
+    enum Method {
+        CIOS,        // Coarsely integrated operand scanning, 2k^2 + k products
+        KARATSUBA    // a*b, (t mod R)*n' and m*n as three Karatsuba products
+    };
+
+    enum ExpMethod {
+        BINARY,          // Left-to-right square-and-multiply
+        FIXED_WINDOW,    // 2^w-entry table, one multiply per non-zero window
+        SLIDING_WINDOW,  // 2^(w-1) odd powers, windows start and end on set bits
+        CONSTANT_TIME    // Fixed window over the full modulus width, every window
+                         // multiplied, table read by masked scan
+    };
+
+    static const int MAX_WINDOW = 6;
+
+    // Window width minimising squarings + table build + multiplies
+    static int defaultWindow(int exp_bits) {
+        return exp_bits > 768 ? 5 : exp_bits > 240 ? 4 : exp_bits > 80 ? 3 : 1;
+    }
+
+    int k = 0;
+    uint64_t n[MAX_LIMBS];
+    uint64_t n0 = 0;                 // -n^-1 mod 2^64
+    uint64_t n_prime[MAX_LIMBS];     // -n^-1 mod R
+    uint64_t r1[MAX_LIMBS];          // R mod n (Montgomery form of 1)
+    uint64_t r2[MAX_LIMBS];          // R^2 mod n
+    BigInt modulus;
+
+    Montgomery() {}
+
+    explicit Montgomery(const BigInt& mod) : modulus(mod) {
+        if (!mod.isOdd()) throw std::domain_error("Montgomery modulus must be odd");
+        k = mod.limbs();
+        if (k > MAX_LIMBS) throw std::length_error("modulus exceeds MAX_LIMBS");
+        mod.toLimbs(n, k);
+
+        // Newton iteration x = x(2 - n x) doubles the correct low bits;
+        // n itself is its own inverse mod 8, so 5 steps cover 64 bits
+        uint64_t x = n[0];
+        for (int i = 0; i < 5; i++) x *= 2 - n[0] * x;
+        n0 = ~x + 1;
+
+        // The same iteration on k limbs for the full -n^-1 mod R
+        uint64_t inv[MAX_LIMBS] = {0}, t[2 * MAX_LIMBS], u[2 * MAX_LIMBS], scratch[6 * MAX_LIMBS];
+        inv[0] = x;
+        for (int correct = 64; correct < 64 * k; correct *= 2) {
+            mulLow(t, n, inv, scratch);                 // n x mod R
+            for (int i = 0; i < k; i++) t[i] = ~t[i];   // 2 - n x = ~(n x) + 3
+            add_1(t, k, 3);
+            mulLow(u, inv, t, scratch);
+            std::copy(u, u + k, inv);
+        }
+        for (int i = 0; i < k; i++) n_prime[i] = ~inv[i];
+        add_1(n_prime, k, 1);
+
+        BigInt R = BigInt(1) << (64 * k);
+        (R % mod).toLimbs(r1, k);
+        (((R % mod) * (R % mod)) % mod).toLimbs(r2, k);
+    }
+
+    // r = a * b * R^-1 mod n, operands and result fully reduced, k limbs
+    void mul(uint64_t* r, const uint64_t* a, const uint64_t* b, Method method = CIOS) const {
+        if (method == KARATSUBA) {
+            mulKaratsuba(r, a, b);
+        } else {
+            mulCIOS(r, a, b);
+        }
+    }
+
+    void mulCIOS(uint64_t* r, const uint64_t* a, const uint64_t* b) const {
+        uint64_t t[MAX_LIMBS + 2] = {0};
+        for (int i = 0; i < k; i++) {
+            uint64_t carry = 0;
+            for (int j = 0; j < k; j++) {
+                u128 s = (u128)a[j] * b[i] + t[j] + carry;
+                t[j] = (uint64_t)s;
+                carry = (uint64_t)(s >> 64);
+            }
+            u128 s = (u128)t[k] + carry;
+            t[k] = (uint64_t)s;
+            t[k + 1] = (uint64_t)(s >> 64);
+
+            uint64_t m = t[0] * n0;
+            s = (u128)m * n[0] + t[0];
+            carry = (uint64_t)(s >> 64);
+            for (int j = 1; j < k; j++) {
+                s = (u128)m * n[j] + t[j] + carry;
+                t[j - 1] = (uint64_t)s;
+                carry = (uint64_t)(s >> 64);
+            }
+            s = (u128)t[k] + carry;
+            t[k - 1] = (uint64_t)s;
+            t[k] = t[k + 1] + (uint64_t)(s >> 64);
+        }
+        finalSubtract(r, t, t[k]);
+    }
+
+    void mulKaratsuba(uint64_t* r, const uint64_t* a, const uint64_t* b) const {
+        uint64_t t[2 * MAX_LIMBS], m[2 * MAX_LIMBS], u[2 * MAX_LIMBS], scratch[6 * MAX_LIMBS];
+        mul_karatsuba(t, a, b, k, scratch);
+        mulLow(m, t, n_prime, scratch);
+        mul_karatsuba(u, m, n, k, scratch);
+        // t + m n is divisible by R; keep the high half
+        uint64_t carry = add_n(t, t, u, 2 * k);
+        finalSubtract(r, t + k, carry);
+    }
+
+    void toMont(uint64_t* r, const uint64_t* a, Method method = CIOS) const {
+        mul(r, a, r2, method);
+    }
+
+    void fromMont(uint64_t* r, const uint64_t* a, Method method = CIOS) const {
+        uint64_t one[MAX_LIMBS] = {1};
+        mul(r, a, one, method);
+    }
+
+    // a mod n for any a < n R: a R^-1 by REDC, then times R^2 R^-1
+    BigInt reduce(const BigInt& a, Method method = CIOS) const {
+        uint64_t t[2 * MAX_LIMBS + 1] = {0}, lo[MAX_LIMBS], res[MAX_LIMBS];
+        if (a.limbs() > 2 * k) throw std::length_error("value too large to reduce");
+        std::copy(a.w.begin(), a.w.end(), t);
+        for (int i = 0; i < k; i++) {
+            uint64_t m = t[i] * n0;
+            uint64_t carry = 0;
+            for (int j = 0; j < k; j++) {
+                u128 s = (u128)m * n[j] + t[i + j] + carry;
+                t[i + j] = (uint64_t)s;
+                carry = (uint64_t)(s >> 64);
+            }
+            t[2 * k] += add_1(t + i + k, k - i, carry);
+        }
+        finalSubtract(lo, t + k, t[2 * k]);
+        mul(res, lo, r2, method);
+        return BigInt::fromLimbs(res, k);
+    }
+
+    // base^exp mod n; window 0 picks defaultWindow(exp.bits())
+    BigInt modExp(const BigInt& base, const BigInt& exp, Method method = CIOS,
+                  ExpMethod exp_method = BINARY, int window = 0) const {
+        uint64_t b[MAX_LIMBS], x[MAX_LIMBS], acc[MAX_LIMBS], out[MAX_LIMBS];
+        reduceInput(base).toLimbs(b, k);
+        toMont(x, b, method);
+        if (window <= 0) window = defaultWindow(exp.bits());
+        window = std::min(window, (int)MAX_WINDOW);
+
+        switch (exp_method) {
+        case FIXED_WINDOW:   expFixedWindow(acc, x, exp, method, window, false); break;
+        case CONSTANT_TIME:  expFixedWindow(acc, x, exp, method, window, true); break;
+        case SLIDING_WINDOW: expSlidingWindow(acc, x, exp, method, window); break;
+        default:             expBinary(acc, x, exp, method); break;
+        }
+        fromMont(out, acc, method);
+        return BigInt::fromLimbs(out, k);
+    }
+
+    static const char* expMethodName(ExpMethod m) {
+        switch (m) {
+        case FIXED_WINDOW:   return "fixed window";
+        case SLIDING_WINDOW: return "sliding window";
+        case CONSTANT_TIME:  return "constant time";
+        default:             return "binary";
+        }
+    }
+
+private:
+    BigInt reduceInput(const BigInt& a) const {
+        return a < modulus ? a : reduce(a);
+    }
+
+    // Bits [pos, pos + w) of exp; bits past the top read as zero
+    static unsigned windowBits(const BigInt& exp, int pos, int w) {
+        unsigned v = 0;
+        for (int j = w - 1; j >= 0; j--) v = (v << 1) | (unsigned)exp.bit(pos + j);
+        return v;
+    }
+
+    void copy(uint64_t* r, const uint64_t* a) const { std::copy(a, a + k, r); }
+
+    // All operands in Montgomery form; acc receives x^exp
+    void expBinary(uint64_t* acc, const uint64_t* x, const BigInt& exp, Method method) const {
+        copy(acc, r1);
+        for (int i = exp.bits() - 1; i >= 0; i--) {
+            mul(acc, acc, acc, method);
+            if (exp.bit(i)) mul(acc, acc, x, method);
+        }
+    }
+
+    void expFixedWindow(uint64_t* acc, const uint64_t* x, const BigInt& exp, Method method,
+                        int w, bool constant_time) const {
+        uint64_t table[1 << MAX_WINDOW][MAX_LIMBS], t[MAX_LIMBS];
+        copy(table[0], r1);
+        copy(table[1], x);
+        for (int j = 2; j < (1 << w); j++) mul(table[j], table[j - 1], x, method);
+
+        // The constant-time walk depends only on the modulus size, never on
+        // the exponent's bit length or window values
+        int top = constant_time ? std::max(64 * k, exp.bits()) : exp.bits();
+        int windows = (top + w - 1) / w;
+        if (windows == 0) {
+            copy(acc, r1);
+            return;
+        }
+
+        auto lookup = [&](uint64_t* r, unsigned idx) {
+            if (!constant_time) {
+                copy(r, table[idx]);
+                return;
+            }
+            std::fill(r, r + k, 0);
+            for (unsigned j = 0; j < (1u << w); j++) {
+                uint64_t mask = 0 - (uint64_t)(j == idx);
+                for (int l = 0; l < k; l++) r[l] |= table[j][l] & mask;
+            }
+        };
+
+        lookup(acc, windowBits(exp, (windows - 1) * w, w));
+        for (int i = windows - 2; i >= 0; i--) {
+            for (int s = 0; s < w; s++) mul(acc, acc, acc, method);
+            unsigned bits = windowBits(exp, i * w, w);
+            if (constant_time) {
+                lookup(t, bits);
+                mul(acc, acc, t, method);
+            } else if (bits) {
+                mul(acc, acc, table[bits], method);
+            }
+        }
+    }
+
+    void expSlidingWindow(uint64_t* acc, const uint64_t* x, const BigInt& exp, Method method, int w) const {
+        uint64_t odd[1 << (MAX_WINDOW - 1)][MAX_LIMBS], x2[MAX_LIMBS];
+        copy(odd[0], x);
+        mul(x2, x, x, method);
+        for (int j = 1; j < (1 << (w - 1)); j++) mul(odd[j], odd[j - 1], x2, method);
+
+        copy(acc, r1);
+        bool started = false;
+        int i = exp.bits() - 1;
+        while (i >= 0) {
+            if (!exp.bit(i)) {
+                if (started) mul(acc, acc, acc, method);
+                i--;
+                continue;
+            }
+            // Longest window of at most w bits that ends on a set bit
+            int l = std::max(i - w + 1, 0);
+            while (!exp.bit(l)) l++;
+            unsigned value = windowBits(exp, l, i - l + 1);
+            if (started) {
+                for (int s = 0; s <= i - l; s++) mul(acc, acc, acc, method);
+                mul(acc, acc, odd[value >> 1], method);
+            } else {
+                copy(acc, odd[value >> 1]);
+                started = true;
+            }
+            i = l - 1;
+        }
+    }
+
+    // r = t - n if (carry:t) >= n, else t; constant time in the data
+    void finalSubtract(uint64_t* r, const uint64_t* t, uint64_t carry) const {
+        uint64_t d[MAX_LIMBS];
+        uint64_t borrow = sub_n(d, t, n, k);
+        uint64_t keep = 0 - (uint64_t)(borrow > carry);  // all ones: t < n
+        for (int i = 0; i < k; i++) {
+            r[i] = (t[i] & keep) | (d[i] & ~keep);
+        }
+    }
+
+    // r = a * b mod R
+    void mulLow(uint64_t* r, const uint64_t* a, const uint64_t* b, uint64_t* scratch) const {
+        uint64_t full[2 * MAX_LIMBS];
+        mul_karatsuba(full, a, b, k, scratch);
+        std::copy(full, full + k, r);
+    }
+};
+
+// ---------------------------------------------------------------------------
+// Primes
+// ---------------------------------------------------------------------------
+
+static const uint32_t small_primes[] = {
+    3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53, 59, 61, 67, 71, 73, 79, 83, 89, 97,
+    101, 103, 107, 109, 113, 127, 131, 137, 139, 149, 151, 157, 163, 167, 173, 179, 181, 191, 193,
+    197, 199, 211, 223, 227, 229, 233, 239, 241, 251, 257, 263, 269, 271, 277, 281, 283, 293, 307,
+    311, 313, 317, 331, 337, 347, 349, 353, 359, 367, 373, 379, 383, 389, 397, 401, 409, 419, 421,
+    431, 433, 439, 443, 449, 457, 461, 463, 467, 479, 487, 491, 499, 503, 509, 521, 523, 541
+};
+
+// Miller-Rabin with `rounds` random bases
+template <typename Rng>
+bool isProbablePrime(const BigInt& n, int rounds, Rng& rng) {
+    if (n < BigInt(2)) return false;
+    for (uint32_t p : small_primes) {
+        if (n == BigInt(p)) return true;
+        if (n.modSmall(p) == 0) return false;
+    }
+    if (!n.isOdd()) return false;
+
+    BigInt n_minus_1 = n - BigInt(1);
+    int s = 0;
+    while (!n_minus_1.bit(s)) s++;
+    BigInt d = n_minus_1 >> s;
+
+    Montgomery mont(n);
+    uint64_t minus_one[MAX_LIMBS], x[MAX_LIMBS], xm[MAX_LIMBS];
+    (n - BigInt::fromLimbs(mont.r1, mont.k)).toLimbs(minus_one, mont.k);  // -R mod n
+
+    for (int round = 0; round < rounds; round++) {
+        BigInt a = BigInt::random(std::max(2, n.bits() - 1), rng) % (n - BigInt(3)) + BigInt(2);
+        mont.modExp(a, d).toLimbs(x, mont.k);
+        mont.toMont(xm, x);
+        if (cmp_n(xm, mont.r1, mont.k) == 0 || cmp_n(xm, minus_one, mont.k) == 0) continue;
+
+        bool witness = true;
+        for (int i = 1; i < s && witness; i++) {
+            mont.mul(xm, xm, xm);
+            if (cmp_n(xm, minus_one, mont.k) == 0) witness = false;
+        }
+        if (witness) return false;
+    }
+    return true;
+}
+
+// Random prime of exactly `bits` bits with the top two bits set (so the
+// product of two such primes has exactly 2 * bits bits) and p - 1 coprime
+// to e
+template <typename Rng>
+BigInt randomPrime(int bits, uint64_t e, Rng& rng) {
+    while (true) {
+        BigInt p = BigInt::random(bits, rng);
+        p.w[(bits - 2) / 64] |= 1ULL << ((bits - 2) % 64);
+        p.w[0] |= 1;
+
+        bool composite = false;
+        for (uint32_t sp : small_primes) {
+            if (p.modSmall(sp) == 0) {
+                composite = true;
+                break;
+            }
+        }
+        if (composite || p.modSmall(e) == 1) continue;
+        if (isProbablePrime(p, 20, rng)) return p;
+    }
+}
+
+}  // namespace bignum
+
+#endif  // _RSA_BIGNUM_H_
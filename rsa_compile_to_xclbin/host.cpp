@@ -0,0 +1,915 @@
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+// XRT includes for Xilinx Runtime
+#include "xrt/xrt_bo.h"
+#include "xrt/xrt_device.h"
+#include "xrt/xrt_kernel.h"
+
+// In-project multi-precision arithmetic (no external bignum library)
+#include "bignum.h"
+
+using bignum::BigInt;
+using bignum::Montgomery;
+
+// Must match RSA_BITS in rsa.h (not included here: it pulls in ap_int.h)
+#define RSA_KERNEL_BITS 2048
+#define RSA_KERNEL_BYTES (RSA_KERNEL_BITS / 8)
+#define RSA_KERNEL_HALF_BYTES (RSA_KERNEL_BYTES / 2)
+#define RSA_KERNEL_MAX_KEY_SLOTS 256
+#define RSA_KERNEL_KEY_SLOT_BYTES (2 * RSA_KERNEL_BYTES)
+
+// RSA key. Public keys leave the private fields zero.
+struct RSAKey {
+    int bits = 0;
+    BigInt n, e;
+    BigInt d, p, q, dp, dq, qinv;
+
+    bool hasPrivate() const { return !d.isZero(); }
+};
+
+// Test key generation: two random primes of bits/2 with the top two bits
+// set, e = 65537, d = e^-1 mod (p-1)(q-1), plus the CRT components.
+// Deterministic for a given seed - NOT for production use.
+RSAKey generateKey(int bits, uint64_t seed, uint64_t e = 65537) {
+    std::mt19937_64 rng(seed);
+    RSAKey key;
+    key.bits = bits;
+    key.e = BigInt(e);
+    do {
+        key.p = bignum::randomPrime(bits / 2, e, rng);
+        key.q = bignum::randomPrime(bits / 2, e, rng);
+    } while (key.p == key.q);
+    if (key.p < key.q) std::swap(key.p, key.q);
+
+    BigInt p1 = key.p - BigInt(1), q1 = key.q - BigInt(1);
+    key.n = key.p * key.q;
+    key.d = bignum::inverse_small_exponent(e, p1 * q1);
+    key.dp = bignum::inverse_small_exponent(e, p1);
+    key.dq = bignum::inverse_small_exponent(e, q1);
+    key.qinv = Montgomery(key.p).modExp(key.q, key.p - BigInt(2));  // Fermat inverse
+    return key;
+}
+
+// Key file: one "name = hex" line per component (n and e required)
+bool loadKey(const std::string& path, RSAKey& key) {
+    std::ifstream in(path);
+    if (!in) return false;
+
+    key = RSAKey();
+    std::string line;
+    while (std::getline(in, line)) {
+        size_t eq = line.find('=');
+        if (eq == std::string::npos || line[0] == '#') continue;
+        std::string name = line.substr(0, eq);
+        name.erase(std::remove_if(name.begin(), name.end(), ::isspace), name.end());
+        BigInt value = BigInt::fromHex(line.substr(eq + 1));
+
+        if (name == "n") key.n = value;
+        else if (name == "e") key.e = value;
+        else if (name == "d") key.d = value;
+        else if (name == "p") key.p = value;
+        else if (name == "q") key.q = value;
+        else if (name == "dp") key.dp = value;
+        else if (name == "dq") key.dq = value;
+        else if (name == "qinv") key.qinv = value;
+    }
+    if (key.n.isZero() || key.e.isZero()) {
+        throw std::runtime_error("key file " + path + " lacks n or e");
+    }
+    key.bits = key.n.bits();
+    return true;
+}
+
+void saveKey(const std::string& path, const RSAKey& key) {
+    std::ofstream out(path);
+    out << "# RSA-" << key.bits << " test key" << std::endl;
+    out << "n = " << key.n.toHex() << std::endl;
+    out << "e = " << key.e.toHex() << std::endl;
+    if (key.hasPrivate()) {
+        out << "d = " << key.d.toHex() << std::endl;
+        out << "p = " << key.p.toHex() << std::endl;
+        out << "q = " << key.q.toHex() << std::endl;
+        out << "dp = " << key.dp.toHex() << std::endl;
+        out << "dq = " << key.dq.toHex() << std::endl;
+        out << "qinv = " << key.qinv.toHex() << std::endl;
+    }
+}
+
+// Latency percentiles of a set of samples (microseconds)
+struct LatencyStats {
+    double mean, p50, p90, p99, max;
+};
+
+LatencyStats latencyStats(std::vector<double> samples) {
+    std::sort(samples.begin(), samples.end());
+    auto at = [&](double q) {
+        size_t idx = std::min(samples.size() - 1, (size_t)(q * (samples.size() - 1) + 0.5));
+        return samples[idx];
+    };
+    LatencyStats s;
+    s.mean = std::accumulate(samples.begin(), samples.end(), 0.0) / samples.size();
+    s.p50 = at(0.50);
+    s.p90 = at(0.90);
+    s.p99 = at(0.99);
+    s.max = samples.back();
+    return s;
+}
+
+// CPU RSA on the in-project bignum: the verification reference for the
+// kernel and the software baseline it is compared against
+class RsaCPU {
+private:
+    RSAKey key;
+    Montgomery mont_n;
+    Montgomery mont_p, mont_q;  // CRT halves, set up when p and q are known
+    Montgomery::Method method;
+    size_t block_bytes;
+
+public:
+    static const char* methodName(Montgomery::Method m) {
+        return m == Montgomery::KARATSUBA ? "Karatsuba" : "CIOS";
+    }
+
+    RsaCPU(const RSAKey& k, Montgomery::Method m) : key(k), mont_n(k.n), method(m) {
+        block_bytes = (k.bits + 7) / 8;
+        if (hasCRT()) {
+            mont_p = Montgomery(k.p);
+            mont_q = Montgomery(k.q);
+        }
+    }
+
+    // CIOS is the faster method at every size bignum supports
+    explicit RsaCPU(const RSAKey& k) : RsaCPU(k, Montgomery::CIOS) {}
+
+    size_t blockBytes() const { return block_bytes; }
+
+    bool hasCRT() const { return !key.p.isZero() && !key.q.isZero() && !key.qinv.isZero(); }
+
+    BigInt publicOp(const BigInt& m) const {
+        return mont_n.modExp(m, key.e, method);
+    }
+
+    BigInt privateOp(const BigInt& c, Montgomery::ExpMethod exp_method = Montgomery::SLIDING_WINDOW) const {
+        if (!key.hasPrivate()) throw std::runtime_error("private key not loaded");
+        return mont_n.modExp(c, key.d, method, exp_method);
+    }
+
+    // c^d mod n from two half-size exponentiations (on two threads when
+    // parallel is set) and Garner's recombination m = m2 + q (qinv (m1 - m2) mod p)
+    BigInt privateOpCRT(const BigInt& c, Montgomery::ExpMethod exp_method = Montgomery::SLIDING_WINDOW,
+                        bool parallel = false) const {
+        if (!hasCRT()) throw std::runtime_error("CRT key components not loaded");
+
+        // c < n < p R, so Montgomery::reduce yields c mod p directly
+        BigInt m1, m2;
+        auto half_q = [&] { m2 = mont_q.modExp(mont_q.reduce(c, method), key.dq, method, exp_method); };
+        if (parallel) {
+            std::thread worker(half_q);
+            m1 = mont_p.modExp(mont_p.reduce(c, method), key.dp, method, exp_method);
+            worker.join();
+        } else {
+            half_q();
+            m1 = mont_p.modExp(mont_p.reduce(c, method), key.dp, method, exp_method);
+        }
+
+        BigInt m2_p = m2 < key.p ? m2 : m2 % key.p;
+        BigInt diff = m1 >= m2_p ? m1 - m2_p : m1 + key.p - m2_p;
+        BigInt h = (key.qinv * diff) % key.p;
+        return m2 + h * key.q;
+    }
+
+    // Batch private-key operation over big-endian blocks; blocks are split
+    // across num_threads workers (0 = all hardware threads)
+    void privateBlocks(const uint8_t* input, uint8_t* output, int num_blocks, bool use_crt,
+                       Montgomery::ExpMethod exp_method = Montgomery::SLIDING_WINDOW,
+                       unsigned num_threads = 1) const {
+        if (num_threads == 0) num_threads = std::max(1u, std::thread::hardware_concurrency());
+        num_threads = std::min<unsigned>(num_threads, std::max(num_blocks, 1));
+
+        auto worker = [=](int begin, int end) {
+            for (int i = begin; i < end; i++) {
+                BigInt c = BigInt::fromBytes(input + i * block_bytes, block_bytes);
+                BigInt m = use_crt ? privateOpCRT(c, exp_method) : privateOp(c, exp_method);
+                m.toBytes(output + i * block_bytes, block_bytes);
+            }
+        };
+
+        std::vector<std::thread> threads;
+        int per_thread = (num_blocks + num_threads - 1) / num_threads;
+        for (unsigned t = 0; t < num_threads; t++) {
+            int begin = t * per_thread;
+            int end = std::min(num_blocks, begin + per_thread);
+            if (begin < end) threads.emplace_back(worker, begin, end);
+        }
+        for (auto& t : threads) t.join();
+    }
+
+    // Big-endian blocks in the kernel's layout
+    void encryptBlocks(const uint8_t* plaintext, uint8_t* ciphertext, int num_blocks) const {
+        for (int i = 0; i < num_blocks; i++) {
+            BigInt m = BigInt::fromBytes(plaintext + i * block_bytes, block_bytes);
+            publicOp(m).toBytes(ciphertext + i * block_bytes, block_bytes);
+        }
+    }
+};
+
+// One signature check for RSAHost::verifyBatch: signature^e mod n must equal
+// the expected encoded message under the key in key_slot
+struct VerifyJob {
+    int key_slot;
+    const uint8_t* signature;
+    const uint8_t* expected;
+};
+
+class RSAHost {
+private:
+    xrt::device device;
+    xrt::kernel kernel;
+    xrt::kernel kernel_modexp;
+    xrt::kernel kernel_crt;
+    xrt::bo bo_plain, bo_n, bo_e, bo_cipher;
+    xrt::bo bo_in, bo_mod, bo_d, bo_out;
+    xrt::bo bo_crt_in, bo_crt_key, bo_crt_out;
+    xrt::kernel kernel_verify;
+    xrt::bo bo_key_table, bo_sigs, bo_expected, bo_job_keys, bo_results;
+    int max_blocks = 0;
+    bool has_modexp = false;
+    bool has_crt_kernel = false;
+    bool has_private = false;
+    bool has_crt = false;
+    bool has_verify = false;
+    int num_key_slots = 0;
+    int dirty_first = 0, dirty_end = 0;  // key slots not yet on the device
+
+public:
+    RSAHost(const std::string& xclbin_path, int device_id = 0) {
+        try {
+            device = xrt::device(device_id);
+            auto uuid = device.load_xclbin(xclbin_path);
+            kernel = xrt::kernel(device, uuid, "rsa_encrypt");
+            try {
+                kernel_modexp = xrt::kernel(device, uuid, "rsa_modexp");
+                has_modexp = true;
+            } catch (const std::exception&) {
+                // Older xclbins only carry rsa_encrypt
+            }
+            try {
+                kernel_crt = xrt::kernel(device, uuid, "rsa_crt");
+                has_crt_kernel = true;
+            } catch (const std::exception&) {
+            }
+            try {
+                kernel_verify = xrt::kernel(device, uuid, "rsa_verify_batch");
+                has_verify = true;
+            } catch (const std::exception&) {
+            }
+            std::cout << "✓ RSA-" << RSA_KERNEL_BITS << " Hardware accelerator initialized successfully" << std::endl;
+        } catch (const std::exception& e) {
+            std::cerr << "Error initializing RSA accelerator: " << e.what() << std::endl;
+            throw;
+        }
+    }
+
+    void allocateBuffers(int blocks) {
+        try {
+            max_blocks = blocks;
+            bo_plain = xrt::bo(device, blocks * RSA_KERNEL_BYTES, kernel.group_id(0));
+            bo_n = xrt::bo(device, RSA_KERNEL_BYTES, kernel.group_id(1));
+            bo_e = xrt::bo(device, RSA_KERNEL_BYTES, kernel.group_id(2));
+            bo_cipher = xrt::bo(device, blocks * RSA_KERNEL_BYTES, kernel.group_id(3));
+            if (has_modexp) {
+                bo_in = xrt::bo(device, blocks * RSA_KERNEL_BYTES, kernel_modexp.group_id(0));
+                bo_mod = xrt::bo(device, RSA_KERNEL_BYTES, kernel_modexp.group_id(1));
+                bo_d = xrt::bo(device, RSA_KERNEL_BYTES, kernel_modexp.group_id(2));
+                bo_out = xrt::bo(device, blocks * RSA_KERNEL_BYTES, kernel_modexp.group_id(3));
+            }
+            if (has_crt_kernel) {
+                bo_crt_in = xrt::bo(device, blocks * RSA_KERNEL_BYTES, kernel_crt.group_id(0));
+                bo_crt_key = xrt::bo(device, 5 * RSA_KERNEL_HALF_BYTES, kernel_crt.group_id(1));
+                bo_crt_out = xrt::bo(device, blocks * RSA_KERNEL_BYTES, kernel_crt.group_id(2));
+            }
+            if (has_verify) {
+                bo_key_table = xrt::bo(device, RSA_KERNEL_MAX_KEY_SLOTS * RSA_KERNEL_KEY_SLOT_BYTES,
+                                       kernel_verify.group_id(0));
+                bo_sigs = xrt::bo(device, blocks * RSA_KERNEL_BYTES, kernel_verify.group_id(3));
+                bo_expected = xrt::bo(device, blocks * RSA_KERNEL_BYTES, kernel_verify.group_id(4));
+                bo_job_keys = xrt::bo(device, blocks * sizeof(uint32_t), kernel_verify.group_id(5));
+                bo_results = xrt::bo(device, blocks, kernel_verify.group_id(6));
+            }
+            std::cout << "✓ Buffers allocated: " << blocks << " blocks" << std::endl;
+        } catch (const std::exception& e) {
+            std::cerr << "Error allocating buffers: " << e.what() << std::endl;
+            throw;
+        }
+    }
+
+    // Upload the public key once; it stays resident for later launches
+    // Blocks passed to encrypt/sign/privateCRT are RSA_KERNEL_BYTES apart,
+    // so the key must be exactly the kernel's size
+    void setKey(const RSAKey& key) {
+        if (key.bits != RSA_KERNEL_BITS) {
+            throw std::runtime_error("kernel is built for RSA-" + std::to_string(RSA_KERNEL_BITS));
+        }
+        key.n.toBytes(bo_n.map<uint8_t*>(), RSA_KERNEL_BYTES);
+        key.e.toBytes(bo_e.map<uint8_t*>(), RSA_KERNEL_BYTES);
+        bo_n.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+        bo_e.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+
+        has_private = has_modexp && key.hasPrivate();
+        if (has_private) {
+            key.n.toBytes(bo_mod.map<uint8_t*>(), RSA_KERNEL_BYTES);
+            key.d.toBytes(bo_d.map<uint8_t*>(), RSA_KERNEL_BYTES);
+            bo_mod.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+            bo_d.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+        }
+
+        // Packed CRT key p | q | dp | dq | qinv for rsa_crt
+        has_crt = has_crt_kernel && !key.qinv.isZero();
+        if (has_crt) {
+            uint8_t* packed = bo_crt_key.map<uint8_t*>();
+            const BigInt* parts[] = {&key.p, &key.q, &key.dp, &key.dq, &key.qinv};
+            for (int i = 0; i < 5; i++) {
+                parts[i]->toBytes(packed + i * RSA_KERNEL_HALF_BYTES, RSA_KERNEL_HALF_BYTES);
+            }
+            bo_crt_key.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+        }
+    }
+
+    bool canSign() const { return has_private; }
+    bool canCRT() const { return has_crt; }
+
+    // c = m^e mod n for num_blocks big-endian blocks; returns seconds
+    // including transfers
+    double encrypt(const uint8_t* plaintext, uint8_t* ciphertext, int num_blocks) {
+        if (num_blocks > max_blocks) {
+            throw std::runtime_error("batch exceeds the allocated buffers");
+        }
+        size_t bytes = (size_t)num_blocks * RSA_KERNEL_BYTES;
+
+        auto start = std::chrono::high_resolution_clock::now();
+        std::memcpy(bo_plain.map<uint8_t*>(), plaintext, bytes);
+        bo_plain.sync(XCL_BO_SYNC_BO_TO_DEVICE, bytes, 0);
+
+        auto run = kernel(bo_plain, bo_n, bo_e, bo_cipher, num_blocks);
+        run.wait();
+
+        bo_cipher.sync(XCL_BO_SYNC_BO_FROM_DEVICE, bytes, 0);
+        std::memcpy(ciphertext, bo_cipher.map<uint8_t*>(), bytes);
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double>(end - start).count();
+    }
+
+    // m = c^d mod n via CRT on the rsa_crt kernel (decryption or signing);
+    // returns seconds including transfers
+    double privateCRT(const uint8_t* input, uint8_t* output, int num_blocks, int exp_method) {
+        if (!has_crt) {
+            throw std::runtime_error("CRT needs rsa_crt and a CRT private key");
+        }
+        if (num_blocks > max_blocks) {
+            throw std::runtime_error("batch exceeds the allocated buffers");
+        }
+        size_t bytes = (size_t)num_blocks * RSA_KERNEL_BYTES;
+
+        auto start = std::chrono::high_resolution_clock::now();
+        std::memcpy(bo_crt_in.map<uint8_t*>(), input, bytes);
+        bo_crt_in.sync(XCL_BO_SYNC_BO_TO_DEVICE, bytes, 0);
+
+        auto run = kernel_crt(bo_crt_in, bo_crt_key, bo_crt_out, num_blocks, exp_method);
+        run.wait();
+
+        bo_crt_out.sync(XCL_BO_SYNC_BO_FROM_DEVICE, bytes, 0);
+        std::memcpy(output, bo_crt_out.map<uint8_t*>(), bytes);
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double>(end - start).count();
+    }
+
+    bool canVerifyBatch() const { return has_verify; }
+
+    // Write a public key into the next free slot of the key table and
+    // return the slot. Only slots added since the last verifyBatch are
+    // transferred and set up on chip by the next launch.
+    int addVerifyKey(const RSAKey& key) {
+        if (!has_verify) throw std::runtime_error("xclbin lacks rsa_verify_batch");
+        if (num_key_slots >= RSA_KERNEL_MAX_KEY_SLOTS) throw std::runtime_error("key slot table is full");
+        if (key.bits > RSA_KERNEL_BITS) {
+            throw std::runtime_error("kernel is built for RSA-" + std::to_string(RSA_KERNEL_BITS));
+        }
+        int slot = num_key_slots++;
+        uint8_t* entry = bo_key_table.map<uint8_t*>() + slot * RSA_KERNEL_KEY_SLOT_BYTES;
+        key.n.toBytes(entry, RSA_KERNEL_BYTES);
+        key.e.toBytes(entry + RSA_KERNEL_BYTES, RSA_KERNEL_BYTES);
+        if (dirty_first == dirty_end) dirty_first = slot;
+        dirty_end = slot + 1;
+        return slot;
+    }
+
+    // Check any number of signatures across the registered key slots in
+    // launches of up to max_blocks jobs; results[j] is 1 when job j
+    // verifies. Returns seconds including transfers.
+    double verifyBatch(const std::vector<VerifyJob>& jobs, std::vector<uint8_t>& results) {
+        if (!has_verify) throw std::runtime_error("xclbin lacks rsa_verify_batch");
+        results.assign(jobs.size(), 0);
+
+        auto start = std::chrono::high_resolution_clock::now();
+        if (dirty_end > dirty_first) {
+            bo_key_table.sync(XCL_BO_SYNC_BO_TO_DEVICE, (dirty_end - dirty_first) * RSA_KERNEL_KEY_SLOT_BYTES,
+                              dirty_first * RSA_KERNEL_KEY_SLOT_BYTES);
+        }
+
+        for (size_t begin = 0; begin < jobs.size(); begin += max_blocks) {
+            int count = (int)std::min<size_t>(max_blocks, jobs.size() - begin);
+            uint8_t* sigs = bo_sigs.map<uint8_t*>();
+            uint8_t* expected = bo_expected.map<uint8_t*>();
+            uint32_t* slots = bo_job_keys.map<uint32_t*>();
+            for (int j = 0; j < count; j++) {
+                const VerifyJob& job = jobs[begin + j];
+                if (job.key_slot < 0 || job.key_slot >= num_key_slots) {
+                    throw std::runtime_error("job references an unregistered key slot");
+                }
+                std::memcpy(sigs + j * RSA_KERNEL_BYTES, job.signature, RSA_KERNEL_BYTES);
+                std::memcpy(expected + j * RSA_KERNEL_BYTES, job.expected, RSA_KERNEL_BYTES);
+                slots[j] = job.key_slot;
+            }
+            size_t bytes = (size_t)count * RSA_KERNEL_BYTES;
+            bo_sigs.sync(XCL_BO_SYNC_BO_TO_DEVICE, bytes, 0);
+            bo_expected.sync(XCL_BO_SYNC_BO_TO_DEVICE, bytes, 0);
+            bo_job_keys.sync(XCL_BO_SYNC_BO_TO_DEVICE, count * sizeof(uint32_t), 0);
+
+            // Pending slots are loaded by the first launch; later ones reuse them
+            auto run = kernel_verify(bo_key_table, dirty_first, dirty_end - dirty_first, bo_sigs, bo_expected,
+                                     bo_job_keys, bo_results, count);
+            run.wait();
+            dirty_first = dirty_end = 0;
+
+            bo_results.sync(XCL_BO_SYNC_BO_FROM_DEVICE, count, 0);
+            std::memcpy(&results[begin], bo_results.map<uint8_t*>(), count);
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double>(end - start).count();
+    }
+
+    // s = m^d mod n on the rsa_modexp kernel; returns seconds including
+    // transfers
+    double sign(const uint8_t* message, uint8_t* signature, int num_blocks, int exp_method) {
+        if (!has_private) {
+            throw std::runtime_error("signing needs rsa_modexp and a private key");
+        }
+        if (num_blocks > max_blocks) {
+            throw std::runtime_error("batch exceeds the allocated buffers");
+        }
+        size_t bytes = (size_t)num_blocks * RSA_KERNEL_BYTES;
+
+        auto start = std::chrono::high_resolution_clock::now();
+        std::memcpy(bo_in.map<uint8_t*>(), message, bytes);
+        bo_in.sync(XCL_BO_SYNC_BO_TO_DEVICE, bytes, 0);
+
+        auto run = kernel_modexp(bo_in, bo_mod, bo_d, bo_out, num_blocks, exp_method);
+        run.wait();
+
+        bo_out.sync(XCL_BO_SYNC_BO_FROM_DEVICE, bytes, 0);
+        std::memcpy(signature, bo_out.map<uint8_t*>(), bytes);
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double>(end - start).count();
+    }
+};
+
+// Kernel exponentiation methods, matching rsa_exp_method in rsa.h
+enum KernelExpMethod {
+    KERNEL_EXP_BINARY = 0,
+    KERNEL_EXP_FIXED_WINDOW = 1,
+    KERNEL_EXP_SLIDING_WINDOW = 2,
+    KERNEL_EXP_CONSTANT_TIME = 3
+};
+
+// Random messages below n, as big-endian blocks
+std::vector<uint8_t> randomBlocks(const RSAKey& key, int count, std::mt19937_64& rng) {
+    size_t block_bytes = (key.bits + 7) / 8;
+    std::vector<uint8_t> blocks(count * block_bytes);
+    for (int i = 0; i < count; i++) {
+        BigInt m = BigInt::random(key.bits - 1, rng);
+        m.toBytes(&blocks[i * block_bytes], block_bytes);
+    }
+    return blocks;
+}
+
+void printStatsRow(const std::string& label, double ops_per_sec, const LatencyStats& s) {
+    std::cout << std::left << std::setw(30) << label << std::right << std::fixed << std::setprecision(1)
+              << std::setw(12) << ops_per_sec << std::setw(11) << s.mean << std::setw(11) << s.p50
+              << std::setw(11) << s.p90 << std::setw(11) << s.p99 << std::endl;
+}
+
+void printStatsHeader() {
+    std::cout << std::left << std::setw(30) << "Operation" << std::right << std::setw(12) << "ops/s"
+              << std::setw(11) << "mean us" << std::setw(11) << "p50 us" << std::setw(11) << "p90 us"
+              << std::setw(11) << "p99 us" << std::endl;
+}
+
+const Montgomery::ExpMethod kExpMethods[] = {Montgomery::BINARY, Montgomery::FIXED_WINDOW,
+                                             Montgomery::SLIDING_WINDOW, Montgomery::CONSTANT_TIME};
+
+// The bignum against itself: decrypt(encrypt(m)) == m, both Montgomery
+// methods agree, and a known answer computed independently
+bool runCpuSelfTest(const std::vector<RSAKey>& keys) {
+    std::cout << "\n=== CPU Bignum Self-Test ===" << std::endl;
+    bool all_passed = true;
+
+    // 512-bit known answer (independently computed): c = m^65537 mod n
+    {
+        BigInt n = BigInt::fromHex(
+            "aac21240af61f7e6e6e2711d6a4328b244cb89cd06fa15e567bb114098cf8d33"
+            "2dc62af32d5afcb6cbf4644c26e9788e55137f0b396f06b6ea3c1b307150b555");
+        BigInt m = BigInt::fromHex("0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef");
+        BigInt expected = BigInt::fromHex(
+            "43b5910f0227841864fd38c60e3fd22d484d70563f434e7f9e57f257726800c6"
+            "f0243b824e654219d11276f1d271cf75cc31decc083a637e538451ad7a642a51");
+        Montgomery mont(n);
+        bool passed = mont.modExp(m, BigInt(65537), Montgomery::CIOS) == expected &&
+                      mont.modExp(m, BigInt(65537), Montgomery::KARATSUBA) == expected;
+        std::cout << "Known answer (512-bit): " << (passed ? "✓ PASSED" : "✗ FAILED") << std::endl;
+        all_passed &= passed;
+    }
+
+    std::mt19937_64 rng(7);
+    for (const auto& key : keys) {
+        RsaCPU cios(key, Montgomery::CIOS), kara(key, Montgomery::KARATSUBA);
+        bool passed = true;
+        for (int i = 0; i < 4; i++) {
+            BigInt m = BigInt::random(key.bits - 1, rng);
+            BigInt c = cios.publicOp(m);
+            passed &= c == kara.publicOp(m);
+            passed &= kara.privateOp(c) == m;
+            for (auto exp_method : kExpMethods) {
+                passed &= cios.privateOp(c, exp_method) == m;
+            }
+        }
+        std::cout << "RSA-" << key.bits << " round trip, CIOS == Karatsuba, all exponent methods: "
+                  << (passed ? "✓ PASSED" : "✗ FAILED") << std::endl;
+        all_passed &= passed;
+
+        if (cios.hasCRT()) {
+            bool crt_passed = true;
+            std::vector<uint8_t> in = randomBlocks(key, 8, rng), out(in.size()), out_crt(in.size());
+            for (int i = 0; i < 4; i++) {
+                BigInt c = BigInt::random(key.bits - 1, rng);
+                BigInt m = cios.privateOp(c);
+                crt_passed &= cios.privateOpCRT(c) == m;
+                crt_passed &= kara.privateOpCRT(c, Montgomery::CONSTANT_TIME, true) == m;
+            }
+            cios.privateBlocks(in.data(), out.data(), 8, false);
+            cios.privateBlocks(in.data(), out_crt.data(), 8, true, Montgomery::SLIDING_WINDOW, 0);
+            crt_passed &= out == out_crt;
+            std::cout << "RSA-" << key.bits << " CRT == full exponentiation (serial, 2 threads, batch): "
+                      << (crt_passed ? "✓ PASSED" : "✗ FAILED") << std::endl;
+            all_passed &= crt_passed;
+        }
+    }
+    return all_passed;
+}
+
+// Kernel ciphertexts against the CPU reference
+bool runKernelTest(RSAHost& rsa, const RSAKey& key) {
+    std::cout << "\n=== Kernel vs CPU Verification ===" << std::endl;
+
+    const int count = 16;
+    std::mt19937_64 rng(11);
+    std::vector<uint8_t> plain = randomBlocks(key, count, rng);
+    std::vector<uint8_t> cipher(plain.size()), expected(plain.size());
+
+    rsa.encrypt(plain.data(), cipher.data(), count);
+    RsaCPU(key).encryptBlocks(plain.data(), expected.data(), count);
+
+    int mismatches = 0;
+    for (int i = 0; i < count; i++) {
+        mismatches += std::memcmp(&cipher[i * RSA_KERNEL_BYTES], &expected[i * RSA_KERNEL_BYTES], RSA_KERNEL_BYTES) != 0;
+    }
+    std::cout << count << " blocks: " << (mismatches == 0 ? "✓ PASSED" : "✗ FAILED")
+              << " (" << mismatches << " mismatches)" << std::endl;
+    if (mismatches != 0) {
+        return false;
+    }
+
+    // Signatures from every kernel method must match the CPU and verify
+    // under the public key
+    RsaCPU cpu(key);
+    const int sign_count = 4;
+    std::vector<uint8_t> sig(sign_count * RSA_KERNEL_BYTES);
+    bool all_passed = true;
+    for (int method = KERNEL_EXP_BINARY; method <= KERNEL_EXP_CONSTANT_TIME && rsa.canSign(); method++) {
+        rsa.sign(plain.data(), sig.data(), sign_count, method);
+        bool passed = true;
+        for (int i = 0; i < sign_count; i++) {
+            BigInt m = BigInt::fromBytes(&plain[i * RSA_KERNEL_BYTES], RSA_KERNEL_BYTES);
+            BigInt s = BigInt::fromBytes(&sig[i * RSA_KERNEL_BYTES], RSA_KERNEL_BYTES);
+            passed &= s == cpu.privateOp(m) && cpu.publicOp(s) == m;
+        }
+        std::cout << "Sign (" << Montgomery::expMethodName((Montgomery::ExpMethod)method) << "): "
+                  << (passed ? "✓ PASSED" : "✗ FAILED") << std::endl;
+        all_passed &= passed;
+    }
+
+    // CRT decryption of the kernel's own ciphertexts must recover the input
+    for (int method = KERNEL_EXP_BINARY; method <= KERNEL_EXP_CONSTANT_TIME && rsa.canCRT(); method++) {
+        std::vector<uint8_t> recovered(plain.size());
+        rsa.privateCRT(cipher.data(), recovered.data(), count, method);
+        bool passed = recovered == plain;
+        std::cout << "CRT decrypt (" << Montgomery::expMethodName((Montgomery::ExpMethod)method) << "): "
+                  << (passed ? "✓ PASSED" : "✗ FAILED") << std::endl;
+        all_passed &= passed;
+    }
+    return all_passed;
+}
+
+// Batched kernel throughput and single-block launch latency
+void runKernelPerformanceTest(RSAHost& rsa, const RSAKey& key) {
+    std::cout << "\n=== FPGA Performance (RSA-" << RSA_KERNEL_BITS << " public op) ===" << std::endl;
+
+    const int batch_sizes[] = {1, 8, 32, 128};
+    std::mt19937_64 rng(13);
+    std::vector<uint8_t> plain = randomBlocks(key, 128, rng), cipher(plain.size());
+
+    std::cout << std::setw(10) << "Batch" << std::setw(14) << "Time (ms)" << std::setw(14) << "ops/s" << std::endl;
+    for (int batch : batch_sizes) {
+        double sec = rsa.encrypt(plain.data(), cipher.data(), batch);
+        std::cout << std::setw(10) << batch << std::fixed << std::setprecision(3) << std::setw(14) << sec * 1000.0
+                  << std::setprecision(1) << std::setw(14) << batch / sec << std::endl;
+    }
+
+    const int launches = 50;
+    std::vector<double> samples;
+    for (int i = 0; i < launches; i++) {
+        samples.push_back(rsa.encrypt(&plain[(i % 128) * RSA_KERNEL_BYTES], cipher.data(), 1) * 1e6);
+    }
+    LatencyStats s = latencyStats(samples);
+    std::cout << std::endl;
+    printStatsHeader();
+    printStatsRow("FPGA encrypt (1 block/launch)", 1e6 / s.mean, s);
+}
+
+// Private-key signatures/s per exponentiation method, kernel and CPU
+void runSigningPerformanceTest(RSAHost& rsa, const std::vector<RSAKey>& keys) {
+    std::cout << "\n=== Signing Performance (m^d mod n) ===" << std::endl;
+    printStatsHeader();
+
+    std::mt19937_64 rng(19);
+    if (rsa.canSign()) {
+        const RSAKey& key = keys.front();
+        const int batch = 16;
+        std::vector<uint8_t> msg = randomBlocks(key, batch, rng), sig(msg.size());
+        for (int method = KERNEL_EXP_BINARY; method <= KERNEL_EXP_CONSTANT_TIME; method++) {
+            std::vector<double> samples;
+            for (int i = 0; i < 4; i++) {
+                samples.push_back(rsa.sign(msg.data(), sig.data(), batch, method) * 1e6 / batch);
+            }
+            LatencyStats s = latencyStats(samples);
+            printStatsRow(std::string("FPGA ") + Montgomery::expMethodName((Montgomery::ExpMethod)method),
+                          1e6 / s.mean, s);
+        }
+    }
+    if (rsa.canCRT()) {
+        const RSAKey& key = keys.front();
+        const int batch = 16;
+        std::vector<uint8_t> msg = randomBlocks(key, batch, rng), sig(msg.size());
+        for (int method = KERNEL_EXP_BINARY; method <= KERNEL_EXP_CONSTANT_TIME; method++) {
+            std::vector<double> samples;
+            for (int i = 0; i < 4; i++) {
+                samples.push_back(rsa.privateCRT(msg.data(), sig.data(), batch, method) * 1e6 / batch);
+            }
+            LatencyStats s = latencyStats(samples);
+            printStatsRow(std::string("FPGA CRT ") + Montgomery::expMethodName((Montgomery::ExpMethod)method),
+                          1e6 / s.mean, s);
+        }
+    }
+
+    for (const auto& key : keys) {
+        if (!key.hasPrivate()) continue;
+        RsaCPU cpu(key);
+        int iterations = key.bits >= 4096 ? 5 : 20;
+        for (auto exp_method : kExpMethods) {
+            std::vector<double> samples;
+            BigInt m = BigInt::random(key.bits - 1, rng);
+            for (int i = 0; i < iterations; i++) {
+                auto start = std::chrono::high_resolution_clock::now();
+                m = cpu.privateOp(m, exp_method);
+                auto end = std::chrono::high_resolution_clock::now();
+                samples.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+            }
+            LatencyStats s = latencyStats(samples);
+            printStatsRow("CPU RSA-" + std::to_string(key.bits) + " " + Montgomery::expMethodName(exp_method),
+                          1e6 / s.mean, s);
+        }
+        if (!cpu.hasCRT()) continue;
+
+        // CRT single-operation latency, serial halves and one thread per half
+        for (bool parallel : {false, true}) {
+            std::vector<double> samples;
+            BigInt m = BigInt::random(key.bits - 1, rng);
+            for (int i = 0; i < iterations * 2; i++) {
+                auto start = std::chrono::high_resolution_clock::now();
+                m = cpu.privateOpCRT(m, Montgomery::SLIDING_WINDOW, parallel);
+                auto end = std::chrono::high_resolution_clock::now();
+                samples.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+            }
+            LatencyStats s = latencyStats(samples);
+            printStatsRow("CPU RSA-" + std::to_string(key.bits) + " CRT" + (parallel ? " 2 threads" : ""),
+                          1e6 / s.mean, s);
+        }
+
+        // Batch throughput across all hardware threads; latency is per block
+        unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+        int batch = (int)threads * (key.bits >= 4096 ? 2 : 8);
+        std::vector<uint8_t> in = randomBlocks(key, batch, rng), out(in.size());
+        std::vector<double> samples;
+        for (int i = 0; i < 3; i++) {
+            auto start = std::chrono::high_resolution_clock::now();
+            cpu.privateBlocks(in.data(), out.data(), batch, true, Montgomery::SLIDING_WINDOW, threads);
+            auto end = std::chrono::high_resolution_clock::now();
+            samples.push_back(std::chrono::duration<double, std::micro>(end - start).count() / batch);
+        }
+        LatencyStats s = latencyStats(samples);
+        printStatsRow("CPU RSA-" + std::to_string(key.bits) + " CRT batch x" + std::to_string(threads),
+                      1e6 / s.mean, s);
+    }
+}
+
+// Signatures under many keys: kernel verdicts against the expected ones,
+// then kernel vs multi-threaded CPU verification throughput
+bool runBatchVerifyTest(RSAHost& rsa, const RSAKey& first_key) {
+    std::cout << "\n=== Batch Verification (multi-key) ===" << std::endl;
+    if (!rsa.canVerifyBatch()) {
+        std::cout << "rsa_verify_batch not in xclbin, skipped" << std::endl;
+        return true;
+    }
+
+    const int num_keys = 8;
+    std::vector<RSAKey> keys = {first_key};
+    for (int k = 1; k < num_keys; k++) {
+        keys.push_back(generateKey(RSA_KERNEL_BITS, 100 + k));
+    }
+    std::vector<RsaCPU> cpus;
+    std::vector<int> slots;
+    for (const auto& key : keys) {
+        cpus.emplace_back(key);
+        slots.push_back(rsa.addVerifyKey(key));
+    }
+
+    // Jobs on random keys; every 16th carries a wrong expected message
+    const int num_jobs = 256;
+    std::mt19937_64 rng(47);
+    std::vector<uint8_t> sigs(num_jobs * RSA_KERNEL_BYTES), expected(num_jobs * RSA_KERNEL_BYTES);
+    std::vector<int> job_key(num_jobs);
+    std::vector<uint8_t> verdicts(num_jobs);
+    std::vector<VerifyJob> jobs;
+    for (int j = 0; j < num_jobs; j++) {
+        uint8_t* sig = &sigs[j * RSA_KERNEL_BYTES];
+        uint8_t* msg = &expected[j * RSA_KERNEL_BYTES];
+        job_key[j] = rng() % num_keys;
+        BigInt m = BigInt::random(keys[job_key[j]].bits - 1, rng);
+        cpus[job_key[j]].privateOpCRT(m).toBytes(sig, RSA_KERNEL_BYTES);
+        m.toBytes(msg, RSA_KERNEL_BYTES);
+        verdicts[j] = j % 16 != 15;
+        if (!verdicts[j]) msg[RSA_KERNEL_BYTES - 1] ^= 0x01;
+        jobs.push_back({slots[job_key[j]], sig, msg});
+    }
+
+    std::vector<uint8_t> results;
+    double t_setup = rsa.verifyBatch(jobs, results);  // includes key slot setup
+    bool passed = results == verdicts;
+    double t_cached = rsa.verifyBatch(jobs, results);
+    passed &= results == verdicts;
+    std::cout << num_jobs << " jobs over " << num_keys << " keys: " << (passed ? "✓ PASSED" : "✗ FAILED") << std::endl;
+    if (!passed) return false;
+
+    // CPU baseline: the same checks split over all hardware threads
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<uint8_t> cpu_results(num_jobs);
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; t++) {
+        workers.emplace_back([&, t] {
+            for (int j = t; j < num_jobs; j += threads) {
+                BigInt s = BigInt::fromBytes(&sigs[j * RSA_KERNEL_BYTES], RSA_KERNEL_BYTES);
+                BigInt m = BigInt::fromBytes(&expected[j * RSA_KERNEL_BYTES], RSA_KERNEL_BYTES);
+                cpu_results[j] = cpus[job_key[j]].publicOp(s) == m;
+            }
+        });
+    }
+    for (auto& w : workers) w.join();
+    auto end = std::chrono::high_resolution_clock::now();
+    double t_cpu = std::chrono::duration<double>(end - start).count();
+    if (cpu_results != verdicts) {
+        std::cout << "✗ CPU verdicts differ" << std::endl;
+        return false;
+    }
+
+    auto row = [&](const std::string& label, double seconds) {
+        std::cout << std::left << std::setw(24) << label << std::right << std::fixed << std::setprecision(1)
+                  << num_jobs / seconds << " verifications/s" << std::endl;
+    };
+    row("FPGA, new key slots:", t_setup);
+    row("FPGA, cached key slots:", t_cached);
+    row("CPU, " + std::to_string(threads) + " threads:", t_cpu);
+    return true;
+}
+
+// CPU public and private operations per key size and Montgomery method
+void runCpuPerformanceTest(const std::vector<RSAKey>& keys) {
+    std::cout << "\n=== CPU Performance ===" << std::endl;
+    printStatsHeader();
+
+    std::mt19937_64 rng(17);
+    for (const auto& key : keys) {
+        for (auto method : {Montgomery::CIOS, Montgomery::KARATSUBA}) {
+            RsaCPU cpu(key, method);
+            std::string suffix = " RSA-" + std::to_string(key.bits) + " " + RsaCPU::methodName(method);
+
+            struct Op { const char* name; int iterations; bool priv; };
+            const Op ops[] = {{"public", key.bits >= 4096 ? 100 : 400, false},
+                              {"private", key.bits >= 4096 ? 5 : 20, true}};
+            for (const Op& op : ops) {
+                std::vector<double> samples;
+                BigInt m = BigInt::random(key.bits - 1, rng);
+                for (int i = 0; i < op.iterations; i++) {
+                    auto start = std::chrono::high_resolution_clock::now();
+                    BigInt r = op.priv ? cpu.privateOp(m) : cpu.publicOp(m);
+                    auto end = std::chrono::high_resolution_clock::now();
+                    samples.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+                    m = r;
+                }
+                LatencyStats s = latencyStats(samples);
+                printStatsRow(op.name + suffix, 1e6 / s.mean, s);
+            }
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <xclbin_path> [device_id] [key_file]" << std::endl;
+        std::cerr << "Example: " << argv[0] << " rsa.xclbin 0 rsa2048.key" << std::endl;
+        std::cerr << "A missing key file is generated (test key) and saved there." << std::endl;
+        return 1;
+    }
+
+    std::string xclbin_path = argv[1];
+    int device_id = (argc > 2) ? std::atoi(argv[2]) : 0;
+    std::string key_file = (argc > 3) ? argv[3] : "";
+
+    try {
+        std::cout << "=== RSA Hardware Accelerator Host Application ===" << std::endl;
+        std::cout << "XCLBIN: " << xclbin_path << std::endl;
+        std::cout << "Device ID: " << device_id << std::endl;
+
+        RSAKey key;
+        if (!key_file.empty() && loadKey(key_file, key)) {
+            std::cout << "✓ Loaded RSA-" << key.bits << " key from " << key_file << std::endl;
+        } else {
+            auto start = std::chrono::high_resolution_clock::now();
+            key = generateKey(RSA_KERNEL_BITS, 2048);
+            auto end = std::chrono::high_resolution_clock::now();
+            std::cout << "✓ Generated RSA-" << key.bits << " test key in " << std::fixed << std::setprecision(2)
+                      << std::chrono::duration<double>(end - start).count() << " s" << std::endl;
+            if (!key_file.empty()) {
+                saveKey(key_file, key);
+                std::cout << "✓ Saved to " << key_file << std::endl;
+            }
+        }
+
+        std::vector<RSAKey> cpu_keys = {key};
+        if (key.bits != 4096) {
+            cpu_keys.push_back(generateKey(4096, 4096));
+        }
+
+        RSAHost rsa(xclbin_path, device_id);
+        rsa.allocateBuffers(128);
+        rsa.setKey(key);
+
+        if (!runCpuSelfTest(cpu_keys) || !runKernelTest(rsa, key) || !runBatchVerifyTest(rsa, key)) {
+            std::cerr << "Verification failed" << std::endl;
+            return 1;
+        }
+        runKernelPerformanceTest(rsa, key);
+        runCpuPerformanceTest(cpu_keys);
+        runSigningPerformanceTest(rsa, cpu_keys);
+
+        std::cout << "\n=== All tests completed successfully! ===" << std::endl;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Application failed: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
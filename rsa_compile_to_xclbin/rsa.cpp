@@ -1,51 +1,26 @@
 #include "rsa.h"
 
-// Montgomery multiplication for efficient modular arithmetic
-static rsa_int_t montgomery_multiply(rsa_int_t a, rsa_int_t b, rsa_int_t n, rsa_int_t n_prime, int r_bits) {
+// The arithmetic below is templated on the operand width W so the same
+// datapath serves full-size (RSA_BITS) and CRT half-size (RSA_HALF_BITS)
+// moduli
+
+// Montgomery multiplication for efficient modular arithmetic: word-serial
+// on RSA_DIGIT_BITS digits, so no W x W multiplier is synthesized
+template <int W>
+static ap_uint<W> montgomery_multiply(ap_uint<W> a, ap_uint<W> b, ap_uint<W> n, ap_uint<RSA_DIGIT_BITS> n0) {
 #pragma HLS INLINE
-    rsa_int_double_t t = (rsa_int_double_t)a * b;
-    rsa_int_t t_low = t(RSA_BITS-1, 0);
-    rsa_int_t m = t_low * n_prime;
-    m = m(RSA_BITS-1, 0);  // Keep only lower bits
-    
-    rsa_int_double_t u = t + (rsa_int_double_t)m * n;
-    rsa_int_t u_high = u(RSA_BITS*2-1, RSA_BITS);
-    
-    if (u_high >= n) {
-        u_high -= n;
-    }
-    
-    return u_high;
+    return montgomery_multiply_ws<W, RSA_DIGIT_BITS>(a, b, n, n0);
 }
 
-// Compute Montgomery parameter n' where n*n' ≡ -1 (mod 2^r)
-static rsa_int_t compute_n_prime(rsa_int_t n) {
+// R^2 mod n by bit-serial doubling of 1; one spare bit so 2*result cannot
+// wrap. Runs once per key, after which conversions are Montgomery products.
+template <int W>
+static ap_uint<W> compute_r2_mod_n(ap_uint<W> n) {
 #pragma HLS INLINE off
-    rsa_int_t n_prime = 1;
-    
-    // Use Newton's method to compute modular inverse
-    for (int i = 0; i < 10; i++) {
-#pragma HLS PIPELINE II=1
-        n_prime = n_prime * (2 - n * n_prime);
-    }
-    
-    return -n_prime;  // Return -n^(-1) mod 2^r
-}
-
-// Convert to Montgomery form: a_mont = a * 2^r mod n
-static rsa_int_t to_montgomery(rsa_int_t a, rsa_int_t n) {
-#pragma HLS INLINE off
-    rsa_int_double_t temp = a;
-    temp = temp << RSA_BITS;  // Multiply by 2^r
-    
-    // Modular reduction
-    rsa_int_t result = 0;
-    for (int i = RSA_BITS*2-1; i >= RSA_BITS; i--) {
+    ap_uint<W+1> result = 1;
+    R2_LOOP: for (int i = 0; i < W*2; i++) {
 #pragma HLS PIPELINE II=1
         result = result << 1;
-        if (temp[i]) {
-            result = result | 1;
-        }
         if (result >= n) {
             result -= n;
         }
@@ -54,47 +29,197 @@ static rsa_int_t to_montgomery(rsa_int_t a, rsa_int_t n) {
     return result;
 }
 
-// Convert from Montgomery form: a = a_mont * 2^(-r) mod n
-static rsa_int_t from_montgomery(rsa_int_t a_mont, rsa_int_t n, rsa_int_t n_prime) {
+// Number of significant bits in the exponent
+template <int W>
+static int exponent_bits(ap_uint<W> exp) {
+#pragma HLS INLINE off
+    int bits = 0;
+    EXP_BITS: for (int i = 0; i < W; i++) {
+#pragma HLS UNROLL factor=64
+        if (exp[i]) {
+            bits = i + 1;
+        }
+    }
+    return bits;
+}
+
+// Key setup: everything that depends only on (n, e)
+template <int W>
+static void montgomery_setup(ap_uint<W> n, ap_uint<W> e, MontgomeryContext<W> &ctx) {
+#pragma HLS INLINE off
+    ctx.n = n;
+    ctx.e = e;
+    ctx.n0 = montgomery_n0<RSA_DIGIT_BITS>(n(RSA_DIGIT_BITS-1, 0));
+    ctx.r2_mod_n = compute_r2_mod_n<W>(n);
+    ctx.r_mod_n = montgomery_multiply<W>(ctx.r2_mod_n, 1, n, ctx.n0);  // R^2 * R^-1
+    ctx.e_bits = exponent_bits<W>(e);
+}
+
+// Convert to Montgomery form: a_mont = a * R^2 * R^-1 = a * R mod n
+template <int W>
+static ap_uint<W> to_montgomery(ap_uint<W> a, const MontgomeryContext<W> &ctx) {
 #pragma HLS INLINE
-    return montgomery_multiply(a_mont, 1, n, n_prime, RSA_BITS);
+    return montgomery_multiply<W>(a, ctx.r2_mod_n, ctx.n, ctx.n0);
 }
 
-// Binary method for modular exponentiation using Montgomery multiplication
-static rsa_int_t mod_exp_montgomery(rsa_int_t base, rsa_int_t exp, rsa_int_t n) {
+// Convert from Montgomery form: a = a_mont * 2^(-W) mod n
+template <int W>
+static ap_uint<W> from_montgomery(ap_uint<W> a_mont, const MontgomeryContext<W> &ctx) {
+#pragma HLS INLINE
+    return montgomery_multiply<W>(a_mont, 1, ctx.n, ctx.n0);
+}
+
+// Left-to-right binary method over the significant exponent bits only:
+// e = 65537 costs 16 squarings and one multiplication instead of W
+// iterations
+template <int W>
+static ap_uint<W> mod_exp_montgomery(ap_uint<W> base, const MontgomeryContext<W> &ctx) {
 #pragma HLS INLINE off
+    if (ctx.e_bits == 0) {
+        return ctx.n == 1 ? ap_uint<W>(0) : ap_uint<W>(1);  // x^0
+    }
     
-    // Precompute Montgomery parameters
-    rsa_int_t n_prime = compute_n_prime(n);
-    
-    // Convert base to Montgomery form
-    rsa_int_t base_mont = to_montgomery(base, n);
-    
-    // Initialize result in Montgomery form (1 * 2^r mod n)
-    rsa_int_t result_mont = to_montgomery(1, n);
+    // Top exponent bit is set: start from the base itself
+    ap_uint<W> base_mont = to_montgomery<W>(base, ctx);
+    ap_uint<W> result_mont = base_mont;
     
     // Square-and-multiply algorithm with Montgomery arithmetic
-    MOD_EXP_LOOP: for (int i = RSA_BITS-1; i >= 0; i--) {
+    MOD_EXP_LOOP: for (int i = ctx.e_bits-2; i >= 0; i--) {
+#pragma HLS LOOP_TRIPCOUNT min=16 max=2047 avg=16
 #pragma HLS PIPELINE II=2
         // Always square
-        result_mont = montgomery_multiply(result_mont, result_mont, n, n_prime, RSA_BITS);
+        result_mont = montgomery_multiply<W>(result_mont, result_mont, ctx.n, ctx.n0);
         
         // Multiply by base if bit is set
-        if (exp[i]) {
-            result_mont = montgomery_multiply(result_mont, base_mont, n, n_prime, RSA_BITS);
+        if (ctx.e[i]) {
+            result_mont = montgomery_multiply<W>(result_mont, base_mont, ctx.n, ctx.n0);
         }
     }
     
     // Convert back from Montgomery form
-    return from_montgomery(result_mont, n, n_prime);
+    return from_montgomery<W>(result_mont, ctx);
 }
 
-// Convert byte array to arbitrary precision integer
-static rsa_int_t bytes_to_rsa_int(const uint8_t *bytes) {
+// RSA_WINDOW_BITS exponent bits starting at pos; bits past the top read as zero
+template <int W>
+static ap_uint<RSA_WINDOW_BITS> window_bits(ap_uint<W> exp, int pos) {
 #pragma HLS INLINE
-    rsa_int_t result = 0;
+    ap_uint<RSA_WINDOW_BITS> bits = 0;
+    WINDOW_BITS: for (int j = RSA_WINDOW_BITS-1; j >= 0; j--) {
+#pragma HLS UNROLL
+        bits = (bits << 1) | (pos + j < W && exp[pos + j]);
+    }
+    return bits;
+}
+
+// Fixed-window exponentiation with table[j] = base^j in local memory.
+// The constant-time variant walks every window of the full W-bit width
+// and multiplies even by table[0] = 1, so the operation sequence does not
+// depend on the exponent; on-chip RAM access time is data-independent.
+template <int W>
+static ap_uint<W> mod_exp_fixed_window(ap_uint<W> base, const MontgomeryContext<W> &ctx, bool constant_time) {
+#pragma HLS INLINE off
+    ap_uint<W> table[RSA_WINDOW_SIZE];
+#pragma HLS BIND_STORAGE variable=table type=ram_2p impl=bram
     
-    BYTES_TO_INT: for (int i = 0; i < RSA_BYTES; i++) {
+    table[0] = ctx.r_mod_n;
+    table[1] = to_montgomery<W>(base, ctx);
+    BUILD_TABLE: for (int j = 2; j < RSA_WINDOW_SIZE; j++) {
+        table[j] = montgomery_multiply<W>(table[j-1], table[1], ctx.n, ctx.n0);
+    }
+    
+    int top = constant_time ? W : ctx.e_bits;
+    int windows = (top + RSA_WINDOW_BITS - 1) / RSA_WINDOW_BITS;
+    if (windows == 0) {
+        return from_montgomery<W>(ctx.r_mod_n, ctx);
+    }
+    
+    ap_uint<W> result_mont = table[window_bits<W>(ctx.e, (windows-1) * RSA_WINDOW_BITS)];
+    WINDOW_LOOP: for (int w = windows-2; w >= 0; w--) {
+#pragma HLS LOOP_TRIPCOUNT min=3 max=410
+        SQUARE_LOOP: for (int s = 0; s < RSA_WINDOW_BITS; s++) {
+            result_mont = montgomery_multiply<W>(result_mont, result_mont, ctx.n, ctx.n0);
+        }
+        ap_uint<RSA_WINDOW_BITS> bits = window_bits<W>(ctx.e, w * RSA_WINDOW_BITS);
+        if (constant_time || bits != 0) {
+            result_mont = montgomery_multiply<W>(result_mont, table[bits], ctx.n, ctx.n0);
+        }
+    }
+    
+    return from_montgomery<W>(result_mont, ctx);
+}
+
+// Sliding-window exponentiation with the odd powers base^1, base^3, ...,
+// base^(2^w - 1): about W/(w+1) multiplies for a random exponent
+template <int W>
+static ap_uint<W> mod_exp_sliding_window(ap_uint<W> base, const MontgomeryContext<W> &ctx) {
+#pragma HLS INLINE off
+    ap_uint<W> odd[RSA_WINDOW_SIZE/2];
+#pragma HLS BIND_STORAGE variable=odd type=ram_2p impl=bram
+    
+    ap_uint<W> base_mont = to_montgomery<W>(base, ctx);
+    ap_uint<W> base_sq = montgomery_multiply<W>(base_mont, base_mont, ctx.n, ctx.n0);
+    odd[0] = base_mont;
+    BUILD_ODD: for (int j = 1; j < RSA_WINDOW_SIZE/2; j++) {
+        odd[j] = montgomery_multiply<W>(odd[j-1], base_sq, ctx.n, ctx.n0);
+    }
+    
+    ap_uint<W> result_mont = ctx.r_mod_n;
+    bool started = false;
+    int i = ctx.e_bits - 1;
+    SLIDE_LOOP: while (i >= 0) {
+#pragma HLS LOOP_TRIPCOUNT min=3 max=2048
+        if (!ctx.e[i]) {
+            if (started) {
+                result_mont = montgomery_multiply<W>(result_mont, result_mont, ctx.n, ctx.n0);
+            }
+            i--;
+            continue;
+        }
+        
+        // Longest window of at most RSA_WINDOW_BITS bits ending on a set bit
+        int low = i - RSA_WINDOW_BITS + 1;
+        if (low < 0) low = 0;
+        FIND_LOW: while (!ctx.e[low]) {
+#pragma HLS LOOP_TRIPCOUNT min=0 max=4
+            low++;
+        }
+        
+        ap_uint<RSA_WINDOW_BITS> value = 0;
+        WINDOW_SQUARE: for (int j = i; j >= low; j--) {
+#pragma HLS LOOP_TRIPCOUNT min=1 max=5
+            value = (value << 1) | ctx.e[j];
+            if (started) {
+                result_mont = montgomery_multiply<W>(result_mont, result_mont, ctx.n, ctx.n0);
+            }
+        }
+        result_mont = started ? montgomery_multiply<W>(result_mont, odd[value >> 1], ctx.n, ctx.n0)
+                              : odd[value >> 1];
+        started = true;
+        i = low - 1;
+    }
+    
+    return from_montgomery<W>(result_mont, ctx);
+}
+
+template <int W>
+static ap_uint<W> mod_exp(ap_uint<W> base, const MontgomeryContext<W> &ctx, int exp_method) {
+#pragma HLS INLINE off
+    switch (exp_method) {
+    case RSA_EXP_FIXED_WINDOW:   return mod_exp_fixed_window<W>(base, ctx, false);
+    case RSA_EXP_CONSTANT_TIME:  return mod_exp_fixed_window<W>(base, ctx, true);
+    case RSA_EXP_SLIDING_WINDOW: return mod_exp_sliding_window<W>(base, ctx);
+    default:                     return mod_exp_montgomery<W>(base, ctx);
+    }
+}
+
+// Convert big-endian byte array to arbitrary precision integer
+template <int W = RSA_BITS>
+static ap_uint<W> bytes_to_rsa_int(const uint8_t *bytes) {
+#pragma HLS INLINE
+    ap_uint<W> result = 0;
+    
+    BYTES_TO_INT: for (int i = 0; i < W/8; i++) {
 #pragma HLS UNROLL factor=8
         result = (result << 8) | bytes[i];
     }
@@ -102,7 +227,7 @@ static rsa_int_t bytes_to_rsa_int(const uint8_t *bytes) {
     return result;
 }
 
-// Convert arbitrary precision integer to byte array
+// Convert arbitrary precision integer to big-endian byte array
 static void rsa_int_to_bytes(rsa_int_t val, uint8_t *bytes) {
 #pragma HLS INLINE
     
@@ -113,23 +238,71 @@ static void rsa_int_to_bytes(rsa_int_t val, uint8_t *bytes) {
     }
 }
 
-// Main RSA encryption function with HLS pragmas
-void rsa_encrypt(const uint8_t *plaintext, 
-                 const uint8_t *n_bytes,
-                 const uint8_t *e_bytes, 
-                 uint8_t *ciphertext, 
-                 int num_blocks) {
-#pragma HLS INTERFACE m_axi port=plaintext depth=1024 offset=slave bundle=gmem0
-#pragma HLS INTERFACE m_axi port=n_bytes depth=256 offset=slave bundle=gmem1
-#pragma HLS INTERFACE m_axi port=e_bytes depth=256 offset=slave bundle=gmem2
-#pragma HLS INTERFACE m_axi port=ciphertext depth=1024 offset=slave bundle=gmem3
-#pragma HLS INTERFACE s_axilite port=plaintext bundle=control
-#pragma HLS INTERFACE s_axilite port=n_bytes bundle=control
-#pragma HLS INTERFACE s_axilite port=e_bytes bundle=control
-#pragma HLS INTERFACE s_axilite port=ciphertext bundle=control
-#pragma HLS INTERFACE s_axilite port=num_blocks bundle=control
-#pragma HLS INTERFACE s_axilite port=return bundle=control
+// c mod p for a c of twice p's width: with c = c_hi R + c_lo (R = 2^W),
+// Montgomery-multiplying c_hi by R^2 gives c_hi R mod p. p has its top bit
+// set, so each half is below 2p and needs one conditional subtraction.
+static rsa_half_t reduce_to_half(rsa_int_t c, const MontgomeryContext<RSA_HALF_BITS> &ctx) {
+#pragma HLS INLINE
+    rsa_half_t c_hi = c(RSA_BITS-1, RSA_HALF_BITS);
+    rsa_half_t c_lo = c(RSA_HALF_BITS-1, 0);
+    if (c_hi >= ctx.n) c_hi -= ctx.n;
+    if (c_lo >= ctx.n) c_lo -= ctx.n;
+    
+    ap_uint<RSA_HALF_BITS+1> r = montgomery_multiply<RSA_HALF_BITS>(c_hi, ctx.r2_mod_n, ctx.n, ctx.n0);
+    r += c_lo;
+    if (r >= ctx.n) r -= ctx.n;
+    return r;
+}
+
+// CRT key setup: Montgomery contexts for p (exponent dp) and q (exponent
+// dq), and qinv in Montgomery form modulo p for the recombination
+static void crt_setup(rsa_half_t p, rsa_half_t q, rsa_half_t dp, rsa_half_t dq, rsa_half_t qinv,
+                      RSACRTContext &ctx) {
+#pragma HLS INLINE off
+    montgomery_setup<RSA_HALF_BITS>(p, dp, ctx.p);
+    montgomery_setup<RSA_HALF_BITS>(q, dq, ctx.q);
+    ctx.qinv = qinv;
+    ctx.qinv_mont = to_montgomery<RSA_HALF_BITS>(qinv, ctx.p);
+}
+
+// c^d mod n from two half-size exponentiations and Garner's formula:
+// m1 = c^dp mod p, m2 = c^dq mod q, h = qinv (m1 - m2) mod p, m = m2 + h q.
+// The two exponentiations share no data, so HLS schedules the two
+// datapath instances concurrently. Requires c < n and q < 2p.
+static rsa_int_t crt_exp(rsa_int_t c, const RSACRTContext &ctx, int exp_method) {
+#pragma HLS INLINE off
+    rsa_half_t m1 = mod_exp<RSA_HALF_BITS>(reduce_to_half(c, ctx.p), ctx.p, exp_method);
+    rsa_half_t m2 = mod_exp<RSA_HALF_BITS>(reduce_to_half(c, ctx.q), ctx.q, exp_method);
+    
+    // m2 < q < 2p: one conditional subtraction reduces it modulo p
+    rsa_half_t m2_p = m2;
+    if (m2_p >= ctx.p.n) {
+        m2_p -= ctx.p.n;
+    }
+    ap_uint<RSA_HALF_BITS+1> diff = m1;
+    if (m1 < m2_p) {
+        diff += ctx.p.n;
+    }
+    diff -= m2_p;
+    
+    // qinv_mont * diff * R^-1 = qinv * diff mod p
+    rsa_half_t h = montgomery_multiply<RSA_HALF_BITS>(ctx.qinv_mont, diff, ctx.p.n, ctx.p.n0);
+
+    // h q + m2 < p q = n, accumulated digit by digit
+    return multiply_add_ws<RSA_HALF_BITS, RSA_DIGIT_BITS>(h, ctx.q.n, m2);
+}
 
+// Shared datapath of the kernels: load the key, refresh the cached key
+// context if it changed, then out = in^exp mod n block by block
+static void process_blocks(const uint8_t *input,
+                           const uint8_t *n_bytes,
+                           const uint8_t *exp_bytes,
+                           uint8_t *output,
+                           int num_blocks,
+                           int exp_method,
+                           RSAKeyContext &ctx,
+                           bool &ctx_valid) {
+#pragma HLS INLINE
     // Local buffers for key components
     uint8_t n_local[RSA_BYTES];
     uint8_t e_local[RSA_BYTES];
@@ -144,41 +317,297 @@ void rsa_encrypt(const uint8_t *plaintext,
     
     LOAD_E: for (int i = 0; i < RSA_BYTES; i++) {
 #pragma HLS PIPELINE II=1
-        e_local[i] = e_bytes[i];
+        e_local[i] = exp_bytes[i];
     }
     
     // Convert to arbitrary precision integers
     rsa_int_t n = bytes_to_rsa_int(n_local);
     rsa_int_t e = bytes_to_rsa_int(e_local);
     
+    // Key context persists across launches; redo the setup only when the
+    // host passes a different key
+    if (!ctx_valid || ctx.n != n || ctx.e != e) {
+        montgomery_setup<RSA_BITS>(n, e, ctx);
+        ctx_valid = true;
+    }
+    
     // Process each block
     BLOCK_LOOP: for (int block = 0; block < num_blocks; block++) {
 #pragma HLS PIPELINE off
         
-        uint8_t plain_block[RSA_BYTES];
-        uint8_t cipher_block[RSA_BYTES];
-#pragma HLS ARRAY_PARTITION variable=plain_block cyclic factor=16
-#pragma HLS ARRAY_PARTITION variable=cipher_block cyclic factor=16
+        uint8_t in_block[RSA_BYTES];
+        uint8_t out_block[RSA_BYTES];
+#pragma HLS ARRAY_PARTITION variable=in_block cyclic factor=16
+#pragma HLS ARRAY_PARTITION variable=out_block cyclic factor=16
         
-        // Load plaintext block
-        LOAD_PLAIN: for (int i = 0; i < RSA_BYTES; i++) {
+        // Load input block
+        LOAD_INPUT: for (int i = 0; i < RSA_BYTES; i++) {
 #pragma HLS PIPELINE II=1
-            plain_block[i] = plaintext[block * RSA_BYTES + i];
+            in_block[i] = input[block * RSA_BYTES + i];
         }
         
-        // Convert plaintext to integer
-        rsa_int_t m = bytes_to_rsa_int(plain_block);
+        // Convert input to integer
+        rsa_int_t m = bytes_to_rsa_int(in_block);
         
-        // Perform RSA encryption: c = m^e mod n
-        rsa_int_t c = mod_exp_montgomery(m, e, n);
+        // c = m^e mod n
+        rsa_int_t c = mod_exp<RSA_BITS>(m, ctx, exp_method);
         
         // Convert result back to bytes
-        rsa_int_to_bytes(c, cipher_block);
+        rsa_int_to_bytes(c, out_block);
         
-        // Store ciphertext block
-        STORE_CIPHER: for (int i = 0; i < RSA_BYTES; i++) {
+        // Store output block
+        STORE_OUTPUT: for (int i = 0; i < RSA_BYTES; i++) {
 #pragma HLS PIPELINE II=1
-            ciphertext[block * RSA_BYTES + i] = cipher_block[i];
+            output[block * RSA_BYTES + i] = out_block[i];
         }
     }
-}
\ No newline at end of file
+}
+
+// Main RSA encryption function with HLS pragmas
+void rsa_encrypt(const uint8_t *plaintext, 
+                 const uint8_t *n_bytes,
+                 const uint8_t *e_bytes, 
+                 uint8_t *ciphertext, 
+                 int num_blocks) {
+#pragma HLS INTERFACE m_axi port=plaintext depth=1024 offset=slave bundle=gmem0
+#pragma HLS INTERFACE m_axi port=n_bytes depth=256 offset=slave bundle=gmem1
+#pragma HLS INTERFACE m_axi port=e_bytes depth=256 offset=slave bundle=gmem2
+#pragma HLS INTERFACE m_axi port=ciphertext depth=1024 offset=slave bundle=gmem3
+#pragma HLS INTERFACE s_axilite port=plaintext bundle=control
+#pragma HLS INTERFACE s_axilite port=n_bytes bundle=control
+#pragma HLS INTERFACE s_axilite port=e_bytes bundle=control
+#pragma HLS INTERFACE s_axilite port=ciphertext bundle=control
+#pragma HLS INTERFACE s_axilite port=num_blocks bundle=control
+#pragma HLS INTERFACE s_axilite port=return bundle=control
+
+    static RSAKeyContext ctx;
+    static bool ctx_valid = false;
+    
+    // Public exponents are short: the binary method is already optimal
+    process_blocks(plaintext, n_bytes, e_bytes, ciphertext, num_blocks, RSA_EXP_BINARY, ctx, ctx_valid);
+}
+
+// General modular exponentiation with a per-call method, for private-key
+// operations where exp is a full-size d
+void rsa_modexp(const uint8_t *input,
+                const uint8_t *n_bytes,
+                const uint8_t *exp_bytes,
+                uint8_t *output,
+                int num_blocks,
+                int exp_method) {
+#pragma HLS INTERFACE m_axi port=input depth=1024 offset=slave bundle=gmem0
+#pragma HLS INTERFACE m_axi port=n_bytes depth=256 offset=slave bundle=gmem1
+#pragma HLS INTERFACE m_axi port=exp_bytes depth=256 offset=slave bundle=gmem2
+#pragma HLS INTERFACE m_axi port=output depth=1024 offset=slave bundle=gmem3
+#pragma HLS INTERFACE s_axilite port=input bundle=control
+#pragma HLS INTERFACE s_axilite port=n_bytes bundle=control
+#pragma HLS INTERFACE s_axilite port=exp_bytes bundle=control
+#pragma HLS INTERFACE s_axilite port=output bundle=control
+#pragma HLS INTERFACE s_axilite port=num_blocks bundle=control
+#pragma HLS INTERFACE s_axilite port=exp_method bundle=control
+#pragma HLS INTERFACE s_axilite port=return bundle=control
+
+    static RSAKeyContext ctx;
+    static bool ctx_valid = false;
+    
+    process_blocks(input, n_bytes, exp_bytes, output, num_blocks, exp_method, ctx, ctx_valid);
+}
+
+// RSA-CRT private-key operation (decryption or signing): out = in^d mod n
+// from the packed CRT key p | q | dp | dq | qinv, RSA_HALF_BYTES each,
+// big-endian
+void rsa_crt(const uint8_t *input,
+             const uint8_t *crt_key,
+             uint8_t *output,
+             int num_blocks,
+             int exp_method) {
+#pragma HLS INTERFACE m_axi port=input depth=1024 offset=slave bundle=gmem0
+#pragma HLS INTERFACE m_axi port=crt_key depth=640 offset=slave bundle=gmem1
+#pragma HLS INTERFACE m_axi port=output depth=1024 offset=slave bundle=gmem2
+#pragma HLS INTERFACE s_axilite port=input bundle=control
+#pragma HLS INTERFACE s_axilite port=crt_key bundle=control
+#pragma HLS INTERFACE s_axilite port=output bundle=control
+#pragma HLS INTERFACE s_axilite port=num_blocks bundle=control
+#pragma HLS INTERFACE s_axilite port=exp_method bundle=control
+#pragma HLS INTERFACE s_axilite port=return bundle=control
+
+    static RSACRTContext ctx;
+    static bool ctx_valid = false;
+    
+    // Load the CRT key
+    uint8_t key_local[RSA_CRT_KEY_BYTES];
+#pragma HLS ARRAY_PARTITION variable=key_local cyclic factor=16
+    LOAD_KEY: for (int i = 0; i < RSA_CRT_KEY_BYTES; i++) {
+#pragma HLS PIPELINE II=1
+        key_local[i] = crt_key[i];
+    }
+    
+    rsa_half_t p = bytes_to_rsa_int<RSA_HALF_BITS>(key_local);
+    rsa_half_t q = bytes_to_rsa_int<RSA_HALF_BITS>(key_local + RSA_HALF_BYTES);
+    rsa_half_t dp = bytes_to_rsa_int<RSA_HALF_BITS>(key_local + 2*RSA_HALF_BYTES);
+    rsa_half_t dq = bytes_to_rsa_int<RSA_HALF_BITS>(key_local + 3*RSA_HALF_BYTES);
+    rsa_half_t qinv = bytes_to_rsa_int<RSA_HALF_BITS>(key_local + 4*RSA_HALF_BYTES);
+    
+    if (!ctx_valid || ctx.p.n != p || ctx.q.n != q || ctx.p.e != dp || ctx.q.e != dq || ctx.qinv != qinv) {
+        crt_setup(p, q, dp, dq, qinv, ctx);
+        ctx_valid = true;
+    }
+    
+    BLOCK_LOOP: for (int block = 0; block < num_blocks; block++) {
+#pragma HLS PIPELINE off
+        
+        uint8_t in_block[RSA_BYTES];
+        uint8_t out_block[RSA_BYTES];
+#pragma HLS ARRAY_PARTITION variable=in_block cyclic factor=16
+#pragma HLS ARRAY_PARTITION variable=out_block cyclic factor=16
+        
+        LOAD_INPUT: for (int i = 0; i < RSA_BYTES; i++) {
+#pragma HLS PIPELINE II=1
+            in_block[i] = input[block * RSA_BYTES + i];
+        }
+        
+        rsa_int_t m = crt_exp(bytes_to_rsa_int(in_block), ctx, exp_method);
+        rsa_int_to_bytes(m, out_block);
+        
+        STORE_OUTPUT: for (int i = 0; i < RSA_BYTES; i++) {
+#pragma HLS PIPELINE II=1
+            output[block * RSA_BYTES + i] = out_block[i];
+        }
+    }
+}
+
+// Public operation for RSA_INTERLEAVE jobs in lock-step, each under its own
+// key: every squaring and multiply is one interleaved pass over all lanes.
+// Lanes start from 1 (R mod n) so shorter exponents just square 1 until
+// their top bit; the multiply pass is skipped when no lane has the bit set.
+static void public_op_interleaved(const rsa_int_t sig[RSA_INTERLEAVE],
+                                  const rsa_int_t n[RSA_INTERLEAVE],
+                                  const ap_uint<RSA_DIGIT_BITS> n0[RSA_INTERLEAVE],
+                                  const rsa_int_t r_mod_n[RSA_INTERLEAVE],
+                                  const rsa_int_t r2_mod_n[RSA_INTERLEAVE],
+                                  const rsa_int_t e[RSA_INTERLEAVE],
+                                  int max_bits,
+                                  rsa_int_t out[RSA_INTERLEAVE]) {
+#pragma HLS INLINE off
+    rsa_int_t base_mont[RSA_INTERLEAVE];
+    rsa_int_t acc[RSA_INTERLEAVE];
+    rsa_int_t sq[RSA_INTERLEAVE];
+    rsa_int_t operand[RSA_INTERLEAVE];
+    
+    montgomery_multiply_ws_interleaved<RSA_BITS, RSA_DIGIT_BITS, RSA_INTERLEAVE>(sig, r2_mod_n, n, n0, base_mont);
+    INIT_ACC: for (int g = 0; g < RSA_INTERLEAVE; g++) {
+        acc[g] = r_mod_n[g];
+    }
+    
+    EXP_LOOP: for (int i = max_bits-1; i >= 0; i--) {
+#pragma HLS LOOP_TRIPCOUNT min=17 max=2048 avg=17
+        montgomery_multiply_ws_interleaved<RSA_BITS, RSA_DIGIT_BITS, RSA_INTERLEAVE>(acc, acc, n, n0, sq);
+        
+        bool any = false;
+        SELECT: for (int g = 0; g < RSA_INTERLEAVE; g++) {
+            operand[g] = e[g][i] ? base_mont[g] : r_mod_n[g];
+            any |= e[g][i];
+        }
+        if (any) {
+            montgomery_multiply_ws_interleaved<RSA_BITS, RSA_DIGIT_BITS, RSA_INTERLEAVE>(sq, operand, n, n0, acc);
+        } else {
+            COPY_SQ: for (int g = 0; g < RSA_INTERLEAVE; g++) {
+                acc[g] = sq[g];
+            }
+        }
+    }
+    
+    rsa_int_t one[RSA_INTERLEAVE];
+    ONE: for (int g = 0; g < RSA_INTERLEAVE; g++) {
+        one[g] = 1;
+    }
+    montgomery_multiply_ws_interleaved<RSA_BITS, RSA_DIGIT_BITS, RSA_INTERLEAVE>(acc, one, n, n0, out);
+}
+
+void rsa_verify_batch(const uint8_t *key_table,
+                      int key_first,
+                      int key_count,
+                      const uint8_t *signatures,
+                      const uint8_t *expected,
+                      const uint32_t *job_keys,
+                      uint8_t *results,
+                      int num_jobs) {
+#pragma HLS INTERFACE m_axi port=key_table depth=131072 offset=slave bundle=gmem0
+#pragma HLS INTERFACE m_axi port=signatures depth=1024 offset=slave bundle=gmem1
+#pragma HLS INTERFACE m_axi port=expected depth=1024 offset=slave bundle=gmem2
+#pragma HLS INTERFACE m_axi port=job_keys depth=4 offset=slave bundle=gmem3
+#pragma HLS INTERFACE m_axi port=results depth=4 offset=slave bundle=gmem4
+#pragma HLS INTERFACE s_axilite port=key_table bundle=control
+#pragma HLS INTERFACE s_axilite port=key_first bundle=control
+#pragma HLS INTERFACE s_axilite port=key_count bundle=control
+#pragma HLS INTERFACE s_axilite port=signatures bundle=control
+#pragma HLS INTERFACE s_axilite port=expected bundle=control
+#pragma HLS INTERFACE s_axilite port=job_keys bundle=control
+#pragma HLS INTERFACE s_axilite port=results bundle=control
+#pragma HLS INTERFACE s_axilite port=num_jobs bundle=control
+#pragma HLS INTERFACE s_axilite port=return bundle=control
+
+    // Key slot table, persistent across launches
+    static RSAKeyContext key_slots[RSA_MAX_KEY_SLOTS];
+#pragma HLS BIND_STORAGE variable=key_slots type=ram_2p impl=uram
+    
+    LOAD_SLOTS: for (int k = 0; k < key_count; k++) {
+#pragma HLS LOOP_TRIPCOUNT min=0 max=256 avg=1
+        int slot = key_first + k;
+        if (slot < 0 || slot >= RSA_MAX_KEY_SLOTS) continue;
+        
+        uint8_t key_local[RSA_KEY_SLOT_BYTES];
+        LOAD_KEY: for (int i = 0; i < RSA_KEY_SLOT_BYTES; i++) {
+#pragma HLS PIPELINE II=1
+            key_local[i] = key_table[slot * RSA_KEY_SLOT_BYTES + i];
+        }
+        montgomery_setup<RSA_BITS>(bytes_to_rsa_int(key_local), bytes_to_rsa_int(key_local + RSA_BYTES),
+                                   key_slots[slot]);
+    }
+    
+    GROUP_LOOP: for (int job = 0; job < num_jobs; job += RSA_INTERLEAVE) {
+#pragma HLS LOOP_TRIPCOUNT min=1 max=1024 avg=64
+        rsa_int_t sig[RSA_INTERLEAVE], n[RSA_INTERLEAVE], r_mod_n[RSA_INTERLEAVE];
+        rsa_int_t r2_mod_n[RSA_INTERLEAVE], e[RSA_INTERLEAVE], out[RSA_INTERLEAVE];
+        ap_uint<RSA_DIGIT_BITS> n0[RSA_INTERLEAVE];
+        bool slot_ok[RSA_INTERLEAVE];
+        int max_bits = 0;
+        
+        // A short last group repeats the first job in the spare lanes
+        LOAD_LANES: for (int g = 0; g < RSA_INTERLEAVE; g++) {
+            int src = (job + g < num_jobs) ? job + g : job;
+            uint32_t slot = job_keys[src];
+            slot_ok[g] = slot < RSA_MAX_KEY_SLOTS;
+            const RSAKeyContext &ctx = key_slots[slot_ok[g] ? slot : 0];
+            
+            uint8_t sig_local[RSA_BYTES];
+            LOAD_SIG: for (int i = 0; i < RSA_BYTES; i++) {
+#pragma HLS PIPELINE II=1
+                sig_local[i] = signatures[src * RSA_BYTES + i];
+            }
+            sig[g] = bytes_to_rsa_int(sig_local);
+            n[g] = ctx.n;
+            n0[g] = ctx.n0;
+            r_mod_n[g] = ctx.r_mod_n;
+            r2_mod_n[g] = ctx.r2_mod_n;
+            e[g] = ctx.e;
+            if (ctx.e_bits > max_bits) max_bits = ctx.e_bits;
+            
+            // Signatures must be below n
+            slot_ok[g] = slot_ok[g] && sig[g] < n[g];
+            if (!slot_ok[g]) sig[g] = 0;
+        }
+        
+        public_op_interleaved(sig, n, n0, r_mod_n, r2_mod_n, e, max_bits, out);
+        
+        STORE_LANES: for (int g = 0; g < RSA_INTERLEAVE; g++) {
+            if (job + g >= num_jobs) continue;
+            uint8_t exp_local[RSA_BYTES];
+            LOAD_EXPECTED: for (int i = 0; i < RSA_BYTES; i++) {
+#pragma HLS PIPELINE II=1
+                exp_local[i] = expected[(job + g) * RSA_BYTES + i];
+            }
+            results[job + g] = (slot_ok[g] && out[g] == bytes_to_rsa_int(exp_local)) ? 1 : 0;
+        }
+    }
+}
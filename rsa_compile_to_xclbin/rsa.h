@@ -4,14 +4,54 @@
 #define AP_INT_MAX_W 4096
 #include <ap_int.h>
 #include <stdint.h>
+#include "rsa_montgomery.h"
 
 // RSA bit widths - using 2048-bit RSA for security
 #define RSA_BITS 2048
 #define RSA_BYTES (RSA_BITS/8)
 
+// CRT operands are half the modulus width; the packed CRT key is
+// p | q | dp | dq | qinv, RSA_HALF_BYTES each
+#define RSA_HALF_BITS (RSA_BITS/2)
+#define RSA_HALF_BYTES (RSA_HALF_BITS/8)
+#define RSA_CRT_KEY_BYTES (5*RSA_HALF_BYTES)
+
+// Digit width of the word-serial Montgomery multiplier (rsa_montgomery.h).
+// Must divide RSA_HALF_BITS so R = 2^W for both operand widths; 16 maps each
+// digit product onto a single DSP, 64 minimises the digit count.
+#ifndef RSA_DIGIT_BITS
+#define RSA_DIGIT_BITS 64
+#endif
+
+// Window width of the windowed exponentiation methods (4 or 5 for
+// full-size private exponents); the table holds 2^RSA_WINDOW_BITS entries
+#ifndef RSA_WINDOW_BITS
+#define RSA_WINDOW_BITS 5
+#endif
+#define RSA_WINDOW_SIZE (1 << RSA_WINDOW_BITS)
+
+// Batched multi-key verification (rsa_verify_batch): public keys live in
+// on-chip key slots, and RSA_INTERLEAVE jobs share the multiplier pipeline
+#define RSA_MAX_KEY_SLOTS 256
+#define RSA_KEY_SLOT_BYTES (2*RSA_BYTES)  // n | e, big-endian
+#ifndef RSA_INTERLEAVE
+#define RSA_INTERLEAVE 4
+#endif
+
+// Exponentiation method, selected per rsa_modexp call
+enum rsa_exp_method {
+    RSA_EXP_BINARY = 0,          // square-and-multiply over the significant bits
+    RSA_EXP_FIXED_WINDOW = 1,    // one multiply per non-zero window
+    RSA_EXP_SLIDING_WINDOW = 2,  // odd-power table, windows end on set bits
+    RSA_EXP_CONSTANT_TIME = 3    // fixed window over all RSA_BITS, always multiplies
+};
+
 // Use arbitrary precision integers for large numbers
 typedef ap_uint<RSA_BITS> rsa_int_t;
 typedef ap_uint<RSA_BITS*2> rsa_int_double_t;
+typedef ap_uint<RSA_HALF_BITS> rsa_half_t;
+
+static_assert(RSA_HALF_BITS % RSA_DIGIT_BITS == 0, "RSA_DIGIT_BITS must divide RSA_HALF_BITS");
 
 // Structure to hold RSA public key
 struct RSAPublicKey {
@@ -19,6 +59,28 @@ struct RSAPublicKey {
     rsa_int_t e;  // public exponent
 };
 
+// Per-key Montgomery constants for a W-bit modulus, computed once when the
+// key is loaded and reused for every block (and every launch with the same key)
+template <int W>
+struct MontgomeryContext {
+    ap_uint<W> n;         // modulus
+    ap_uint<W> e;         // exponent
+    ap_uint<RSA_DIGIT_BITS> n0;  // -n^(-1) mod 2^RSA_DIGIT_BITS
+    ap_uint<W> r_mod_n;   // R mod n, i.e. 1 in Montgomery form
+    ap_uint<W> r2_mod_n;  // R^2 mod n, converts into Montgomery form
+    int e_bits;           // significant bits of e (17 for 65537)
+};
+
+typedef MontgomeryContext<RSA_BITS> RSAKeyContext;
+
+// CRT private key: half-size contexts for p (exponent dp) and q (exponent dq)
+struct RSACRTContext {
+    MontgomeryContext<RSA_HALF_BITS> p;
+    MontgomeryContext<RSA_HALF_BITS> q;
+    rsa_half_t qinv;       // q^(-1) mod p
+    rsa_half_t qinv_mont;  // qinv * R mod p
+};
+
 // RSA encryption function
 extern "C" {
     void rsa_encrypt(const uint8_t *plaintext, 
@@ -26,6 +88,34 @@ extern "C" {
                      const uint8_t *e_bytes, 
                      uint8_t *ciphertext, 
                      int num_blocks);
+
+    // out = in^exp mod n per block, e.g. private-key signing with exp = d
+    void rsa_modexp(const uint8_t *input,
+                    const uint8_t *n_bytes,
+                    const uint8_t *exp_bytes,
+                    uint8_t *output,
+                    int num_blocks,
+                    int exp_method);
+
+    // Private-key operation via CRT with the packed key p | q | dp | dq | qinv
+    void rsa_crt(const uint8_t *input,
+                 const uint8_t *crt_key,
+                 uint8_t *output,
+                 int num_blocks,
+                 int exp_method);
+
+    // Batched verification: results[j] = (signatures[j]^e == expected[j]
+    // mod n) under key slot job_keys[j]. Slots key_first .. key_first +
+    // key_count - 1 are (re)loaded from key_table first; the others keep
+    // the contexts cached by earlier launches.
+    void rsa_verify_batch(const uint8_t *key_table,
+                          int key_first,
+                          int key_count,
+                          const uint8_t *signatures,
+                          const uint8_t *expected,
+                          const uint32_t *job_keys,
+                          uint8_t *results,
+                          int num_jobs);
 }
 
 #endif
\ No newline at end of file
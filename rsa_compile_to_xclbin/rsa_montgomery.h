@@ -0,0 +1,241 @@
+#ifndef _RSA_MONTGOMERY_H_
+#define _RSA_MONTGOMERY_H_
+
+#include <ap_int.h>
+
+// Word-serial Montgomery multiplication (FIOS) on D-bit digits.
+//
+// Instead of one W x W -> 2W product followed by another for m * n, the
+// operands are split into S = ceil(W/D) digits and the inner loop performs
+// two D x D digit products per cycle (a_j * b_i and m * n_j), so the
+// multiplier size is set by D and the latency grows as S^2 instead of
+// requiring a monolithic multiplier. R = 2^(S*D).
+
+#define MONT_DIGITS(W, D) (((W) + (D) - 1) / (D))
+
+// -n^(-1) mod 2^D from the low digit of an odd modulus; Newton's iteration
+// x = x(2 - n x) doubles the number of correct low bits per step
+template <int D>
+ap_uint<D> montgomery_n0(ap_uint<D> n_low) {
+#pragma HLS INLINE off
+    ap_uint<D> x = 1;
+    N0_NEWTON: for (int correct = 1; correct < D; correct *= 2) {
+#pragma HLS PIPELINE II=1
+        x = x * (2 - n_low * x);
+    }
+    return -x;
+}
+
+// a * b * R^(-1) mod n for a, b < n, n odd, n0 = -n^(-1) mod 2^D
+template <int W, int D>
+ap_uint<W> montgomery_multiply_ws(ap_uint<W> a, ap_uint<W> b, ap_uint<W> n, ap_uint<D> n0) {
+#pragma HLS INLINE off
+    const int S = MONT_DIGITS(W, D);
+
+    ap_uint<D> a_d[S];
+    ap_uint<D> n_d[S];
+    ap_uint<D> t[S+1];
+#pragma HLS ARRAY_PARTITION variable=a_d cyclic factor=2
+#pragma HLS ARRAY_PARTITION variable=n_d cyclic factor=2
+#pragma HLS ARRAY_PARTITION variable=t cyclic factor=2
+
+    ap_uint<S*D> a_ext = a;
+    ap_uint<S*D> b_ext = b;
+    ap_uint<S*D> n_ext = n;
+
+    SPLIT: for (int j = 0; j < S; j++) {
+#pragma HLS PIPELINE II=1
+        a_d[j] = a_ext(j*D+D-1, j*D);
+        n_d[j] = n_ext(j*D+D-1, j*D);
+        t[j] = 0;
+    }
+    t[S] = 0;
+
+    OUTER: for (int i = 0; i < S; i++) {
+        ap_uint<D> b_i = b_ext(i*D+D-1, i*D);
+
+        // Digit 0 fixes m so that t + a b_i + m n is divisible by 2^D
+        ap_uint<2*D> p = (ap_uint<2*D>)a_d[0] * b_i + t[0];
+        ap_uint<D> p_low = p(D-1, 0);
+        ap_uint<D> m = p_low * n0;
+        ap_uint<2*D> q = (ap_uint<2*D>)m * n_d[0] + p_low;
+        ap_uint<D> carry_mul = p >> D;
+        ap_uint<D> carry_red = q >> D;
+
+        // (2^D - 1)^2 + 2(2^D - 1) = 2^(2D) - 1: both sums fit a double digit
+        INNER: for (int j = 1; j < S; j++) {
+#pragma HLS PIPELINE II=1
+            p = (ap_uint<2*D>)a_d[j] * b_i + t[j] + carry_mul;
+            q = (ap_uint<2*D>)m * n_d[j] + p(D-1, 0) + carry_red;
+            carry_mul = p >> D;
+            carry_red = q >> D;
+            t[j-1] = q(D-1, 0);  // shift down one digit: the divide by 2^D
+        }
+
+        ap_uint<D+2> top = (ap_uint<D+2>)t[S] + carry_mul + carry_red;
+        t[S-1] = top(D-1, 0);
+        t[S] = top >> D;
+    }
+
+    // t < 2n: one conditional subtraction
+    ap_uint<S*D+D> u = 0;
+    JOIN: for (int j = S; j >= 0; j--) {
+#pragma HLS PIPELINE II=1
+        u = (u << D) | t[j];
+    }
+    if (u >= n) {
+        u -= n;
+    }
+    return u(W-1, 0);
+}
+
+// a * b + c on D-bit digits (schoolbook): row i adds a * b_i into
+// r[i..i+S] one digit per cycle, so the multiplier is D x D as in
+// montgomery_multiply_ws. The result a b + c < 2^(2W) needs no reduction.
+template <int W, int D>
+ap_uint<2*W> multiply_add_ws(ap_uint<W> a, ap_uint<W> b, ap_uint<W> c) {
+#pragma HLS INLINE off
+    const int S = MONT_DIGITS(W, D);
+
+    ap_uint<D> a_d[S];
+    ap_uint<D> r[2*S];
+#pragma HLS ARRAY_PARTITION variable=a_d cyclic factor=2
+#pragma HLS ARRAY_PARTITION variable=r cyclic factor=2
+
+    ap_uint<S*D> a_ext = a;
+    ap_uint<S*D> b_ext = b;
+    ap_uint<S*D> c_ext = c;
+
+    SPLIT: for (int j = 0; j < S; j++) {
+#pragma HLS PIPELINE II=1
+        a_d[j] = a_ext(j*D+D-1, j*D);
+        r[j] = c_ext(j*D+D-1, j*D);
+        r[S+j] = 0;
+    }
+
+    OUTER: for (int i = 0; i < S; i++) {
+        ap_uint<D> b_i = b_ext(i*D+D-1, i*D);
+        ap_uint<D> carry = 0;
+
+        // (2^D - 1)^2 + 2(2^D - 1) = 2^(2D) - 1: the sum fits a double digit
+        INNER: for (int j = 0; j < S; j++) {
+#pragma HLS PIPELINE II=1
+            ap_uint<2*D> p = (ap_uint<2*D>)a_d[j] * b_i + r[i+j] + carry;
+            r[i+j] = p(D-1, 0);
+            carry = p >> D;
+        }
+        r[i+S] = carry;  // not yet written by any earlier row
+    }
+
+    ap_uint<2*S*D> u = 0;
+    JOIN: for (int j = 2*S-1; j >= 0; j--) {
+#pragma HLS PIPELINE II=1
+        u = (u << D) | r[j];
+    }
+    return u(2*W-1, 0);
+}
+
+// G independent products r[g] = a[g] * b[g] * R^(-1) mod n[g], e.g. under
+// different keys. The job loop is innermost, so consecutive pipeline
+// iterations belong to different jobs and each job's carry recurrence is G
+// iterations apart: the digit pipeline stays full across rows instead of
+// draining once per outer iteration as in montgomery_multiply_ws.
+template <int W, int D, int G>
+void montgomery_multiply_ws_interleaved(const ap_uint<W> a[G], const ap_uint<W> b[G],
+                                        const ap_uint<W> n[G], const ap_uint<D> n0[G],
+                                        ap_uint<W> r[G]) {
+#pragma HLS INLINE off
+    const int S = MONT_DIGITS(W, D);
+
+    ap_uint<D> a_d[G][S];
+    ap_uint<D> b_d[G][S];
+    ap_uint<D> n_d[G][S];
+    ap_uint<D> t[G][S+1];
+    ap_uint<D> m[G];
+    ap_uint<D> carry_mul[G];
+    ap_uint<D> carry_red[G];
+#pragma HLS ARRAY_PARTITION variable=t dim=1 complete
+#pragma HLS ARRAY_PARTITION variable=m complete
+#pragma HLS ARRAY_PARTITION variable=carry_mul complete
+#pragma HLS ARRAY_PARTITION variable=carry_red complete
+
+    SPLIT: for (int g = 0; g < G; g++) {
+        ap_uint<S*D> a_ext = a[g];
+        ap_uint<S*D> b_ext = b[g];
+        ap_uint<S*D> n_ext = n[g];
+        SPLIT_DIGITS: for (int j = 0; j < S; j++) {
+#pragma HLS PIPELINE II=1
+            a_d[g][j] = a_ext(j*D+D-1, j*D);
+            b_d[g][j] = b_ext(j*D+D-1, j*D);
+            n_d[g][j] = n_ext(j*D+D-1, j*D);
+            t[g][j] = 0;
+        }
+        t[g][S] = 0;
+    }
+
+    OUTER: for (int i = 0; i < S; i++) {
+        DIGIT0: for (int g = 0; g < G; g++) {
+#pragma HLS PIPELINE II=1
+            ap_uint<D> b_i = b_d[g][i];
+            ap_uint<2*D> p = (ap_uint<2*D>)a_d[g][0] * b_i + t[g][0];
+            ap_uint<D> p_low = p(D-1, 0);
+            m[g] = p_low * n0[g];
+            ap_uint<2*D> q = (ap_uint<2*D>)m[g] * n_d[g][0] + p_low;
+            carry_mul[g] = p >> D;
+            carry_red[g] = q >> D;
+        }
+
+        INNER: for (int j = 1; j < S; j++) {
+            JOBS: for (int g = 0; g < G; g++) {
+#pragma HLS PIPELINE II=1
+#pragma HLS DEPENDENCE variable=t inter false
+                ap_uint<D> b_i = b_d[g][i];
+                ap_uint<2*D> p = (ap_uint<2*D>)a_d[g][j] * b_i + t[g][j] + carry_mul[g];
+                ap_uint<2*D> q = (ap_uint<2*D>)m[g] * n_d[g][j] + p(D-1, 0) + carry_red[g];
+                carry_mul[g] = p >> D;
+                carry_red[g] = q >> D;
+                t[g][j-1] = q(D-1, 0);
+            }
+        }
+
+        TOP: for (int g = 0; g < G; g++) {
+#pragma HLS PIPELINE II=1
+            ap_uint<D+2> top = (ap_uint<D+2>)t[g][S] + carry_mul[g] + carry_red[g];
+            t[g][S-1] = top(D-1, 0);
+            t[g][S] = top >> D;
+        }
+    }
+
+    JOIN: for (int g = 0; g < G; g++) {
+        ap_uint<S*D+D> u = 0;
+        JOIN_DIGITS: for (int j = S; j >= 0; j--) {
+#pragma HLS PIPELINE II=1
+            u = (u << D) | t[g][j];
+        }
+        if (u >= n[g]) {
+            u -= n[g];
+        }
+        r[g] = u(W-1, 0);
+    }
+}
+
+// Latency model for C-sim reports, assuming DSP48E2 (26 x 17 unsigned)
+// digit products and the inner loop at II=1: S outer iterations of S-1
+// inner cycles plus the pipeline depth, plus the split and join passes
+template <int W, int D>
+struct MontgomeryWSModel {
+    static const int DIGITS = MONT_DIGITS(W, D);
+    static const int DSP_PER_PRODUCT = ((D + 16) / 17) * ((D + 25) / 26);
+    static const int DSP_TOTAL = 3 * DSP_PER_PRODUCT;  // a*b_i, m*n_j, p*n0
+    static const int PIPELINE_DEPTH = 4 + (D + 16) / 17;
+    static const int CYCLES = DIGITS * (DIGITS - 1 + PIPELINE_DEPTH) + 2 * DIGITS + 1;
+
+    // Cycles per product with G interleaved jobs: each row streams
+    // (DIGITS + 1) * G iterations and drains the pipeline twice, shared by
+    // all G jobs, so per-product cost approaches DIGITS^2 as G grows
+    static int interleavedCycles(int jobs) {
+        return (DIGITS * ((DIGITS + 1) * jobs + 2 * PIPELINE_DEPTH) + 2 * DIGITS * jobs) / jobs;
+    }
+};
+
+#endif
@@ -4,12 +4,22 @@ open_project -reset rsa_encryption_project
 # Set the top level function
 set_top rsa_encrypt
 
+# Exponent bits per window of the windowed exponentiation methods (4 or 5)
+set rsa_window_bits 5
+
+# Digit width of the word-serial Montgomery multiplier (16, 32 or 64)
+set rsa_digit_bits 64
+
+# Verification jobs interleaved in the multiplier pipeline by rsa_verify_batch
+set rsa_interleave 4
+
 # Add design files
-add_files rsa.cpp
+add_files -cflags "-DRSA_WINDOW_BITS=$rsa_window_bits -DRSA_DIGIT_BITS=$rsa_digit_bits -DRSA_INTERLEAVE=$rsa_interleave" rsa.cpp
 add_files -cflags "-std=c++11 -DAP_INT_MAX_W=8192" rsa.h
+add_files rsa_montgomery.h
 
 # Add testbench files
-add_files -tb rsa_tb.cpp
+add_files -tb -cflags "-DRSA_WINDOW_BITS=$rsa_window_bits -DRSA_DIGIT_BITS=$rsa_digit_bits -DRSA_INTERLEAVE=$rsa_interleave" rsa_tb.cpp
 
 # Create a solution
 open_solution solution1
@@ -0,0 +1,716 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+#include <string>
+#include <algorithm>
+#include <immintrin.h>
+#include "../common/cpu_features.h"
+
+// Kernel C model (sha3.cpp), linked in so every engine can be checked
+// against the code that C-simulation runs:
+//   g++ -O3 -std=c++17 cpu_only.cpp sha3.cpp -o cpu_only
+#include "sha3.h"
+
+// Keccak-f[1600] round constants
+static const uint64_t keccak_rc[KECCAK_ROUNDS] = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808AULL, 0x8000000080008000ULL,
+    0x000000000000808BULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+    0x000000000000008AULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000AULL,
+    0x000000008000808BULL, 0x800000000000008BULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+    0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800AULL, 0x800000008000000AULL,
+    0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL
+};
+
+// Rho rotation offsets, indexed by lane x + 5 * y
+static constexpr int keccak_rho[KECCAK_STATE_SIZE] = {
+     0,  1, 62, 28, 27,
+    36, 44,  6, 55, 20,
+     3, 10, 43, 25, 39,
+    41, 45, 15, 21,  8,
+    18,  2, 61, 56, 14
+};
+
+// Source lane of each lane after pi: B[y + 5 * ((2x + 3y) % 5)] = A[x + 5y]
+struct KeccakPi {
+    int src[KECCAK_STATE_SIZE] = {};
+
+    constexpr KeccakPi() {
+        for (int y = 0; y < 5; y++) {
+            for (int x = 0; x < 5; x++) {
+                src[y + 5 * ((2 * x + 3 * y) % 5)] = x + 5 * y;
+            }
+        }
+    }
+};
+static constexpr KeccakPi keccak_pi;
+
+// Lanes held complemented by the lane-complementing engine (Keccak
+// implementation overview, section 2.2): (1,0) (2,0) (3,1) (2,2) (2,3) (0,4)
+static const uint64_t lane_complement[KECCAK_STATE_SIZE] = {
+    0, ~0ULL, ~0ULL, 0, 0,
+    0, 0, 0, ~0ULL, 0,
+    0, 0, ~0ULL, 0, 0,
+    0, 0, ~0ULL, 0, 0,
+    ~0ULL, 0, 0, 0, 0
+};
+
+static inline uint64_t rotl64(uint64_t x, int n) {
+    return n == 0 ? x : (x << n) | (x >> (64 - n));
+}
+
+static inline uint64_t load_le64(const uint8_t* p) {
+    uint64_t v;
+    memcpy(&v, p, 8);
+    return v;
+}
+
+// Single-stream reference permutation, straight from FIPS 202
+static void keccak_f1600_scalar(uint64_t* A) {
+    for (int round = 0; round < KECCAK_ROUNDS; round++) {
+        uint64_t C[5], D[5], B[KECCAK_STATE_SIZE];
+        for (int x = 0; x < 5; x++) {
+            C[x] = A[x] ^ A[x + 5] ^ A[x + 10] ^ A[x + 15] ^ A[x + 20];
+        }
+        for (int x = 0; x < 5; x++) {
+            D[x] = C[(x + 4) % 5] ^ rotl64(C[(x + 1) % 5], 1);
+        }
+#pragma GCC unroll 25
+        for (int i = 0; i < KECCAK_STATE_SIZE; i++) {
+            int s = keccak_pi.src[i];
+            B[i] = rotl64(A[s] ^ D[s % 5], keccak_rho[s]);
+        }
+#pragma GCC unroll 5
+        for (int y = 0; y < 25; y += 5) {
+#pragma GCC unroll 5
+            for (int x = 0; x < 5; x++) {
+                A[y + x] = B[y + x] ^ (~B[y + (x + 1) % 5] & B[y + (x + 2) % 5]);
+            }
+        }
+        A[0] ^= keccak_rc[round];
+    }
+}
+
+// Lane-complementing permutation: with the lanes of lane_complement held
+// inverted, chi needs one NOT per plane instead of five. Theta, rho and pi
+// are linear and carry the complement pattern through; each plane's chi
+// mixes AND and OR so its outputs land back in the same pattern.
+static void keccak_f1600_complemented(uint64_t* A) {
+    for (int round = 0; round < KECCAK_ROUNDS; round++) {
+        uint64_t C[5], D[5], B[KECCAK_STATE_SIZE];
+        for (int x = 0; x < 5; x++) {
+            C[x] = A[x] ^ A[x + 5] ^ A[x + 10] ^ A[x + 15] ^ A[x + 20];
+        }
+        for (int x = 0; x < 5; x++) {
+            D[x] = C[(x + 4) % 5] ^ rotl64(C[(x + 1) % 5], 1);
+        }
+#pragma GCC unroll 25
+        for (int i = 0; i < KECCAK_STATE_SIZE; i++) {
+            int s = keccak_pi.src[i];
+            B[i] = rotl64(A[s] ^ D[s % 5], keccak_rho[s]);
+        }
+
+        const uint64_t* b = B;
+        A[0]  = b[0] ^ (b[1] | b[2]);
+        A[1]  = b[1] ^ (~b[2] | b[3]);
+        A[2]  = b[2] ^ (b[3] & b[4]);
+        A[3]  = b[3] ^ (b[4] | b[0]);
+        A[4]  = b[4] ^ (b[0] & b[1]);
+
+        b = B + 5;
+        A[5]  = b[0] ^ (b[1] | b[2]);
+        A[6]  = b[1] ^ (b[2] & b[3]);
+        A[7]  = b[2] ^ (b[3] | ~b[4]);
+        A[8]  = b[3] ^ (b[4] | b[0]);
+        A[9]  = b[4] ^ (b[0] & b[1]);
+
+        b = B + 10;
+        uint64_t n = ~b[3];
+        A[10] = b[0] ^ (b[1] | b[2]);
+        A[11] = b[1] ^ (b[2] & b[3]);
+        A[12] = b[2] ^ (n & b[4]);
+        A[13] = n ^ (b[4] | b[0]);
+        A[14] = b[4] ^ (b[0] & b[1]);
+
+        b = B + 15;
+        n = ~b[3];
+        A[15] = b[0] ^ (b[1] & b[2]);
+        A[16] = b[1] ^ (b[2] | b[3]);
+        A[17] = b[2] ^ (n | b[4]);
+        A[18] = n ^ (b[4] & b[0]);
+        A[19] = b[4] ^ (b[0] | b[1]);
+
+        b = B + 20;
+        n = ~b[1];
+        A[20] = b[0] ^ (n & b[2]);
+        A[21] = n ^ (b[2] | b[3]);
+        A[22] = b[2] ^ (b[3] & b[4]);
+        A[23] = b[3] ^ (b[4] | b[0]);
+        A[24] = b[4] ^ (b[0] & b[1]);
+
+        A[0] ^= keccak_rc[round];
+    }
+}
+
+// Rotation with a compile-time count after unrolling; AVX2 has no 64-bit
+// rotate, AVX-512 does
+#define ROTL_X4(v, n) \
+    ((n) == 0 ? (v) : _mm256_or_si256(_mm256_slli_epi64(v, n), _mm256_srli_epi64(v, 64 - (n))))
+
+// Four independent states in lock-step. S holds one 256-bit register per
+// lane index: state word i of stream k is S[4 * i + k].
+__attribute__((target("avx2")))
+static void keccak_f1600_x4(uint64_t* S) {
+    __m256i A[KECCAK_STATE_SIZE];
+    for (int i = 0; i < KECCAK_STATE_SIZE; i++) {
+        A[i] = _mm256_load_si256((const __m256i*)(S + 4 * i));
+    }
+
+    for (int round = 0; round < KECCAK_ROUNDS; round++) {
+        __m256i C[5], D[5], B[KECCAK_STATE_SIZE];
+        for (int x = 0; x < 5; x++) {
+            C[x] = _mm256_xor_si256(_mm256_xor_si256(A[x], A[x + 5]),
+                                    _mm256_xor_si256(_mm256_xor_si256(A[x + 10], A[x + 15]), A[x + 20]));
+        }
+        for (int x = 0; x < 5; x++) {
+            D[x] = _mm256_xor_si256(C[(x + 4) % 5], ROTL_X4(C[(x + 1) % 5], 1));
+        }
+#pragma GCC unroll 25
+        for (int i = 0; i < KECCAK_STATE_SIZE; i++) {
+            int s = keccak_pi.src[i];
+            B[i] = ROTL_X4(_mm256_xor_si256(A[s], D[s % 5]), keccak_rho[s]);
+        }
+#pragma GCC unroll 5
+        for (int y = 0; y < 25; y += 5) {
+#pragma GCC unroll 5
+            for (int x = 0; x < 5; x++) {
+                A[y + x] = _mm256_xor_si256(B[y + x], _mm256_andnot_si256(B[y + (x + 1) % 5], B[y + (x + 2) % 5]));
+            }
+        }
+        A[0] = _mm256_xor_si256(A[0], _mm256_set1_epi64x((long long)keccak_rc[round]));
+    }
+
+    for (int i = 0; i < KECCAK_STATE_SIZE; i++) {
+        _mm256_store_si256((__m256i*)(S + 4 * i), A[i]);
+    }
+}
+
+// Eight states in lock-step. Theta's five-way XOR and chi are single
+// ternary-logic instructions (0x96 = a ^ b ^ c, 0xD2 = a ^ (~b & c)).
+__attribute__((target("avx512f")))
+static void keccak_f1600_x8(uint64_t* S) {
+    __m512i A[KECCAK_STATE_SIZE];
+    for (int i = 0; i < KECCAK_STATE_SIZE; i++) {
+        A[i] = _mm512_load_si512((const void*)(S + 8 * i));
+    }
+
+    for (int round = 0; round < KECCAK_ROUNDS; round++) {
+        __m512i C[5], D[5], B[KECCAK_STATE_SIZE];
+        for (int x = 0; x < 5; x++) {
+            C[x] = _mm512_ternarylogic_epi64(A[x], A[x + 5], A[x + 10], 0x96);
+            C[x] = _mm512_ternarylogic_epi64(C[x], A[x + 15], A[x + 20], 0x96);
+        }
+        for (int x = 0; x < 5; x++) {
+            D[x] = _mm512_xor_si512(C[(x + 4) % 5], _mm512_rol_epi64(C[(x + 1) % 5], 1));
+        }
+#pragma GCC unroll 25
+        for (int i = 0; i < KECCAK_STATE_SIZE; i++) {
+            int s = keccak_pi.src[i];
+            B[i] = _mm512_rolv_epi64(_mm512_xor_si512(A[s], D[s % 5]), _mm512_set1_epi64(keccak_rho[s]));
+        }
+#pragma GCC unroll 5
+        for (int y = 0; y < 25; y += 5) {
+#pragma GCC unroll 5
+            for (int x = 0; x < 5; x++) {
+                A[y + x] = _mm512_ternarylogic_epi64(B[y + x], B[y + (x + 1) % 5], B[y + (x + 2) % 5], 0xD2);
+            }
+        }
+        A[0] = _mm512_xor_si512(A[0], _mm512_set1_epi64((long long)keccak_rc[round]));
+    }
+
+    for (int i = 0; i < KECCAK_STATE_SIZE; i++) {
+        _mm512_store_si512((void*)(S + 8 * i), A[i]);
+    }
+}
+
+class Sha3CPU {
+public:
+    enum Engine {
+        ENGINE_SCALAR = 0,        // single-stream reference
+        ENGINE_COMPLEMENTED,      // single-stream, lane complementing
+        ENGINE_AVX2,              // 4 streams per permutation
+        ENGINE_AVX512             // 8 streams per permutation
+    };
+
+    // One message of a batch
+    struct Message {
+        const uint8_t* input;
+        size_t length;
+        uint8_t* output;          // outputLength(mode, out_len) bytes
+    };
+
+private:
+    Engine engine;
+    bool verbose;
+
+    static void modeParams(sha3_mode mode, uint32_t& rate, uint8_t& domain, size_t& digest) {
+        domain = SHA3_DOMAIN;
+        switch (mode) {
+            case SHA3_MODE_224: rate = SHA3_224_RATE; digest = SHA3_224_HASH_SIZE; break;
+            case SHA3_MODE_384: rate = SHA3_384_RATE; digest = SHA3_384_HASH_SIZE; break;
+            case SHA3_MODE_512: rate = SHA3_512_RATE; digest = SHA3_512_HASH_SIZE; break;
+            case SHAKE_MODE_128: rate = SHAKE128_RATE; domain = SHAKE_DOMAIN; digest = 0; break;
+            case SHAKE_MODE_256: rate = SHAKE256_RATE; domain = SHAKE_DOMAIN; digest = 0; break;
+            default: rate = SHA3_256_RATE; digest = SHA3_256_HASH_SIZE; break;
+        }
+    }
+
+    // Final padded block: message tail, domain suffix, closing 0x80
+    static void padBlock(const uint8_t* tail, size_t tail_len, uint32_t rate, uint8_t domain, uint8_t* block) {
+        memset(block, 0, rate);
+        memcpy(block, tail, tail_len);
+        block[tail_len] = domain;
+        block[rate - 1] |= 0x80;
+    }
+
+    // Up to LANES messages through one multi-stream permutation. Lanes
+    // that have absorbed their last block are saved before each
+    // permutation and restored after it while longer messages continue;
+    // squeezing then runs in lock-step.
+    template <int LANES>
+    static void hashGroup(void (*permute)(uint64_t*), const Message* msgs, int count,
+                          uint32_t rate, uint8_t domain, size_t out_len) {
+        alignas(64) uint64_t S[KECCAK_STATE_SIZE * LANES];
+        uint8_t pad[LANES][SHA3_MAX_RATE];
+        size_t nblocks[LANES];
+        size_t max_blocks = 0;
+
+        memset(S, 0, sizeof(S));
+        for (int k = 0; k < LANES; k++) {
+            nblocks[k] = k < count ? msgs[k].length / rate + 1 : 0;
+            max_blocks = std::max(max_blocks, nblocks[k]);
+        }
+
+        const uint32_t words = rate / 8;
+        for (size_t blk = 0; blk < max_blocks; blk++) {
+            uint64_t saved[LANES][KECCAK_STATE_SIZE];
+            bool idle[LANES];
+            for (int k = 0; k < LANES; k++) {
+                idle[k] = blk >= nblocks[k];
+                if (idle[k]) {
+                    for (int i = 0; i < KECCAK_STATE_SIZE; i++) saved[k][i] = S[LANES * i + k];
+                    continue;
+                }
+                const uint8_t* block = msgs[k].input + blk * rate;
+                if (blk + 1 == nblocks[k]) {
+                    padBlock(block, msgs[k].length - blk * rate, rate, domain, pad[k]);
+                    block = pad[k];
+                }
+                for (uint32_t w = 0; w < words; w++) {
+                    S[LANES * w + k] ^= load_le64(block + 8 * w);
+                }
+            }
+
+            permute(S);
+
+            for (int k = 0; k < LANES; k++) {
+                if (!idle[k]) continue;
+                for (int i = 0; i < KECCAK_STATE_SIZE; i++) S[LANES * i + k] = saved[k][i];
+            }
+        }
+
+        for (size_t pos = 0, offset = 0; pos < out_len; pos++, offset++) {
+            if (offset == rate) {
+                permute(S);
+                offset = 0;
+            }
+            for (int k = 0; k < count; k++) {
+                msgs[k].output[pos] = (uint8_t)(S[LANES * (offset / 8) + k] >> (8 * (offset % 8)));
+            }
+        }
+    }
+
+public:
+    static Engine bestEngine() {
+        if (cpu_has_avx512f()) return ENGINE_AVX512;
+        if (cpu_has_avx2()) return ENGINE_AVX2;
+        return ENGINE_COMPLEMENTED;
+    }
+
+    static bool engineSupported(Engine e) {
+        switch (e) {
+            case ENGINE_AVX512: return cpu_has_avx512f();
+            case ENGINE_AVX2: return cpu_has_avx2();
+            default: return true;
+        }
+    }
+
+    static const char* engineName(Engine e) {
+        switch (e) {
+            case ENGINE_AVX512: return "AVX-512 x8";
+            case ENGINE_AVX2: return "AVX2 x4";
+            case ENGINE_COMPLEMENTED: return "Complemented";
+            default: return "Scalar";
+        }
+    }
+
+    // Bytes written per message: the digest size for SHA3, out_len for SHAKE
+    static size_t outputLength(sha3_mode mode, size_t out_len) {
+        uint32_t rate;
+        uint8_t domain;
+        size_t digest;
+        modeParams(mode, rate, domain, digest);
+        return digest != 0 ? digest : out_len;
+    }
+
+    // Unsupported engines fall back to the best available one
+    Sha3CPU(Engine requested = bestEngine(), bool log = true) : verbose(log) {
+        engine = engineSupported(requested) ? requested : bestEngine();
+        if (verbose) {
+            std::cout << "✓ SHA-3 CPU implementation initialized (" << engineName(engine) << ")" << std::endl;
+        }
+    }
+
+    Engine getEngine() const { return engine; }
+
+    // One message on one state. The vector engines batch across messages,
+    // so a single stream uses the lane-complementing permutation.
+    void hash(const uint8_t* input, size_t input_len, uint8_t* output,
+              sha3_mode mode = SHA3_MODE_256, size_t out_len = 0) const {
+        uint32_t rate;
+        uint8_t domain;
+        size_t digest;
+        modeParams(mode, rate, domain, digest);
+        out_len = digest != 0 ? digest : out_len;
+
+        bool complemented = engine != ENGINE_SCALAR;
+        void (*permute)(uint64_t*) = complemented ? keccak_f1600_complemented : keccak_f1600_scalar;
+        uint64_t A[KECCAK_STATE_SIZE];
+        for (int i = 0; i < KECCAK_STATE_SIZE; i++) {
+            A[i] = complemented ? lane_complement[i] : 0;
+        }
+
+        // Absorbing XORs into the lanes, which commutes with the complement
+        const uint32_t words = rate / 8;
+        while (input_len >= rate) {
+            for (uint32_t w = 0; w < words; w++) A[w] ^= load_le64(input + 8 * w);
+            permute(A);
+            input += rate;
+            input_len -= rate;
+        }
+        uint8_t block[SHA3_MAX_RATE];
+        padBlock(input, input_len, rate, domain, block);
+        for (uint32_t w = 0; w < words; w++) A[w] ^= load_le64(block + 8 * w);
+        permute(A);
+
+        for (size_t pos = 0, offset = 0; pos < out_len; pos++, offset++) {
+            if (offset == rate) {
+                permute(A);
+                offset = 0;
+            }
+            uint64_t lane = A[offset / 8] ^ (complemented ? lane_complement[offset / 8] : 0);
+            output[pos] = (uint8_t)(lane >> (8 * (offset % 8)));
+        }
+    }
+
+    // Many independent hashes of one mode. The vector engines permute 4 or
+    // 8 states at once; sort by length beforehand so the lanes of a group
+    // finish together.
+    void hashBatch(const std::vector<Message>& msgs, sha3_mode mode = SHA3_MODE_256, size_t out_len = 0) const {
+        uint32_t rate;
+        uint8_t domain;
+        size_t digest;
+        modeParams(mode, rate, domain, digest);
+        out_len = digest != 0 ? digest : out_len;
+
+        if (engine == ENGINE_AVX512) {
+            for (size_t i = 0; i < msgs.size(); i += 8) {
+                hashGroup<8>(keccak_f1600_x8, &msgs[i], (int)std::min<size_t>(8, msgs.size() - i),
+                             rate, domain, out_len);
+            }
+            return;
+        }
+        if (engine == ENGINE_AVX2) {
+            for (size_t i = 0; i < msgs.size(); i += 4) {
+                hashGroup<4>(keccak_f1600_x4, &msgs[i], (int)std::min<size_t>(4, msgs.size() - i),
+                             rate, domain, out_len);
+            }
+            return;
+        }
+        for (const auto& msg : msgs) {
+            hash(msg.input, msg.length, msg.output, mode, out_len);
+        }
+    }
+
+    ~Sha3CPU() {
+        if (verbose) std::cout << "✓ SHA-3 CPU cleanup completed" << std::endl;
+    }
+};
+
+void printHash(const std::string& label, const uint8_t* hash, size_t len) {
+    std::cout << label << ": ";
+    for (size_t i = 0; i < len; i++) {
+        std::cout << std::hex << std::setw(2) << std::setfill('0') << (int)hash[i];
+    }
+    std::cout << std::dec << std::setfill(' ') << std::endl;
+}
+
+bool parseHex(const char* hex, uint8_t* out, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        unsigned int byte;
+        if (sscanf(hex + 2 * i, "%2x", &byte) != 1) return false;
+        out[i] = (uint8_t)byte;
+    }
+    return true;
+}
+
+static const Sha3CPU::Engine all_engines[] = {
+    Sha3CPU::ENGINE_SCALAR, Sha3CPU::ENGINE_COMPLEMENTED, Sha3CPU::ENGINE_AVX2, Sha3CPU::ENGINE_AVX512
+};
+
+static const sha3_mode all_modes[] = {
+    SHA3_MODE_224, SHA3_MODE_256, SHA3_MODE_384, SHA3_MODE_512, SHAKE_MODE_128, SHAKE_MODE_256
+};
+
+static const char* modeName(sha3_mode mode) {
+    switch (mode) {
+        case SHA3_MODE_224: return "SHA3-224";
+        case SHA3_MODE_384: return "SHA3-384";
+        case SHA3_MODE_512: return "SHA3-512";
+        case SHAKE_MODE_128: return "SHAKE128";
+        case SHAKE_MODE_256: return "SHAKE256";
+        default: return "SHA3-256";
+    }
+}
+
+bool runTestVectors() {
+    std::cout << "\n=== SHA-3 Test Vectors (FIPS 202) ===" << std::endl;
+
+    struct Vector {
+        const char* name;
+        std::string message;
+        sha3_mode mode;
+        size_t out_len;
+        const char* expected;
+    };
+
+    const Vector vectors[] = {
+        {"SHA3-256(\"\")", "", SHA3_MODE_256, 32,
+         "a7ffc6f8bf1ed76651c14756a061d662f580ff4de43b49fa82d80a4b80f8434a"},
+        {"SHA3-224(\"abc\")", "abc", SHA3_MODE_224, 28,
+         "e642824c3f8cf24ad09234ee7d3c766fc9a3a5168d0c94ad73b46fdf"},
+        {"SHA3-256(\"abc\")", "abc", SHA3_MODE_256, 32,
+         "3a985da74fe225b2045c172d6bd390bd855f086e3e9d525b46bfe24511431532"},
+        {"SHA3-384(\"abc\")", "abc", SHA3_MODE_384, 48,
+         "ec01498288516fc926459f58e2c6ad8df9b473cb0fc08c2596da7cf0e49be4b2"
+         "98d88cea927ac7f539f1edf228376d25"},
+        {"SHA3-512(\"abc\")", "abc", SHA3_MODE_512, 64,
+         "b751850b1a57168a5693cd924b6b096e08f621827444f70d884f5d0240d2712e"
+         "10e116e9192af3c91a7ec57647e3934057340b4cf408d5a56592f8274eec53f0"},
+        {"SHAKE128(\"\", 32)", "", SHAKE_MODE_128, 32,
+         "7f9c2ba4e88f827d616045507605853ed73b8093f6efbc88eb1a6eacfa66ef26"},
+        {"SHAKE256(\"\", 64)", "", SHAKE_MODE_256, 64,
+         "46b9dd2b0ba88d13233b3feb743eeb243fcd52ea62b81b82b50c27646ed5762f"
+         "d75dc4ddd8c0f200cb05019d67b592f6fc821c49479ab48640292eacb3b7c4be"}
+    };
+
+    bool all_passed = true;
+    int test_num = 1;
+    for (const auto& vec : vectors) {
+        std::cout << "\nTest " << test_num++ << ": " << vec.name << std::endl;
+        uint8_t expected[64];
+        parseHex(vec.expected, expected, vec.out_len);
+
+        for (auto e : all_engines) {
+            if (!Sha3CPU::engineSupported(e)) continue;
+            Sha3CPU sha3(e, false);
+            uint8_t hash[64];
+            Sha3CPU::Message msg = {(const uint8_t*)vec.message.data(), vec.message.size(), hash};
+            sha3.hashBatch({msg}, vec.mode, vec.out_len);
+            bool passed = memcmp(hash, expected, vec.out_len) == 0;
+            std::cout << std::left << std::setw(16) << Sha3CPU::engineName(e) << std::right
+                      << (passed ? "✓ PASSED" : "✗ FAILED") << std::endl;
+            all_passed &= passed;
+        }
+        std::cout << "Expected: " << vec.expected << std::endl;
+    }
+
+    // Every engine and mode against the kernel C model, across rate
+    // boundaries; batches mix lengths so lanes finish at different blocks
+    // and SHAKE squeezes past one rate block
+    std::cout << "\nTest " << test_num++ << ": Engines vs kernel C model (sha3_hash)" << std::endl;
+    {
+        std::vector<uint8_t> data(1100);
+        for (auto& b : data) b = rand() & 0xFF;
+
+        std::vector<size_t> lengths;
+        for (size_t len = 0; len <= data.size(); len += (len < 400 ? 1 : 37)) lengths.push_back(len);
+        for (size_t i = lengths.size() - 1; i > 0; i--) std::swap(lengths[i], lengths[rand() % (i + 1)]);
+        const size_t shake_len = 400;
+
+        for (auto e : all_engines) {
+            if (!Sha3CPU::engineSupported(e)) continue;
+            Sha3CPU sha3(e, false);
+            int mismatches = 0;
+            for (sha3_mode mode : all_modes) {
+                size_t out_len = Sha3CPU::outputLength(mode, shake_len);
+                std::vector<uint8_t> digests(lengths.size() * out_len), csim(out_len);
+                std::vector<Sha3CPU::Message> msgs;
+                for (size_t i = 0; i < lengths.size(); i++) {
+                    msgs.push_back({data.data(), lengths[i], &digests[i * out_len]});
+                }
+                sha3.hashBatch(msgs, mode, shake_len);
+                for (size_t i = 0; i < lengths.size(); i++) {
+                    sha3_hash(data.data(), (uint32_t)lengths[i], csim.data(), (uint32_t)out_len, mode);
+                    mismatches += memcmp(&digests[i * out_len], csim.data(), out_len) != 0;
+                }
+            }
+            std::cout << std::left << std::setw(16) << Sha3CPU::engineName(e) << std::right
+                      << (mismatches == 0 ? "✓ PASSED" : "✗ FAILED") << std::endl;
+            all_passed &= mismatches == 0;
+        }
+    }
+
+    return all_passed;
+}
+
+// Single-stream throughput: reference vs lane-complementing permutation
+// vs the kernel C model
+void runPerformanceTest() {
+    std::cout << "\n=== Single-Message SHA3-256 Performance (MB/s) ===" << std::endl;
+
+    const size_t test_sizes[] = {64, 256, 1024, 4096, 16384, 65536, 1024 * 1024};
+    const size_t total_bytes = 16 * 1024 * 1024;
+
+    std::vector<uint8_t> message(test_sizes[6]);
+    for (auto& b : message) b = rand() & 0xFF;
+
+    std::cout << std::setw(10) << "Size" << std::setw(16) << "Scalar" << std::setw(16) << "Complemented"
+              << std::setw(16) << "Kernel C-sim" << std::endl;
+
+    for (size_t size : test_sizes) {
+        size_t iterations = std::max<size_t>(1, total_bytes / size);
+        uint8_t hash[SHA3_256_HASH_SIZE];
+        double mb = (double)(iterations * size) / (1024.0 * 1024.0);
+
+        std::cout << std::setw(10) << size << std::fixed << std::setprecision(2);
+        for (auto e : {Sha3CPU::ENGINE_SCALAR, Sha3CPU::ENGINE_COMPLEMENTED}) {
+            Sha3CPU sha3(e, false);
+            auto start = std::chrono::high_resolution_clock::now();
+            for (size_t i = 0; i < iterations; i++) {
+                sha3.hash(message.data(), size, hash);
+            }
+            auto end = std::chrono::high_resolution_clock::now();
+            std::cout << std::setw(16) << mb / std::chrono::duration<double>(end - start).count();
+        }
+
+        // The C model is slower, so time a quarter of the data
+        size_t csim_iterations = std::max<size_t>(1, iterations / 4);
+        auto start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < csim_iterations; i++) {
+            sha3_256(message.data(), (uint32_t)size, hash, 0);
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        double csim_mb = (double)(csim_iterations * size) / (1024.0 * 1024.0);
+        std::cout << std::setw(16) << csim_mb / std::chrono::duration<double>(end - start).count() << std::endl;
+    }
+}
+
+// Many-message throughput per engine. 32-byte SHAKE256 outputs over short
+// seeds are the shape of post-quantum signature expansion.
+void runBatchPerformanceTest() {
+    std::cout << "\n=== Batched Hashing Performance (hashes/s) ===" << std::endl;
+
+    struct Workload { sha3_mode mode; size_t size; size_t out_len; };
+    const Workload workloads[] = {
+        {SHAKE_MODE_256, 32, 32}, {SHAKE_MODE_128, 34, 168}, {SHA3_MODE_256, 64, 0},
+        {SHA3_MODE_256, 1024, 0}, {SHA3_MODE_512, 4096, 0}
+    };
+    const size_t batch_bytes = 8 * 1024 * 1024;
+
+    std::vector<uint8_t> data(batch_bytes);
+    for (auto& b : data) b = rand() & 0xFF;
+
+    std::cout << std::setw(10) << "Mode" << std::setw(8) << "Size" << std::setw(8) << "Out";
+    for (auto e : all_engines) {
+        if (Sha3CPU::engineSupported(e)) std::cout << std::setw(16) << Sha3CPU::engineName(e);
+    }
+    std::cout << std::endl;
+
+    for (const auto& w : workloads) {
+        size_t count = std::min<size_t>(batch_bytes / w.size, 65536);
+        size_t out_len = Sha3CPU::outputLength(w.mode, w.out_len);
+        std::vector<uint8_t> reference;
+
+        std::cout << std::setw(10) << modeName(w.mode) << std::setw(8) << w.size << std::setw(8) << out_len
+                  << std::fixed << std::setprecision(0);
+        bool mismatch = false;
+        for (auto e : all_engines) {
+            if (!Sha3CPU::engineSupported(e)) continue;
+            Sha3CPU sha3(e, false);
+            std::vector<uint8_t> digests(count * out_len);
+            std::vector<Sha3CPU::Message> msgs(count);
+            for (size_t i = 0; i < count; i++) {
+                msgs[i] = {data.data() + i * w.size, w.size, &digests[i * out_len]};
+            }
+
+            auto start = std::chrono::high_resolution_clock::now();
+            sha3.hashBatch(msgs, w.mode, w.out_len);
+            auto end = std::chrono::high_resolution_clock::now();
+            std::cout << std::setw(16) << count / std::chrono::duration<double>(end - start).count();
+
+            if (reference.empty()) {
+                reference = digests;
+            } else {
+                mismatch |= digests != reference;
+            }
+        }
+        if (mismatch) {
+            std::cout << "  ✗ MISMATCH";
+        }
+        std::cout << std::endl;
+    }
+}
+
+void runBenchmarkComparison() {
+    std::cout << "\n=== Benchmark Summary ===" << std::endl;
+    std::cout << "CPU Implementation: SHA3-224/256/384/512 and SHAKE128/256 (FIPS 202)" << std::endl;
+    std::cout << "Algorithm: Keccak-f[1600], 24 rounds, rate 72-168 bytes" << std::endl;
+    std::cout << "Engines: scalar reference, scalar lane-complementing," << std::endl;
+    std::cout << "         AVX2 4-way and AVX-512 8-way multi-state for batches" << std::endl;
+    std::cout << "Reference: kernel C model (sha3_256 / sha3_hash) linked from sha3.cpp" << std::endl;
+    std::cout << "\nFor comparison with FPGA accelerator:" << std::endl;
+    std::cout << "- Run both programs with identical test parameters" << std::endl;
+    std::cout << "- Compare MB/s for single messages and hashes/s for batches" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    (void)argc;
+    (void)argv;
+    try {
+        std::cout << "=== SHA-3 CPU Benchmark Application ===" << std::endl;
+        std::cout << "Platform: CPU-only implementation" << std::endl;
+        std::cout << "Purpose: Benchmarking comparison with FPGA accelerator" << std::endl;
+
+        Sha3CPU sha3;
+
+        if (!runTestVectors()) {
+            std::cerr << "Test vectors failed" << std::endl;
+            return 1;
+        }
+        runPerformanceTest();
+        runBatchPerformanceTest();
+        runBenchmarkComparison();
+
+        std::cout << "\n=== All tests completed successfully! ===" << std::endl;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Application failed: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
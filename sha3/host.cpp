@@ -2,6 +2,11 @@
 #include <vector>
 #include <iomanip>
 #include <cstring>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <algorithm>
+#include <stdexcept>
 #include <xrt.h>
 #include <experimental/xrt_kernel.h>
 #include <chrono>
@@ -11,149 +16,639 @@ void print_hex(const uint8_t* data, int len) {
     for (int i = 0; i < len; i++) {
         std::cout << std::hex << std::setw(2) << std::setfill('0') << (int)data[i];
     }
+    std::cout << std::dec << std::setfill(' ');
+}
+
+// Software reference: FIPS 202 Keccak-f[1600] sponge
+static const uint64_t sw_round_constants[KECCAK_ROUNDS] = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808AULL, 0x8000000080008000ULL,
+    0x000000000000808BULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+    0x000000000000008AULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000AULL,
+    0x000000008000808BULL, 0x800000000000008BULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+    0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800AULL, 0x800000008000000AULL,
+    0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL
+};
+
+static const int sw_rho_offsets[KECCAK_STATE_SIZE] = {
+     0,  1, 62, 28, 27, 36, 44,  6, 55, 20,  3, 10, 43, 25, 39,
+    41, 45, 15, 21,  8, 18,  2, 61, 56, 14
+};
+
+static inline uint64_t rotl64_sw(uint64_t x, int n) {
+    return n == 0 ? x : (x << n) | (x >> (64 - n));
+}
+
+void keccak_f1600_sw(uint64_t state[KECCAK_STATE_SIZE]) {
+    for (int round = 0; round < KECCAK_ROUNDS; round++) {
+        uint64_t C[5], D[5], B[KECCAK_STATE_SIZE];
+        for (int x = 0; x < 5; x++) {
+            C[x] = state[x] ^ state[x + 5] ^ state[x + 10] ^ state[x + 15] ^ state[x + 20];
+        }
+        for (int x = 0; x < 5; x++) {
+            D[x] = C[(x + 4) % 5] ^ rotl64_sw(C[(x + 1) % 5], 1);
+        }
+        for (int y = 0; y < 5; y++) {
+            for (int x = 0; x < 5; x++) {
+                B[y + 5 * ((2 * x + 3 * y) % 5)] = rotl64_sw(state[x + 5 * y] ^ D[x], sw_rho_offsets[x + 5 * y]);
+            }
+        }
+        for (int y = 0; y < 5; y++) {
+            for (int x = 0; x < 5; x++) {
+                state[x + 5 * y] = B[x + 5 * y] ^ (~B[(x + 1) % 5 + 5 * y] & B[(x + 2) % 5 + 5 * y]);
+            }
+        }
+        state[0] ^= sw_round_constants[round];
+    }
+}
+
+// Sponge with pad10*1 and the given domain suffix; squeezes output_len bytes
+void keccak_sw(const uint8_t* message, uint32_t message_len, uint8_t* output, uint32_t output_len,
+               uint32_t rate, uint8_t domain) {
+    uint64_t state[KECCAK_STATE_SIZE] = {0};
+    uint8_t block[SHA3_MAX_RATE];
+
+    // Full blocks, then the padded tail (always at least one padding byte)
+    while (message_len >= rate) {
+        for (uint32_t w = 0; w < rate / 8; w++) {
+            uint64_t word = 0;
+            for (int j = 0; j < 8; j++) word |= (uint64_t)message[w * 8 + j] << (8 * j);
+            state[w] ^= word;
+        }
+        keccak_f1600_sw(state);
+        message += rate;
+        message_len -= rate;
+    }
+    std::memset(block, 0, rate);
+    std::memcpy(block, message, message_len);
+    block[message_len] = domain;
+    block[rate - 1] |= 0x80;
+    for (uint32_t w = 0; w < rate / 8; w++) {
+        uint64_t word = 0;
+        for (int j = 0; j < 8; j++) word |= (uint64_t)block[w * 8 + j] << (8 * j);
+        state[w] ^= word;
+    }
+    keccak_f1600_sw(state);
+
+    for (uint32_t i = 0, offset = 0; i < output_len; i++, offset++) {
+        if (offset == rate) {
+            keccak_f1600_sw(state);
+            offset = 0;
+        }
+        output[i] = (uint8_t)(state[offset / 8] >> ((offset % 8) * 8));
+    }
 }
 
-// Software reference implementation for verification
 void sha3_256_sw(const uint8_t* message, uint32_t message_len, uint8_t* hash) {
-    // This is a simplified reference - in real implementation you'd use a library
-    // For now, we'll just create a predictable pattern for testing
-    for (int i = 0; i < SHA3_256_HASH_SIZE; i++) {
-        hash[i] = (message_len + i) & 0xFF;
+    keccak_sw(message, message_len, hash, SHA3_256_HASH_SIZE, SHA3_256_RATE, SHA3_DOMAIN);
+}
+
+// Rate, domain suffix and digest size (0 = extendable output) of a mode
+static void mode_params(uint32_t mode, uint32_t& rate, uint8_t& domain, uint32_t& digest) {
+    domain = SHA3_DOMAIN;
+    switch (mode) {
+        case SHA3_MODE_224: rate = SHA3_224_RATE; digest = SHA3_224_HASH_SIZE; break;
+        case SHA3_MODE_384: rate = SHA3_384_RATE; digest = SHA3_384_HASH_SIZE; break;
+        case SHA3_MODE_512: rate = SHA3_512_RATE; digest = SHA3_512_HASH_SIZE; break;
+        case SHAKE_MODE_128: rate = SHAKE128_RATE; domain = SHAKE_DOMAIN; digest = 0; break;
+        case SHAKE_MODE_256: rate = SHAKE256_RATE; domain = SHAKE_DOMAIN; digest = 0; break;
+        default: rate = SHA3_256_RATE; digest = SHA3_256_HASH_SIZE; break;
     }
 }
 
-int main() {
-    std::cout << "SHA3-256 FPGA Accelerator Test\n";
-    std::cout << "==============================\n\n";
+class SHA3Host {
+private:
+    xrt::device device;
+    xrt::uuid uuid;
+    xrt::kernel kernel;
+    xrt::bo bo_input, bo_output;
+    size_t input_capacity = 0;
+
+    // Optional generic kernel (sha3_hash), sharing bo_input
+    xrt::kernel hash_kernel;
+    xrt::bo bo_mode_output;
+    bool has_modes = false;
+
+    // Optional streaming kernel (sha3_update). The Keccak state stays in
+    // bo_stream_state on the device between launches; two input buffers
+    // alternate so the next chunk is read while the previous one absorbs.
+    xrt::kernel stream_kernel;
+    xrt::bo bo_stream_in[2], bo_stream_state, bo_stream_out;
+    xrt::run stream_run;
+    bool has_stream = false;
+    bool stream_pending = false;
+    int stream_slot = 0;
+    size_t stream_capacity = 0;
+    size_t stream_chunk = 0;        // stream_capacity rounded down to the rate
+    size_t stream_out_capacity = 0;
+    uint32_t stream_rate = SHA3_256_RATE;
+    uint8_t stream_domain = SHA3_DOMAIN;
+    uint32_t stream_out_len = SHA3_256_HASH_SIZE;
+    uint64_t stream_total = 0;
+    std::vector<uint8_t> stream_tail;  // < rate bytes not yet forming a block
+
+    static constexpr size_t MAX_MODE_OUTPUT = 512;
+
+    // Blocks of consecutive chunks depend on each other through the state,
+    // so a launch waits for its predecessor. Only the file read and
+    // host-to-device copy of the next chunk overlap with the running kernel.
+    void launchStreamChunk(size_t num_blocks, uint32_t output_len) {
+        xrt::bo& bo = bo_stream_in[stream_slot];
+        bo.sync(XCL_BO_SYNC_BO_TO_DEVICE, num_blocks * stream_rate, 0);
+
+        if (stream_pending) {
+            stream_run.wait();
+        }
+        stream_run = stream_kernel(bo, bo_stream_state, (uint32_t)num_blocks, stream_rate,
+                                   bo_stream_out, output_len);
+        stream_pending = true;
+        stream_slot ^= 1;
+    }
+
+public:
+    SHA3Host(const std::string& xclbin_path, int device_id = 0) {
+        try {
+            device = xrt::device(device_id);
+            uuid = device.load_xclbin(xclbin_path);
+            kernel = xrt::kernel(device, uuid, "sha3_256", xrt::kernel::cu_access_mode::exclusive);
+
+            // The generic and streaming kernels are optional in the xclbin
+            try {
+                hash_kernel = xrt::kernel(device, uuid, "sha3_hash", xrt::kernel::cu_access_mode::exclusive);
+                has_modes = true;
+            } catch (const std::exception&) {
+                has_modes = false;
+            }
+            try {
+                stream_kernel = xrt::kernel(device, uuid, "sha3_update", xrt::kernel::cu_access_mode::exclusive);
+                has_stream = true;
+            } catch (const std::exception&) {
+                has_stream = false;
+            }
+
+            std::cout << "✓ SHA3 Hardware accelerator initialized successfully" << std::endl;
+            std::cout << "  - SHA3/SHAKE kernel: " << (has_modes ? "available" : "not present") << std::endl;
+            std::cout << "  - Streaming kernel: " << (has_stream ? "available" : "not present") << std::endl;
+        } catch (const std::exception& e) {
+            std::cerr << "Error initializing SHA3 accelerator: " << e.what() << std::endl;
+            throw;
+        }
+    }
+
+    void allocateBuffers(size_t max_bytes) {
+        try {
+            input_capacity = max_bytes;
+            bo_input = xrt::bo(device, max_bytes, kernel.group_id(0));
+            bo_output = xrt::bo(device, SHA3_256_HASH_SIZE, kernel.group_id(2));
+            if (has_modes) {
+                bo_mode_output = xrt::bo(device, MAX_MODE_OUTPUT, hash_kernel.group_id(2));
+            }
+            std::cout << "✓ Buffers allocated: " << max_bytes / 1024 << " KB input" << std::endl;
+        } catch (const std::exception& e) {
+            std::cerr << "Error allocating buffers: " << e.what() << std::endl;
+            throw;
+        }
+    }
+
+    bool hasModes() const { return has_modes; }
+    bool hasStream() const { return has_stream; }
+
+    // SHA3-256 through the one-shot kernel; returns kernel time in ms
+    double hash(const uint8_t* message, size_t msg_len, uint8_t* hash_out, bool upload = true) {
+        if (msg_len > input_capacity) {
+            throw std::runtime_error("message exceeds the allocated input buffer");
+        }
+        if (upload) {
+            std::memcpy(bo_input.map<uint8_t*>(), message, msg_len);
+            bo_input.sync(XCL_BO_SYNC_BO_TO_DEVICE, msg_len, 0);
+        }
+
+        auto start = std::chrono::high_resolution_clock::now();
+        auto run = kernel(bo_input, (uint32_t)msg_len, bo_output, (uint32_t)(msg_len / SHA3_256_RATE + 1));
+        run.wait();
+        auto end = std::chrono::high_resolution_clock::now();
+
+        bo_output.sync(XCL_BO_SYNC_BO_FROM_DEVICE);
+        std::memcpy(hash_out, bo_output.map<uint8_t*>(), SHA3_256_HASH_SIZE);
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    }
+
+    // Any SHA3/SHAKE mode through sha3_hash; out_len is the SHAKE length
+    void hashMode(const uint8_t* message, size_t msg_len, uint8_t* out, uint32_t mode, uint32_t out_len) {
+        if (!has_modes) {
+            throw std::runtime_error("sha3_hash not in xclbin");
+        }
+        if (msg_len > input_capacity || out_len > MAX_MODE_OUTPUT) {
+            throw std::runtime_error("request exceeds the allocated buffers");
+        }
+        std::memcpy(bo_input.map<uint8_t*>(), message, msg_len);
+        bo_input.sync(XCL_BO_SYNC_BO_TO_DEVICE, msg_len, 0);
+
+        auto run = hash_kernel(bo_input, (uint32_t)msg_len, bo_mode_output, out_len, mode);
+        run.wait();
+        bo_mode_output.sync(XCL_BO_SYNC_BO_FROM_DEVICE, out_len, 0);
+        std::memcpy(out, bo_mode_output.map<uint8_t*>(), out_len);
+    }
+
+    // Device memory for streaming is fixed at 2 x chunk_bytes plus the
+    // state and output buffers, regardless of the total message length.
+    void allocateStreamBuffers(size_t chunk_bytes, size_t max_output = 4096) {
+        try {
+            stream_capacity = chunk_bytes;
+            stream_out_capacity = max_output;
+            for (int i = 0; i < 2; i++) {
+                bo_stream_in[i] = xrt::bo(device, chunk_bytes, stream_kernel.group_id(0));
+            }
+            bo_stream_state = xrt::bo(device, KECCAK_STATE_BYTES, stream_kernel.group_id(1));
+            bo_stream_out = xrt::bo(device, max_output, stream_kernel.group_id(4));
+
+            std::cout << "✓ Stream buffers allocated: 2 x " << chunk_bytes / 1024 << " KB" << std::endl;
+        } catch (const std::exception& e) {
+            std::cerr << "Error allocating stream buffers: " << e.what() << std::endl;
+            throw;
+        }
+    }
+
+    // Start a streamed hash. out_len is the SHAKE output length; SHA3
+    // modes always produce their digest size.
+    void streamInit(uint32_t mode = SHA3_MODE_256, uint32_t out_len = 0) {
+        uint32_t digest;
+        mode_params(mode, stream_rate, stream_domain, digest);
+        stream_out_len = digest != 0 ? digest : out_len;
+        if (stream_out_len > stream_out_capacity) {
+            throw std::runtime_error("output length exceeds the allocated stream output buffer");
+        }
+        stream_chunk = stream_capacity / stream_rate * stream_rate;
+        if (stream_chunk < stream_rate) {
+            throw std::runtime_error("stream buffers are smaller than one block of this mode");
+        }
+
+        if (stream_pending) {
+            stream_run.wait();
+            stream_pending = false;
+        }
+        std::memset(bo_stream_state.map<uint8_t*>(), 0, KECCAK_STATE_BYTES);
+        bo_stream_state.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+        stream_total = 0;
+        stream_slot = 0;
+        stream_tail.clear();
+    }
+
+    void streamUpdate(const uint8_t* data, size_t len) {
+        stream_total += len;
+
+        while (len > 0) {
+            uint8_t* dst = bo_stream_in[stream_slot].map<uint8_t*>();
+
+            // Carry over the bytes that did not fill a block last time
+            size_t fill = stream_tail.size();
+            std::memcpy(dst, stream_tail.data(), fill);
+            size_t take = std::min(len, stream_chunk - fill);
+            std::memcpy(dst + fill, data, take);
+            data += take;
+            len -= take;
+
+            size_t usable = (fill + take) / stream_rate * stream_rate;
+            stream_tail.assign(dst + usable, dst + fill + take);
+            if (usable > 0) {
+                launchStreamChunk(usable / stream_rate, 0);
+            }
+        }
+    }
+
+    // Returns the output length written to out
+    uint32_t streamFinal(uint8_t* out) {
+        // Pad the tail on the host: always exactly one block
+        uint8_t* dst = bo_stream_in[stream_slot].map<uint8_t*>();
+        size_t tail = stream_tail.size();
+        std::memcpy(dst, stream_tail.data(), tail);
+        std::memset(dst + tail, 0, stream_rate - tail);
+        dst[tail] = stream_domain;
+        dst[stream_rate - 1] |= 0x80;
+
+        launchStreamChunk(1, stream_out_len);
+        stream_run.wait();
+        stream_pending = false;
+
+        bo_stream_out.sync(XCL_BO_SYNC_BO_FROM_DEVICE, stream_out_len, 0);
+        std::memcpy(out, bo_stream_out.map<uint8_t*>(), stream_out_len);
+        stream_tail.clear();
+        return stream_out_len;
+    }
+
+    // Hash a file of any size with bounded memory. Chunks are read straight
+    // into the idle device buffer while the other one is being absorbed.
+    uint64_t hashFile(const std::string& path, uint8_t* out, uint32_t mode = SHA3_MODE_256, uint32_t out_len = 0) {
+        std::ifstream infile(path, std::ios::binary);
+        if (!infile) {
+            throw std::runtime_error("cannot open " + path);
+        }
+
+        streamInit(mode, out_len);
+        while (true) {
+            uint8_t* dst = bo_stream_in[stream_slot].map<uint8_t*>();
+            infile.read(reinterpret_cast<char*>(dst), stream_chunk);
+            size_t got = (size_t)infile.gcount();
+            stream_total += got;
+
+            size_t usable = got / stream_rate * stream_rate;
+            if (usable > 0) {
+                launchStreamChunk(usable / stream_rate, 0);
+            }
+            if (got < stream_chunk) {
+                stream_tail.assign(dst + usable, dst + got);
+                break;
+            }
+        }
+        streamFinal(out);
+        return stream_total;
+    }
+
+    ~SHA3Host() {
+        if (stream_pending) {
+            stream_run.wait();
+        }
+    }
+};
 
-    // Test data sizes
+bool runTestVectors(SHA3Host& sha3) {
+    std::cout << "\n=== FIPS 202 Test Vectors ===" << std::endl;
+
+    const uint8_t* abc = (const uint8_t*)"abc";
+    uint8_t hash[SHA3_256_HASH_SIZE], expected[SHA3_256_HASH_SIZE];
+    sha3.hash(abc, 3, hash);
+    sha3_256_sw(abc, 3, expected);
+
+    bool match = std::memcmp(hash, expected, SHA3_256_HASH_SIZE) == 0;
+    std::cout << "SHA3-256(\"abc\"): ";
+    print_hex(hash, SHA3_256_HASH_SIZE);
+    std::cout << (match ? " PASS" : " FAIL") << std::endl;
+    return match;
+}
+
+// One-shot SHA3-256 across sizes against the software reference
+int runPerformanceTest(SHA3Host& sha3) {
     const std::vector<uint32_t> test_sizes = {64, 256, 1024, 4096};
-    
-    // Setup XRT device and kernel
-    std::cout << "Initializing FPGA device...\n";
-    auto device = xrt::device(0);
-    auto uuid = device.load_xclbin("sha3_hw.xclbin");
-    auto kernel = xrt::kernel(device, uuid, "sha3_256", xrt::kernel::cu_access_mode::exclusive);
+    int failures = 0;
 
     for (uint32_t size : test_sizes) {
         std::cout << "\n" << std::string(50, '-') << "\n";
         std::cout << "Testing with " << size << " bytes of data\n";
-        
+
         // Create test message
         std::vector<uint8_t> message(size);
         for (uint32_t i = 0; i < size; i++) {
             message[i] = (i * 37 + 123) & 0xFF; // Pseudo-random pattern
         }
-        
-        // Calculate number of blocks
-        uint32_t num_blocks = (size + SHA3_256_RATE - 1) / SHA3_256_RATE;
-        if (num_blocks == 0) num_blocks = 1;
-        
-        std::cout << "Message size: " << size << " bytes\n";
-        std::cout << "Number of blocks: " << num_blocks << "\n";
-
-        // Create buffer objects
-        auto message_buf = xrt::bo(device, size * sizeof(uint8_t), kernel.group_id(0));
-        auto hash_buf = xrt::bo(device, SHA3_256_HASH_SIZE * sizeof(uint8_t), kernel.group_id(2));
-
-        // Map buffers
-        auto message_map = message_buf.map<uint8_t*>();
-        auto hash_map = hash_buf.map<uint8_t*>();
-
-        // Copy input data
-        std::memcpy(message_map, message.data(), size);
-
-        // Sync to device
-        std::cout << "Copying data to FPGA...\n";
-        message_buf.sync(XCL_BO_SYNC_BO_TO_DEVICE);
 
-        // Execute kernel
-        std::cout << "Executing SHA3-256 on FPGA...\n";
-        auto start = std::chrono::high_resolution_clock::now();
-        
-        auto run = kernel(message_buf, size, hash_buf, num_blocks);
-        run.wait();
-        
-        auto end = std::chrono::high_resolution_clock::now();
-        double duration_ms = std::chrono::duration<double, std::milli>(end - start).count();
+        std::cout << "Message size: " << size << " bytes\n";
+        std::cout << "Number of blocks: " << size / SHA3_256_RATE + 1 << "\n";
 
-        // Get results
-        hash_buf.sync(XCL_BO_SYNC_BO_FROM_DEVICE);
+        uint8_t hash[SHA3_256_HASH_SIZE];
+        double duration_ms = sha3.hash(message.data(), size, hash);
 
-        // Print results
         std::cout << "FPGA Hash: ";
-        print_hex(hash_map, SHA3_256_HASH_SIZE);
+        print_hex(hash, SHA3_256_HASH_SIZE);
         std::cout << "\n";
 
         // Performance metrics
         std::cout << "Execution time: " << duration_ms << " ms\n";
         double throughput_mbps = (size / (1024.0 * 1024.0)) / (duration_ms / 1000.0);
         std::cout << "Throughput: " << throughput_mbps << " MB/s\n";
-        
-        // Calculate hash rate
-        double hash_rate = 1000.0 / duration_ms; // hashes per second
-        std::cout << "Hash rate: " << hash_rate << " hashes/sec\n";
+        std::cout << "Hash rate: " << 1000.0 / duration_ms << " hashes/sec\n";
 
-        // Software verification (simplified)
+        // Software verification
         std::vector<uint8_t> sw_hash(SHA3_256_HASH_SIZE);
         auto sw_start = std::chrono::high_resolution_clock::now();
         sha3_256_sw(message.data(), size, sw_hash.data());
         auto sw_end = std::chrono::high_resolution_clock::now();
         double sw_duration_ms = std::chrono::duration<double, std::milli>(sw_end - sw_start).count();
-        
+
+        bool match = std::memcmp(sw_hash.data(), hash, SHA3_256_HASH_SIZE) == 0;
+        std::cout << "Verification: " << (match ? "PASS" : "FAIL") << "\n";
+        if (!match) failures++;
+
         std::cout << "SW time: " << sw_duration_ms << " ms\n";
         std::cout << "Speedup: " << (sw_duration_ms / duration_ms) << "x\n";
     }
+    return failures;
+}
 
-    // Stress test with multiple iterations
+// Stress test with multiple iterations over a resident message
+int runStressTest(SHA3Host& sha3) {
     std::cout << "\n" << std::string(50, '=') << "\n";
     std::cout << "Stress Test - 100 iterations of 1KB hashing\n";
-    
+
     const uint32_t stress_size = 1024;
     const uint32_t iterations = 100;
-    
+
     std::vector<uint8_t> stress_message(stress_size);
     for (uint32_t i = 0; i < stress_size; i++) {
         stress_message[i] = i & 0xFF;
     }
-    
-    uint32_t stress_blocks = (stress_size + SHA3_256_RATE - 1) / SHA3_256_RATE;
-    
-    // Setup buffers for stress test
-    auto stress_msg_buf = xrt::bo(device, stress_size, kernel.group_id(0));
-    auto stress_hash_buf = xrt::bo(device, SHA3_256_HASH_SIZE, kernel.group_id(2));
-    auto stress_msg_map = stress_msg_buf.map<uint8_t*>();
-    auto stress_hash_map = stress_hash_buf.map<uint8_t*>();
-    
-    std::memcpy(stress_msg_map, stress_message.data(), stress_size);
-    stress_msg_buf.sync(XCL_BO_SYNC_BO_TO_DEVICE);
-    
-    auto stress_start = std::chrono::high_resolution_clock::now();
-    
+
+    uint8_t hash[SHA3_256_HASH_SIZE];
+    double total_time = 0;
     for (uint32_t i = 0; i < iterations; i++) {
-        auto run = kernel(stress_msg_buf, stress_size, stress_hash_buf, stress_blocks);
-        run.wait();
-        
+        total_time += sha3.hash(stress_message.data(), stress_size, hash, i == 0);
+
         if (i % 20 == 0) {
             std::cout << "Completed " << i << "/" << iterations << " iterations\n";
         }
     }
-    
-    auto stress_end = std::chrono::high_resolution_clock::now();
-    double total_time = std::chrono::duration<double, std::milli>(stress_end - stress_start).count();
-    
-    stress_hash_buf.sync(XCL_BO_SYNC_BO_FROM_DEVICE);
-    
+
     std::cout << "Stress test completed!\n";
     std::cout << "Total time: " << total_time << " ms\n";
     std::cout << "Average time per hash: " << (total_time / iterations) << " ms\n";
     std::cout << "Average throughput: " << (iterations * stress_size / (1024.0 * 1024.0)) / (total_time / 1000.0) << " MB/s\n";
     std::cout << "Average hash rate: " << (iterations * 1000.0 / total_time) << " hashes/sec\n";
-    
+
     std::cout << "Final hash: ";
-    print_hex(stress_hash_map, SHA3_256_HASH_SIZE);
+    print_hex(hash, SHA3_256_HASH_SIZE);
     std::cout << "\n";
 
+    std::vector<uint8_t> sw(SHA3_256_HASH_SIZE);
+    sha3_256_sw(stress_message.data(), stress_size, sw.data());
+    if (std::memcmp(sw.data(), hash, SHA3_256_HASH_SIZE) != 0) {
+        std::cout << "Stress verification: FAIL\n";
+        return 1;
+    }
+    return 0;
+}
+
+// SHA3-224/384/512 and SHAKE through the generic kernel, when present
+int runModeTest(SHA3Host& sha3) {
+    if (!sha3.hasModes()) {
+        std::cout << "\nsha3_hash kernel not in xclbin, skipping FIPS 202 mode test\n";
+        return 0;
+    }
+
+    struct Mode { const char* name; uint32_t mode; uint32_t out_len; };
+    const Mode modes[] = {
+        {"SHA3-224", SHA3_MODE_224, SHA3_224_HASH_SIZE},
+        {"SHA3-256", SHA3_MODE_256, SHA3_256_HASH_SIZE},
+        {"SHA3-384", SHA3_MODE_384, SHA3_384_HASH_SIZE},
+        {"SHA3-512", SHA3_MODE_512, SHA3_512_HASH_SIZE},
+        {"SHAKE128", SHAKE_MODE_128, 500},
+        {"SHAKE256", SHAKE_MODE_256, 500}
+    };
+    const uint32_t size = 1024;
+
+    std::vector<uint8_t> message(size);
+    for (uint32_t i = 0; i < size; i++) {
+        message[i] = i & 0xFF;
+    }
+
+    std::cout << "\n" << std::string(50, '=') << "\n";
+    std::cout << "FIPS 202 modes (" << size << "-byte message)\n";
+
+    int failures = 0;
+    std::vector<uint8_t> out(512), expected(512);
+    for (const Mode& m : modes) {
+        uint32_t rate, digest;
+        uint8_t domain;
+        mode_params(m.mode, rate, domain, digest);
+
+        sha3.hashMode(message.data(), size, out.data(), m.mode, m.out_len);
+        keccak_sw(message.data(), size, expected.data(), m.out_len, rate, domain);
+        bool match = std::memcmp(expected.data(), out.data(), m.out_len) == 0;
+        std::cout << std::left << std::setw(10) << m.name << std::right
+                  << std::setw(4) << m.out_len << " bytes: ";
+        print_hex(out.data(), 16);
+        std::cout << "... " << (match ? "PASS" : "FAIL") << "\n";
+        if (!match) failures++;
+    }
+    return failures;
+}
+
+// Streamed hashing: any update split must match the software sponge, and
+// a file far beyond MAX_MESSAGE_SIZE hashes through fixed device buffers
+int runFileHashTest(SHA3Host& sha3, const std::string& user_file) {
+    std::cout << "\n=== Streaming / File Hash Test ===" << std::endl;
+
+    if (!sha3.hasStream()) {
+        std::cout << "sha3_update not in xclbin, skipping" << std::endl;
+        return 0;
+    }
+
+    int failures = 0;
+    {
+        const size_t msg_size = 100 * 1024 + 37;
+        const size_t splits[] = {1, 135, 136, 137, 4096, 70000};
+        std::vector<uint8_t> message(msg_size);
+        for (size_t i = 0; i < msg_size; i++) {
+            message[i] = rand() & 0xFF;
+        }
+
+        struct Mode { const char* name; uint32_t mode; uint32_t out_len; };
+        const Mode modes[] = {
+            {"SHA3-256", SHA3_MODE_256, 0}, {"SHA3-512", SHA3_MODE_512, 0}, {"SHAKE128", SHAKE_MODE_128, 1000}
+        };
+        for (const Mode& m : modes) {
+            uint32_t rate, digest;
+            uint8_t domain;
+            mode_params(m.mode, rate, domain, digest);
+            uint32_t out_len = digest != 0 ? digest : m.out_len;
+            std::vector<uint8_t> expected(out_len), out(out_len);
+            keccak_sw(message.data(), (uint32_t)msg_size, expected.data(), out_len, rate, domain);
+
+            bool all_match = true;
+            for (size_t split : splits) {
+                sha3.streamInit(m.mode, m.out_len);
+                for (size_t off = 0; off < msg_size; off += split) {
+                    sha3.streamUpdate(message.data() + off, std::min(split, msg_size - off));
+                }
+                sha3.streamFinal(out.data());
+                all_match &= out == expected;
+            }
+            std::cout << "Streaming " << m.name << " vs software: " << (all_match ? "✓ PASSED" : "✗ FAILED") << std::endl;
+            if (!all_match) failures++;
+        }
+    }
+
+    // Hash the user's file, or generate one far larger than the one-shot buffers
+    std::string filename = user_file;
+    bool generated = filename.empty();
+    std::vector<uint8_t> expected(SHA3_256_HASH_SIZE);
+    if (generated) {
+        filename = "test_file.bin";
+        const size_t file_size = 256 * 1024 * 1024; // 256 MB
+
+        std::cout << "Creating " << file_size / (1024 * 1024) << " MB test file..." << std::endl;
+
+        std::vector<uint8_t> contents(file_size);
+        for (size_t i = 0; i < file_size; i++) {
+            contents[i] = rand() & 0xFF;
+        }
+        std::ofstream file(filename, std::ios::binary);
+        file.write(reinterpret_cast<char*>(contents.data()), contents.size());
+        file.close();
+
+        auto sw_start = std::chrono::high_resolution_clock::now();
+        sha3_256_sw(contents.data(), (uint32_t)file_size, expected.data());
+        auto sw_end = std::chrono::high_resolution_clock::now();
+        std::cout << "SW reference: " << std::fixed << std::setprecision(2)
+                  << (double)file_size / (1024.0 * 1024.0) / std::chrono::duration<double>(sw_end - sw_start).count()
+                  << " MB/s" << std::endl;
+    }
+
+    std::cout << "Hashing " << filename << "..." << std::endl;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    uint8_t hash[SHA3_256_HASH_SIZE];
+    uint64_t file_size = sha3.hashFile(filename, hash);
+    auto end = std::chrono::high_resolution_clock::now();
+    double time_sec = std::chrono::duration<double>(end - start).count();
+
+    std::cout << "File hash: ";
+    print_hex(hash, SHA3_256_HASH_SIZE);
+    std::cout << std::endl;
+    std::cout << "✓ " << file_size << " bytes hashed in " << std::fixed << std::setprecision(3)
+              << time_sec << " s (" << std::setprecision(2)
+              << (double)file_size / (1024.0 * 1024.0) / time_sec << " MB/s incl. file I/O)" << std::endl;
+
+    if (generated) {
+        bool match = std::memcmp(hash, expected.data(), SHA3_256_HASH_SIZE) == 0;
+        std::cout << "File hash vs software: " << (match ? "✓ PASSED" : "✗ FAILED") << std::endl;
+        if (!match) failures++;
+
+        std::remove(filename.c_str());
+        std::cout << "✓ Test file removed" << std::endl;
+    }
+    return failures;
+}
+
+int main(int argc, char* argv[]) {
+    std::string xclbin_path = (argc > 1) ? argv[1] : "sha3_hw.xclbin";
+    int device_id = (argc > 2) ? std::atoi(argv[2]) : 0;
+    std::string file_to_hash = (argc > 3) ? argv[3] : "";
+
+    try {
+        std::cout << "SHA3-256 FPGA Accelerator Test\n";
+        std::cout << "==============================\n\n";
+        std::cout << "Initializing FPGA device...\n";
+
+        SHA3Host sha3(xclbin_path, device_id);
+        sha3.allocateBuffers(4096);
+        if (sha3.hasStream()) {
+            sha3.allocateStreamBuffers(4 * 1024 * 1024); // 2 x 4 MB, any file size
+        }
+
+        int failures = 0;
+        if (!runTestVectors(sha3)) failures++;
+        failures += runPerformanceTest(sha3);
+        failures += runStressTest(sha3);
+        failures += runModeTest(sha3);
+        failures += runFileHashTest(sha3, file_to_hash);
+
+        if (failures != 0) {
+            std::cout << "\n" << failures << " verification failure(s)\n";
+            return 1;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Application failed: " << e.what() << std::endl;
+        return 1;
+    }
+
     std::cout << "\nSHA3-256 FPGA accelerator test completed successfully!\n";
     return 0;
-}
\ No newline at end of file
+}
@@ -2,8 +2,11 @@
 open_project -reset sha3_project
 set_top sha3_256
 
+# Keccak rounds per permutation step (1, 2, 3, 4, 6, 8, 12 or 24)
+set keccak_unroll 1
+
 # Add source files
-add_files sha3.cpp
+add_files -cflags "-std=c++11 -DKECCAK_UNROLL=$keccak_unroll" sha3.cpp
 add_files -cflags "-std=c++11" sha3.h
 
 # Open solution
@@ -21,7 +24,7 @@ config_schedule -enable_dsp_full_reg
 csynth_design
 
 # Add testbench
-add_files -tb sha3_tb.cpp
+add_files -tb -cflags "-DKECCAK_UNROLL=$keccak_unroll" sha3_tb.cpp
 
 # Run C simulation
 csim_design
@@ -1,107 +1,145 @@
 #include "sha3.h"
 
-// Simplified Keccak round constants (first 8 rounds for faster synthesis)
-static const uint64_t keccak_round_constants[8] = {
-    0x0000000000000001ULL, 0x0000000000008082ULL, 
-    0x800000000000808AULL, 0x8000000080008000ULL,
-    0x000000000000808BULL, 0x0000000080000001ULL, 
-    0x8000000080008081ULL, 0x8000000000008009ULL
+// Keccak-f[1600] round constants
+static const uint64_t keccak_round_constants[KECCAK_ROUNDS] = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808AULL, 0x8000000080008000ULL,
+    0x000000000000808BULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+    0x000000000000008AULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000AULL,
+    0x000000008000808BULL, 0x800000000000008BULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+    0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800AULL, 0x800000008000000AULL,
+    0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL
 };
 
-// Simplified rotation offsets
-static const int rho_offsets[25] = {
-    0,  1,  3,  6,  10, 15, 21, 28, 36, 45, 55, 2,  14,
-    27, 41, 56, 8,  25, 43, 62, 18, 39, 61, 20, 44
+// Rho rotation offsets, indexed by lane x + 5 * y
+static const int rho_offsets[KECCAK_STATE_SIZE] = {
+     0,  1, 62, 28, 27,
+    36, 44,  6, 55, 20,
+     3, 10, 43, 25, 39,
+    41, 45, 15, 21,  8,
+    18,  2, 61, 56, 14
 };
 
 // Rotate left function
-uint64_t rotl64(uint64_t x, int n) {
+static inline uint64_t rotl64(uint64_t x, int n) {
 #pragma HLS INLINE
     if (n == 0) return x;
     return (x << n) | (x >> (64 - n));
 }
 
-// Simplified Keccak-f permutation (8 rounds instead of 24 for faster synthesis)
-void keccak_f_simple(keccak_state_t state) {
-#pragma HLS INLINE off
-    
-    uint64_t C[5], D[5];
-    
-    // Reduced rounds for faster synthesis and testing
-    ROUNDS_LOOP: for (int round = 0; round < 8; round++) {
-#pragma HLS PIPELINE off
-        
-        // Theta step
-        THETA_C_LOOP: for (int x = 0; x < 5; x++) {
+// One Keccak-f[1600] round: theta, rho and pi (lane (x, y) moves to
+// (y, 2x + 3y)), chi, iota
+static void keccak_round(keccak_state_t state, uint64_t rc) {
+#pragma HLS INLINE
+    uint64_t C[5], D[5], B[KECCAK_STATE_SIZE];
+#pragma HLS ARRAY_PARTITION variable=C complete
+#pragma HLS ARRAY_PARTITION variable=D complete
+#pragma HLS ARRAY_PARTITION variable=B complete
+
+    // Theta step
+    THETA_C_LOOP: for (int x = 0; x < 5; x++) {
 #pragma HLS UNROLL
-            C[x] = state[x] ^ state[x + 5] ^ state[x + 10] ^ state[x + 15] ^ state[x + 20];
-        }
-        
-        THETA_D_LOOP: for (int x = 0; x < 5; x++) {
+        C[x] = state[x] ^ state[x + 5] ^ state[x + 10] ^ state[x + 15] ^ state[x + 20];
+    }
+
+    THETA_D_LOOP: for (int x = 0; x < 5; x++) {
 #pragma HLS UNROLL
-            D[x] = C[(x + 4) % 5] ^ rotl64(C[(x + 1) % 5], 1);
-        }
-        
-        THETA_APPLY_LOOP: for (int y = 0; y < 5; y++) {
+        D[x] = C[(x + 4) % 5] ^ rotl64(C[(x + 1) % 5], 1);
+    }
+
+    // Theta apply, rho and pi
+    RHO_PI_LOOP: for (int y = 0; y < 5; y++) {
 #pragma HLS UNROLL
-            for (int x = 0; x < 5; x++) {
+        for (int x = 0; x < 5; x++) {
 #pragma HLS UNROLL
-                state[y * 5 + x] ^= D[x];
-            }
+            B[y + 5 * ((2 * x + 3 * y) % 5)] = rotl64(state[x + 5 * y] ^ D[x], rho_offsets[x + 5 * y]);
         }
-        
-        // Simplified Rho and Pi steps
-        uint64_t temp = state[1];
-        RHO_PI_LOOP: for (int i = 0; i < 24; i++) {
-#pragma HLS UNROLL factor=4
-            int j = ((i + 1) * (i + 2) / 2) % 25;
-            uint64_t temp2 = state[j];
-            state[j] = rotl64(temp, rho_offsets[i]);
-            temp = temp2;
-        }
-        
-        // Chi step
-        CHI_LOOP: for (int y = 0; y < 5; y++) {
-#pragma HLS UNROLL
-            uint64_t row[5];
-            for (int x = 0; x < 5; x++) {
+    }
+
+    // Chi step
+    CHI_LOOP: for (int y = 0; y < 5; y++) {
 #pragma HLS UNROLL
-                row[x] = state[y * 5 + x];
-            }
-            for (int x = 0; x < 5; x++) {
+        for (int x = 0; x < 5; x++) {
 #pragma HLS UNROLL
-                state[y * 5 + x] = row[x] ^ ((~row[(x + 1) % 5]) & row[(x + 2) % 5]);
-            }
+            state[x + 5 * y] = B[x + 5 * y] ^ ((~B[(x + 1) % 5 + 5 * y]) & B[(x + 2) % 5 + 5 * y]);
         }
-        
-        // Iota step
-        state[0] ^= keccak_round_constants[round];
     }
+
+    // Iota step
+    state[0] ^= rc;
 }
 
-// Absorb one block into the state
-void absorb_block(keccak_state_t state, const uint8_t *block) {
+// Keccak-f[1600]: 24 rounds, ROUNDS_PER_STEP of them chained combinationally
+// per loop iteration (one iteration per cycle, so 24 / ROUNDS_PER_STEP
+// cycles per permutation)
+template <int ROUNDS_PER_STEP>
+static void keccak_f1600(keccak_state_t state) {
 #pragma HLS INLINE off
-    
-    // Convert bytes to 64-bit words and XOR with state
-    ABSORB_LOOP: for (int i = 0; i < 17; i++) { // 136/8 = 17 words
-#pragma HLS PIPELINE II=1
-        uint64_t word = 0;
-        
-        // Little-endian byte order
-        BYTE_LOOP: for (int j = 0; j < 8; j++) {
+    static_assert(KECCAK_ROUNDS % ROUNDS_PER_STEP == 0, "rounds per step must divide 24");
+
+    ROUNDS_LOOP: for (int round = 0; round < KECCAK_ROUNDS; round += ROUNDS_PER_STEP) {
+#pragma HLS PIPELINE off
+        for (int r = 0; r < ROUNDS_PER_STEP; r++) {
 #pragma HLS UNROLL
-            word |= ((uint64_t)block[i * 8 + j]) << (j * 8);
+            keccak_round(state, keccak_round_constants[round + r]);
         }
-        
-        state[i] ^= word;
     }
-    
-    // Apply simplified Keccak-f permutation
-    keccak_f_simple(state);
 }
 
-// Main SHA-3 256 function (simplified version)
+// Absorb message_len bytes with the pad10*1 rule and domain suffix. The
+// padded message is a whole number of rate-byte blocks; the suffix byte
+// sits right after the message and 0x80 ends the last block (both in the
+// same byte when only one byte of padding fits).
+static void sponge_absorb(keccak_state_t state, const uint8_t *message, uint32_t message_len,
+                          uint32_t rate, uint8_t domain) {
+#pragma HLS INLINE
+    uint32_t num_blocks = message_len / rate + 1;
+    uint32_t padded_len = num_blocks * rate;
+
+    BLOCK_LOOP: for (uint32_t block_idx = 0; block_idx < num_blocks; block_idx++) {
+#pragma HLS PIPELINE off
+
+        ABSORB_LOOP: for (uint32_t w = 0; w < rate / 8; w++) {
+            uint64_t word = 0;
+
+            // Little-endian byte order
+            BYTE_LOOP: for (int j = 0; j < 8; j++) {
+#pragma HLS PIPELINE II=1
+                uint32_t pos = block_idx * rate + w * 8 + j;
+                uint8_t byte = 0;
+                if (pos < message_len) {
+                    byte = message[pos];
+                } else if (pos == message_len) {
+                    byte = domain;
+                }
+                if (pos == padded_len - 1) {
+                    byte |= 0x80;
+                }
+                word |= ((uint64_t)byte) << (j * 8);
+            }
+
+            state[w] ^= word;
+        }
+
+        keccak_f1600<KECCAK_UNROLL>(state);
+    }
+}
+
+// Squeeze output_len bytes, permuting again after every rate bytes
+static void sponge_squeeze(keccak_state_t state, uint8_t *output, uint32_t output_len, uint32_t rate) {
+#pragma HLS INLINE
+    uint32_t offset = 0;
+    SQUEEZE_LOOP: for (uint32_t i = 0; i < output_len; i++) {
+#pragma HLS PIPELINE off
+        if (offset == rate) {
+            keccak_f1600<KECCAK_UNROLL>(state);
+            offset = 0;
+        }
+        output[i] = (uint8_t)(state[offset / 8] >> ((offset % 8) * 8));
+        offset++;
+    }
+}
+
+// SHA3-256
 void sha3_256(
     const uint8_t *message,
     uint32_t message_len,
@@ -116,52 +154,112 @@ void sha3_256(
 #pragma HLS INTERFACE s_axilite port=num_blocks bundle=control
 #pragma HLS INTERFACE s_axilite port=return bundle=control
 
+    (void)num_blocks;
+
     // Initialize state to all zeros
     keccak_state_t state;
+#pragma HLS ARRAY_PARTITION variable=state complete
     INIT_LOOP: for (int i = 0; i < KECCAK_STATE_SIZE; i++) {
 #pragma HLS UNROLL
         state[i] = 0;
     }
-    
-    // Process message in blocks
-    uint32_t processed = 0;
-    uint8_t block[SHA3_256_RATE];
-    
-    BLOCK_LOOP: for (uint32_t block_idx = 0; block_idx < num_blocks; block_idx++) {
+
+    sponge_absorb(state, message, message_len, SHA3_256_RATE, SHA3_DOMAIN);
+    sponge_squeeze(state, hash, SHA3_256_HASH_SIZE, SHA3_256_RATE);
+}
+
+// SHA3-224/256/384/512 and SHAKE128/256
+void sha3_hash(
+    const uint8_t *message,
+    uint32_t message_len,
+    uint8_t *output,
+    uint32_t output_len,
+    uint32_t mode
+) {
+#pragma HLS INTERFACE m_axi port=message depth=1024 offset=slave bundle=gmem0
+#pragma HLS INTERFACE m_axi port=output depth=512 offset=slave bundle=gmem1
+#pragma HLS INTERFACE s_axilite port=message bundle=control
+#pragma HLS INTERFACE s_axilite port=message_len bundle=control
+#pragma HLS INTERFACE s_axilite port=output bundle=control
+#pragma HLS INTERFACE s_axilite port=output_len bundle=control
+#pragma HLS INTERFACE s_axilite port=mode bundle=control
+#pragma HLS INTERFACE s_axilite port=return bundle=control
+
+    uint32_t rate;
+    uint32_t digest = 0;  // 0 = extendable output
+    uint8_t domain = SHA3_DOMAIN;
+    switch (mode) {
+        case SHA3_MODE_224: rate = SHA3_224_RATE; digest = SHA3_224_HASH_SIZE; break;
+        case SHA3_MODE_384: rate = SHA3_384_RATE; digest = SHA3_384_HASH_SIZE; break;
+        case SHA3_MODE_512: rate = SHA3_512_RATE; digest = SHA3_512_HASH_SIZE; break;
+        case SHAKE_MODE_128: rate = SHAKE128_RATE; domain = SHAKE_DOMAIN; break;
+        case SHAKE_MODE_256: rate = SHAKE256_RATE; domain = SHAKE_DOMAIN; break;
+        default: rate = SHA3_256_RATE; digest = SHA3_256_HASH_SIZE; break;
+    }
+    if (digest != 0 && output_len > digest) {
+        output_len = digest;
+    }
+
+    keccak_state_t state;
+#pragma HLS ARRAY_PARTITION variable=state complete
+    INIT_LOOP: for (int i = 0; i < KECCAK_STATE_SIZE; i++) {
+#pragma HLS UNROLL
+        state[i] = 0;
+    }
+
+    sponge_absorb(state, message, message_len, rate, domain);
+    sponge_squeeze(state, output, output_len, rate);
+}
+
+// Streaming absorb with state import/export
+void sha3_update(
+    const uint8_t *input,
+    uint64_t *state_io,
+    uint32_t num_blocks,
+    uint32_t rate,
+    uint8_t *output,
+    uint32_t output_len
+) {
+#pragma HLS INTERFACE m_axi port=input depth=4096 offset=slave bundle=gmem0
+#pragma HLS INTERFACE m_axi port=state_io depth=25 offset=slave bundle=gmem1
+#pragma HLS INTERFACE m_axi port=output depth=512 offset=slave bundle=gmem1
+#pragma HLS INTERFACE s_axilite port=input bundle=control
+#pragma HLS INTERFACE s_axilite port=state_io bundle=control
+#pragma HLS INTERFACE s_axilite port=num_blocks bundle=control
+#pragma HLS INTERFACE s_axilite port=rate bundle=control
+#pragma HLS INTERFACE s_axilite port=output bundle=control
+#pragma HLS INTERFACE s_axilite port=output_len bundle=control
+#pragma HLS INTERFACE s_axilite port=return bundle=control
+
+    keccak_state_t state;
+#pragma HLS ARRAY_PARTITION variable=state complete
+
+    LOAD_STATE: for (int i = 0; i < KECCAK_STATE_SIZE; i++) {
+#pragma HLS PIPELINE II=1
+        state[i] = state_io[i];
+    }
+
+    UPDATE_BLOCK_LOOP: for (uint32_t block_idx = 0; block_idx < num_blocks; block_idx++) {
 #pragma HLS PIPELINE off
-        
-        // Copy block from input
-        COPY_BLOCK_LOOP: for (int i = 0; i < SHA3_256_RATE; i++) {
+
+        UPDATE_ABSORB: for (uint32_t w = 0; w < rate / 8; w++) {
+            uint64_t word = 0;
+
+            UPDATE_BYTES: for (int j = 0; j < 8; j++) {
 #pragma HLS PIPELINE II=1
-            if (processed + i < message_len) {
-                block[i] = message[processed + i];
-            } else {
-                block[i] = 0;
-            }
-        }
-        
-        // Add simple padding for the last block
-        if (block_idx == num_blocks - 1) {
-            // Simplified padding: just add 0x80 at message end
-            if (message_len % SHA3_256_RATE < SHA3_256_RATE) {
-                block[message_len % SHA3_256_RATE] = 0x80;
+                word |= ((uint64_t)input[block_idx * rate + w * 8 + j]) << (j * 8);
             }
+
+            state[w] ^= word;
         }
-        
-        // Absorb the block
-        absorb_block(state, block);
-        processed += SHA3_256_RATE;
+
+        keccak_f1600<KECCAK_UNROLL>(state);
     }
-    
-    // Extract hash (squeeze phase) - simplified
-    EXTRACT_LOOP: for (int i = 0; i < SHA3_256_HASH_SIZE; i++) {
+
+    STORE_STATE: for (int i = 0; i < KECCAK_STATE_SIZE; i++) {
 #pragma HLS PIPELINE II=1
-        int word_idx = i / 8;
-        int byte_idx = i % 8;
-        if (word_idx < KECCAK_STATE_SIZE) {
-            hash[i] = (uint8_t)(state[word_idx] >> (byte_idx * 8));
-        } else {
-            hash[i] = 0;
-        }
+        state_io[i] = state[i];
     }
-}
\ No newline at end of file
+
+    sponge_squeeze(state, output, output_len, rate);
+}
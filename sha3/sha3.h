@@ -5,10 +5,44 @@
 
 #define KECCAK_ROUNDS 24
 #define KECCAK_STATE_SIZE 25
+#define KECCAK_STATE_BYTES 200
 #define SHA3_256_RATE 136  // 1088 bits / 8 = 136 bytes
 #define SHA3_256_CAPACITY 64  // 512 bits / 8 = 64 bytes
 #define SHA3_256_HASH_SIZE 32  // 256 bits / 8 = 32 bytes
-#define MAX_MESSAGE_SIZE 1024  // Maximum input message size in bytes
+#define MAX_MESSAGE_SIZE 1024  // One-shot kernels; larger inputs stream through sha3_update
+
+// Rates (block sizes) in bytes: 200 - 2 * security bytes
+#define SHA3_224_RATE 144
+#define SHA3_384_RATE 104
+#define SHA3_512_RATE 72
+#define SHAKE128_RATE 168
+#define SHAKE256_RATE 136
+#define SHA3_MAX_RATE SHAKE128_RATE
+
+#define SHA3_224_HASH_SIZE 28
+#define SHA3_384_HASH_SIZE 48
+#define SHA3_512_HASH_SIZE 64
+
+// Domain separation suffixes (with the first padding bit)
+#define SHA3_DOMAIN 0x06
+#define SHAKE_DOMAIN 0x1F
+
+// Keccak rounds evaluated per loop iteration in the permutation: 1 gives
+// the smallest datapath, 24 a fully unrolled one. Must divide 24; set with
+// -DKECCAK_UNROLL=<n> to sweep area against throughput.
+#ifndef KECCAK_UNROLL
+#define KECCAK_UNROLL 1
+#endif
+
+// sha3_hash modes
+enum sha3_mode {
+    SHA3_MODE_224 = 0,
+    SHA3_MODE_256 = 1,
+    SHA3_MODE_384 = 2,
+    SHA3_MODE_512 = 3,
+    SHAKE_MODE_128 = 4,
+    SHAKE_MODE_256 = 5
+};
 
 typedef uint64_t keccak_state_t[KECCAK_STATE_SIZE];
 
@@ -17,8 +51,33 @@ extern "C" {
         const uint8_t *message,    // Input message
         uint32_t message_len,      // Message length in bytes
         uint8_t *hash,             // Output hash (32 bytes)
-        uint32_t num_blocks        // Number of message blocks to process
+        uint32_t num_blocks        // Unused: the block count follows from message_len
+    );
+
+    // Any FIPS 202 function. SHA3 modes write their digest size (output_len
+    // is clamped to it); SHAKE modes squeeze output_len bytes.
+    void sha3_hash(
+        const uint8_t *message,
+        uint32_t message_len,
+        uint8_t *output,
+        uint32_t output_len,
+        uint32_t mode              // sha3_mode
+    );
+
+    // Streaming sponge. Imports the 25-word state from state_io, absorbs
+    // num_blocks full rate-byte blocks, and writes the state back, so a
+    // message of any length is absorbed over many launches. The host pads
+    // the final block (domain suffix and 0x80) itself; when output_len is
+    // nonzero the kernel then squeezes output_len bytes into output. The
+    // exported state is the one before squeezing.
+    void sha3_update(
+        const uint8_t *input,
+        uint64_t *state_io,        // KECCAK_STATE_SIZE words, in and out
+        uint32_t num_blocks,
+        uint32_t rate,             // Bytes per block, a multiple of 8
+        uint8_t *output,
+        uint32_t output_len
     );
 }
 
-#endif // _SHA3_H_
\ No newline at end of file
+#endif // _SHA3_H_
@@ -5,21 +5,9 @@
 #include <cstring>
 #include <cstdlib>
 #include <fstream>
-
-#define SHA256_BLOCK_SIZE 64
-#define SHA256_DIGEST_SIZE 32
-
-// SHA-256 Constants
-static const uint32_t K[64] = {
-    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
-    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
-    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
-    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
-    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
-    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
-    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
-    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
-};
+#include <immintrin.h>
+#include "../common/cpu_features.h"
+#include "../common/sha256_cpu.h"
 
 class SHA256CPU {
 private:
@@ -200,6 +188,212 @@ public:
     }
 };
 
+#define FAST_ROTR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+static void sha256_blocks_scalar(uint32_t state[8], const uint8_t* data, size_t num_blocks) {
+    for (size_t blk = 0; blk < num_blocks; blk++, data += SHA256_BLOCK_SIZE) {
+        uint32_t W[64];
+        for (int t = 0; t < 16; t++) {
+            W[t] = load_be32(data + t * 4);
+        }
+        for (int t = 16; t < 64; t++) {
+            uint32_t s0 = FAST_ROTR(W[t-15], 7) ^ FAST_ROTR(W[t-15], 18) ^ (W[t-15] >> 3);
+            uint32_t s1 = FAST_ROTR(W[t-2], 17) ^ FAST_ROTR(W[t-2], 19) ^ (W[t-2] >> 10);
+            W[t] = s1 + W[t-7] + s0 + W[t-16];
+        }
+
+        uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+        uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+        for (int t = 0; t < 64; t++) {
+            uint32_t T1 = h + (FAST_ROTR(e, 6) ^ FAST_ROTR(e, 11) ^ FAST_ROTR(e, 25)) + ((e & f) ^ (~e & g)) + K[t] + W[t];
+            uint32_t T2 = (FAST_ROTR(a, 2) ^ FAST_ROTR(a, 13) ^ FAST_ROTR(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+            h = g; g = f; f = e; e = d + T1;
+            d = c; c = b; b = a; a = T1 + T2;
+        }
+
+        state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+        state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+    }
+}
+
+// Single-stream SHA-NI compression. The extension keeps the state as the
+// register pair ABEF/CDGH and retires two rounds per sha256rnds2.
+__attribute__((target("sha,sse4.1")))
+static void sha256_blocks_shani(uint32_t state[8], const uint8_t* data, size_t num_blocks) {
+    const __m128i BSWAP = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+    __m128i tmp = _mm_loadu_si128((const __m128i*)&state[0]);
+    __m128i state1 = _mm_loadu_si128((const __m128i*)&state[4]);
+    tmp = _mm_shuffle_epi32(tmp, 0xB1);                      // CDAB
+    state1 = _mm_shuffle_epi32(state1, 0x1B);                // EFGH
+    __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);        // ABEF
+    state1 = _mm_blend_epi16(state1, tmp, 0xF0);             // CDGH
+
+    for (size_t blk = 0; blk < num_blocks; blk++, data += SHA256_BLOCK_SIZE) {
+        __m128i abef_save = state0;
+        __m128i cdgh_save = state1;
+        __m128i M[4];
+
+#pragma GCC unroll 16
+        for (int g = 0; g < 16; g++) {
+            if (g < 4) {
+                M[g] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + g * 16)), BSWAP);
+            } else {
+                __m128i t = _mm_sha256msg1_epu32(M[g & 3], M[(g + 1) & 3]);
+                t = _mm_add_epi32(t, _mm_alignr_epi8(M[(g + 3) & 3], M[(g + 2) & 3], 4));
+                M[g & 3] = _mm_sha256msg2_epu32(t, M[(g + 3) & 3]);
+            }
+            __m128i msg = _mm_add_epi32(M[g & 3], _mm_loadu_si128((const __m128i*)&K[g * 4]));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+            msg = _mm_shuffle_epi32(msg, 0x0E);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, msg);
+        }
+
+        state0 = _mm_add_epi32(state0, abef_save);
+        state1 = _mm_add_epi32(state1, cdgh_save);
+    }
+
+    tmp = _mm_shuffle_epi32(state0, 0x1B);                   // FEBA
+    state1 = _mm_shuffle_epi32(state1, 0xB1);                // DCHG
+    state0 = _mm_blend_epi16(tmp, state1, 0xF0);             // DCBA
+    state1 = _mm_alignr_epi8(state1, tmp, 8);                // HGFE
+    _mm_storeu_si128((__m128i*)&state[0], state0);
+    _mm_storeu_si128((__m128i*)&state[4], state1);
+}
+
+// Single large messages: SHA-NI when the CPU has it, scalar otherwise
+class SHA256FastCPU {
+private:
+    bool use_shani;
+
+    void compress(uint32_t state[8], const uint8_t* data, size_t num_blocks) const {
+        if (use_shani) {
+            sha256_blocks_shani(state, data, num_blocks);
+        } else {
+            sha256_blocks_scalar(state, data, num_blocks);
+        }
+    }
+
+public:
+    explicit SHA256FastCPU(bool allow_shani = true) : use_shani(allow_shani && cpu_has_sha()) {}
+
+    const char* engineName() const { return use_shani ? "SHA-NI" : "scalar"; }
+
+    void hash(const uint8_t* message, size_t msg_len, uint8_t* hash_out) const {
+        uint32_t state[8];
+        memcpy(state, SHA256_H0, sizeof(state));
+
+        size_t full_blocks = msg_len / SHA256_BLOCK_SIZE;
+        compress(state, message, full_blocks);
+
+        uint8_t last[128];
+        size_t tail_len = msg_len - full_blocks * SHA256_BLOCK_SIZE;
+        size_t last_blocks = build_final_blocks(message + full_blocks * SHA256_BLOCK_SIZE, tail_len, msg_len, last);
+        compress(state, last, last_blocks);
+
+        for (int i = 0; i < 8; i++) {
+            store_be32(hash_out + i * 4, state[i]);
+        }
+    }
+};
+
+// Many independent messages: eight AVX2 lanes, each refilled with the next
+// queued message as soon as its current one finishes, so short and long
+// messages can share a batch without idling lanes until the longest ends.
+class SHA256MultiBufferCPU {
+private:
+    bool use_avx2;
+    SHA256FastCPU single;
+
+    struct Lane {
+        bool active = false;
+        size_t msg = 0;
+        size_t block = 0;
+        size_t full_blocks = 0;
+        size_t total_blocks = 0;
+        uint8_t last[128];
+    };
+
+    // Lanes are refilled one at a time, so their states are kept as columns
+    __attribute__((target("avx2")))
+    static void compressColumns(uint32_t state[8][MB_LANES], const uint32_t words[16][MB_LANES]) {
+        __m256i s[8];
+        for (int i = 0; i < 8; i++) {
+            s[i] = _mm256_loadu_si256((const __m256i*)state[i]);
+        }
+        sha256_compress_x8(s, words);
+        for (int i = 0; i < 8; i++) {
+            _mm256_storeu_si256((__m256i*)state[i], s[i]);
+        }
+    }
+
+public:
+    SHA256MultiBufferCPU() : use_avx2(cpu_has_avx2()) {}
+
+    const char* engineName() const { return use_avx2 ? "AVX2 x8 multi-buffer" : "single-stream fallback"; }
+
+    void hashBatch(const uint8_t* const* messages, const size_t* lengths, size_t count, uint8_t* digests) const {
+        if (!use_avx2) {
+            for (size_t i = 0; i < count; i++) {
+                single.hash(messages[i], lengths[i], digests + i * SHA256_DIGEST_SIZE);
+            }
+            return;
+        }
+
+        Lane lanes[MB_LANES];
+        uint32_t state[8][MB_LANES];
+        uint32_t words[16][MB_LANES];
+        size_t next = 0;
+        size_t done = 0;
+
+        while (done < count) {
+            for (int l = 0; l < MB_LANES; l++) {
+                Lane& lane = lanes[l];
+                if (!lane.active && next < count) {
+                    lane.active = true;
+                    lane.msg = next++;
+                    lane.block = 0;
+                    lane.full_blocks = lengths[lane.msg] / SHA256_BLOCK_SIZE;
+                    size_t tail = lengths[lane.msg] - lane.full_blocks * SHA256_BLOCK_SIZE;
+                    lane.total_blocks = lane.full_blocks +
+                        build_final_blocks(messages[lane.msg] + lane.full_blocks * SHA256_BLOCK_SIZE,
+                                           tail, lengths[lane.msg], lane.last);
+                    for (int i = 0; i < 8; i++) {
+                        state[i][l] = SHA256_H0[i];
+                    }
+                }
+
+                // Transpose this lane's next block into column l
+                if (lane.active) {
+                    const uint8_t* src = (lane.block < lane.full_blocks)
+                        ? messages[lane.msg] + lane.block * SHA256_BLOCK_SIZE
+                        : lane.last + (lane.block - lane.full_blocks) * SHA256_BLOCK_SIZE;
+                    for (int t = 0; t < 16; t++) {
+                        words[t][l] = load_be32(src + t * 4);
+                    }
+                } else {
+                    for (int t = 0; t < 16; t++) {
+                        words[t][l] = 0;
+                    }
+                }
+            }
+
+            compressColumns(state, words);
+
+            for (int l = 0; l < MB_LANES; l++) {
+                Lane& lane = lanes[l];
+                if (lane.active && ++lane.block == lane.total_blocks) {
+                    for (int i = 0; i < 8; i++) {
+                        store_be32(digests + lane.msg * SHA256_DIGEST_SIZE + i * 4, state[i][l]);
+                    }
+                    lane.active = false;
+                    done++;
+                }
+            }
+        }
+    }
+};
+
 void printHash(const std::string& label, const uint8_t* hash) {
     std::cout << label << ": ";
     for (int i = 0; i < SHA256_DIGEST_SIZE; i++) {
@@ -315,6 +509,133 @@ void runStressTest(SHA256CPU& sha) {
     std::cout << "Average throughput: " << avg_throughput << " MB/s" << std::endl;
 }
 
+// Fast engines must agree with the baseline for every padding boundary
+bool runFastEngineVerification(SHA256CPU& sha) {
+    std::cout << "\n=== Fast Engine Verification ===" << std::endl;
+
+    SHA256FastCPU fast;
+    SHA256MultiBufferCPU mb;
+    std::cout << "Single-stream engine: " << fast.engineName() << std::endl;
+    std::cout << "Multi-message engine: " << mb.engineName() << std::endl;
+
+    const size_t num_msgs = 301;  // Lengths 0..300 cover 1-6 blocks and both padding cases
+    std::vector<std::vector<uint8_t>> messages(num_msgs);
+    std::vector<const uint8_t*> ptrs(num_msgs);
+    std::vector<size_t> lengths(num_msgs);
+    for (size_t m = 0; m < num_msgs; m++) {
+        messages[m].resize(m);
+        for (size_t i = 0; i < m; i++) {
+            messages[m][i] = rand() & 0xFF;
+        }
+        ptrs[m] = messages[m].data();
+        lengths[m] = m;
+    }
+
+    std::vector<uint8_t> batch(num_msgs * SHA256_DIGEST_SIZE);
+    mb.hashBatch(ptrs.data(), lengths.data(), num_msgs, batch.data());
+
+    // The baseline prints timing per call; silence it for this sweep
+    std::streambuf* saved = std::cout.rdbuf(nullptr);
+    int mismatches = 0;
+    for (size_t m = 0; m < num_msgs; m++) {
+        uint8_t expected[SHA256_DIGEST_SIZE];
+        uint8_t single[SHA256_DIGEST_SIZE];
+        sha.hash(ptrs[m], lengths[m], expected);
+        fast.hash(ptrs[m], lengths[m], single);
+        if (memcmp(expected, single, SHA256_DIGEST_SIZE) != 0 ||
+            memcmp(expected, &batch[m * SHA256_DIGEST_SIZE], SHA256_DIGEST_SIZE) != 0) {
+            mismatches++;
+        }
+    }
+    std::cout.rdbuf(saved);
+
+    std::cout << "Messages checked: " << num_msgs << " (0-300 bytes)" << std::endl;
+    std::cout << (mismatches == 0 ? "✓ PASSED" : "✗ FAILED") << std::endl;
+    return mismatches == 0;
+}
+
+void runFastEngineBenchmark(SHA256CPU& sha) {
+    std::cout << "\n=== Fast Engine Benchmark ===" << std::endl;
+
+    SHA256FastCPU fast;
+    SHA256FastCPU scalar(false);
+    SHA256MultiBufferCPU mb;
+    std::cout << std::setfill(' ');
+
+    // Single large message: baseline vs in-place padding on the fast engine
+    {
+        const size_t size = 64 * 1024 * 1024;
+        std::vector<uint8_t> message(size);
+        for (size_t i = 0; i < size; i++) {
+            message[i] = rand() & 0xFF;
+        }
+        uint8_t hash[SHA256_DIGEST_SIZE];
+
+        std::streambuf* saved = std::cout.rdbuf(nullptr);
+        auto start = std::chrono::high_resolution_clock::now();
+        sha.hash(message.data(), size, hash);
+        auto end = std::chrono::high_resolution_clock::now();
+        std::cout.rdbuf(saved);
+        double base_sec = std::chrono::duration<double>(end - start).count();
+
+        double mb_total = (double)size / (1024.0 * 1024.0);
+        std::cout << "\nSingle " << (size >> 20) << " MB message:" << std::endl;
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "  Baseline:           " << mb_total / base_sec << " MB/s" << std::endl;
+
+        const SHA256FastCPU* engines[] = {&scalar, &fast};
+        for (const SHA256FastCPU* engine : engines) {
+            start = std::chrono::high_resolution_clock::now();
+            engine->hash(message.data(), size, hash);
+            end = std::chrono::high_resolution_clock::now();
+            double sec = std::chrono::duration<double>(end - start).count();
+            std::cout << "  " << std::left << std::setw(20) << (std::string(engine->engineName()) + " in-place:")
+                      << std::right << mb_total / sec << " MB/s (" << base_sec / sec << "x)" << std::endl;
+        }
+    }
+
+    // Many independent messages: one-at-a-time vs 8-lane multi-buffer
+    const size_t msg_sizes[] = {64, 4096};
+    for (size_t size : msg_sizes) {
+        const size_t count = (size <= 64) ? 200000 : 8192;
+        std::vector<uint8_t> data(count * size);
+        for (size_t i = 0; i < data.size(); i++) {
+            data[i] = rand() & 0xFF;
+        }
+        std::vector<const uint8_t*> ptrs(count);
+        std::vector<size_t> lengths(count, size);
+        for (size_t m = 0; m < count; m++) {
+            ptrs[m] = &data[m * size];
+        }
+        std::vector<uint8_t> digests(count * SHA256_DIGEST_SIZE);
+
+        double mb_total = (double)(count * size) / (1024.0 * 1024.0);
+        std::cout << "\n" << count << " messages of " << size << " bytes:" << std::endl;
+        std::cout << std::fixed << std::setprecision(2);
+
+        const SHA256FastCPU* engines[] = {&scalar, &fast};
+        for (const SHA256FastCPU* engine : engines) {
+            auto start = std::chrono::high_resolution_clock::now();
+            for (size_t m = 0; m < count; m++) {
+                engine->hash(ptrs[m], size, &digests[m * SHA256_DIGEST_SIZE]);
+            }
+            auto end = std::chrono::high_resolution_clock::now();
+            double sec = std::chrono::duration<double>(end - start).count();
+            std::cout << "  " << std::left << std::setw(22) << (std::string(engine->engineName()) + " loop:")
+                      << std::right << mb_total / sec << " MB/s, "
+                      << (double)count / sec << " hashes/s" << std::endl;
+        }
+
+        auto start = std::chrono::high_resolution_clock::now();
+        mb.hashBatch(ptrs.data(), lengths.data(), count, digests.data());
+        auto end = std::chrono::high_resolution_clock::now();
+        double batch_sec = std::chrono::duration<double>(end - start).count();
+        std::cout << "  " << std::left << std::setw(22) << (std::string(mb.engineName()) + ":")
+                  << std::right << mb_total / batch_sec << " MB/s, "
+                  << (double)count / batch_sec << " hashes/s" << std::endl;
+    }
+}
+
 void runBenchmarkComparison() {
     std::cout << "\n=== Benchmark Summary ===" << std::endl;
     std::cout << "CPU Implementation: SHA-256 Hashing" << std::endl;
@@ -327,6 +648,8 @@ void runBenchmarkComparison() {
     std::cout << "- Note latency differences in microseconds" << std::endl;
     std::cout << "- FPGA advantages: Pipelined message schedule and compression" << std::endl;
     std::cout << "- FPGA optimizations: II=1 for inner loops, II=64 for blocks" << std::endl;
+    std::cout << "- CPU fast paths: SHA-NI for single streams, AVX2 8-lane multi-buffer for" << std::endl;
+    std::cout << "  many messages; compare the latter against the batched FPGA kernel" << std::endl;
 }
 
 int main(int argc, char* argv[]) {
@@ -342,6 +665,11 @@ int main(int argc, char* argv[]) {
         runTestVectors(sha);
         runPerformanceTest(sha);
         runStressTest(sha);
+        if (!runFastEngineVerification(sha)) {
+            std::cerr << "Fast engine verification failed" << std::endl;
+            return 1;
+        }
+        runFastEngineBenchmark(sha);
         runBenchmarkComparison();
         
         std::cout << "\n=== All tests completed successfully! ===" << std::endl;
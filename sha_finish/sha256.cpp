@@ -18,6 +18,20 @@ const uint32_t H0[8] = {
     0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
 };
 
+// K[t] + W[t] for the padding block of a 64-byte message (0x80, zeros,
+// bit length 512). That block is identical for every Merkle node, so its
+// schedule is folded into the round constants instead of being expanded.
+static const uint32_t PAD64_WK[64] = {
+    0xc28a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf374,
+    0x649b69c1, 0xf0fe4786, 0x0fe1edc6, 0x240cf254, 0x4fe9346f, 0x6cc984be, 0x61b9411e, 0x16f988fa,
+    0xf2c65152, 0xa88e5a6d, 0xb019fc65, 0xb9d99ec7, 0x9a1231c3, 0xe70eeaa0, 0xfdb1232b, 0xc7353eb0,
+    0x3069bad5, 0xcb976d5f, 0x5a0f118f, 0xdc1eeefd, 0x0a35b689, 0xde0b7a04, 0x58f4ca9d, 0xe15d5b16,
+    0x007f3e86, 0x37088980, 0xa507ea32, 0x6fab9537, 0x17406110, 0x0d8cd6f1, 0xcdaa3b6d, 0xc0bbbe37,
+    0x83613bda, 0xdb48a363, 0x0b02e931, 0x6fd15ca7, 0x521afaca, 0x31338431, 0x6ed41a95, 0x6d437890,
+    0xc39c91f2, 0x9eccabbd, 0xb5c9a0e6, 0x532fb63c, 0xd2c741c6, 0x07237ea3, 0xa4954b68, 0x4c191d76
+};
+
 // Convert big-endian bytes to 32-bit word
 static uint32_t bytes_to_word(const uint8_t *bytes) {
 #pragma HLS INLINE
@@ -161,4 +175,348 @@ void sha256_hash(const uint8_t *input, uint8_t *output, int num_blocks) {
 #pragma HLS UNROLL
         word_to_bytes(state[i], &output[i * 4]);
     }
-}
\ No newline at end of file
+}
+// Resumable SHA-256: absorbs num_blocks full blocks into the chaining
+// state held in state_io (8 words, read at start and written back at the
+// end). The host initializes state_io with H0, streams arbitrarily long
+// input through repeated launches and pads only the final chunk itself.
+void sha256_update(const uint8_t *input, uint32_t *state_io, int num_blocks) {
+#pragma HLS INTERFACE m_axi port=input depth=4096 offset=slave bundle=gmem0
+#pragma HLS INTERFACE m_axi port=state_io depth=8 offset=slave bundle=gmem1
+#pragma HLS INTERFACE s_axilite port=input bundle=control
+#pragma HLS INTERFACE s_axilite port=state_io bundle=control
+#pragma HLS INTERFACE s_axilite port=num_blocks bundle=control
+#pragma HLS INTERFACE s_axilite port=return bundle=control
+
+    uint32_t state[8];
+#pragma HLS ARRAY_PARTITION variable=state complete
+    
+    LOAD_STATE: for (int i = 0; i < 8; i++) {
+#pragma HLS PIPELINE II=1
+        state[i] = state_io[i];
+    }
+    
+    UPDATE_BLOCK_LOOP: for (int block = 0; block < num_blocks; block++) {
+#pragma HLS PIPELINE II=64
+        
+        uint8_t block_data[64];
+#pragma HLS ARRAY_PARTITION variable=block_data cyclic factor=8
+        
+        UPDATE_LOAD_BLOCK: for (int i = 0; i < 64; i++) {
+#pragma HLS PIPELINE II=1
+            block_data[i] = input[block * 64 + i];
+        }
+        
+        process_block(state, block_data);
+    }
+    
+    STORE_STATE: for (int i = 0; i < 8; i++) {
+#pragma HLS PIPELINE II=1
+        state_io[i] = state[i];
+    }
+}
+
+// Build padded block `blk` of a message of `len` bytes starting at `base`.
+// Padding (0x80, zeros, 64-bit big-endian bit length) is generated here so
+// the host can pass messages back to back without reformatting them.
+static void load_padded_block(const uint8_t *input, uint32_t base, uint32_t len,
+                              uint32_t blk, uint32_t num_blocks, uint32_t M[16]) {
+#pragma HLS INLINE off
+    uint64_t bit_len = (uint64_t)len * 8;
+
+    PAD_WORD_LOOP: for (int w = 0; w < 16; w++) {
+        uint32_t word = 0;
+        PAD_BYTE_LOOP: for (int j = 0; j < 4; j++) {
+#pragma HLS PIPELINE II=1
+            uint32_t pos = blk * SHA256_BLOCK_SIZE + w * 4 + j;
+            uint8_t byte;
+            if (pos < len) {
+                byte = input[base + pos];
+            } else if (pos == len) {
+                byte = 0x80;
+            } else if (blk == num_blocks - 1 && w >= 14) {
+                byte = (bit_len >> (8 * (7 - ((w - 14) * 4 + j)))) & 0xFF;
+            } else {
+                byte = 0x00;
+            }
+            word = (word << 8) | byte;
+        }
+        M[w] = word;
+    }
+}
+
+// 64 rounds for every lane of an interleave group, one (round, lane) pair
+// per cycle, with the schedule kept as a 16-word window per lane. With
+// pad64 the block is the constant padding block of a 64-byte message and
+// each round's W+K comes from PAD64_WK instead of W.
+static void interleaved_rounds(uint32_t work[SHA256_BATCH_LANES][8], uint32_t W[SHA256_BATCH_LANES][16],
+                               bool pad64) {
+#pragma HLS INLINE
+    LANE_ROUND_LOOP: for (int t = 0; t < SHA256_ROUNDS; t++) {
+        LANE_LOOP: for (int l = 0; l < SHA256_BATCH_LANES; l++) {
+#pragma HLS PIPELINE II=1
+#pragma HLS DEPENDENCE variable=work inter distance=SHA256_BATCH_LANES true
+#pragma HLS DEPENDENCE variable=W inter distance=SHA256_BATCH_LANES true
+            uint32_t wk;
+            if (pad64) {
+                wk = PAD64_WK[t];
+            } else if (t < 16) {
+                wk = K[t] + W[l][t];
+            } else {
+                uint32_t w_t = sigma1(W[l][(t - 2) & 15]) + W[l][(t - 7) & 15] +
+                               sigma0(W[l][(t - 15) & 15]) + W[l][t & 15];
+                W[l][t & 15] = w_t;
+                wk = K[t] + w_t;
+            }
+
+            uint32_t a = work[l][0], b = work[l][1], c = work[l][2], d = work[l][3];
+            uint32_t e = work[l][4], f = work[l][5], g = work[l][6], h = work[l][7];
+
+            uint32_t T1 = h + SIGMA1(e) + CH(e, f, g) + wk;
+            uint32_t T2 = SIGMA0(a) + MAJ(a, b, c);
+
+            work[l][7] = g;
+            work[l][6] = f;
+            work[l][5] = e;
+            work[l][4] = d + T1;
+            work[l][3] = c;
+            work[l][2] = b;
+            work[l][1] = a;
+            work[l][0] = T1 + T2;
+        }
+    }
+}
+
+// Batched SHA-256 over an offset/length table. A single message's
+// compression chain is serial, so up to SHA256_BATCH_LANES messages are
+// hashed together and their rounds issued round-robin: consecutive pipeline
+// iterations belong to different messages and the loop-carried dependency
+// on each working state is SHA256_BATCH_LANES iterations apart.
+void sha256_hash_batch(const uint8_t *input, const uint32_t *msg_table, uint8_t *output, int num_messages) {
+#pragma HLS INTERFACE m_axi port=input depth=4096 offset=slave bundle=gmem0
+#pragma HLS INTERFACE m_axi port=msg_table depth=64 offset=slave bundle=gmem1
+#pragma HLS INTERFACE m_axi port=output depth=1024 offset=slave bundle=gmem2
+#pragma HLS INTERFACE s_axilite port=input bundle=control
+#pragma HLS INTERFACE s_axilite port=msg_table bundle=control
+#pragma HLS INTERFACE s_axilite port=output bundle=control
+#pragma HLS INTERFACE s_axilite port=num_messages bundle=control
+#pragma HLS INTERFACE s_axilite port=return bundle=control
+
+    uint32_t state[SHA256_BATCH_LANES][8];
+    uint32_t work[SHA256_BATCH_LANES][8];
+    uint32_t W[SHA256_BATCH_LANES][16];
+#pragma HLS ARRAY_PARTITION variable=state complete dim=2
+#pragma HLS ARRAY_PARTITION variable=work complete dim=2
+#pragma HLS ARRAY_PARTITION variable=W complete dim=2
+
+    uint32_t base[SHA256_BATCH_LANES];
+    uint32_t len[SHA256_BATCH_LANES];
+    uint32_t nblocks[SHA256_BATCH_LANES];
+
+    GROUP_LOOP: for (int group = 0; group < num_messages; group += SHA256_BATCH_LANES) {
+        int lanes = num_messages - group;
+        if (lanes > SHA256_BATCH_LANES) lanes = SHA256_BATCH_LANES;
+
+        // Read descriptors and reset chaining values
+        uint32_t max_blocks = 0;
+        DESC_LOOP: for (int l = 0; l < SHA256_BATCH_LANES; l++) {
+#pragma HLS PIPELINE II=2
+            if (l < lanes) {
+                base[l] = msg_table[(group + l) * SHA256_DESC_WORDS + 0];
+                len[l] = msg_table[(group + l) * SHA256_DESC_WORDS + 1];
+                nblocks[l] = (len[l] + 9 + SHA256_BLOCK_SIZE - 1) / SHA256_BLOCK_SIZE;
+            } else {
+                nblocks[l] = 0;
+            }
+            if (nblocks[l] > max_blocks) max_blocks = nblocks[l];
+            for (int i = 0; i < 8; i++) {
+                state[l][i] = H0[i];
+            }
+        }
+
+        BATCH_BLOCK_LOOP: for (uint32_t blk = 0; blk < max_blocks; blk++) {
+
+            // Stage the next padded block of every lane still running
+            BATCH_LOAD_LOOP: for (int l = 0; l < SHA256_BATCH_LANES; l++) {
+                if (blk < nblocks[l]) {
+                    load_padded_block(input, base[l], len[l], blk, nblocks[l], W[l]);
+                }
+                for (int i = 0; i < 8; i++) {
+#pragma HLS UNROLL
+                    work[l][i] = state[l][i];
+                }
+            }
+
+            interleaved_rounds(work, W, false);
+
+            BATCH_UPDATE_LOOP: for (int l = 0; l < SHA256_BATCH_LANES; l++) {
+#pragma HLS PIPELINE II=1
+                if (blk < nblocks[l]) {
+                    for (int i = 0; i < 8; i++) {
+                        state[l][i] += work[l][i];
+                    }
+                }
+            }
+        }
+
+        // Digest i lands at output[i * 32], whatever group it was hashed in
+        BATCH_OUTPUT_LOOP: for (int l = 0; l < SHA256_BATCH_LANES; l++) {
+            if (l < lanes) {
+                for (int i = 0; i < 8; i++) {
+#pragma HLS PIPELINE II=1
+                    word_to_bytes(state[l][i], &output[(group + l) * SHA256_DIGEST_SIZE + i * 4]);
+                }
+            }
+        }
+    }
+}
+
+// One Merkle level: parent i = SHA-256(children[64*i .. 64*i+63]). Each
+// parent is a two-block message; the first block is the child pair and
+// the second is the constant padding block, whose rounds use PAD64_WK.
+// Parents are interleaved across SHA256_BATCH_LANES lanes as in
+// sha256_hash_batch, but with fixed-size inputs there is no descriptor
+// table and every lane runs the same number of blocks.
+void sha256_merkle_level(const uint8_t *children, uint8_t *parents, int num_parents) {
+#pragma HLS INTERFACE m_axi port=children depth=4096 offset=slave bundle=gmem0
+#pragma HLS INTERFACE m_axi port=parents depth=2048 offset=slave bundle=gmem1
+#pragma HLS INTERFACE s_axilite port=children bundle=control
+#pragma HLS INTERFACE s_axilite port=parents bundle=control
+#pragma HLS INTERFACE s_axilite port=num_parents bundle=control
+#pragma HLS INTERFACE s_axilite port=return bundle=control
+
+    uint32_t state[SHA256_BATCH_LANES][8];
+    uint32_t work[SHA256_BATCH_LANES][8];
+    uint32_t W[SHA256_BATCH_LANES][16];
+#pragma HLS ARRAY_PARTITION variable=state complete dim=2
+#pragma HLS ARRAY_PARTITION variable=work complete dim=2
+#pragma HLS ARRAY_PARTITION variable=W complete dim=2
+
+    NODE_GROUP_LOOP: for (int group = 0; group < num_parents; group += SHA256_BATCH_LANES) {
+        int lanes = num_parents - group;
+        if (lanes > SHA256_BATCH_LANES) lanes = SHA256_BATCH_LANES;
+
+        // Load each lane's child pair as its first block
+        NODE_LOAD_LOOP: for (int l = 0; l < SHA256_BATCH_LANES; l++) {
+            NODE_WORD_LOOP: for (int w = 0; w < 16; w++) {
+#pragma HLS PIPELINE II=1
+                W[l][w] = (l < lanes) ? bytes_to_word(&children[(group + l) * SHA256_NODE_INPUT_SIZE + w * 4]) : 0;
+            }
+            for (int i = 0; i < 8; i++) {
+#pragma HLS UNROLL
+                state[l][i] = H0[i];
+                work[l][i] = H0[i];
+            }
+        }
+
+        NODE_BLOCK_LOOP: for (int blk = 0; blk < 2; blk++) {
+            // The second block is the padding block
+            interleaved_rounds(work, W, blk == 1);
+
+            NODE_UPDATE_LOOP: for (int l = 0; l < SHA256_BATCH_LANES; l++) {
+#pragma HLS PIPELINE II=1
+                for (int i = 0; i < 8; i++) {
+                    state[l][i] += work[l][i];
+                    work[l][i] = state[l][i];
+                }
+            }
+        }
+
+        NODE_OUTPUT_LOOP: for (int l = 0; l < SHA256_BATCH_LANES; l++) {
+            if (l < lanes) {
+                for (int i = 0; i < 8; i++) {
+#pragma HLS PIPELINE II=1
+                    word_to_bytes(state[l][i], &parents[(group + l) * SHA256_DIGEST_SIZE + i * 4]);
+                }
+            }
+        }
+    }
+}
+
+// PBKDF2-HMAC-SHA256, iterations 2..c of one derived block per job. The
+// host precomputes each key's ipad/opad midstates and U1, so every
+// iteration is exactly two compressions: the 32-byte U_{j-1} padded as a
+// 96-byte message from the inner midstate, then the inner digest the same
+// way from the outer midstate. Jobs are serial within themselves, so
+// SHA256_BATCH_LANES of them advance in lock-step through the pipeline.
+// Output is T = U1 ^ ... ^ Uc as eight words per job.
+void sha256_pbkdf2_batch(const uint32_t *jobs, uint32_t *output, int num_jobs, int iterations) {
+#pragma HLS INTERFACE m_axi port=jobs depth=192 offset=slave bundle=gmem0
+#pragma HLS INTERFACE m_axi port=output depth=64 offset=slave bundle=gmem1
+#pragma HLS INTERFACE s_axilite port=jobs bundle=control
+#pragma HLS INTERFACE s_axilite port=output bundle=control
+#pragma HLS INTERFACE s_axilite port=num_jobs bundle=control
+#pragma HLS INTERFACE s_axilite port=iterations bundle=control
+#pragma HLS INTERFACE s_axilite port=return bundle=control
+
+    uint32_t inner[SHA256_BATCH_LANES][8];
+    uint32_t outer[SHA256_BATCH_LANES][8];
+    uint32_t U[SHA256_BATCH_LANES][8];
+    uint32_t T[SHA256_BATCH_LANES][8];
+    uint32_t work[SHA256_BATCH_LANES][8];
+    uint32_t W[SHA256_BATCH_LANES][16];
+#pragma HLS ARRAY_PARTITION variable=inner complete dim=2
+#pragma HLS ARRAY_PARTITION variable=outer complete dim=2
+#pragma HLS ARRAY_PARTITION variable=U complete dim=2
+#pragma HLS ARRAY_PARTITION variable=T complete dim=2
+#pragma HLS ARRAY_PARTITION variable=work complete dim=2
+#pragma HLS ARRAY_PARTITION variable=W complete dim=2
+
+    PBKDF2_GROUP_LOOP: for (int group = 0; group < num_jobs; group += SHA256_BATCH_LANES) {
+        int lanes = num_jobs - group;
+        if (lanes > SHA256_BATCH_LANES) lanes = SHA256_BATCH_LANES;
+
+        PBKDF2_LOAD_LOOP: for (int l = 0; l < SHA256_BATCH_LANES; l++) {
+            // Idle lanes rerun the group's last job and are never stored
+            int job = group + (l < lanes ? l : lanes - 1);
+            for (int i = 0; i < 8; i++) {
+#pragma HLS PIPELINE II=1
+                inner[l][i] = jobs[job * SHA256_PBKDF2_JOB_WORDS + i];
+                outer[l][i] = jobs[job * SHA256_PBKDF2_JOB_WORDS + 8 + i];
+                U[l][i] = jobs[job * SHA256_PBKDF2_JOB_WORDS + 16 + i];
+                T[l][i] = U[l][i];
+            }
+        }
+
+        PBKDF2_ITER_LOOP: for (int iter = 1; iter < iterations; iter++) {
+            PBKDF2_HALF_LOOP: for (int half = 0; half < 2; half++) {
+
+                // Block = U (or the inner digest) || 0x80 || zeros || 768-bit length
+                PBKDF2_BLOCK_LOOP: for (int l = 0; l < SHA256_BATCH_LANES; l++) {
+#pragma HLS PIPELINE II=1
+                    for (int i = 0; i < 8; i++) {
+                        W[l][i] = U[l][i];
+                        work[l][i] = (half == 0) ? inner[l][i] : outer[l][i];
+                    }
+                    W[l][8] = 0x80000000;
+                    for (int i = 9; i < 15; i++) {
+                        W[l][i] = 0;
+                    }
+                    W[l][15] = SHA256_HMAC_INNER_BITS;
+                }
+
+                interleaved_rounds(work, W, false);
+
+                // U holds the inner digest after the first half, U_j after the second
+                PBKDF2_FOLD_LOOP: for (int l = 0; l < SHA256_BATCH_LANES; l++) {
+#pragma HLS PIPELINE II=1
+                    for (int i = 0; i < 8; i++) {
+                        U[l][i] = work[l][i] + ((half == 0) ? inner[l][i] : outer[l][i]);
+                        if (half == 1) {
+                            T[l][i] ^= U[l][i];
+                        }
+                    }
+                }
+            }
+        }
+
+        PBKDF2_OUTPUT_LOOP: for (int l = 0; l < SHA256_BATCH_LANES; l++) {
+            if (l < lanes) {
+                for (int i = 0; i < 8; i++) {
+#pragma HLS PIPELINE II=1
+                    output[(group + l) * 8 + i] = T[l][i];
+                }
+            }
+        }
+    }
+}
@@ -7,6 +7,19 @@
 #define SHA256_DIGEST_SIZE 32 // 256 bits
 #define SHA256_ROUNDS 64
 
+// Batched hashing: independent messages whose compression rounds are
+// interleaved in the pipeline, and the per-message descriptor layout
+#define SHA256_BATCH_LANES 8   // Messages in flight per interleave group
+#define SHA256_DESC_WORDS 2    // {byte offset into input, byte length}
+
+// Merkle levels: every parent is SHA-256 of two concatenated child digests
+#define SHA256_NODE_INPUT_SIZE (2 * SHA256_DIGEST_SIZE)
+
+// PBKDF2-HMAC-SHA256 jobs: {inner (ipad) midstate[8], outer (opad)
+// midstate[8], U1[8]} per derived block, all as big-endian words
+#define SHA256_PBKDF2_JOB_WORDS 24
+#define SHA256_HMAC_INNER_BITS ((SHA256_BLOCK_SIZE + SHA256_DIGEST_SIZE) * 8)
+
 // SHA-256 Constants (first 32 bits of fractional parts of cube roots of first 64 primes)
 extern const uint32_t K[64];
 
@@ -26,6 +39,10 @@ extern const uint32_t H0[8];
 
 extern "C" {
     void sha256_hash(const uint8_t *input, uint8_t *output, int num_blocks);
+    void sha256_update(const uint8_t *input, uint32_t *state_io, int num_blocks);
+    void sha256_hash_batch(const uint8_t *input, const uint32_t *msg_table, uint8_t *output, int num_messages);
+    void sha256_merkle_level(const uint8_t *children, uint8_t *parents, int num_parents);
+    void sha256_pbkdf2_batch(const uint32_t *jobs, uint32_t *output, int num_jobs, int iterations);
 }
 
 #endif
\ No newline at end of file
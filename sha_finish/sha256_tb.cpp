@@ -37,6 +37,69 @@ void pad_message(const char* message, uint8_t* padded, int* num_blocks) {
     }
 }
 
+void word_to_bytes_tb(uint32_t word, uint8_t* bytes) {
+    bytes[0] = (word >> 24) & 0xFF;
+    bytes[1] = (word >> 16) & 0xFF;
+    bytes[2] = (word >> 8) & 0xFF;
+    bytes[3] = word & 0xFF;
+}
+
+// Finish a hash whose first `prior_bytes` (a multiple of 64) are already
+// absorbed into `state`, padding `msg` for the full length
+void sha256_continue(uint32_t state[8], const uint8_t* msg, size_t len, size_t prior_bytes) {
+    uint8_t padded[256];
+    size_t total_len = len + 1 + 8;
+    int num_blocks = (int)((total_len + 63) / 64);
+    memset(padded, 0, sizeof(padded));
+    memcpy(padded, msg, len);
+    padded[len] = 0x80;
+    uint64_t bit_len = (uint64_t)(prior_bytes + len) * 8;
+    for (int i = 0; i < 8; i++) {
+        padded[num_blocks * 64 - 8 + i] = (bit_len >> (56 - i * 8)) & 0xFF;
+    }
+    sha256_update(padded, state, num_blocks);
+}
+
+// PBKDF2 job words (ipad/opad midstates and U1) for block 1 of a key <= 64 bytes
+void pbkdf2_job(const char* password, const char* salt, uint32_t job[SHA256_PBKDF2_JOB_WORDS]) {
+    uint8_t ipad[64], opad[64];
+    size_t key_len = strlen(password);
+    for (int i = 0; i < 64; i++) {
+        uint8_t k = (i < (int)key_len) ? password[i] : 0;
+        ipad[i] = k ^ 0x36;
+        opad[i] = k ^ 0x5c;
+    }
+    for (int i = 0; i < 8; i++) {
+        job[i] = H0[i];
+        job[8 + i] = H0[i];
+    }
+    sha256_update(ipad, &job[0], 1);
+    sha256_update(opad, &job[8], 1);
+
+    // U1 = HMAC(P, S || INT(1))
+    uint8_t msg[128];
+    size_t salt_len = strlen(salt);
+    memcpy(msg, salt, salt_len);
+    msg[salt_len + 0] = 0;
+    msg[salt_len + 1] = 0;
+    msg[salt_len + 2] = 0;
+    msg[salt_len + 3] = 1;
+
+    uint32_t inner[8], outer[8];
+    uint8_t inner_digest[32];
+    memcpy(inner, &job[0], sizeof(inner));
+    memcpy(outer, &job[8], sizeof(outer));
+    sha256_continue(inner, msg, salt_len + 4, 64);
+    for (int i = 0; i < 8; i++) {
+        inner_digest[i * 4 + 0] = (inner[i] >> 24) & 0xFF;
+        inner_digest[i * 4 + 1] = (inner[i] >> 16) & 0xFF;
+        inner_digest[i * 4 + 2] = (inner[i] >> 8) & 0xFF;
+        inner_digest[i * 4 + 3] = inner[i] & 0xFF;
+    }
+    sha256_continue(outer, inner_digest, 32, 64);
+    memcpy(&job[16], outer, sizeof(outer));
+}
+
 int main() {
     std::cout << "=== SHA-256 Hardware Accelerator Test ===" << std::endl;
     
@@ -104,6 +167,150 @@ int main() {
         print_hash(hash);
     }
     
+    // Test 5: Batched hashing with on-device padding
+    {
+        std::cout << "\nTest 5: Batched hashing (sha256_hash_batch)" << std::endl;
+        const int num_msgs = 11;  // More than one interleave group
+        const uint32_t lengths[num_msgs] = {0, 3, 43, 55, 56, 63, 64, 119, 120, 200, 1};
+
+        uint8_t input[1024];
+        uint32_t msg_table[num_msgs * SHA256_DESC_WORDS];
+        uint8_t digests[num_msgs * 32];
+        uint32_t offset = 0;
+
+        for (int m = 0; m < num_msgs; m++) {
+            msg_table[m * SHA256_DESC_WORDS + 0] = offset;
+            msg_table[m * SHA256_DESC_WORDS + 1] = lengths[m];
+            for (uint32_t i = 0; i < lengths[m]; i++) {
+                input[offset + i] = 'a' + (m + i) % 26;
+            }
+            offset += lengths[m];
+        }
+
+        sha256_hash_batch(input, msg_table, digests, num_msgs);
+
+        int mismatches = 0;
+        for (int m = 0; m < num_msgs; m++) {
+            char msg[256];
+            uint8_t padded[320];
+            uint8_t hash[32];
+            int num_blocks;
+
+            memcpy(msg, &input[msg_table[m * SHA256_DESC_WORDS]], lengths[m]);
+            msg[lengths[m]] = '\0';
+            pad_message(msg, padded, &num_blocks);
+            sha256_hash(padded, hash, num_blocks);
+
+            if (memcmp(hash, &digests[m * 32], 32) != 0) {
+                std::cout << "Mismatch for message " << m << " (" << lengths[m] << " bytes)" << std::endl;
+                mismatches++;
+            }
+        }
+
+        std::cout << "Batch digest for message 1: ";
+        print_hash(&digests[1 * 32]);
+        std::cout << "Batch vs single-message: " << (mismatches == 0 ? "✓ PASSED" : "✗ FAILED") << std::endl;
+        if (mismatches != 0) return 1;
+    }
+
+    // Test 6: Resumable state across several sha256_update launches
+    {
+        std::cout << "\nTest 6: Incremental hashing (sha256_update)" << std::endl;
+        const char* msg = "This is a longer message that will span multiple SHA-256 blocks to test the pipelined implementation."
+                          " It is absorbed one block per launch with the chaining state carried between calls.";
+        uint8_t padded[320];
+        uint8_t expected[32];
+        uint8_t hash[32];
+        int num_blocks;
+
+        pad_message(msg, padded, &num_blocks);
+        sha256_hash(padded, expected, num_blocks);
+
+        uint32_t state[8];
+        for (int i = 0; i < 8; i++) {
+            state[i] = H0[i];
+        }
+        for (int b = 0; b < num_blocks; b++) {
+            sha256_update(&padded[b * 64], state, 1);
+        }
+        for (int i = 0; i < 8; i++) {
+            hash[i * 4 + 0] = (state[i] >> 24) & 0xFF;
+            hash[i * 4 + 1] = (state[i] >> 16) & 0xFF;
+            hash[i * 4 + 2] = (state[i] >> 8) & 0xFF;
+            hash[i * 4 + 3] = state[i] & 0xFF;
+        }
+
+        std::cout << "Blocks: " << num_blocks << " (one launch each)" << std::endl;
+        std::cout << "Hash: ";
+        print_hash(hash);
+        bool match = memcmp(hash, expected, 32) == 0;
+        std::cout << "Incremental vs one-shot: " << (match ? "✓ PASSED" : "✗ FAILED") << std::endl;
+        if (!match) return 1;
+    }
+
+    // Test 7: One Merkle level of 2-to-1 compressions
+    {
+        std::cout << "\nTest 7: Merkle level (sha256_merkle_level)" << std::endl;
+        const int num_parents = 11;  // More than one interleave group
+        uint8_t children[num_parents * SHA256_NODE_INPUT_SIZE];
+        uint8_t parents[num_parents * 32];
+
+        for (int i = 0; i < num_parents * SHA256_NODE_INPUT_SIZE; i++) {
+            children[i] = (i * 131 + 7) & 0xFF;
+        }
+
+        sha256_merkle_level(children, parents, num_parents);
+
+        int mismatches = 0;
+        for (int p = 0; p < num_parents; p++) {
+            uint32_t msg_table[SHA256_DESC_WORDS] = {(uint32_t)(p * SHA256_NODE_INPUT_SIZE), SHA256_NODE_INPUT_SIZE};
+            uint8_t expected[32];
+            sha256_hash_batch(children, msg_table, expected, 1);
+            if (memcmp(expected, &parents[p * 32], 32) != 0) {
+                std::cout << "Mismatch for parent " << p << std::endl;
+                mismatches++;
+            }
+        }
+
+        std::cout << "Parent 0: ";
+        print_hash(parents);
+        std::cout << "Merkle level vs batch: " << (mismatches == 0 ? "✓ PASSED" : "✗ FAILED") << std::endl;
+        if (mismatches != 0) return 1;
+    }
+
+    // Test 8: PBKDF2-HMAC-SHA256 in lock-step lanes
+    {
+        std::cout << "\nTest 8: PBKDF2-HMAC-SHA256 (sha256_pbkdf2_batch)" << std::endl;
+        const int num_jobs = 9;  // More than one interleave group
+        uint32_t jobs[num_jobs * SHA256_PBKDF2_JOB_WORDS];
+        uint32_t T[num_jobs * 8];
+        uint8_t dk[32];
+
+        for (int j = 0; j < num_jobs; j++) {
+            pbkdf2_job("password", "salt", &jobs[j * SHA256_PBKDF2_JOB_WORDS]);
+        }
+        sha256_pbkdf2_batch(jobs, T, num_jobs, 4096);
+
+        // RFC 7914-style vector: P="password", S="salt", c=4096, dkLen=32
+        const uint8_t expected[32] = {
+            0xc5, 0xe4, 0x78, 0xd5, 0x92, 0x88, 0xc8, 0x41, 0xaa, 0x53, 0x0d, 0xb6, 0x84, 0x5c, 0x4c, 0x8d,
+            0x96, 0x28, 0x93, 0xa0, 0x01, 0xce, 0x4e, 0x11, 0xa4, 0x96, 0x38, 0x73, 0xaa, 0x98, 0x13, 0x4a
+        };
+        int mismatches = 0;
+        for (int j = 0; j < num_jobs; j++) {
+            for (int i = 0; i < 8; i++) {
+                word_to_bytes_tb(T[j * 8 + i], &dk[i * 4]);
+            }
+            if (memcmp(dk, expected, 32) != 0) mismatches++;
+        }
+
+        std::cout << "DK: ";
+        print_hash(dk);
+        std::cout << "Expected: c5e478d59288c841aa530db6845c4c8d962893a001ce4e11a4963873aa98134a" << std::endl;
+        std::cout << "PBKDF2 c=4096 x " << num_jobs << " jobs: " << (mismatches == 0 ? "✓ PASSED" : "✗ FAILED") << std::endl;
+        if (mismatches != 0) return 1;
+    }
+
     // Performance test
     {
         std::cout << "\n=== Performance Features ===" << std::endl;